@@ -131,6 +131,8 @@ typedef struct {
     uint32_t led;
     uint32_t powmon;
     uint32_t activity_detected;
+    uint32_t ml_credit_granted;
+    uint32_t ml_result_received;
 } timestamps_t;
 
 
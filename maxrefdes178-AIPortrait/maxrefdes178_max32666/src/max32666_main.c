@@ -97,6 +97,7 @@ static char mac_string[(sizeof(device_info.ble_mac) + 1) * 3] = {0};
 static uint16_t video_string_color;
 static uint16_t video_frame_color;
 static uint16_t audio_string_color;
+static uint8_t ml_credit_pending = 0;
 
 //-----------------------------------------------------------------------------
 // Local function declarations
@@ -107,6 +108,7 @@ static void core0_icc(int enable);
 static void core1_icc(int enable);
 static void run_application(void);
 static int refresh_screen(void);
+static void grant_ml_credit(void);
 static void update_mask(uint32_t mask);
 static void write_TFT_pixel(int row, int col, unsigned char value, uint32_t mask);
 
@@ -464,6 +466,9 @@ static void run_application(void)
 				update_mask(0x7f);
                 timestamps.video_data_received = timer_ms_tick;
                 lcd_data.refresh_screen = 1;
+                // Next credit is granted after the mask is drawn
+                ml_credit_pending = 1;
+                timestamps.ml_result_received = timer_ms_tick;
                 break;
 				
             case QSPI_PACKET_TYPE_VIDEO_CLASSIFICATION_RES:
@@ -686,6 +691,15 @@ static void run_application(void)
             led_worker();
         }
 
+        // ML result credit worker, grants the initial credit and recovers a lost one.
+        // A granted credit is lost if no mask arrived since the last mask and grant for the timeout
+        if (device_settings.enable_max78000_video && !ml_credit_pending &&
+            ((timer_ms_tick - timestamps.ml_result_received) > MAX32666_ML_CREDIT_LOSS_TIMEOUT) &&
+            ((timer_ms_tick - timestamps.ml_credit_granted) > MAX32666_ML_CREDIT_LOSS_TIMEOUT)) {
+            PR_DEBUG("grant ml credit after %d ms without mask", timer_ms_tick - timestamps.ml_result_received);
+            grant_ml_credit();
+        }
+
         // IO expander worker
         expander_worker();
 
@@ -722,11 +736,24 @@ static void run_application(void)
             refresh_screen();
         }
 
+        // Grant next ML result credit once the mask buffer is free
+        if (ml_credit_pending && (!device_settings.enable_lcd ||
+            (!lcd_data.refresh_screen && !spi_dma_busy_flag(MAX32666_LCD_DMA_CHANNEL)))) {
+            grant_ml_credit();
+        }
+
         // Sleep until an interrupt
         __WFI();
     }
 }
 
+static void grant_ml_credit(void)
+{
+    qspi_master_send_video(NULL, 0, QSPI_PACKET_TYPE_VIDEO_ML_CREDIT_CMD);
+    timestamps.ml_credit_granted = timer_ms_tick;
+    ml_credit_pending = 0;
+}
+
 static int refresh_screen(void)
 {
     if (device_status.fuel_gauge_working) {
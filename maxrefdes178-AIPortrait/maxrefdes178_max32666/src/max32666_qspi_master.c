@@ -60,6 +60,37 @@
 //-----------------------------------------------------------------------------
 // Typedefs
 //-----------------------------------------------------------------------------
+// Receive registration of one packet type. Frames and masks are received straight into their
+// buffer. State read by the rest of the main loop is received into qspi_rx_staging and copied
+// to buffer once its crc passed. Registered types have a payload (max_size) or a handler,
+// others are drained
+typedef struct {
+    uint8_t *buffer;
+    uint8_t staged;
+    uint32_t min_size;
+    uint32_t max_size;
+    void (*handler)(qspi_packet_header_t *header);  // optional
+} qspi_master_rx_entry_t;
+
+typedef struct {
+    const char *name;
+    const mxc_gpio_cfg_t *cs_pin;
+    const mxc_gpio_cfg_t *rw_pin;
+    volatile int *int_flag;
+    int (*wait_int)(void);
+    const qspi_master_rx_entry_t *rx_table;     // indexed by packet type
+} qspi_master_link_t;
+
+// Largest staged payload
+typedef union {
+    classification_result_t classification;
+    max78000_statistics_t statistics;
+    version_t version;
+    char demo_name[DEMO_STRING_SIZE];
+    serial_num_t serial;
+    uint8_t faceid_embed_update_status;
+    char faceid_embed_subject_names[sizeof(device_status.faceid_embed_subject_names)];
+} qspi_master_staging_t;
 
 
 //-----------------------------------------------------------------------------
@@ -82,9 +113,116 @@ static uint8_t qspi_payload_buff_audio_tx[100];
 
 extern int8_t *ml_data8;
 
+// Staged payloads and drained bytes of rejected ones land here
+static qspi_master_staging_t qspi_rx_staging;
+
+// Packet handlers, defined below
+static void qspi_master_rx_video_data(qspi_packet_header_t *header);
+static void qspi_master_rx_video_ml(qspi_packet_header_t *header);
+static void qspi_master_rx_video_classification(qspi_packet_header_t *header);
+static void qspi_master_rx_video_statistics(qspi_packet_header_t *header);
+static void qspi_master_rx_video_version(qspi_packet_header_t *header);
+static void qspi_master_rx_video_demo_name(qspi_packet_header_t *header);
+static void qspi_master_rx_video_serial(qspi_packet_header_t *header);
+static void qspi_master_rx_video_faceid_embed_update(qspi_packet_header_t *header);
+static void qspi_master_rx_video_faceid_subjects(qspi_packet_header_t *header);
+static void qspi_master_rx_video_button_press(qspi_packet_header_t *header);
+static void qspi_master_rx_audio_classification(qspi_packet_header_t *header);
+static void qspi_master_rx_audio_statistics(qspi_packet_header_t *header);
+static void qspi_master_rx_audio_version(qspi_packet_header_t *header);
+static void qspi_master_rx_audio_demo_name(qspi_packet_header_t *header);
+static void qspi_master_rx_audio_serial(qspi_packet_header_t *header);
+static void qspi_master_rx_audio_button_press(qspi_packet_header_t *header);
+
+static const qspi_master_rx_entry_t qspi_rx_table_video[QSPI_PACKET_TYPE_LAST] = {
+    [QSPI_PACKET_TYPE_VIDEO_DATA_RES] = {
+        .buffer = (uint8_t *) lcd_data.buffer,
+        .min_size = LCD_DATA_SIZE, .max_size = LCD_DATA_SIZE,
+        .handler = qspi_master_rx_video_data},
+    [QSPI_PACKET_TYPE_VIDEO_ML_RES] = {
+        .buffer = (uint8_t *) lcd_data.ml_data8,
+        .min_size = 30976/2, .max_size = 30976/2,
+        .handler = qspi_master_rx_video_ml},
+    [QSPI_PACKET_TYPE_VIDEO_CLASSIFICATION_RES] = {
+        .buffer = (uint8_t *) &device_status.classification_video, .staged = 1,
+        .min_size = sizeof(classification_result_t), .max_size = sizeof(classification_result_t),
+        .handler = qspi_master_rx_video_classification},
+    [QSPI_PACKET_TYPE_VIDEO_STATISTICS_RES] = {
+        .buffer = (uint8_t *) &device_status.statistics.max78000_video, .staged = 1,
+        .min_size = sizeof(max78000_statistics_t), .max_size = sizeof(max78000_statistics_t),
+        .handler = qspi_master_rx_video_statistics},
+    [QSPI_PACKET_TYPE_VIDEO_VERSION_RES] = {
+        .buffer = (uint8_t *) &device_info.device_version.max78000_video, .staged = 1,
+        .min_size = sizeof(version_t), .max_size = sizeof(version_t),
+        .handler = qspi_master_rx_video_version},
+    [QSPI_PACKET_TYPE_VIDEO_DEMO_NAME_RES] = {
+        .buffer = (uint8_t *) device_info.max78000_video_demo_name, .staged = 1,
+        .min_size = 1, .max_size = DEMO_STRING_SIZE,
+        .handler = qspi_master_rx_video_demo_name},
+    [QSPI_PACKET_TYPE_VIDEO_SERIAL_RES] = {
+        .buffer = (uint8_t *) &device_info.device_serial_num.max78000_video, .staged = 1,
+        .min_size = sizeof(serial_num_t), .max_size = sizeof(serial_num_t),
+        .handler = qspi_master_rx_video_serial},
+    [QSPI_PACKET_TYPE_VIDEO_FACEID_EMBED_UPDATE_RES] = {
+        .buffer = (uint8_t *) &device_status.faceid_embed_update_status, .staged = 1,
+        .min_size = sizeof(faceid_embed_update_status_e), .max_size = sizeof(faceid_embed_update_status_e),
+        .handler = qspi_master_rx_video_faceid_embed_update},
+    [QSPI_PACKET_TYPE_VIDEO_FACEID_SUBJECTS_RES] = {
+        .buffer = (uint8_t *) &device_status.faceid_embed_subject_names, .staged = 1,
+        .min_size = 0, .max_size = sizeof(device_status.faceid_embed_subject_names),
+        .handler = qspi_master_rx_video_faceid_subjects},
+    [QSPI_PACKET_TYPE_VIDEO_BUTTON_PRESS_RES] = {
+        .handler = qspi_master_rx_video_button_press},
+};
+
+static const qspi_master_rx_entry_t qspi_rx_table_audio[QSPI_PACKET_TYPE_LAST] = {
+    [QSPI_PACKET_TYPE_AUDIO_CLASSIFICATION_RES] = {
+        .buffer = (uint8_t *) &device_status.classification_audio, .staged = 1,
+        .min_size = sizeof(classification_result_t), .max_size = sizeof(classification_result_t),
+        .handler = qspi_master_rx_audio_classification},
+    [QSPI_PACKET_TYPE_AUDIO_STATISTICS_RES] = {
+        .buffer = (uint8_t *) &device_status.statistics.max78000_audio, .staged = 1,
+        .min_size = sizeof(max78000_statistics_t), .max_size = sizeof(max78000_statistics_t),
+        .handler = qspi_master_rx_audio_statistics},
+    [QSPI_PACKET_TYPE_AUDIO_VERSION_RES] = {
+        .buffer = (uint8_t *) &device_info.device_version.max78000_audio, .staged = 1,
+        .min_size = sizeof(version_t), .max_size = sizeof(version_t),
+        .handler = qspi_master_rx_audio_version},
+    [QSPI_PACKET_TYPE_AUDIO_DEMO_NAME_RES] = {
+        .buffer = (uint8_t *) device_info.max78000_audio_demo_name, .staged = 1,
+        .min_size = 1, .max_size = DEMO_STRING_SIZE,
+        .handler = qspi_master_rx_audio_demo_name},
+    [QSPI_PACKET_TYPE_AUDIO_SERIAL_RES] = {
+        .buffer = (uint8_t *) &device_info.device_serial_num.max78000_audio, .staged = 1,
+        .min_size = sizeof(serial_num_t), .max_size = sizeof(serial_num_t),
+        .handler = qspi_master_rx_audio_serial},
+    [QSPI_PACKET_TYPE_AUDIO_BUTTON_PRESS_RES] = {
+        .handler = qspi_master_rx_audio_button_press},
+};
+
+static const qspi_master_link_t qspi_link_video = {
+    .name = "video",
+    .cs_pin = &video_cs_pin,
+    .rw_pin = &video_rw_pin,
+    .int_flag = &qspi_video_int_flag,
+    .wait_int = qspi_master_wait_video_int,
+    .rx_table = qspi_rx_table_video,
+};
+
+static const qspi_master_link_t qspi_link_audio = {
+    .name = "audio",
+    .cs_pin = &audio_cs_pin,
+    .rw_pin = &audio_rw_pin,
+    .int_flag = &qspi_audio_int_flag,
+    .wait_int = qspi_master_wait_audio_int,
+    .rx_table = qspi_rx_table_audio,
+};
+
 //-----------------------------------------------------------------------------
 // Local function declarations
 //-----------------------------------------------------------------------------
+static int qspi_master_rx_worker(const qspi_master_link_t *link, qspi_packet_type_e *qspi_packet_type_rx);
+static void qspi_master_rx_drain(uint32_t len);
 
 
 //-----------------------------------------------------------------------------
@@ -179,209 +317,76 @@ int qspi_master_init(void)
 
 int qspi_master_video_rx_worker(qspi_packet_type_e *qspi_packet_type_rx)
 {
-    qspi_packet_header_t qspi_packet_header_rx;
-
-    if (!qspi_video_int_flag) {
-        return E_NONE_AVAIL;
-    }
-    qspi_video_int_flag = 0;
-
-    GPIO_SET(video_rw_pin); // RX request
-
-    GPIO_CLR(video_cs_pin);
-    MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-    spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &qspi_packet_header_rx, sizeof(qspi_packet_header_t), MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-    spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-    GPIO_SET(video_cs_pin);
-    *qspi_packet_type_rx = qspi_packet_header_rx.info.packet_type;
-
-    if (qspi_packet_header_rx.start_symbol != QSPI_START_SYMBOL) {
-        PR_ERROR("Invalid QSPI start byte 0x%08hhX", qspi_packet_header_rx.start_symbol);
-        return E_COMM_ERR;
-    }
-
-    if (qspi_packet_header_rx.header_crc16 != crc16_sw((uint8_t *) &qspi_packet_header_rx.info, sizeof(qspi_packet_header_rx.info))) {
-        PR_ERROR("Invalid header crc 0x%x", qspi_packet_header_rx.header_crc16);
-        return E_COMM_ERR;
-    }
-
-    if (qspi_packet_header_rx.info.packet_size) {
-        qspi_master_wait_video_int();
-        qspi_video_int_flag = 0;
-    }
-
-    switch(qspi_packet_header_rx.info.packet_type) {
-    case QSPI_PACKET_TYPE_VIDEO_DATA_RES:
-        //if (qspi_packet_header_rx.info.packet_size != LCD_WIDTH * LCD_BYTE_PER_PIXEL) {
-        if (qspi_packet_header_rx.info.packet_size != LCD_DATA_SIZE) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *)(lcd_data.buffer), qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
-        PR_DEBUG("video Cam %u", qspi_packet_header_rx.info.packet_size);
-		
-        break;
-		
-    case QSPI_PACKET_TYPE_VIDEO_ML_RES:
-        if (qspi_packet_header_rx.info.packet_size != 30976/2) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *)lcd_data.ml_data8, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
-
-        PR_DEBUG("video ML %u", qspi_packet_header_rx.info.packet_size);
-
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_CLASSIFICATION_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(classification_result_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_status.classification_video, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
-
-        PR_INFO("video %s %d %0.1f", device_status.classification_video.result, device_status.classification_video.classification, (double)device_status.classification_video.probability);
-
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_STATISTICS_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(max78000_statistics_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_status.statistics.max78000_video, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
-
-        PR_DEBUG("video capture : %lu", device_status.statistics.max78000_video.capture_duration_us);
-        PR_DEBUG("video cnn     : %lu", device_status.statistics.max78000_video.cnn_duration_us);
-        PR_DEBUG("video qspi    : %lu", device_status.statistics.max78000_video.communication_duration_us);
-        PR_DEBUG("video total   : %lu", device_status.statistics.max78000_video.total_duration_us);
-
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_VERSION_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(version_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_info.device_version.max78000_video, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
-
-        PR_INFO("MAX78000 Video v%d.%d.%d", device_info.device_version.max78000_video.major, device_info.device_version.max78000_video.minor, device_info.device_version.max78000_video.build);
-
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_DEMO_NAME_RES:
-        if (qspi_packet_header_rx.info.packet_size == 0 || qspi_packet_header_rx.info.packet_size > DEMO_STRING_SIZE) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) device_info.max78000_video_demo_name, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
-
-        PR_INFO("MAX78000 Video demo %s", device_info.max78000_video_demo_name);
-
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_SERIAL_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(serial_num_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_info.device_serial_num.max78000_video, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
-
-        PR_INFO("MAX78000 Video serial: ");
-        for (int i = 0; i < sizeof(device_info.device_serial_num.max78000_video); i++) {
-            PR("%02X", device_info.device_serial_num.max78000_video[i]);
-        }
-        PR("\n");
+    return qspi_master_rx_worker(&qspi_link_video, qspi_packet_type_rx);
+}
 
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_FACEID_EMBED_UPDATE_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(faceid_embed_update_status_e)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
+static void qspi_master_rx_video_data(qspi_packet_header_t *header)
+{
+    PR_DEBUG("video Cam %u", header->info.packet_size);
+}
 
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_status.faceid_embed_update_status, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
+static void qspi_master_rx_video_ml(qspi_packet_header_t *header)
+{
+    PR_DEBUG("video ML %u", header->info.packet_size);
+}
 
-        PR_INFO("FaceID stat %d", device_status.faceid_embed_update_status);
+static void qspi_master_rx_video_classification(qspi_packet_header_t *header)
+{
+    PR_INFO("video %s %d %0.1f", device_status.classification_video.result, device_status.classification_video.classification, (double)device_status.classification_video.probability);
+}
 
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_FACEID_SUBJECTS_RES:
-        if (qspi_packet_header_rx.info.packet_size > sizeof(device_status.faceid_embed_subject_names)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
+static void qspi_master_rx_video_statistics(qspi_packet_header_t *header)
+{
+    PR_DEBUG("video capture : %lu", device_status.statistics.max78000_video.capture_duration_us);
+    PR_DEBUG("video cnn     : %lu", device_status.statistics.max78000_video.cnn_duration_us);
+    PR_DEBUG("video qspi    : %lu", device_status.statistics.max78000_video.communication_duration_us);
+    PR_DEBUG("video total   : %lu", device_status.statistics.max78000_video.total_duration_us);
+}
 
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_status.faceid_embed_subject_names, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
+static void qspi_master_rx_video_version(qspi_packet_header_t *header)
+{
+    PR_INFO("MAX78000 Video v%d.%d.%d", device_info.device_version.max78000_video.major, device_info.device_version.max78000_video.minor, device_info.device_version.max78000_video.build);
+}
 
-        device_status.faceid_embed_subject_names_size = qspi_packet_header_rx.info.packet_size;
+static void qspi_master_rx_video_demo_name(qspi_packet_header_t *header)
+{
+    PR_INFO("MAX78000 Video demo %s", device_info.max78000_video_demo_name);
+}
 
-        PR_INFO("FaceID names %d", device_status.faceid_embed_subject_names_size);
-        for (int i = 0; i < device_status.faceid_embed_subject_names_size;
-                i += printf("%s\n", &device_status.faceid_embed_subject_names[i])) {}
+static void qspi_master_rx_video_serial(qspi_packet_header_t *header)
+{
+    PR_INFO("MAX78000 Video serial: ");
+    for (int i = 0; i < sizeof(device_info.device_serial_num.max78000_video); i++) {
+        PR("%02X", device_info.device_serial_num.max78000_video[i]);
+    }
+    PR("\n");
+}
 
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_BUTTON_PRESS_RES:
-        if (qspi_packet_header_rx.info.packet_size != 0) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
+static void qspi_master_rx_video_faceid_embed_update(qspi_packet_header_t *header)
+{
+    PR_INFO("FaceID stat %d", device_status.faceid_embed_update_status);
+}
 
-        PR_INFO("Video button A pressed");
-        timestamps.activity_detected = timer_ms_tick;
-        device_settings.enable_max78000_video_flash_led = !device_settings.enable_max78000_video_flash_led;
+static void qspi_master_rx_video_faceid_subjects(qspi_packet_header_t *header)
+{
+    device_status.faceid_embed_subject_names_size = header->info.packet_size;
 
-        if (device_settings.enable_max78000_video_flash_led) {
-            lcd_notification(MAGENTA, "Video flash LED enabled");
-        } else {
-            lcd_notification(MAGENTA, "Video flash LED disabled");
-        }
+    PR_INFO("FaceID names %d", device_status.faceid_embed_subject_names_size);
+    for (int i = 0; i < device_status.faceid_embed_subject_names_size;
+            i += printf("%s\n", &device_status.faceid_embed_subject_names[i])) {}
+}
 
-        break;
-    default:
-        PR_ERROR("Unknown qspi video packet");
-        return E_INVALID;
-        break;
+static void qspi_master_rx_video_button_press(qspi_packet_header_t *header)
+{
+    PR_INFO("Video button A pressed");
+    timestamps.activity_detected = timer_ms_tick;
+    device_settings.enable_max78000_video_flash_led = !device_settings.enable_max78000_video_flash_led;
+
+    if (device_settings.enable_max78000_video_flash_led) {
+        lcd_notification(MAGENTA, "Video flash LED enabled");
+    } else {
+        lcd_notification(MAGENTA, "Video flash LED disabled");
     }
-
-    return E_NO_ERROR;
 }
 
 int qspi_master_video_tx_worker(void)
@@ -398,134 +403,42 @@ int qspi_master_video_tx_worker(void)
 
 int qspi_master_audio_rx_worker(qspi_packet_type_e *qspi_packet_type_rx)
 {
-    qspi_packet_header_t qspi_packet_header_rx;
-
-    if (!qspi_audio_int_flag) {
-        return E_NONE_AVAIL;
-    }
-    qspi_audio_int_flag = 0;
-
-    GPIO_SET(audio_rw_pin); // RX request
-
-    GPIO_CLR(audio_cs_pin);
-    MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-    spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &qspi_packet_header_rx, sizeof(qspi_packet_header_t), MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-    spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-    GPIO_SET(audio_cs_pin);
-    *qspi_packet_type_rx = qspi_packet_header_rx.info.packet_type;
-
-    if (qspi_packet_header_rx.start_symbol != QSPI_START_SYMBOL) {
-        PR_ERROR("Invalid QSPI start byte 0x%08hhX", qspi_packet_header_rx.start_symbol);
-        return E_COMM_ERR;
-    }
-
-    if (qspi_packet_header_rx.header_crc16 != crc16_sw((uint8_t *) &qspi_packet_header_rx.info, sizeof(qspi_packet_header_rx.info))) {
-        PR_ERROR("Invalid header crc 0x%x", qspi_packet_header_rx.header_crc16);
-        return E_COMM_ERR;
-    }
-
-    if (qspi_packet_header_rx.info.packet_size) {
-        qspi_master_wait_audio_int();
-        qspi_audio_int_flag = 0;
-    }
-
-    switch(qspi_packet_header_rx.info.packet_type) {
-    case QSPI_PACKET_TYPE_AUDIO_CLASSIFICATION_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(classification_result_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(audio_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_status.classification_audio, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(audio_cs_pin);
-
-        PR_INFO("audio %s %d %0.1f", device_status.classification_audio.result, device_status.classification_audio.classification, (double)device_status.classification_audio.probability);
-
-        break;
-    case QSPI_PACKET_TYPE_AUDIO_STATISTICS_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(max78000_statistics_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(audio_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_status.statistics.max78000_audio, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(audio_cs_pin);
-
-        PR_DEBUG("audio cnn: %lu", device_status.statistics.max78000_audio.cnn_duration_us);
-
-        break;
-    case QSPI_PACKET_TYPE_AUDIO_VERSION_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(version_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(audio_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_info.device_version.max78000_audio, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(audio_cs_pin);
-
-        PR_INFO("MAX78000 Audio v%d.%d.%d", device_info.device_version.max78000_audio.major, device_info.device_version.max78000_audio.minor, device_info.device_version.max78000_audio.build);
-
-        break;
-    case QSPI_PACKET_TYPE_AUDIO_DEMO_NAME_RES:
-        if (qspi_packet_header_rx.info.packet_size == 0 || qspi_packet_header_rx.info.packet_size > DEMO_STRING_SIZE) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(audio_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) device_info.max78000_audio_demo_name, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(audio_cs_pin);
-
-        PR_INFO("MAX78000 Audio demo %s", device_info.max78000_audio_demo_name);
-
-        break;
-    case QSPI_PACKET_TYPE_AUDIO_SERIAL_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(serial_num_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
+    return qspi_master_rx_worker(&qspi_link_audio, qspi_packet_type_rx);
+}
 
-        GPIO_CLR(audio_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_info.device_serial_num.max78000_audio, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(audio_cs_pin);
+static void qspi_master_rx_audio_classification(qspi_packet_header_t *header)
+{
+    PR_INFO("audio %s %d %0.1f", device_status.classification_audio.result, device_status.classification_audio.classification, (double)device_status.classification_audio.probability);
+}
 
-        PR_INFO("MAX78000 Audio serial: ");
-        for (int i = 0; i < sizeof(device_info.device_serial_num.max78000_audio); i++) {
-            PR("%02X", device_info.device_serial_num.max78000_audio[i]);
-        }
-        PR("\n");
+static void qspi_master_rx_audio_statistics(qspi_packet_header_t *header)
+{
+    PR_DEBUG("audio cnn: %lu", device_status.statistics.max78000_audio.cnn_duration_us);
+}
 
-        break;
-    case QSPI_PACKET_TYPE_AUDIO_BUTTON_PRESS_RES:
-        if (qspi_packet_header_rx.info.packet_size != 0) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
+static void qspi_master_rx_audio_version(qspi_packet_header_t *header)
+{
+    PR_INFO("MAX78000 Audio v%d.%d.%d", device_info.device_version.max78000_audio.major, device_info.device_version.max78000_audio.minor, device_info.device_version.max78000_audio.build);
+}
 
-        PR_INFO("Audio button B pressed");
-        timestamps.activity_detected = timer_ms_tick;
+static void qspi_master_rx_audio_demo_name(qspi_packet_header_t *header)
+{
+    PR_INFO("MAX78000 Audio demo %s", device_info.max78000_audio_demo_name);
+}
 
-        break;
-    default:
-        PR_ERROR("Unknown qspi audio packet");
-        return E_INVALID;
-        break;
+static void qspi_master_rx_audio_serial(qspi_packet_header_t *header)
+{
+    PR_INFO("MAX78000 Audio serial: ");
+    for (int i = 0; i < sizeof(device_info.device_serial_num.max78000_audio); i++) {
+        PR("%02X", device_info.device_serial_num.max78000_audio[i]);
     }
+    PR("\n");
+}
 
-    return E_NO_ERROR;
+static void qspi_master_rx_audio_button_press(qspi_packet_header_t *header)
+{
+    PR_INFO("Audio button B pressed");
+    timestamps.activity_detected = timer_ms_tick;
 }
 
 int qspi_master_audio_tx_worker(void)
@@ -657,3 +570,103 @@ int qspi_master_send_audio(uint8_t *data, uint32_t data_size, uint8_t data_type)
 
     return E_NO_ERROR;
 }
+
+static int qspi_master_rx_worker(const qspi_master_link_t *link, qspi_packet_type_e *qspi_packet_type_rx)
+{
+    qspi_packet_header_t qspi_packet_header_rx;
+    const qspi_master_rx_entry_t *entry = NULL;
+    uint32_t packet_size;
+    uint8_t *buffer = NULL;
+    int ret = E_NO_ERROR;
+
+    if (!*link->int_flag) {
+        return E_NONE_AVAIL;
+    }
+    *link->int_flag = 0;
+
+    MXC_GPIO_OutSet(link->rw_pin->port, link->rw_pin->mask); // RX request
+
+    MXC_GPIO_OutClr(link->cs_pin->port, link->cs_pin->mask);
+    MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
+    spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &qspi_packet_header_rx, sizeof(qspi_packet_header_t), MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
+    spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
+    MXC_GPIO_OutSet(link->cs_pin->port, link->cs_pin->mask);
+    *qspi_packet_type_rx = qspi_packet_header_rx.info.packet_type;
+    packet_size = qspi_packet_header_rx.info.packet_size;
+
+    if (qspi_packet_header_rx.start_symbol != QSPI_START_SYMBOL) {
+        PR_ERROR("Invalid QSPI start byte 0x%08hhX", qspi_packet_header_rx.start_symbol);
+        return E_COMM_ERR;
+    }
+
+    if (qspi_packet_header_rx.header_crc16 != crc16_sw((uint8_t *) &qspi_packet_header_rx.info, sizeof(qspi_packet_header_rx.info))) {
+        PR_ERROR("Invalid header crc 0x%x", qspi_packet_header_rx.header_crc16);
+        return E_COMM_ERR;
+    }
+
+    if (qspi_packet_header_rx.info.packet_type < QSPI_PACKET_TYPE_LAST) {
+        entry = &link->rx_table[qspi_packet_header_rx.info.packet_type];
+    }
+
+    if (!entry || (!entry->max_size && !entry->handler)) {
+        PR_ERROR("Unknown qspi %s packet", link->name);
+        ret = E_INVALID;
+    } else if ((packet_size < entry->min_size) || (packet_size > entry->max_size) ||
+               (entry->staged && (packet_size > sizeof(qspi_rx_staging)))) {
+        PR_ERROR("Invalid QSPI data len %u", packet_size);
+        ret = E_INVALID;
+    } else if (packet_size) {
+        buffer = entry->staged ? (uint8_t *) &qspi_rx_staging : entry->buffer;
+    }
+
+    if (packet_size) {
+        if (link->wait_int() != E_NO_ERROR) {
+            return E_TIME_OUT;
+        }
+        *link->int_flag = 0;
+
+        MXC_GPIO_OutClr(link->cs_pin->port, link->cs_pin->mask);
+        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
+        if (buffer) {
+            spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, buffer, packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
+            spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
+        } else {
+            // Clock the rejected payload out so the slave is released, nothing is stored
+            qspi_master_rx_drain(packet_size);
+        }
+        MXC_GPIO_OutSet(link->cs_pin->port, link->cs_pin->mask);
+
+        if (buffer && (qspi_packet_header_rx.payload_crc16 != crc16_sw(buffer, packet_size))) {
+            PR_ERROR("Invalid %s payload crc 0x%x", link->name, qspi_packet_header_rx.payload_crc16);
+            ret = E_COMM_ERR;
+        }
+    }
+
+    if (ret != E_NO_ERROR) {
+        return ret;
+    }
+
+    // Publish the staged payload, checked and complete
+    if (entry->staged && packet_size) {
+        memcpy(entry->buffer, &qspi_rx_staging, packet_size);
+    }
+
+    if (entry->handler) {
+        entry->handler(&qspi_packet_header_rx);
+    }
+
+    return E_NO_ERROR;
+}
+
+static void qspi_master_rx_drain(uint32_t len)
+{
+    uint32_t chunk;
+
+    // CS stays asserted, the slave DMA keeps streaming between chunks
+    while (len) {
+        chunk = MIN(len, sizeof(qspi_rx_staging));
+        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &qspi_rx_staging, chunk, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
+        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
+        len -= chunk;
+    }
+}
@@ -59,6 +59,13 @@
 //-----------------------------------------------------------------------------
 // Typedefs
 //-----------------------------------------------------------------------------
+// Payloads longer than one SPI character count are split into segments, the next one
+// is written to the reload registers each time the DMA reloads
+typedef struct {
+    uint32_t next;          // address of the segment after the one in the reload registers
+    uint32_t remaining;     // bytes after the segment in the reload registers
+    uint8_t tx;
+} qspi_dma_chain_t;
 
 
 //-----------------------------------------------------------------------------
@@ -72,6 +79,7 @@ static volatile qspi_packet_header_t g_qspi_packet_header_tx = {0};
 static volatile qspi_state_e g_qspi_state_tx = QSPI_STATE_IDLE;
 static volatile qspi_packet_header_t g_qspi_packet_header_rx = {0};
 static volatile qspi_state_e g_qspi_state_rx = QSPI_STATE_IDLE;
+static volatile qspi_dma_chain_t g_qspi_dma_chain = {0};
 
 #if defined(MAXREFDES178_MAX78000_AUDIO)
 static const mxc_gpio_cfg_t qspi_int_pin = MAX78000_AUDIO_HOST_INT_PIN;
@@ -93,6 +101,7 @@ static uint8_t qspi_ch; // QSPI DMA channel
 //-----------------------------------------------------------------------------
 static int qspi_slave_dma(uint8_t *tx_data, uint8_t *rx_data, uint32_t data_size);
 static int qspi_slave_wait_tx(qspi_state_e qspi_state);
+static void qspi_slave_dma_chain_load(void);
 
 
 //-----------------------------------------------------------------------------
@@ -110,7 +119,11 @@ void MAX78000_VIDEO_QSPI_DMA_IRQ_HAND(void)
         }
 
         if (MXC_DMA->ch[qspi_ch].status & MXC_F_DMA_STATUS_RLD_IF) {
-            // reload interrupt, do nothing
+            // Reload occurred, queue the following segment
+            if (g_qspi_dma_chain.remaining) {
+                qspi_slave_dma_chain_load();
+                MXC_DMA->ch[qspi_ch].ctrl |= MXC_F_DMA_CTRL_RLDEN;
+            }
         } else {
             if (MXC_DMA->ch[qspi_ch].cnt) {
                 PR_ERROR("dma is not empty %d", MXC_DMA->ch[qspi_ch].cnt);
@@ -174,6 +187,8 @@ void qspi_slave_cs_handler(void *cbdata)
                 } else {
                     g_qspi_state_rx = QSPI_STATE_COMPLETED;
                 }
+                // Set again for each packet, a stale buffer must not take the payload of the next one
+                g_rx_data = NULL;
                 break;
             default:
                 PR_ERROR("invalid rx state %d", g_qspi_state_rx);
@@ -209,6 +224,11 @@ void qspi_slave_cs_handler(void *cbdata)
             // RX request
             switch (g_qspi_state_rx) {
             case QSPI_STATE_IDLE:
+                // Master only sends on an idle link, the TX packet it was reading lost a CS edge
+                if ((g_qspi_state_tx == QSPI_STATE_CS_ASSERTED_HEADER) || (g_qspi_state_tx == QSPI_STATE_CS_DEASSERTED_HEADER) ||
+                        (g_qspi_state_tx == QSPI_STATE_CS_ASSERTED_DATA)) {
+                    g_qspi_state_tx = QSPI_STATE_IDLE;
+                }
                 qspi_slave_dma(NULL, (uint8_t *) &g_qspi_packet_header_rx, sizeof(g_qspi_packet_header_rx));
                 g_qspi_state_rx = QSPI_STATE_CS_ASSERTED_HEADER;
                 break;
@@ -385,18 +405,14 @@ static int qspi_slave_dma(uint8_t *tx_data, uint8_t *rx_data, uint32_t data_size
         MXC_DMA->ch[qspi_ch].dst = (unsigned int) rx_data;
     }
 
-    // if too big, set reload registers
+    // if too big, chain segments through the reload registers
+    g_qspi_dma_chain.remaining = 0;
     if (data_size > SPI_DMA_COUNTER_MAX) {
         MXC_DMA->ch[qspi_ch].cnt = SPI_DMA_COUNTER_MAX;
-        if (tx_data) {
-            MXC_DMA->ch[qspi_ch].srcrld = (unsigned int) (tx_data + SPI_DMA_COUNTER_MAX);
-            MXC_DMA->ch[qspi_ch].dstrld = 0;
-        }
-        if (rx_data) {
-            MXC_DMA->ch[qspi_ch].srcrld = 0;
-            MXC_DMA->ch[qspi_ch].dstrld = (unsigned int) (rx_data + SPI_DMA_COUNTER_MAX);
-        }
-        MXC_DMA->ch[qspi_ch].cntrld = data_size - SPI_DMA_COUNTER_MAX;
+        g_qspi_dma_chain.tx = (tx_data != NULL);
+        g_qspi_dma_chain.next = (unsigned int) (tx_data ? tx_data : rx_data) + SPI_DMA_COUNTER_MAX;
+        g_qspi_dma_chain.remaining = data_size - SPI_DMA_COUNTER_MAX;
+        qspi_slave_dma_chain_load();
     }
 
     // Enable DMA int
@@ -412,6 +428,27 @@ static int qspi_slave_dma(uint8_t *tx_data, uint8_t *rx_data, uint32_t data_size
     return E_NO_ERROR;
 }
 
+static void qspi_slave_dma_chain_load(void)
+{
+    uint32_t len = g_qspi_dma_chain.remaining;
+
+    if (len > SPI_DMA_COUNTER_MAX) {
+        len = SPI_DMA_COUNTER_MAX;
+    }
+
+    if (g_qspi_dma_chain.tx) {
+        MXC_DMA->ch[qspi_ch].srcrld = g_qspi_dma_chain.next;
+        MXC_DMA->ch[qspi_ch].dstrld = 0;
+    } else {
+        MXC_DMA->ch[qspi_ch].srcrld = 0;
+        MXC_DMA->ch[qspi_ch].dstrld = g_qspi_dma_chain.next;
+    }
+    MXC_DMA->ch[qspi_ch].cntrld = len;
+
+    g_qspi_dma_chain.next += len;
+    g_qspi_dma_chain.remaining -= len;
+}
+
 int qspi_slave_trigger(void)
 {
     // Send interrupt to master
@@ -448,6 +485,12 @@ static int qspi_slave_wait_tx(qspi_state_e qspi_state)
     uint32_t cnt = SPI_TIMEOUT_CNT * 10;
 
     while((g_qspi_state_tx != qspi_state) && cnt) {
+        // Dropped by the CS handler, or the master sent a data header instead of reading ours and took
+        // our INT for its payload request
+        if ((g_qspi_state_tx == QSPI_STATE_IDLE) ||
+                ((g_qspi_state_tx == QSPI_STATE_STARTED) && (g_qspi_state_rx == QSPI_STATE_CS_DEASSERTED_HEADER))) {
+            return E_BUSY;
+        }
         cnt--;
     }
 
@@ -461,6 +504,11 @@ static int qspi_slave_wait_tx(qspi_state_e qspi_state)
 
 int qspi_slave_send_packet(uint8_t *data, uint32_t data_size, uint8_t data_type)
 {
+    int ret;
+
+    // Computed before the idle checks, a frame takes milliseconds and the master may start a transfer meanwhile
+    uint16_t payload_crc16 = data_size ? crc16_sw(data, data_size) : 0;
+
     if (g_qspi_state_tx != QSPI_STATE_IDLE) {
         PR_WARN("qspi is not idle %d", g_qspi_state_tx);
         return E_BUSY;
@@ -477,7 +525,7 @@ int qspi_slave_send_packet(uint8_t *data, uint32_t data_size, uint8_t data_type)
     g_qspi_packet_header_tx.info.packet_size = data_size;
     g_qspi_packet_header_tx.info.packet_type = data_type;
     g_qspi_packet_header_tx.header_crc16 = crc16_sw((uint8_t *) &g_qspi_packet_header_tx.info, sizeof(g_qspi_packet_header_tx.info));
-//    g_qspi_packet_header_tx.payload_crc16 = crc16_sw(data, data_size);
+    g_qspi_packet_header_tx.payload_crc16 = payload_crc16;
     g_tx_data = data;
     g_tx_data_size = data_size;
 
@@ -487,7 +535,13 @@ int qspi_slave_send_packet(uint8_t *data, uint32_t data_size, uint8_t data_type)
     qspi_slave_trigger();
 
     if (data_size) {
-        if (qspi_slave_wait_tx(QSPI_STATE_CS_DEASSERTED_HEADER) != E_NO_ERROR) {
+        ret = qspi_slave_wait_tx(QSPI_STATE_CS_DEASSERTED_HEADER);
+        if (ret == E_BUSY) {
+            // Master dropped it or sent its own packet first, the caller sends again
+            g_qspi_state_tx = QSPI_STATE_IDLE;
+            PR_WARN("tx dropped %d", data_type);
+            return E_BUSY;
+        } else if (ret != E_NO_ERROR) {
             g_qspi_state_tx = QSPI_STATE_IDLE;
             PR_ERROR("wait fail %d %d", data_size, data_type);
             return E_BAD_STATE;
@@ -497,7 +551,13 @@ int qspi_slave_send_packet(uint8_t *data, uint32_t data_size, uint8_t data_type)
         qspi_slave_trigger();
     }
 
-    if (qspi_slave_wait_tx(QSPI_STATE_COMPLETED) != E_NO_ERROR) {
+    ret = qspi_slave_wait_tx(QSPI_STATE_COMPLETED);
+    if (ret == E_BUSY) {
+        // Master dropped it or sent its own packet first, the caller sends again
+        g_qspi_state_tx = QSPI_STATE_IDLE;
+        PR_WARN("tx dropped %d", data_type);
+        return E_BUSY;
+    } else if (ret != E_NO_ERROR) {
         g_qspi_state_tx = QSPI_STATE_IDLE;
         PR_ERROR("wait fail %d %d", data_size, data_type);
         return E_BAD_STATE;
@@ -217,6 +217,9 @@ static int8_t enable_cnn = 0;
 static int8_t flash_led = 0;
 static int8_t camera_vflip = 1;
 static int8_t enable_video = 0;
+static int8_t ml_credit = 0;
+static uint8_t *ml_result = NULL;  // mask waiting for a credit
+static uint32_t ml_result_time = 0;
 static int8_t enable_sleep = 0;
 static uint8_t *qspi_payload_buffer = NULL;
 static version_t version = {S_VERSION_MAJOR, S_VERSION_MINOR, S_VERSION_BUILD};
@@ -235,6 +238,7 @@ static uint32_t camera_clock = 10 * 1000 * 1000;
 static void fail(void);
 static void send_img(void);
 static void run_cnn(int x_offset, int y_offset);
+static int send_ml_result(void);
 static void run_demo(void);
 
 
@@ -454,8 +458,9 @@ static void run_demo(void)
         if (qspi_rx_state == QSPI_STATE_CS_DEASSERTED_HEADER) {
             qspi_rx_header = qspi_slave_get_rx_header();
 
-            // Use camera interface buffer for QSPI payload
+            // Use camera interface buffer for QSPI payload, it overwrites a mask waiting for a credit
             MXC_PCIF_Stop();
+            ml_result = NULL;
 
             qspi_slave_set_rx_data(qspi_payload_buffer, qspi_rx_header.info.packet_size);
             qspi_slave_trigger();
@@ -518,6 +523,7 @@ static void run_demo(void)
                 PR_INFO("disable video");
                 enable_video = 0;
                 MXC_PCIF_Stop();
+                ml_result = NULL;
                 // Disable camera
                 GPIO_SET(gpio_camera);
                 GPIO_CLR(gpio_red);
@@ -586,6 +592,9 @@ static void run_demo(void)
                 enable_sleep = 0;
                 MXC_TMR_Start(MAX78000_VIDEO_SLEEP_DEFER_TMR);
                 break;
+            case QSPI_PACKET_TYPE_VIDEO_ML_CREDIT_CMD:
+                ml_credit = 1;
+                break;
             default:
                 PR_ERROR("Invalid packet %d", qspi_rx_header.info.packet_type);
                 break;
@@ -616,6 +625,11 @@ static void run_demo(void)
             continue;
         }
 
+        // Mask stays in the camera buffer until it is sent or dropped, commands are served meanwhile
+        if (send_ml_result() == E_BUSY) {
+            continue;
+        }
+
         capture_started_time = GET_RTC_MS();
         // capture image frame for display
         camera_start_capture_image();
@@ -968,9 +982,31 @@ static void run_cnn(int x_offset, int y_offset)
     pass_time = GET_RTC_MS();
 #endif
 
-    MXC_Delay(MXC_DELAY_MSEC(500));
+    // Send the mask when host has a free mask buffer, otherwise main loop retries until the timeout
+    ml_result = (uint8_t*)&camera_image[LCD_DATA_SIZE/8];
+    ml_result_time = GET_RTC_MS();
+    send_ml_result();
+}
+
+// Sends the pending mask if host granted a credit, E_BUSY while it is still waiting for one
+static int send_ml_result(void)
+{
+    if (ml_result == NULL) {
+        return E_NO_ERROR;
+    }
+
+    if (!ml_credit) {
+        if ((GET_RTC_MS() - ml_result_time) <= MAX78000_VIDEO_ML_CREDIT_TIMEOUT) {
+            return E_BUSY;
+        }
+        PR_DEBUG("no ml credit, drop result");
+        ml_result = NULL;
+        return E_TIME_OUT;
+    }
 
-    qspi_slave_send_packet((uint8_t*)&camera_image[LCD_DATA_SIZE/8], AIPORTRAIT_INFER_SIZE/2, QSPI_PACKET_TYPE_VIDEO_ML_RES); // send mask
+    ml_credit = 0;
+    qspi_slave_send_packet(ml_result, AIPORTRAIT_INFER_SIZE/2, QSPI_PACKET_TYPE_VIDEO_ML_RES); // send mask
+    ml_result = NULL;
 
-    MXC_Delay(MXC_DELAY_MSEC(500));
+    return E_NO_ERROR;
 }
@@ -256,6 +256,7 @@ int qspi_master_video_rx_worker(qspi_packet_type_e *qspi_packet_type_rx)
         PR_DEBUG("video cnn     : %lu", device_status.statistics.max78000_video.cnn_duration_us);
         PR_DEBUG("video qspi    : %lu", device_status.statistics.max78000_video.communication_duration_us);
         PR_DEBUG("video total   : %lu", device_status.statistics.max78000_video.total_duration_us);
+        PR_DEBUG("video overflow: %lu", device_status.statistics.max78000_video.stream_overflow_count);
 
         break;
     case QSPI_PACKET_TYPE_VIDEO_VERSION_RES:
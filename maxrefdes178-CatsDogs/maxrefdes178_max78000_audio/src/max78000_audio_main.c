@@ -54,9 +54,11 @@
 #include <tmr.h>
 
 #include "max78000_audio_cnn.h"
+#include "max78000_cnn_loader.h"
 #include "max78000_debug.h"
 #include "max78000_qspi_slave.h"
 #include "maxrefdes178_definitions.h"
+#include "maxrefdes178_mic.h"
 #include "maxrefdes178_utility.h"
 #include "maxrefdes178_version.h"
 
@@ -78,7 +80,6 @@
 #define CHUNK               128     // number of data points to read at a time and average for threshold, keep multiple of 128
 #define TRANSPOSE_WIDTH     128     // width of 2d data model to be used for transpose
 #define NUM_OUTPUTS         CNN_NUM_OUTPUTS      // number of classes
-#define I2S_RX_BUFFER_SIZE  64      // I2S buffer size
 #define TFT_BUFF_SIZE       50      // TFT buffer size
 /*-----------------------------*/
 
@@ -89,6 +90,10 @@
 #define SILENCE_COUNTER_THRESHOLD   20      // [>20] number of back to back CHUNK periods with avg < THRESHOLD_LOW to declare the end of a word
 #define PREAMBLE_SIZE               30*CHUNK// how many samples before beginning of a keyword to include
 #define INFERENCE_THRESHOLD         75      // min probability (0-100) to accept an inference
+#define MIC_DISCARD_SAMPLES         10000   // number of samples discarded at start due to microphone charging cap effect
+
+/* First DMA block is shortened so that following CHUNK blocks start right after the discarded samples */
+#define MIC_DISCARD_FIRST_BLOCK     ((MIC_DISCARD_SAMPLES % CHUNK) ? (MIC_DISCARD_SAMPLES % CHUNK) : CHUNK)
 
 /* MAX9867 Audio Codec */
 #define MAX9867_I2C        MXC_I2C1
@@ -130,14 +135,19 @@ static uint8_t pPreambleCircBuffer[PREAMBLE_SIZE];
 static int16_t Max, Min;
 static uint16_t thresholdHigh = THRESHOLD_HIGH;
 static uint16_t thresholdLow = THRESHOLD_LOW;
-static int16_t  x0, x1, Coeff;
-static int32_t  y0, y1;
+static mic_hpf_t hpf;
 static int8_t enable_audio = 1;
 static int8_t enable_sleep = 0;
 static volatile int8_t button_pressed = 0;
 
-static volatile uint8_t i2s_flag = 0;
-static int32_t i2s_rx_buffer[I2S_RX_BUFFER_SIZE];
+static const uint8_t i2s_ch = MAX78000_AUDIO_I2S_DMA_CHANNEL;
+static int32_t i2s_dma_buffer[2][CHUNK];       // ping-pong microphone sample buffers
+static uint16_t i2s_dma_size[2];               // number of samples DMA writes to each buffer
+static uint8_t i2s_dma_active_buffer = 0;      // buffer DMA is writing to
+static volatile uint8_t i2s_dma_ready = 0;
+static volatile uint8_t i2s_dma_ready_buffer = 0;
+static volatile uint16_t i2s_dma_ready_size = 0;
+static volatile uint32_t i2s_dma_overrun = 0;
 static max78000_statistics_t max78000_statistics = {0};
 static version_t version = {S_VERSION_MAJOR, S_VERSION_MINOR, S_VERSION_BUILD};
 static char demo_name[] = CATSDOGS_DEMO_NAME;
@@ -168,19 +178,41 @@ static uint8_t AddTranspose(uint8_t* pIn, uint8_t* pOut, uint16_t inSize,
 static uint8_t check_inference(q15_t* ml_soft, int32_t* ml_data,
                         int16_t* out_class, double* out_prob);
 static void I2SInit();
-static void HPF_init(void);
-static int16_t HPF(int16_t input);
 static int max9867_init(void);
 
 
 //-----------------------------------------------------------------------------
 // Function definitions
 //-----------------------------------------------------------------------------
-void i2s_isr(void)
+void MAX78000_AUDIO_I2S_DMA_IRQ_HAND(void)
 {
-    i2s_flag = 1;
-    /* Clear I2S interrupt flag */
-    MXC_I2S_ClearFlags(MXC_F_I2S_INTFL_RX_THD_CH0);
+    uint8_t completed_buffer;
+
+    if (MXC_DMA->intfl & (0x1 << i2s_ch)) {
+        if (MXC_DMA->ch[i2s_ch].status & (MXC_F_DMA_STATUS_TO_IF | MXC_F_DMA_STATUS_BUS_ERR)) {
+            PR_ERROR("dma error %d", MXC_DMA->ch[i2s_ch].status);
+        }
+
+        /* DMA already moved to the other buffer, reload the completed one after it */
+        completed_buffer = i2s_dma_active_buffer;
+        i2s_dma_active_buffer ^= 1;
+        MXC_DMA->ch[i2s_ch].dstrld = (unsigned int) i2s_dma_buffer[completed_buffer];
+        MXC_DMA->ch[i2s_ch].cntrld = CHUNK * sizeof(int32_t);
+        MXC_DMA->ch[i2s_ch].ctrl |= MXC_F_DMA_CTRL_RLDEN;
+
+        /* previous block is not processed yet */
+        if (i2s_dma_ready) {
+            i2s_dma_overrun++;
+        }
+
+        i2s_dma_ready_buffer = completed_buffer;
+        i2s_dma_ready_size = i2s_dma_size[completed_buffer];
+        i2s_dma_size[completed_buffer] = CHUNK;
+        i2s_dma_ready = 1;
+
+        // Clear DMA int flags
+        MXC_DMA->ch[i2s_ch].status = MXC_DMA->ch[i2s_ch].status;
+    }
 }
 
 void button_int(void *cbdata)
@@ -283,6 +315,11 @@ int main(void)
         fail();
     }
 
+    if (cnn_loader_init() != E_NO_ERROR) {
+        PR_ERROR("cnn_loader_init fail");
+        fail();
+    }
+
     /* Bring state machine into consistent state */
     cnn_init();
     /* Load kernels */
@@ -665,9 +702,9 @@ static void I2SInit()
 
     PR_INFO("*** I2S & Mic Init ***");
     /* Initialize High Pass Filter */
-    HPF_init();
-    /* Initialize I2S RX buffer */
-    memset(i2s_rx_buffer, 0, sizeof(i2s_rx_buffer));
+    mic_hpf_init(&hpf);
+    /* Initialize I2S RX buffers */
+    memset(i2s_dma_buffer, 0, sizeof(i2s_dma_buffer));
     /* Configure I2S interface parameters */
     req.wordSize    = MXC_I2S_DATASIZE_WORD;
     req.sampleSize  = MXC_I2S_SAMPLESIZE_THIRTYTWO;
@@ -682,8 +719,8 @@ static void I2SInit()
     req.clkdiv      = 5;
     req.rawData     = NULL;
     req.txData      = NULL;
-    req.rxData      = i2s_rx_buffer;
-    req.length      = I2S_RX_BUFFER_SIZE;
+    req.rxData      = i2s_dma_buffer[0];
+    req.length      = CHUNK;
 
 
     if((err = MXC_I2S_Init(&req)) != E_NO_ERROR) {
@@ -691,12 +728,41 @@ static void I2SInit()
         fail();
     }
 
-    /* Set I2S RX FIFO threshold to generate interrupt */
+    /* DMA fills one buffer while the other one is processed. First block covers
+     * the remainder of the discarded samples, then each block is one CHUNK */
+    i2s_dma_size[0] = MIC_DISCARD_FIRST_BLOCK;
+    i2s_dma_size[1] = CHUNK;
+    i2s_dma_active_buffer = 0;
+    i2s_dma_ready = 0;
+
+    // Clear DMA int flags
+    MXC_DMA->ch[i2s_ch].status = MXC_DMA->ch[i2s_ch].status;
+
+    // Enable DST increment, set request, set source and destination width, Count-To-Zero int enable
+    MXC_DMA->ch[i2s_ch].ctrl = (MXC_F_DMA_CTRL_DSTINC |
+                                MXC_S_DMA_CTRL_REQUEST_I2SRX |
+                                MXC_S_DMA_CTRL_SRCWD_WORD |
+                                MXC_S_DMA_CTRL_DSTWD_WORD |
+                                MXC_F_DMA_CTRL_CTZ_IE);
+
+    // Set DMA source, destination, counter and reload registers for the second buffer
+    MXC_DMA->ch[i2s_ch].src = 0;
+    MXC_DMA->ch[i2s_ch].dst = (unsigned int) i2s_dma_buffer[0];
+    MXC_DMA->ch[i2s_ch].cnt = i2s_dma_size[0] * sizeof(int32_t);
+    MXC_DMA->ch[i2s_ch].srcrld = 0;
+    MXC_DMA->ch[i2s_ch].dstrld = (unsigned int) i2s_dma_buffer[1];
+    MXC_DMA->ch[i2s_ch].cntrld = i2s_dma_size[1] * sizeof(int32_t);
+
+    // Enable DMA int
+    MXC_DMA->inten |= (1 << i2s_ch);
+    NVIC_EnableIRQ(MAX78000_AUDIO_I2S_DMA_IRQ);
+
+    // Enable DMA
+    MXC_DMA->ch[i2s_ch].ctrl |= (MXC_F_DMA_CTRL_EN | MXC_F_DMA_CTRL_RLDEN);
+
+    /* Set I2S RX FIFO threshold to generate DMA request */
     MXC_I2S_SetRXThreshold(4);
-    MXC_NVIC_SetVector(I2S_IRQn, i2s_isr);
-    NVIC_EnableIRQ(I2S_IRQn);
-    /* Enable RX FIFO Threshold Interrupt */
-    MXC_I2S_EnableInt(MXC_F_I2S_INTEN_RX_THD_CH0);
+    MXC_I2S->dmach0 |= MXC_F_I2S_DMACH0_DMA_RX_EN;
     MXC_I2S_RXEnable();
     __enable_irq();
 }
@@ -744,224 +810,86 @@ static uint8_t check_inference(q15_t *ml_soft, int32_t *ml_data,
 
 static uint8_t cnn_load_data(uint8_t* pIn)
 {
-    uint32_t mem;
+    static cnn_loader_desc_t desc[SAMPLE_SIZE / 1024];
+    uint32_t quadrant, mem;
     uint16_t index = 0;
 
     /* data should already be formatted correctly */
-    /* pIn is 16KB, each 1KB belongs to a memory group */
-    for (mem = 0x50400000; mem <= 0x50418000; mem += 0x8000) {
-        memcpy((uint8_t*)mem, &pIn[index], 1024);
-        //printf("%.10X \n",(uint8_t *)mem);
-        index += 1024;
-    }
-
-    for (mem = 0x50800000; mem <= 0x50818000; mem += 0x8000) {
-        memcpy((uint8_t*)mem, &pIn[index], 1024);
-        index += 1024;
-    }
-
-    for (mem = 0x50C00000; mem <= 0x50C18000; mem += 0x8000) {
-        memcpy((uint8_t*)mem, &pIn[index], 1024);
-        index += 1024;
+    /* pIn is 16KB, each 1KB belongs to a memory group, 4 groups in each quadrant */
+    for (quadrant = 0x50400000; quadrant <= 0x51000000; quadrant += 0x400000) {
+        for (mem = quadrant; mem <= quadrant + 0x18000; mem += 0x8000) {
+            desc[index].dst = mem;
+            desc[index].src = &pIn[1024 * index];
+            desc[index].size = 1024;
+            index++;
+        }
     }
 
-    for (mem = 0x51000000; mem <= 0x51018000; mem += 0x8000) {
-        memcpy((uint8_t*)mem, &pIn[index], 1024);
-        index += 1024;
+    /* DMA copies all groups, sleep until it is done */
+    if (cnn_loader_start(desc, index) != E_NO_ERROR) {
+        return CNN_FAIL;
     }
+    cnn_loader_wait();
 
     return CNN_OK;
 }
 
 static uint8_t AddTranspose(uint8_t *pIn, uint8_t *pOut, uint16_t inSize,
         uint16_t outSize, uint16_t width) {
-    /* Data order in Ai85 memory (transpose is included):
-	input(series of 8 bit samples): (0,0) ...  (0,127)  (1,0) ... (1,127) ...... (127,0)...(127,127)    16384 samples
-	output (32bit word): 16K samples in a buffer. Later, each 1K goes to a separate CNN memory group
-	0x0000:
-		(0,3)(0,2)(0,1)(0,0)
-		(0,67)(0,66)(0,65)(0,64)
-		(1,3)(1,2)(1,1)(1,0)
-		(1,67)(1,66)(1,65)(1,64)
-		....
-		(127,67)(127,66)(127,65)(127,64)
-	0x0400:
-		(0,7)(0,6)(0,5)(0,4)
-		(0,71)(0,70)(0,69)(0,68)
-		....
-		(127,71)(127,70)(127,69)(127,68)
-	...
-	0x3C00:
-		(0,63)(0,62)(0,61)(0,60)
-		(0,127)(0,126)(0,125)(0,124)
-		....
-		(127,127)(127,126)(127,125)(127,124)
-     */
-
-    static uint16_t row = 0, col = 0, total = 0;
-    uint16_t  secondHalf = 0, wordRow = 0, byteInWord = 0, group = 0, index = 0;
-    for (int i = 0; i < inSize; i++) {
-        /* is it above 63? */
-        if (col >= (width >> 1)) {
-            secondHalf = 1; // odd word rows
-        } else {
-            secondHalf = 0; // even word rows
-        }
-
-        /* which group (0-15) it should be */
-        group = (col % (width >> 1)) / 4;
-
-        /* which word row (0-255) within the group */
-        wordRow = secondHalf + (row << 1);
-
-        /* which byte (0-3) in the word */
-        byteInWord = col % 4;
-
-        /* find output index */
-        index = 1024 * group + 4 * wordRow + byteInWord;
-
-        /* place sample in correct output location */
-        pOut[index] = pIn[i];
+    static uint16_t row = 0;
+    int ret;
 
-        total++;
-
-        /* increment row and col index */
-        col++;
-        if (col >= width) {
-            col = 0;
-            row++;
-        }
-    }
-
-    if (total >= outSize) {
-        /* sanity check */
-        if (row != width) {
-            PR_ERROR("ERROR: Rearranging!");
-        }
-
-        total = 0;
-        row = 0;
-        col = 0;
-        return 1;
-    } else {
+    ret = mic_transpose(&row, pIn, pOut, inSize, outSize, width);
+    if (ret == MIC_TRANSPOSE_ERROR) {
+        PR_ERROR("ERROR: Rearranging!");
         return 0;
     }
+
+    return ret;
 }
 
 static uint8_t MicReadChunk(uint8_t *pBuff, uint16_t * avg)
 {
-    static uint16_t chunkCount = 0;
-    static uint16_t sum = 0;
-
     static uint32_t index = 0;
+    static uint32_t overrun = 0;
 
-    int32_t sample = 0;
-    int16_t temp = 0;
-    uint32_t rx_size = 0;
+    int16_t hpf_block[CHUNK];
+    uint8_t buffer;
+    uint16_t size;
 
-    /* sample not ready */
-    if (!i2s_flag) {
+    /* block not ready */
+    if (!i2s_dma_ready) {
         *avg = 0;
         return 0;
     }
 
-    /* Clear flag */
-    i2s_flag = 0;
-    /* Read number of samples in I2S RX FIFO */
-    rx_size = MXC_I2S->dmach0 >> MXC_F_I2S_DMACH0_RX_LVL_POS;
-    //	printf("%d ", rx_size);
-
-    /* read until fifo is empty or enough samples are collected */
-    while ((rx_size--) && (chunkCount < CHUNK)) {
-        /* Read microphone sample from I2S FIFO */
-        sample = (int32_t)MXC_I2S->fifoch0;
-        /* The actual value is 18 MSB of 32-bit word */
-        temp = sample >> 14;
-
-        /* Remove DC from microphone signal */
-        sample = HPF((int16_t)temp); // filter needs about 1K sample to converge
-
-        /* Discard first 10k samples due to microphone charging cap effect */
-        if (index++ < 10000)
-            continue;
-
-        /* absolute for averaging */
-        if (sample >= 0)
-            sum += sample;
-        else
-            sum -= sample;
-
-        /* Convert to 8 bit unsigned */
-        pBuff[chunkCount] = (uint8_t)((sample)*SAMPLE_SCALE_FACTOR/256);
-
-        temp=(int8_t)pBuff[chunkCount];
-
-        chunkCount++;
-
-        /* record max and min */
-        if (temp > Max) {
-            Max = temp;
-        }
-
-        if (temp < Min) {
-            Min = temp;
-        }
+    __disable_irq();
+    buffer = i2s_dma_ready_buffer;
+    size = i2s_dma_ready_size;
+    i2s_dma_ready = 0;
+    __enable_irq();
 
+    if (overrun != i2s_dma_overrun) {
+        overrun = i2s_dma_overrun;
+        PR_DEBUG("i2s dma overrun %d", overrun);
     }
 
-    /* if not enough samples, return 0 */
-    if (chunkCount < CHUNK) {
+    /* Remove DC from microphone signal */
+    mic_hpf(&hpf, i2s_dma_buffer[buffer], hpf_block, size); // filter needs about 1K sample to converge
+
+    /* Discard first samples due to microphone charging cap effect */
+    if (index < MIC_DISCARD_SAMPLES) {
+        index += size;
         *avg = 0;
         return 0;
     }
 
-    /* enough samples are collected, calculate average and return 1 */
-    *avg = ((uint16_t)(sum / CHUNK));
+    /* Convert to 8 bit unsigned, record max and min, calculate average and return 1 */
+    *avg = mic_chunk(hpf_block, pBuff, CHUNK, SAMPLE_SCALE_FACTOR, &Max, &Min);
 
-    chunkCount = 0;
-    sum = 0;
     return 1;
 }
 
-static void HPF_init(void) {
-    Coeff = 32604; //0.995
-    x0 = 0;
-    y0 = 0;
-    y1 = y0;
-    x1 = x0;
-}
-
-static int16_t HPF(int16_t input) {
-    int16_t Acc, output;
-    int32_t tmp;
-
-    /* a 1st order IIR high pass filter (100 Hz cutoff frequency)  */
-    /* y(n)=x(n)-x(n-1)+A*y(n-1) and A =.995*2^15 */
-
-    x0 = input;
-
-    tmp = (Coeff * y1);
-    Acc = (int16_t)((tmp + (1 << 14)) >> 15);
-    y0 = x0 - x1 + Acc;
-
-    /* Clipping */
-    if (y0 > 32767) {
-        y0 = 32767;
-    }
-
-    if (y0 < -32768) {
-        y0 = -32768;
-    }
-
-    /* Update filter state */
-    y1 = y0;
-    x1 = x0;
-
-    output = (int16_t)y0;
-
-    return (output);
-}
-
 static void fail(void)
 {
     PR_ERROR("fail");
@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2023 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+#ifndef _MAX78000_CAMERA_STREAM_H_
+#define _MAX78000_CAMERA_STREAM_H_
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+// Called with the first cropped pixel of a camera row, decimation in x is up to the handler
+typedef void (*camera_stream_row_handler_t)(const uint8_t *row);
+
+typedef struct {
+    uint8_t *frame;                     // Full frame copy for QSPI, NULL to skip
+    uint32_t row_size;                  // Camera row size in bytes
+    uint32_t row_count;                 // Camera rows per frame
+    uint32_t cnn_x;                     // CNN window first column in pixels
+    uint32_t cnn_y;                     // CNN window first row
+    uint32_t cnn_height;                // CNN window height in camera rows
+    uint32_t cnn_step;                  // Take one of every cnn_step rows
+    camera_stream_row_handler_t cnn_row; // NULL to skip CNN
+} camera_stream_config_t;
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+// Start a capture, unless camera_stream_start() already did, and process it row by row as rows arrive
+// from the camera DMA. E_TIME_OUT if the frame ended with missing rows or no row came for
+// MAX78000_VIDEO_CAMERA_FRAME_TIMEOUT after the capture started
+int camera_stream_frame(const camera_stream_config_t *config);
+// Start the next capture early, e.g. while the previous frame is post-processed. The camera stream
+// buffer holds only a couple of rows, rows that arrive before camera_stream_frame() are lost as overflow
+void camera_stream_start(void);
+// Stop a capture in progress
+void camera_stream_stop(void);
+// Rows lost to streaming buffer overflow since last call
+uint32_t camera_stream_get_overflow_count(void);
+
+
+#endif /* _MAX78000_CAMERA_STREAM_H_ */
@@ -0,0 +1,212 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2023 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <mxc.h>
+#include <stdint.h>
+
+#include "max78000_cnn_loader.h"
+#include "max78000_debug.h"
+#include "maxrefdes178_definitions.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define S_MODULE_NAME   "cnn_loader"
+
+#define CNN_LOADER_DMA_COUNTER_MAX  0xffffff
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static const cnn_loader_desc_t *g_desc = NULL;
+static volatile uint32_t g_desc_count = 0;
+static volatile uint32_t g_desc_next = 0;       // next descriptor to put into reload registers
+static volatile uint32_t g_desc_completed = 0;
+static volatile int g_busy = 0;
+
+#if defined(MAXREFDES178_MAX78000_AUDIO)
+static const uint8_t cnn_ch = MAX78000_AUDIO_CNN_DMA_CHANNEL;
+#elif defined(MAXREFDES178_MAX78000_VIDEO)
+static const uint8_t cnn_ch = MAX78000_VIDEO_CNN_DMA_CHANNEL;
+#else
+#error MAX78000 AUDIO or MAX78000 VIDEO flag should be set
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+#if defined(MAXREFDES178_MAX78000_AUDIO)
+void MAX78000_AUDIO_CNN_DMA_IRQ_HAND(void)
+#else
+void MAX78000_VIDEO_CNN_DMA_IRQ_HAND(void)
+#endif
+{
+    if (MXC_DMA->intfl & (0x1 << cnn_ch)) {
+        if (MXC_DMA->ch[cnn_ch].status & (MXC_F_DMA_STATUS_TO_IF | MXC_F_DMA_STATUS_BUS_ERR)) {
+            PR_ERROR("dma error %d", MXC_DMA->ch[cnn_ch].status);
+        }
+
+        g_desc_completed++;
+
+        // DMA already moved to the reload descriptor, chain the next one after it
+        if (g_desc_next < g_desc_count) {
+            MXC_DMA->ch[cnn_ch].srcrld = (unsigned int) g_desc[g_desc_next].src;
+            MXC_DMA->ch[cnn_ch].dstrld = g_desc[g_desc_next].dst;
+            MXC_DMA->ch[cnn_ch].cntrld = g_desc[g_desc_next].size;
+            MXC_DMA->ch[cnn_ch].ctrl |= MXC_F_DMA_CTRL_RLDEN;
+            g_desc_next++;
+        } else {
+            MXC_DMA->ch[cnn_ch].ctrl &= ~MXC_F_DMA_CTRL_RLDEN;
+        }
+
+        if (g_desc_completed >= g_desc_count) {
+            MXC_DMA->ch[cnn_ch].ctrl &= ~MXC_F_DMA_CTRL_EN;
+            g_busy = 0;
+        }
+
+        // Clear DMA int flags
+        MXC_DMA->ch[cnn_ch].status = MXC_DMA->ch[cnn_ch].status;
+    }
+}
+
+int cnn_loader_start(const cnn_loader_desc_t *desc, uint32_t desc_count)
+{
+    if (g_busy) {
+        return E_BUSY;
+    }
+
+    if (!desc || !desc_count) {
+        return E_NULL_PTR;
+    }
+
+    for (uint32_t i = 0; i < desc_count; i++) {
+        if (!desc[i].size || (desc[i].size > CNN_LOADER_DMA_COUNTER_MAX) || (desc[i].size & 0x3)) {
+            PR_ERROR("invalid descriptor %d size %d", i, desc[i].size);
+            return E_BAD_PARAM;
+        }
+    }
+
+    g_desc = desc;
+    g_desc_count = desc_count;
+    g_desc_completed = 0;
+    g_busy = 1;
+
+    // Clear DMA int flags
+    MXC_DMA->ch[cnn_ch].status = MXC_DMA->ch[cnn_ch].status;
+
+    // Enable SRC and DST increment, memory to memory request, word width, Count-To-Zero int enable
+    MXC_DMA->ch[cnn_ch].ctrl = (MXC_F_DMA_CTRL_SRCINC |
+                                MXC_F_DMA_CTRL_DSTINC |
+                                MXC_S_DMA_CTRL_REQUEST_MEMTOMEM |
+                                MXC_S_DMA_CTRL_SRCWD_WORD |
+                                MXC_S_DMA_CTRL_DSTWD_WORD |
+                                MXC_F_DMA_CTRL_CTZ_IE);
+
+    // Set first descriptor, and the second one as reload
+    MXC_DMA->ch[cnn_ch].src = (unsigned int) desc[0].src;
+    MXC_DMA->ch[cnn_ch].dst = desc[0].dst;
+    MXC_DMA->ch[cnn_ch].cnt = desc[0].size;
+    g_desc_next = 1;
+
+    if (desc_count > 1) {
+        MXC_DMA->ch[cnn_ch].srcrld = (unsigned int) desc[1].src;
+        MXC_DMA->ch[cnn_ch].dstrld = desc[1].dst;
+        MXC_DMA->ch[cnn_ch].cntrld = desc[1].size;
+        g_desc_next = 2;
+    }
+
+    // Enable DMA int
+    MXC_DMA->inten |= (1 << cnn_ch);
+
+    // Enable DMA
+    if (desc_count > 1) {
+        MXC_DMA->ch[cnn_ch].ctrl |= (MXC_F_DMA_CTRL_EN | MXC_F_DMA_CTRL_RLDEN);
+    } else {
+        MXC_DMA->ch[cnn_ch].ctrl |= MXC_F_DMA_CTRL_EN;
+    }
+
+    return E_NO_ERROR;
+}
+
+int cnn_loader_busy(void)
+{
+    return g_busy;
+}
+
+int cnn_loader_wait(void)
+{
+    // DMA interrupt wakes up the core. Interrupts are masked between the check and WFI, otherwise
+    // the final DMA interrupt could fire in between and leave the core asleep. A pending interrupt still
+    // ends WFI with PRIMASK set, and its handler runs once they are enabled again
+    while (g_busy) {
+        __disable_irq();
+        if (g_busy) {
+            __WFI();
+        }
+        __enable_irq();
+    }
+
+    return E_NO_ERROR;
+}
+
+int cnn_loader_init(void)
+{
+    MXC_DMA->ch[cnn_ch].ctrl &= ~MXC_F_DMA_CTRL_EN;
+    g_busy = 0;
+
+#if defined(MAXREFDES178_MAX78000_AUDIO)
+    NVIC_EnableIRQ(MAX78000_AUDIO_CNN_DMA_IRQ);
+#else
+    NVIC_EnableIRQ(MAX78000_VIDEO_CNN_DMA_IRQ);
+#endif
+
+    return E_NO_ERROR;
+}
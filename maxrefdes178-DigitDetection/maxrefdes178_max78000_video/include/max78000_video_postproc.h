@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2022 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+#ifndef _MAX78000_VIDEO_POSTPROC_H_
+#define _MAX78000_VIDEO_POSTPROC_H_
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define X_SIZE       74
+#define Y_SIZE       74
+#define IMG_SCALE   3
+#define NUM_ARS     4
+#define NUM_SCALES  4
+#define NUM_CLASSES 12
+#define LOC_DIM     4 //(x, y, w, h) or (x1, y1, x2, y2)
+#define NUM_PRIORS_PER_AR   425
+#define NUM_PRIORS          NUM_PRIORS_PER_AR*NUM_ARS
+#define MAX_PRIORS          100
+#define MIN_CLASS_SCORE     16384 // ~0.25*65536
+#define MAX_ALLOWED_OVERLAP 0.3   //170
+#define ML_DATA_SIZE 5
+
+// Scratch memory postproc_init() carves the post-processing arrays from
+#define POSTPROC_SCRATCH_SIZE ((2 * NUM_CLASSES * NUM_PRIORS) + \
+                               (4 * (NUM_CLASSES - 2) * MAX_PRIORS * LOC_DIM) + \
+                               (4 * (NUM_CLASSES - 2) * MAX_PRIORS) + \
+                               ((NUM_CLASSES - 2) * MAX_PRIORS) + \
+                               (NUM_CLASSES * NUM_PRIORS) + \
+                               (LOC_DIM * NUM_PRIORS) + \
+                               1 + (ML_DATA_SIZE * (NUM_CLASSES - 2) * MAX_PRIORS))
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+void postproc_init(uint8_t *scratch);
+// CNN outputs in prior order, int8_t prior_locs[NUM_PRIORS][LOC_DIM] and int8_t prior_cls[NUM_PRIORS][NUM_CLASSES]
+int8_t *postproc_get_prior_locs(void);
+int8_t *postproc_get_prior_cls(void);
+// Softmax, NMS and box decoding. Returns objects[0] = count, then class, x1, y1, x2, y2 per object
+uint8_t *postproc_localize_objects(void);
+
+
+#endif /* _MAX78000_VIDEO_POSTPROC_H_ */
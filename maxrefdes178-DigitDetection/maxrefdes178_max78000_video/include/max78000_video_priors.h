@@ -0,0 +1,1822 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2022 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+#ifndef _MAX78000_VIDEO_PRIORS_H_
+#define _MAX78000_VIDEO_PRIORS_H_
+
+// Generated from the SSD prior configuration in max78000_video_main.c:
+// dims {18, 9, 4, 2}, scales {0.15, 0.35, 0.55, 0.725}, ars {0.85, 0.60, 0.40, 0.25}
+// All values are unsigned Q15 (32768 = 1.0)
+
+// Prior boxes (cx, cy, w, h) clamped to [0, 1], in CNN output prior order
+#define PRIORS_CXCY_Q15 \
+    { \
+        {  910,   910,  4532,  5331}, \
+        {  910,   910,  3807,  6345}, \
+        {  910,   910,  3109,  7772}, \
+        {  910,   910,  2458,  9830}, \
+        { 2731,   910,  4532,  5331}, \
+        { 2731,   910,  3807,  6345}, \
+        { 2731,   910,  3109,  7772}, \
+        { 2731,   910,  2458,  9830}, \
+        { 4551,   910,  4532,  5331}, \
+        { 4551,   910,  3807,  6345}, \
+        { 4551,   910,  3109,  7772}, \
+        { 4551,   910,  2458,  9830}, \
+        { 6372,   910,  4532,  5331}, \
+        { 6372,   910,  3807,  6345}, \
+        { 6372,   910,  3109,  7772}, \
+        { 6372,   910,  2458,  9830}, \
+        { 8192,   910,  4532,  5331}, \
+        { 8192,   910,  3807,  6345}, \
+        { 8192,   910,  3109,  7772}, \
+        { 8192,   910,  2458,  9830}, \
+        {10012,   910,  4532,  5331}, \
+        {10012,   910,  3807,  6345}, \
+        {10012,   910,  3109,  7772}, \
+        {10012,   910,  2458,  9830}, \
+        {11833,   910,  4532,  5331}, \
+        {11833,   910,  3807,  6345}, \
+        {11833,   910,  3109,  7772}, \
+        {11833,   910,  2458,  9830}, \
+        {13653,   910,  4532,  5331}, \
+        {13653,   910,  3807,  6345}, \
+        {13653,   910,  3109,  7772}, \
+        {13653,   910,  2458,  9830}, \
+        {15474,   910,  4532,  5331}, \
+        {15474,   910,  3807,  6345}, \
+        {15474,   910,  3109,  7772}, \
+        {15474,   910,  2458,  9830}, \
+        {17294,   910,  4532,  5331}, \
+        {17294,   910,  3807,  6345}, \
+        {17294,   910,  3109,  7772}, \
+        {17294,   910,  2458,  9830}, \
+        {19115,   910,  4532,  5331}, \
+        {19115,   910,  3807,  6345}, \
+        {19115,   910,  3109,  7772}, \
+        {19115,   910,  2458,  9830}, \
+        {20935,   910,  4532,  5331}, \
+        {20935,   910,  3807,  6345}, \
+        {20935,   910,  3109,  7772}, \
+        {20935,   910,  2458,  9830}, \
+        {22756,   910,  4532,  5331}, \
+        {22756,   910,  3807,  6345}, \
+        {22756,   910,  3109,  7772}, \
+        {22756,   910,  2458,  9830}, \
+        {24576,   910,  4532,  5331}, \
+        {24576,   910,  3807,  6345}, \
+        {24576,   910,  3109,  7772}, \
+        {24576,   910,  2458,  9830}, \
+        {26396,   910,  4532,  5331}, \
+        {26396,   910,  3807,  6345}, \
+        {26396,   910,  3109,  7772}, \
+        {26396,   910,  2458,  9830}, \
+        {28217,   910,  4532,  5331}, \
+        {28217,   910,  3807,  6345}, \
+        {28217,   910,  3109,  7772}, \
+        {28217,   910,  2458,  9830}, \
+        {30037,   910,  4532,  5331}, \
+        {30037,   910,  3807,  6345}, \
+        {30037,   910,  3109,  7772}, \
+        {30037,   910,  2458,  9830}, \
+        {31858,   910,  4532,  5331}, \
+        {31858,   910,  3807,  6345}, \
+        {31858,   910,  3109,  7772}, \
+        {31858,   910,  2458,  9830}, \
+        {  910,  2731,  4532,  5331}, \
+        {  910,  2731,  3807,  6345}, \
+        {  910,  2731,  3109,  7772}, \
+        {  910,  2731,  2458,  9830}, \
+        { 2731,  2731,  4532,  5331}, \
+        { 2731,  2731,  3807,  6345}, \
+        { 2731,  2731,  3109,  7772}, \
+        { 2731,  2731,  2458,  9830}, \
+        { 4551,  2731,  4532,  5331}, \
+        { 4551,  2731,  3807,  6345}, \
+        { 4551,  2731,  3109,  7772}, \
+        { 4551,  2731,  2458,  9830}, \
+        { 6372,  2731,  4532,  5331}, \
+        { 6372,  2731,  3807,  6345}, \
+        { 6372,  2731,  3109,  7772}, \
+        { 6372,  2731,  2458,  9830}, \
+        { 8192,  2731,  4532,  5331}, \
+        { 8192,  2731,  3807,  6345}, \
+        { 8192,  2731,  3109,  7772}, \
+        { 8192,  2731,  2458,  9830}, \
+        {10012,  2731,  4532,  5331}, \
+        {10012,  2731,  3807,  6345}, \
+        {10012,  2731,  3109,  7772}, \
+        {10012,  2731,  2458,  9830}, \
+        {11833,  2731,  4532,  5331}, \
+        {11833,  2731,  3807,  6345}, \
+        {11833,  2731,  3109,  7772}, \
+        {11833,  2731,  2458,  9830}, \
+        {13653,  2731,  4532,  5331}, \
+        {13653,  2731,  3807,  6345}, \
+        {13653,  2731,  3109,  7772}, \
+        {13653,  2731,  2458,  9830}, \
+        {15474,  2731,  4532,  5331}, \
+        {15474,  2731,  3807,  6345}, \
+        {15474,  2731,  3109,  7772}, \
+        {15474,  2731,  2458,  9830}, \
+        {17294,  2731,  4532,  5331}, \
+        {17294,  2731,  3807,  6345}, \
+        {17294,  2731,  3109,  7772}, \
+        {17294,  2731,  2458,  9830}, \
+        {19115,  2731,  4532,  5331}, \
+        {19115,  2731,  3807,  6345}, \
+        {19115,  2731,  3109,  7772}, \
+        {19115,  2731,  2458,  9830}, \
+        {20935,  2731,  4532,  5331}, \
+        {20935,  2731,  3807,  6345}, \
+        {20935,  2731,  3109,  7772}, \
+        {20935,  2731,  2458,  9830}, \
+        {22756,  2731,  4532,  5331}, \
+        {22756,  2731,  3807,  6345}, \
+        {22756,  2731,  3109,  7772}, \
+        {22756,  2731,  2458,  9830}, \
+        {24576,  2731,  4532,  5331}, \
+        {24576,  2731,  3807,  6345}, \
+        {24576,  2731,  3109,  7772}, \
+        {24576,  2731,  2458,  9830}, \
+        {26396,  2731,  4532,  5331}, \
+        {26396,  2731,  3807,  6345}, \
+        {26396,  2731,  3109,  7772}, \
+        {26396,  2731,  2458,  9830}, \
+        {28217,  2731,  4532,  5331}, \
+        {28217,  2731,  3807,  6345}, \
+        {28217,  2731,  3109,  7772}, \
+        {28217,  2731,  2458,  9830}, \
+        {30037,  2731,  4532,  5331}, \
+        {30037,  2731,  3807,  6345}, \
+        {30037,  2731,  3109,  7772}, \
+        {30037,  2731,  2458,  9830}, \
+        {31858,  2731,  4532,  5331}, \
+        {31858,  2731,  3807,  6345}, \
+        {31858,  2731,  3109,  7772}, \
+        {31858,  2731,  2458,  9830}, \
+        {  910,  4551,  4532,  5331}, \
+        {  910,  4551,  3807,  6345}, \
+        {  910,  4551,  3109,  7772}, \
+        {  910,  4551,  2458,  9830}, \
+        { 2731,  4551,  4532,  5331}, \
+        { 2731,  4551,  3807,  6345}, \
+        { 2731,  4551,  3109,  7772}, \
+        { 2731,  4551,  2458,  9830}, \
+        { 4551,  4551,  4532,  5331}, \
+        { 4551,  4551,  3807,  6345}, \
+        { 4551,  4551,  3109,  7772}, \
+        { 4551,  4551,  2458,  9830}, \
+        { 6372,  4551,  4532,  5331}, \
+        { 6372,  4551,  3807,  6345}, \
+        { 6372,  4551,  3109,  7772}, \
+        { 6372,  4551,  2458,  9830}, \
+        { 8192,  4551,  4532,  5331}, \
+        { 8192,  4551,  3807,  6345}, \
+        { 8192,  4551,  3109,  7772}, \
+        { 8192,  4551,  2458,  9830}, \
+        {10012,  4551,  4532,  5331}, \
+        {10012,  4551,  3807,  6345}, \
+        {10012,  4551,  3109,  7772}, \
+        {10012,  4551,  2458,  9830}, \
+        {11833,  4551,  4532,  5331}, \
+        {11833,  4551,  3807,  6345}, \
+        {11833,  4551,  3109,  7772}, \
+        {11833,  4551,  2458,  9830}, \
+        {13653,  4551,  4532,  5331}, \
+        {13653,  4551,  3807,  6345}, \
+        {13653,  4551,  3109,  7772}, \
+        {13653,  4551,  2458,  9830}, \
+        {15474,  4551,  4532,  5331}, \
+        {15474,  4551,  3807,  6345}, \
+        {15474,  4551,  3109,  7772}, \
+        {15474,  4551,  2458,  9830}, \
+        {17294,  4551,  4532,  5331}, \
+        {17294,  4551,  3807,  6345}, \
+        {17294,  4551,  3109,  7772}, \
+        {17294,  4551,  2458,  9830}, \
+        {19115,  4551,  4532,  5331}, \
+        {19115,  4551,  3807,  6345}, \
+        {19115,  4551,  3109,  7772}, \
+        {19115,  4551,  2458,  9830}, \
+        {20935,  4551,  4532,  5331}, \
+        {20935,  4551,  3807,  6345}, \
+        {20935,  4551,  3109,  7772}, \
+        {20935,  4551,  2458,  9830}, \
+        {22756,  4551,  4532,  5331}, \
+        {22756,  4551,  3807,  6345}, \
+        {22756,  4551,  3109,  7772}, \
+        {22756,  4551,  2458,  9830}, \
+        {24576,  4551,  4532,  5331}, \
+        {24576,  4551,  3807,  6345}, \
+        {24576,  4551,  3109,  7772}, \
+        {24576,  4551,  2458,  9830}, \
+        {26396,  4551,  4532,  5331}, \
+        {26396,  4551,  3807,  6345}, \
+        {26396,  4551,  3109,  7772}, \
+        {26396,  4551,  2458,  9830}, \
+        {28217,  4551,  4532,  5331}, \
+        {28217,  4551,  3807,  6345}, \
+        {28217,  4551,  3109,  7772}, \
+        {28217,  4551,  2458,  9830}, \
+        {30037,  4551,  4532,  5331}, \
+        {30037,  4551,  3807,  6345}, \
+        {30037,  4551,  3109,  7772}, \
+        {30037,  4551,  2458,  9830}, \
+        {31858,  4551,  4532,  5331}, \
+        {31858,  4551,  3807,  6345}, \
+        {31858,  4551,  3109,  7772}, \
+        {31858,  4551,  2458,  9830}, \
+        {  910,  6372,  4532,  5331}, \
+        {  910,  6372,  3807,  6345}, \
+        {  910,  6372,  3109,  7772}, \
+        {  910,  6372,  2458,  9830}, \
+        { 2731,  6372,  4532,  5331}, \
+        { 2731,  6372,  3807,  6345}, \
+        { 2731,  6372,  3109,  7772}, \
+        { 2731,  6372,  2458,  9830}, \
+        { 4551,  6372,  4532,  5331}, \
+        { 4551,  6372,  3807,  6345}, \
+        { 4551,  6372,  3109,  7772}, \
+        { 4551,  6372,  2458,  9830}, \
+        { 6372,  6372,  4532,  5331}, \
+        { 6372,  6372,  3807,  6345}, \
+        { 6372,  6372,  3109,  7772}, \
+        { 6372,  6372,  2458,  9830}, \
+        { 8192,  6372,  4532,  5331}, \
+        { 8192,  6372,  3807,  6345}, \
+        { 8192,  6372,  3109,  7772}, \
+        { 8192,  6372,  2458,  9830}, \
+        {10012,  6372,  4532,  5331}, \
+        {10012,  6372,  3807,  6345}, \
+        {10012,  6372,  3109,  7772}, \
+        {10012,  6372,  2458,  9830}, \
+        {11833,  6372,  4532,  5331}, \
+        {11833,  6372,  3807,  6345}, \
+        {11833,  6372,  3109,  7772}, \
+        {11833,  6372,  2458,  9830}, \
+        {13653,  6372,  4532,  5331}, \
+        {13653,  6372,  3807,  6345}, \
+        {13653,  6372,  3109,  7772}, \
+        {13653,  6372,  2458,  9830}, \
+        {15474,  6372,  4532,  5331}, \
+        {15474,  6372,  3807,  6345}, \
+        {15474,  6372,  3109,  7772}, \
+        {15474,  6372,  2458,  9830}, \
+        {17294,  6372,  4532,  5331}, \
+        {17294,  6372,  3807,  6345}, \
+        {17294,  6372,  3109,  7772}, \
+        {17294,  6372,  2458,  9830}, \
+        {19115,  6372,  4532,  5331}, \
+        {19115,  6372,  3807,  6345}, \
+        {19115,  6372,  3109,  7772}, \
+        {19115,  6372,  2458,  9830}, \
+        {20935,  6372,  4532,  5331}, \
+        {20935,  6372,  3807,  6345}, \
+        {20935,  6372,  3109,  7772}, \
+        {20935,  6372,  2458,  9830}, \
+        {22756,  6372,  4532,  5331}, \
+        {22756,  6372,  3807,  6345}, \
+        {22756,  6372,  3109,  7772}, \
+        {22756,  6372,  2458,  9830}, \
+        {24576,  6372,  4532,  5331}, \
+        {24576,  6372,  3807,  6345}, \
+        {24576,  6372,  3109,  7772}, \
+        {24576,  6372,  2458,  9830}, \
+        {26396,  6372,  4532,  5331}, \
+        {26396,  6372,  3807,  6345}, \
+        {26396,  6372,  3109,  7772}, \
+        {26396,  6372,  2458,  9830}, \
+        {28217,  6372,  4532,  5331}, \
+        {28217,  6372,  3807,  6345}, \
+        {28217,  6372,  3109,  7772}, \
+        {28217,  6372,  2458,  9830}, \
+        {30037,  6372,  4532,  5331}, \
+        {30037,  6372,  3807,  6345}, \
+        {30037,  6372,  3109,  7772}, \
+        {30037,  6372,  2458,  9830}, \
+        {31858,  6372,  4532,  5331}, \
+        {31858,  6372,  3807,  6345}, \
+        {31858,  6372,  3109,  7772}, \
+        {31858,  6372,  2458,  9830}, \
+        {  910,  8192,  4532,  5331}, \
+        {  910,  8192,  3807,  6345}, \
+        {  910,  8192,  3109,  7772}, \
+        {  910,  8192,  2458,  9830}, \
+        { 2731,  8192,  4532,  5331}, \
+        { 2731,  8192,  3807,  6345}, \
+        { 2731,  8192,  3109,  7772}, \
+        { 2731,  8192,  2458,  9830}, \
+        { 4551,  8192,  4532,  5331}, \
+        { 4551,  8192,  3807,  6345}, \
+        { 4551,  8192,  3109,  7772}, \
+        { 4551,  8192,  2458,  9830}, \
+        { 6372,  8192,  4532,  5331}, \
+        { 6372,  8192,  3807,  6345}, \
+        { 6372,  8192,  3109,  7772}, \
+        { 6372,  8192,  2458,  9830}, \
+        { 8192,  8192,  4532,  5331}, \
+        { 8192,  8192,  3807,  6345}, \
+        { 8192,  8192,  3109,  7772}, \
+        { 8192,  8192,  2458,  9830}, \
+        {10012,  8192,  4532,  5331}, \
+        {10012,  8192,  3807,  6345}, \
+        {10012,  8192,  3109,  7772}, \
+        {10012,  8192,  2458,  9830}, \
+        {11833,  8192,  4532,  5331}, \
+        {11833,  8192,  3807,  6345}, \
+        {11833,  8192,  3109,  7772}, \
+        {11833,  8192,  2458,  9830}, \
+        {13653,  8192,  4532,  5331}, \
+        {13653,  8192,  3807,  6345}, \
+        {13653,  8192,  3109,  7772}, \
+        {13653,  8192,  2458,  9830}, \
+        {15474,  8192,  4532,  5331}, \
+        {15474,  8192,  3807,  6345}, \
+        {15474,  8192,  3109,  7772}, \
+        {15474,  8192,  2458,  9830}, \
+        {17294,  8192,  4532,  5331}, \
+        {17294,  8192,  3807,  6345}, \
+        {17294,  8192,  3109,  7772}, \
+        {17294,  8192,  2458,  9830}, \
+        {19115,  8192,  4532,  5331}, \
+        {19115,  8192,  3807,  6345}, \
+        {19115,  8192,  3109,  7772}, \
+        {19115,  8192,  2458,  9830}, \
+        {20935,  8192,  4532,  5331}, \
+        {20935,  8192,  3807,  6345}, \
+        {20935,  8192,  3109,  7772}, \
+        {20935,  8192,  2458,  9830}, \
+        {22756,  8192,  4532,  5331}, \
+        {22756,  8192,  3807,  6345}, \
+        {22756,  8192,  3109,  7772}, \
+        {22756,  8192,  2458,  9830}, \
+        {24576,  8192,  4532,  5331}, \
+        {24576,  8192,  3807,  6345}, \
+        {24576,  8192,  3109,  7772}, \
+        {24576,  8192,  2458,  9830}, \
+        {26396,  8192,  4532,  5331}, \
+        {26396,  8192,  3807,  6345}, \
+        {26396,  8192,  3109,  7772}, \
+        {26396,  8192,  2458,  9830}, \
+        {28217,  8192,  4532,  5331}, \
+        {28217,  8192,  3807,  6345}, \
+        {28217,  8192,  3109,  7772}, \
+        {28217,  8192,  2458,  9830}, \
+        {30037,  8192,  4532,  5331}, \
+        {30037,  8192,  3807,  6345}, \
+        {30037,  8192,  3109,  7772}, \
+        {30037,  8192,  2458,  9830}, \
+        {31858,  8192,  4532,  5331}, \
+        {31858,  8192,  3807,  6345}, \
+        {31858,  8192,  3109,  7772}, \
+        {31858,  8192,  2458,  9830}, \
+        {  910, 10012,  4532,  5331}, \
+        {  910, 10012,  3807,  6345}, \
+        {  910, 10012,  3109,  7772}, \
+        {  910, 10012,  2458,  9830}, \
+        { 2731, 10012,  4532,  5331}, \
+        { 2731, 10012,  3807,  6345}, \
+        { 2731, 10012,  3109,  7772}, \
+        { 2731, 10012,  2458,  9830}, \
+        { 4551, 10012,  4532,  5331}, \
+        { 4551, 10012,  3807,  6345}, \
+        { 4551, 10012,  3109,  7772}, \
+        { 4551, 10012,  2458,  9830}, \
+        { 6372, 10012,  4532,  5331}, \
+        { 6372, 10012,  3807,  6345}, \
+        { 6372, 10012,  3109,  7772}, \
+        { 6372, 10012,  2458,  9830}, \
+        { 8192, 10012,  4532,  5331}, \
+        { 8192, 10012,  3807,  6345}, \
+        { 8192, 10012,  3109,  7772}, \
+        { 8192, 10012,  2458,  9830}, \
+        {10012, 10012,  4532,  5331}, \
+        {10012, 10012,  3807,  6345}, \
+        {10012, 10012,  3109,  7772}, \
+        {10012, 10012,  2458,  9830}, \
+        {11833, 10012,  4532,  5331}, \
+        {11833, 10012,  3807,  6345}, \
+        {11833, 10012,  3109,  7772}, \
+        {11833, 10012,  2458,  9830}, \
+        {13653, 10012,  4532,  5331}, \
+        {13653, 10012,  3807,  6345}, \
+        {13653, 10012,  3109,  7772}, \
+        {13653, 10012,  2458,  9830}, \
+        {15474, 10012,  4532,  5331}, \
+        {15474, 10012,  3807,  6345}, \
+        {15474, 10012,  3109,  7772}, \
+        {15474, 10012,  2458,  9830}, \
+        {17294, 10012,  4532,  5331}, \
+        {17294, 10012,  3807,  6345}, \
+        {17294, 10012,  3109,  7772}, \
+        {17294, 10012,  2458,  9830}, \
+        {19115, 10012,  4532,  5331}, \
+        {19115, 10012,  3807,  6345}, \
+        {19115, 10012,  3109,  7772}, \
+        {19115, 10012,  2458,  9830}, \
+        {20935, 10012,  4532,  5331}, \
+        {20935, 10012,  3807,  6345}, \
+        {20935, 10012,  3109,  7772}, \
+        {20935, 10012,  2458,  9830}, \
+        {22756, 10012,  4532,  5331}, \
+        {22756, 10012,  3807,  6345}, \
+        {22756, 10012,  3109,  7772}, \
+        {22756, 10012,  2458,  9830}, \
+        {24576, 10012,  4532,  5331}, \
+        {24576, 10012,  3807,  6345}, \
+        {24576, 10012,  3109,  7772}, \
+        {24576, 10012,  2458,  9830}, \
+        {26396, 10012,  4532,  5331}, \
+        {26396, 10012,  3807,  6345}, \
+        {26396, 10012,  3109,  7772}, \
+        {26396, 10012,  2458,  9830}, \
+        {28217, 10012,  4532,  5331}, \
+        {28217, 10012,  3807,  6345}, \
+        {28217, 10012,  3109,  7772}, \
+        {28217, 10012,  2458,  9830}, \
+        {30037, 10012,  4532,  5331}, \
+        {30037, 10012,  3807,  6345}, \
+        {30037, 10012,  3109,  7772}, \
+        {30037, 10012,  2458,  9830}, \
+        {31858, 10012,  4532,  5331}, \
+        {31858, 10012,  3807,  6345}, \
+        {31858, 10012,  3109,  7772}, \
+        {31858, 10012,  2458,  9830}, \
+        {  910, 11833,  4532,  5331}, \
+        {  910, 11833,  3807,  6345}, \
+        {  910, 11833,  3109,  7772}, \
+        {  910, 11833,  2458,  9830}, \
+        { 2731, 11833,  4532,  5331}, \
+        { 2731, 11833,  3807,  6345}, \
+        { 2731, 11833,  3109,  7772}, \
+        { 2731, 11833,  2458,  9830}, \
+        { 4551, 11833,  4532,  5331}, \
+        { 4551, 11833,  3807,  6345}, \
+        { 4551, 11833,  3109,  7772}, \
+        { 4551, 11833,  2458,  9830}, \
+        { 6372, 11833,  4532,  5331}, \
+        { 6372, 11833,  3807,  6345}, \
+        { 6372, 11833,  3109,  7772}, \
+        { 6372, 11833,  2458,  9830}, \
+        { 8192, 11833,  4532,  5331}, \
+        { 8192, 11833,  3807,  6345}, \
+        { 8192, 11833,  3109,  7772}, \
+        { 8192, 11833,  2458,  9830}, \
+        {10012, 11833,  4532,  5331}, \
+        {10012, 11833,  3807,  6345}, \
+        {10012, 11833,  3109,  7772}, \
+        {10012, 11833,  2458,  9830}, \
+        {11833, 11833,  4532,  5331}, \
+        {11833, 11833,  3807,  6345}, \
+        {11833, 11833,  3109,  7772}, \
+        {11833, 11833,  2458,  9830}, \
+        {13653, 11833,  4532,  5331}, \
+        {13653, 11833,  3807,  6345}, \
+        {13653, 11833,  3109,  7772}, \
+        {13653, 11833,  2458,  9830}, \
+        {15474, 11833,  4532,  5331}, \
+        {15474, 11833,  3807,  6345}, \
+        {15474, 11833,  3109,  7772}, \
+        {15474, 11833,  2458,  9830}, \
+        {17294, 11833,  4532,  5331}, \
+        {17294, 11833,  3807,  6345}, \
+        {17294, 11833,  3109,  7772}, \
+        {17294, 11833,  2458,  9830}, \
+        {19115, 11833,  4532,  5331}, \
+        {19115, 11833,  3807,  6345}, \
+        {19115, 11833,  3109,  7772}, \
+        {19115, 11833,  2458,  9830}, \
+        {20935, 11833,  4532,  5331}, \
+        {20935, 11833,  3807,  6345}, \
+        {20935, 11833,  3109,  7772}, \
+        {20935, 11833,  2458,  9830}, \
+        {22756, 11833,  4532,  5331}, \
+        {22756, 11833,  3807,  6345}, \
+        {22756, 11833,  3109,  7772}, \
+        {22756, 11833,  2458,  9830}, \
+        {24576, 11833,  4532,  5331}, \
+        {24576, 11833,  3807,  6345}, \
+        {24576, 11833,  3109,  7772}, \
+        {24576, 11833,  2458,  9830}, \
+        {26396, 11833,  4532,  5331}, \
+        {26396, 11833,  3807,  6345}, \
+        {26396, 11833,  3109,  7772}, \
+        {26396, 11833,  2458,  9830}, \
+        {28217, 11833,  4532,  5331}, \
+        {28217, 11833,  3807,  6345}, \
+        {28217, 11833,  3109,  7772}, \
+        {28217, 11833,  2458,  9830}, \
+        {30037, 11833,  4532,  5331}, \
+        {30037, 11833,  3807,  6345}, \
+        {30037, 11833,  3109,  7772}, \
+        {30037, 11833,  2458,  9830}, \
+        {31858, 11833,  4532,  5331}, \
+        {31858, 11833,  3807,  6345}, \
+        {31858, 11833,  3109,  7772}, \
+        {31858, 11833,  2458,  9830}, \
+        {  910, 13653,  4532,  5331}, \
+        {  910, 13653,  3807,  6345}, \
+        {  910, 13653,  3109,  7772}, \
+        {  910, 13653,  2458,  9830}, \
+        { 2731, 13653,  4532,  5331}, \
+        { 2731, 13653,  3807,  6345}, \
+        { 2731, 13653,  3109,  7772}, \
+        { 2731, 13653,  2458,  9830}, \
+        { 4551, 13653,  4532,  5331}, \
+        { 4551, 13653,  3807,  6345}, \
+        { 4551, 13653,  3109,  7772}, \
+        { 4551, 13653,  2458,  9830}, \
+        { 6372, 13653,  4532,  5331}, \
+        { 6372, 13653,  3807,  6345}, \
+        { 6372, 13653,  3109,  7772}, \
+        { 6372, 13653,  2458,  9830}, \
+        { 8192, 13653,  4532,  5331}, \
+        { 8192, 13653,  3807,  6345}, \
+        { 8192, 13653,  3109,  7772}, \
+        { 8192, 13653,  2458,  9830}, \
+        {10012, 13653,  4532,  5331}, \
+        {10012, 13653,  3807,  6345}, \
+        {10012, 13653,  3109,  7772}, \
+        {10012, 13653,  2458,  9830}, \
+        {11833, 13653,  4532,  5331}, \
+        {11833, 13653,  3807,  6345}, \
+        {11833, 13653,  3109,  7772}, \
+        {11833, 13653,  2458,  9830}, \
+        {13653, 13653,  4532,  5331}, \
+        {13653, 13653,  3807,  6345}, \
+        {13653, 13653,  3109,  7772}, \
+        {13653, 13653,  2458,  9830}, \
+        {15474, 13653,  4532,  5331}, \
+        {15474, 13653,  3807,  6345}, \
+        {15474, 13653,  3109,  7772}, \
+        {15474, 13653,  2458,  9830}, \
+        {17294, 13653,  4532,  5331}, \
+        {17294, 13653,  3807,  6345}, \
+        {17294, 13653,  3109,  7772}, \
+        {17294, 13653,  2458,  9830}, \
+        {19115, 13653,  4532,  5331}, \
+        {19115, 13653,  3807,  6345}, \
+        {19115, 13653,  3109,  7772}, \
+        {19115, 13653,  2458,  9830}, \
+        {20935, 13653,  4532,  5331}, \
+        {20935, 13653,  3807,  6345}, \
+        {20935, 13653,  3109,  7772}, \
+        {20935, 13653,  2458,  9830}, \
+        {22756, 13653,  4532,  5331}, \
+        {22756, 13653,  3807,  6345}, \
+        {22756, 13653,  3109,  7772}, \
+        {22756, 13653,  2458,  9830}, \
+        {24576, 13653,  4532,  5331}, \
+        {24576, 13653,  3807,  6345}, \
+        {24576, 13653,  3109,  7772}, \
+        {24576, 13653,  2458,  9830}, \
+        {26396, 13653,  4532,  5331}, \
+        {26396, 13653,  3807,  6345}, \
+        {26396, 13653,  3109,  7772}, \
+        {26396, 13653,  2458,  9830}, \
+        {28217, 13653,  4532,  5331}, \
+        {28217, 13653,  3807,  6345}, \
+        {28217, 13653,  3109,  7772}, \
+        {28217, 13653,  2458,  9830}, \
+        {30037, 13653,  4532,  5331}, \
+        {30037, 13653,  3807,  6345}, \
+        {30037, 13653,  3109,  7772}, \
+        {30037, 13653,  2458,  9830}, \
+        {31858, 13653,  4532,  5331}, \
+        {31858, 13653,  3807,  6345}, \
+        {31858, 13653,  3109,  7772}, \
+        {31858, 13653,  2458,  9830}, \
+        {  910, 15474,  4532,  5331}, \
+        {  910, 15474,  3807,  6345}, \
+        {  910, 15474,  3109,  7772}, \
+        {  910, 15474,  2458,  9830}, \
+        { 2731, 15474,  4532,  5331}, \
+        { 2731, 15474,  3807,  6345}, \
+        { 2731, 15474,  3109,  7772}, \
+        { 2731, 15474,  2458,  9830}, \
+        { 4551, 15474,  4532,  5331}, \
+        { 4551, 15474,  3807,  6345}, \
+        { 4551, 15474,  3109,  7772}, \
+        { 4551, 15474,  2458,  9830}, \
+        { 6372, 15474,  4532,  5331}, \
+        { 6372, 15474,  3807,  6345}, \
+        { 6372, 15474,  3109,  7772}, \
+        { 6372, 15474,  2458,  9830}, \
+        { 8192, 15474,  4532,  5331}, \
+        { 8192, 15474,  3807,  6345}, \
+        { 8192, 15474,  3109,  7772}, \
+        { 8192, 15474,  2458,  9830}, \
+        {10012, 15474,  4532,  5331}, \
+        {10012, 15474,  3807,  6345}, \
+        {10012, 15474,  3109,  7772}, \
+        {10012, 15474,  2458,  9830}, \
+        {11833, 15474,  4532,  5331}, \
+        {11833, 15474,  3807,  6345}, \
+        {11833, 15474,  3109,  7772}, \
+        {11833, 15474,  2458,  9830}, \
+        {13653, 15474,  4532,  5331}, \
+        {13653, 15474,  3807,  6345}, \
+        {13653, 15474,  3109,  7772}, \
+        {13653, 15474,  2458,  9830}, \
+        {15474, 15474,  4532,  5331}, \
+        {15474, 15474,  3807,  6345}, \
+        {15474, 15474,  3109,  7772}, \
+        {15474, 15474,  2458,  9830}, \
+        {17294, 15474,  4532,  5331}, \
+        {17294, 15474,  3807,  6345}, \
+        {17294, 15474,  3109,  7772}, \
+        {17294, 15474,  2458,  9830}, \
+        {19115, 15474,  4532,  5331}, \
+        {19115, 15474,  3807,  6345}, \
+        {19115, 15474,  3109,  7772}, \
+        {19115, 15474,  2458,  9830}, \
+        {20935, 15474,  4532,  5331}, \
+        {20935, 15474,  3807,  6345}, \
+        {20935, 15474,  3109,  7772}, \
+        {20935, 15474,  2458,  9830}, \
+        {22756, 15474,  4532,  5331}, \
+        {22756, 15474,  3807,  6345}, \
+        {22756, 15474,  3109,  7772}, \
+        {22756, 15474,  2458,  9830}, \
+        {24576, 15474,  4532,  5331}, \
+        {24576, 15474,  3807,  6345}, \
+        {24576, 15474,  3109,  7772}, \
+        {24576, 15474,  2458,  9830}, \
+        {26396, 15474,  4532,  5331}, \
+        {26396, 15474,  3807,  6345}, \
+        {26396, 15474,  3109,  7772}, \
+        {26396, 15474,  2458,  9830}, \
+        {28217, 15474,  4532,  5331}, \
+        {28217, 15474,  3807,  6345}, \
+        {28217, 15474,  3109,  7772}, \
+        {28217, 15474,  2458,  9830}, \
+        {30037, 15474,  4532,  5331}, \
+        {30037, 15474,  3807,  6345}, \
+        {30037, 15474,  3109,  7772}, \
+        {30037, 15474,  2458,  9830}, \
+        {31858, 15474,  4532,  5331}, \
+        {31858, 15474,  3807,  6345}, \
+        {31858, 15474,  3109,  7772}, \
+        {31858, 15474,  2458,  9830}, \
+        {  910, 17294,  4532,  5331}, \
+        {  910, 17294,  3807,  6345}, \
+        {  910, 17294,  3109,  7772}, \
+        {  910, 17294,  2458,  9830}, \
+        { 2731, 17294,  4532,  5331}, \
+        { 2731, 17294,  3807,  6345}, \
+        { 2731, 17294,  3109,  7772}, \
+        { 2731, 17294,  2458,  9830}, \
+        { 4551, 17294,  4532,  5331}, \
+        { 4551, 17294,  3807,  6345}, \
+        { 4551, 17294,  3109,  7772}, \
+        { 4551, 17294,  2458,  9830}, \
+        { 6372, 17294,  4532,  5331}, \
+        { 6372, 17294,  3807,  6345}, \
+        { 6372, 17294,  3109,  7772}, \
+        { 6372, 17294,  2458,  9830}, \
+        { 8192, 17294,  4532,  5331}, \
+        { 8192, 17294,  3807,  6345}, \
+        { 8192, 17294,  3109,  7772}, \
+        { 8192, 17294,  2458,  9830}, \
+        {10012, 17294,  4532,  5331}, \
+        {10012, 17294,  3807,  6345}, \
+        {10012, 17294,  3109,  7772}, \
+        {10012, 17294,  2458,  9830}, \
+        {11833, 17294,  4532,  5331}, \
+        {11833, 17294,  3807,  6345}, \
+        {11833, 17294,  3109,  7772}, \
+        {11833, 17294,  2458,  9830}, \
+        {13653, 17294,  4532,  5331}, \
+        {13653, 17294,  3807,  6345}, \
+        {13653, 17294,  3109,  7772}, \
+        {13653, 17294,  2458,  9830}, \
+        {15474, 17294,  4532,  5331}, \
+        {15474, 17294,  3807,  6345}, \
+        {15474, 17294,  3109,  7772}, \
+        {15474, 17294,  2458,  9830}, \
+        {17294, 17294,  4532,  5331}, \
+        {17294, 17294,  3807,  6345}, \
+        {17294, 17294,  3109,  7772}, \
+        {17294, 17294,  2458,  9830}, \
+        {19115, 17294,  4532,  5331}, \
+        {19115, 17294,  3807,  6345}, \
+        {19115, 17294,  3109,  7772}, \
+        {19115, 17294,  2458,  9830}, \
+        {20935, 17294,  4532,  5331}, \
+        {20935, 17294,  3807,  6345}, \
+        {20935, 17294,  3109,  7772}, \
+        {20935, 17294,  2458,  9830}, \
+        {22756, 17294,  4532,  5331}, \
+        {22756, 17294,  3807,  6345}, \
+        {22756, 17294,  3109,  7772}, \
+        {22756, 17294,  2458,  9830}, \
+        {24576, 17294,  4532,  5331}, \
+        {24576, 17294,  3807,  6345}, \
+        {24576, 17294,  3109,  7772}, \
+        {24576, 17294,  2458,  9830}, \
+        {26396, 17294,  4532,  5331}, \
+        {26396, 17294,  3807,  6345}, \
+        {26396, 17294,  3109,  7772}, \
+        {26396, 17294,  2458,  9830}, \
+        {28217, 17294,  4532,  5331}, \
+        {28217, 17294,  3807,  6345}, \
+        {28217, 17294,  3109,  7772}, \
+        {28217, 17294,  2458,  9830}, \
+        {30037, 17294,  4532,  5331}, \
+        {30037, 17294,  3807,  6345}, \
+        {30037, 17294,  3109,  7772}, \
+        {30037, 17294,  2458,  9830}, \
+        {31858, 17294,  4532,  5331}, \
+        {31858, 17294,  3807,  6345}, \
+        {31858, 17294,  3109,  7772}, \
+        {31858, 17294,  2458,  9830}, \
+        {  910, 19115,  4532,  5331}, \
+        {  910, 19115,  3807,  6345}, \
+        {  910, 19115,  3109,  7772}, \
+        {  910, 19115,  2458,  9830}, \
+        { 2731, 19115,  4532,  5331}, \
+        { 2731, 19115,  3807,  6345}, \
+        { 2731, 19115,  3109,  7772}, \
+        { 2731, 19115,  2458,  9830}, \
+        { 4551, 19115,  4532,  5331}, \
+        { 4551, 19115,  3807,  6345}, \
+        { 4551, 19115,  3109,  7772}, \
+        { 4551, 19115,  2458,  9830}, \
+        { 6372, 19115,  4532,  5331}, \
+        { 6372, 19115,  3807,  6345}, \
+        { 6372, 19115,  3109,  7772}, \
+        { 6372, 19115,  2458,  9830}, \
+        { 8192, 19115,  4532,  5331}, \
+        { 8192, 19115,  3807,  6345}, \
+        { 8192, 19115,  3109,  7772}, \
+        { 8192, 19115,  2458,  9830}, \
+        {10012, 19115,  4532,  5331}, \
+        {10012, 19115,  3807,  6345}, \
+        {10012, 19115,  3109,  7772}, \
+        {10012, 19115,  2458,  9830}, \
+        {11833, 19115,  4532,  5331}, \
+        {11833, 19115,  3807,  6345}, \
+        {11833, 19115,  3109,  7772}, \
+        {11833, 19115,  2458,  9830}, \
+        {13653, 19115,  4532,  5331}, \
+        {13653, 19115,  3807,  6345}, \
+        {13653, 19115,  3109,  7772}, \
+        {13653, 19115,  2458,  9830}, \
+        {15474, 19115,  4532,  5331}, \
+        {15474, 19115,  3807,  6345}, \
+        {15474, 19115,  3109,  7772}, \
+        {15474, 19115,  2458,  9830}, \
+        {17294, 19115,  4532,  5331}, \
+        {17294, 19115,  3807,  6345}, \
+        {17294, 19115,  3109,  7772}, \
+        {17294, 19115,  2458,  9830}, \
+        {19115, 19115,  4532,  5331}, \
+        {19115, 19115,  3807,  6345}, \
+        {19115, 19115,  3109,  7772}, \
+        {19115, 19115,  2458,  9830}, \
+        {20935, 19115,  4532,  5331}, \
+        {20935, 19115,  3807,  6345}, \
+        {20935, 19115,  3109,  7772}, \
+        {20935, 19115,  2458,  9830}, \
+        {22756, 19115,  4532,  5331}, \
+        {22756, 19115,  3807,  6345}, \
+        {22756, 19115,  3109,  7772}, \
+        {22756, 19115,  2458,  9830}, \
+        {24576, 19115,  4532,  5331}, \
+        {24576, 19115,  3807,  6345}, \
+        {24576, 19115,  3109,  7772}, \
+        {24576, 19115,  2458,  9830}, \
+        {26396, 19115,  4532,  5331}, \
+        {26396, 19115,  3807,  6345}, \
+        {26396, 19115,  3109,  7772}, \
+        {26396, 19115,  2458,  9830}, \
+        {28217, 19115,  4532,  5331}, \
+        {28217, 19115,  3807,  6345}, \
+        {28217, 19115,  3109,  7772}, \
+        {28217, 19115,  2458,  9830}, \
+        {30037, 19115,  4532,  5331}, \
+        {30037, 19115,  3807,  6345}, \
+        {30037, 19115,  3109,  7772}, \
+        {30037, 19115,  2458,  9830}, \
+        {31858, 19115,  4532,  5331}, \
+        {31858, 19115,  3807,  6345}, \
+        {31858, 19115,  3109,  7772}, \
+        {31858, 19115,  2458,  9830}, \
+        {  910, 20935,  4532,  5331}, \
+        {  910, 20935,  3807,  6345}, \
+        {  910, 20935,  3109,  7772}, \
+        {  910, 20935,  2458,  9830}, \
+        { 2731, 20935,  4532,  5331}, \
+        { 2731, 20935,  3807,  6345}, \
+        { 2731, 20935,  3109,  7772}, \
+        { 2731, 20935,  2458,  9830}, \
+        { 4551, 20935,  4532,  5331}, \
+        { 4551, 20935,  3807,  6345}, \
+        { 4551, 20935,  3109,  7772}, \
+        { 4551, 20935,  2458,  9830}, \
+        { 6372, 20935,  4532,  5331}, \
+        { 6372, 20935,  3807,  6345}, \
+        { 6372, 20935,  3109,  7772}, \
+        { 6372, 20935,  2458,  9830}, \
+        { 8192, 20935,  4532,  5331}, \
+        { 8192, 20935,  3807,  6345}, \
+        { 8192, 20935,  3109,  7772}, \
+        { 8192, 20935,  2458,  9830}, \
+        {10012, 20935,  4532,  5331}, \
+        {10012, 20935,  3807,  6345}, \
+        {10012, 20935,  3109,  7772}, \
+        {10012, 20935,  2458,  9830}, \
+        {11833, 20935,  4532,  5331}, \
+        {11833, 20935,  3807,  6345}, \
+        {11833, 20935,  3109,  7772}, \
+        {11833, 20935,  2458,  9830}, \
+        {13653, 20935,  4532,  5331}, \
+        {13653, 20935,  3807,  6345}, \
+        {13653, 20935,  3109,  7772}, \
+        {13653, 20935,  2458,  9830}, \
+        {15474, 20935,  4532,  5331}, \
+        {15474, 20935,  3807,  6345}, \
+        {15474, 20935,  3109,  7772}, \
+        {15474, 20935,  2458,  9830}, \
+        {17294, 20935,  4532,  5331}, \
+        {17294, 20935,  3807,  6345}, \
+        {17294, 20935,  3109,  7772}, \
+        {17294, 20935,  2458,  9830}, \
+        {19115, 20935,  4532,  5331}, \
+        {19115, 20935,  3807,  6345}, \
+        {19115, 20935,  3109,  7772}, \
+        {19115, 20935,  2458,  9830}, \
+        {20935, 20935,  4532,  5331}, \
+        {20935, 20935,  3807,  6345}, \
+        {20935, 20935,  3109,  7772}, \
+        {20935, 20935,  2458,  9830}, \
+        {22756, 20935,  4532,  5331}, \
+        {22756, 20935,  3807,  6345}, \
+        {22756, 20935,  3109,  7772}, \
+        {22756, 20935,  2458,  9830}, \
+        {24576, 20935,  4532,  5331}, \
+        {24576, 20935,  3807,  6345}, \
+        {24576, 20935,  3109,  7772}, \
+        {24576, 20935,  2458,  9830}, \
+        {26396, 20935,  4532,  5331}, \
+        {26396, 20935,  3807,  6345}, \
+        {26396, 20935,  3109,  7772}, \
+        {26396, 20935,  2458,  9830}, \
+        {28217, 20935,  4532,  5331}, \
+        {28217, 20935,  3807,  6345}, \
+        {28217, 20935,  3109,  7772}, \
+        {28217, 20935,  2458,  9830}, \
+        {30037, 20935,  4532,  5331}, \
+        {30037, 20935,  3807,  6345}, \
+        {30037, 20935,  3109,  7772}, \
+        {30037, 20935,  2458,  9830}, \
+        {31858, 20935,  4532,  5331}, \
+        {31858, 20935,  3807,  6345}, \
+        {31858, 20935,  3109,  7772}, \
+        {31858, 20935,  2458,  9830}, \
+        {  910, 22756,  4532,  5331}, \
+        {  910, 22756,  3807,  6345}, \
+        {  910, 22756,  3109,  7772}, \
+        {  910, 22756,  2458,  9830}, \
+        { 2731, 22756,  4532,  5331}, \
+        { 2731, 22756,  3807,  6345}, \
+        { 2731, 22756,  3109,  7772}, \
+        { 2731, 22756,  2458,  9830}, \
+        { 4551, 22756,  4532,  5331}, \
+        { 4551, 22756,  3807,  6345}, \
+        { 4551, 22756,  3109,  7772}, \
+        { 4551, 22756,  2458,  9830}, \
+        { 6372, 22756,  4532,  5331}, \
+        { 6372, 22756,  3807,  6345}, \
+        { 6372, 22756,  3109,  7772}, \
+        { 6372, 22756,  2458,  9830}, \
+        { 8192, 22756,  4532,  5331}, \
+        { 8192, 22756,  3807,  6345}, \
+        { 8192, 22756,  3109,  7772}, \
+        { 8192, 22756,  2458,  9830}, \
+        {10012, 22756,  4532,  5331}, \
+        {10012, 22756,  3807,  6345}, \
+        {10012, 22756,  3109,  7772}, \
+        {10012, 22756,  2458,  9830}, \
+        {11833, 22756,  4532,  5331}, \
+        {11833, 22756,  3807,  6345}, \
+        {11833, 22756,  3109,  7772}, \
+        {11833, 22756,  2458,  9830}, \
+        {13653, 22756,  4532,  5331}, \
+        {13653, 22756,  3807,  6345}, \
+        {13653, 22756,  3109,  7772}, \
+        {13653, 22756,  2458,  9830}, \
+        {15474, 22756,  4532,  5331}, \
+        {15474, 22756,  3807,  6345}, \
+        {15474, 22756,  3109,  7772}, \
+        {15474, 22756,  2458,  9830}, \
+        {17294, 22756,  4532,  5331}, \
+        {17294, 22756,  3807,  6345}, \
+        {17294, 22756,  3109,  7772}, \
+        {17294, 22756,  2458,  9830}, \
+        {19115, 22756,  4532,  5331}, \
+        {19115, 22756,  3807,  6345}, \
+        {19115, 22756,  3109,  7772}, \
+        {19115, 22756,  2458,  9830}, \
+        {20935, 22756,  4532,  5331}, \
+        {20935, 22756,  3807,  6345}, \
+        {20935, 22756,  3109,  7772}, \
+        {20935, 22756,  2458,  9830}, \
+        {22756, 22756,  4532,  5331}, \
+        {22756, 22756,  3807,  6345}, \
+        {22756, 22756,  3109,  7772}, \
+        {22756, 22756,  2458,  9830}, \
+        {24576, 22756,  4532,  5331}, \
+        {24576, 22756,  3807,  6345}, \
+        {24576, 22756,  3109,  7772}, \
+        {24576, 22756,  2458,  9830}, \
+        {26396, 22756,  4532,  5331}, \
+        {26396, 22756,  3807,  6345}, \
+        {26396, 22756,  3109,  7772}, \
+        {26396, 22756,  2458,  9830}, \
+        {28217, 22756,  4532,  5331}, \
+        {28217, 22756,  3807,  6345}, \
+        {28217, 22756,  3109,  7772}, \
+        {28217, 22756,  2458,  9830}, \
+        {30037, 22756,  4532,  5331}, \
+        {30037, 22756,  3807,  6345}, \
+        {30037, 22756,  3109,  7772}, \
+        {30037, 22756,  2458,  9830}, \
+        {31858, 22756,  4532,  5331}, \
+        {31858, 22756,  3807,  6345}, \
+        {31858, 22756,  3109,  7772}, \
+        {31858, 22756,  2458,  9830}, \
+        {  910, 24576,  4532,  5331}, \
+        {  910, 24576,  3807,  6345}, \
+        {  910, 24576,  3109,  7772}, \
+        {  910, 24576,  2458,  9830}, \
+        { 2731, 24576,  4532,  5331}, \
+        { 2731, 24576,  3807,  6345}, \
+        { 2731, 24576,  3109,  7772}, \
+        { 2731, 24576,  2458,  9830}, \
+        { 4551, 24576,  4532,  5331}, \
+        { 4551, 24576,  3807,  6345}, \
+        { 4551, 24576,  3109,  7772}, \
+        { 4551, 24576,  2458,  9830}, \
+        { 6372, 24576,  4532,  5331}, \
+        { 6372, 24576,  3807,  6345}, \
+        { 6372, 24576,  3109,  7772}, \
+        { 6372, 24576,  2458,  9830}, \
+        { 8192, 24576,  4532,  5331}, \
+        { 8192, 24576,  3807,  6345}, \
+        { 8192, 24576,  3109,  7772}, \
+        { 8192, 24576,  2458,  9830}, \
+        {10012, 24576,  4532,  5331}, \
+        {10012, 24576,  3807,  6345}, \
+        {10012, 24576,  3109,  7772}, \
+        {10012, 24576,  2458,  9830}, \
+        {11833, 24576,  4532,  5331}, \
+        {11833, 24576,  3807,  6345}, \
+        {11833, 24576,  3109,  7772}, \
+        {11833, 24576,  2458,  9830}, \
+        {13653, 24576,  4532,  5331}, \
+        {13653, 24576,  3807,  6345}, \
+        {13653, 24576,  3109,  7772}, \
+        {13653, 24576,  2458,  9830}, \
+        {15474, 24576,  4532,  5331}, \
+        {15474, 24576,  3807,  6345}, \
+        {15474, 24576,  3109,  7772}, \
+        {15474, 24576,  2458,  9830}, \
+        {17294, 24576,  4532,  5331}, \
+        {17294, 24576,  3807,  6345}, \
+        {17294, 24576,  3109,  7772}, \
+        {17294, 24576,  2458,  9830}, \
+        {19115, 24576,  4532,  5331}, \
+        {19115, 24576,  3807,  6345}, \
+        {19115, 24576,  3109,  7772}, \
+        {19115, 24576,  2458,  9830}, \
+        {20935, 24576,  4532,  5331}, \
+        {20935, 24576,  3807,  6345}, \
+        {20935, 24576,  3109,  7772}, \
+        {20935, 24576,  2458,  9830}, \
+        {22756, 24576,  4532,  5331}, \
+        {22756, 24576,  3807,  6345}, \
+        {22756, 24576,  3109,  7772}, \
+        {22756, 24576,  2458,  9830}, \
+        {24576, 24576,  4532,  5331}, \
+        {24576, 24576,  3807,  6345}, \
+        {24576, 24576,  3109,  7772}, \
+        {24576, 24576,  2458,  9830}, \
+        {26396, 24576,  4532,  5331}, \
+        {26396, 24576,  3807,  6345}, \
+        {26396, 24576,  3109,  7772}, \
+        {26396, 24576,  2458,  9830}, \
+        {28217, 24576,  4532,  5331}, \
+        {28217, 24576,  3807,  6345}, \
+        {28217, 24576,  3109,  7772}, \
+        {28217, 24576,  2458,  9830}, \
+        {30037, 24576,  4532,  5331}, \
+        {30037, 24576,  3807,  6345}, \
+        {30037, 24576,  3109,  7772}, \
+        {30037, 24576,  2458,  9830}, \
+        {31858, 24576,  4532,  5331}, \
+        {31858, 24576,  3807,  6345}, \
+        {31858, 24576,  3109,  7772}, \
+        {31858, 24576,  2458,  9830}, \
+        {  910, 26396,  4532,  5331}, \
+        {  910, 26396,  3807,  6345}, \
+        {  910, 26396,  3109,  7772}, \
+        {  910, 26396,  2458,  9830}, \
+        { 2731, 26396,  4532,  5331}, \
+        { 2731, 26396,  3807,  6345}, \
+        { 2731, 26396,  3109,  7772}, \
+        { 2731, 26396,  2458,  9830}, \
+        { 4551, 26396,  4532,  5331}, \
+        { 4551, 26396,  3807,  6345}, \
+        { 4551, 26396,  3109,  7772}, \
+        { 4551, 26396,  2458,  9830}, \
+        { 6372, 26396,  4532,  5331}, \
+        { 6372, 26396,  3807,  6345}, \
+        { 6372, 26396,  3109,  7772}, \
+        { 6372, 26396,  2458,  9830}, \
+        { 8192, 26396,  4532,  5331}, \
+        { 8192, 26396,  3807,  6345}, \
+        { 8192, 26396,  3109,  7772}, \
+        { 8192, 26396,  2458,  9830}, \
+        {10012, 26396,  4532,  5331}, \
+        {10012, 26396,  3807,  6345}, \
+        {10012, 26396,  3109,  7772}, \
+        {10012, 26396,  2458,  9830}, \
+        {11833, 26396,  4532,  5331}, \
+        {11833, 26396,  3807,  6345}, \
+        {11833, 26396,  3109,  7772}, \
+        {11833, 26396,  2458,  9830}, \
+        {13653, 26396,  4532,  5331}, \
+        {13653, 26396,  3807,  6345}, \
+        {13653, 26396,  3109,  7772}, \
+        {13653, 26396,  2458,  9830}, \
+        {15474, 26396,  4532,  5331}, \
+        {15474, 26396,  3807,  6345}, \
+        {15474, 26396,  3109,  7772}, \
+        {15474, 26396,  2458,  9830}, \
+        {17294, 26396,  4532,  5331}, \
+        {17294, 26396,  3807,  6345}, \
+        {17294, 26396,  3109,  7772}, \
+        {17294, 26396,  2458,  9830}, \
+        {19115, 26396,  4532,  5331}, \
+        {19115, 26396,  3807,  6345}, \
+        {19115, 26396,  3109,  7772}, \
+        {19115, 26396,  2458,  9830}, \
+        {20935, 26396,  4532,  5331}, \
+        {20935, 26396,  3807,  6345}, \
+        {20935, 26396,  3109,  7772}, \
+        {20935, 26396,  2458,  9830}, \
+        {22756, 26396,  4532,  5331}, \
+        {22756, 26396,  3807,  6345}, \
+        {22756, 26396,  3109,  7772}, \
+        {22756, 26396,  2458,  9830}, \
+        {24576, 26396,  4532,  5331}, \
+        {24576, 26396,  3807,  6345}, \
+        {24576, 26396,  3109,  7772}, \
+        {24576, 26396,  2458,  9830}, \
+        {26396, 26396,  4532,  5331}, \
+        {26396, 26396,  3807,  6345}, \
+        {26396, 26396,  3109,  7772}, \
+        {26396, 26396,  2458,  9830}, \
+        {28217, 26396,  4532,  5331}, \
+        {28217, 26396,  3807,  6345}, \
+        {28217, 26396,  3109,  7772}, \
+        {28217, 26396,  2458,  9830}, \
+        {30037, 26396,  4532,  5331}, \
+        {30037, 26396,  3807,  6345}, \
+        {30037, 26396,  3109,  7772}, \
+        {30037, 26396,  2458,  9830}, \
+        {31858, 26396,  4532,  5331}, \
+        {31858, 26396,  3807,  6345}, \
+        {31858, 26396,  3109,  7772}, \
+        {31858, 26396,  2458,  9830}, \
+        {  910, 28217,  4532,  5331}, \
+        {  910, 28217,  3807,  6345}, \
+        {  910, 28217,  3109,  7772}, \
+        {  910, 28217,  2458,  9830}, \
+        { 2731, 28217,  4532,  5331}, \
+        { 2731, 28217,  3807,  6345}, \
+        { 2731, 28217,  3109,  7772}, \
+        { 2731, 28217,  2458,  9830}, \
+        { 4551, 28217,  4532,  5331}, \
+        { 4551, 28217,  3807,  6345}, \
+        { 4551, 28217,  3109,  7772}, \
+        { 4551, 28217,  2458,  9830}, \
+        { 6372, 28217,  4532,  5331}, \
+        { 6372, 28217,  3807,  6345}, \
+        { 6372, 28217,  3109,  7772}, \
+        { 6372, 28217,  2458,  9830}, \
+        { 8192, 28217,  4532,  5331}, \
+        { 8192, 28217,  3807,  6345}, \
+        { 8192, 28217,  3109,  7772}, \
+        { 8192, 28217,  2458,  9830}, \
+        {10012, 28217,  4532,  5331}, \
+        {10012, 28217,  3807,  6345}, \
+        {10012, 28217,  3109,  7772}, \
+        {10012, 28217,  2458,  9830}, \
+        {11833, 28217,  4532,  5331}, \
+        {11833, 28217,  3807,  6345}, \
+        {11833, 28217,  3109,  7772}, \
+        {11833, 28217,  2458,  9830}, \
+        {13653, 28217,  4532,  5331}, \
+        {13653, 28217,  3807,  6345}, \
+        {13653, 28217,  3109,  7772}, \
+        {13653, 28217,  2458,  9830}, \
+        {15474, 28217,  4532,  5331}, \
+        {15474, 28217,  3807,  6345}, \
+        {15474, 28217,  3109,  7772}, \
+        {15474, 28217,  2458,  9830}, \
+        {17294, 28217,  4532,  5331}, \
+        {17294, 28217,  3807,  6345}, \
+        {17294, 28217,  3109,  7772}, \
+        {17294, 28217,  2458,  9830}, \
+        {19115, 28217,  4532,  5331}, \
+        {19115, 28217,  3807,  6345}, \
+        {19115, 28217,  3109,  7772}, \
+        {19115, 28217,  2458,  9830}, \
+        {20935, 28217,  4532,  5331}, \
+        {20935, 28217,  3807,  6345}, \
+        {20935, 28217,  3109,  7772}, \
+        {20935, 28217,  2458,  9830}, \
+        {22756, 28217,  4532,  5331}, \
+        {22756, 28217,  3807,  6345}, \
+        {22756, 28217,  3109,  7772}, \
+        {22756, 28217,  2458,  9830}, \
+        {24576, 28217,  4532,  5331}, \
+        {24576, 28217,  3807,  6345}, \
+        {24576, 28217,  3109,  7772}, \
+        {24576, 28217,  2458,  9830}, \
+        {26396, 28217,  4532,  5331}, \
+        {26396, 28217,  3807,  6345}, \
+        {26396, 28217,  3109,  7772}, \
+        {26396, 28217,  2458,  9830}, \
+        {28217, 28217,  4532,  5331}, \
+        {28217, 28217,  3807,  6345}, \
+        {28217, 28217,  3109,  7772}, \
+        {28217, 28217,  2458,  9830}, \
+        {30037, 28217,  4532,  5331}, \
+        {30037, 28217,  3807,  6345}, \
+        {30037, 28217,  3109,  7772}, \
+        {30037, 28217,  2458,  9830}, \
+        {31858, 28217,  4532,  5331}, \
+        {31858, 28217,  3807,  6345}, \
+        {31858, 28217,  3109,  7772}, \
+        {31858, 28217,  2458,  9830}, \
+        {  910, 30037,  4532,  5331}, \
+        {  910, 30037,  3807,  6345}, \
+        {  910, 30037,  3109,  7772}, \
+        {  910, 30037,  2458,  9830}, \
+        { 2731, 30037,  4532,  5331}, \
+        { 2731, 30037,  3807,  6345}, \
+        { 2731, 30037,  3109,  7772}, \
+        { 2731, 30037,  2458,  9830}, \
+        { 4551, 30037,  4532,  5331}, \
+        { 4551, 30037,  3807,  6345}, \
+        { 4551, 30037,  3109,  7772}, \
+        { 4551, 30037,  2458,  9830}, \
+        { 6372, 30037,  4532,  5331}, \
+        { 6372, 30037,  3807,  6345}, \
+        { 6372, 30037,  3109,  7772}, \
+        { 6372, 30037,  2458,  9830}, \
+        { 8192, 30037,  4532,  5331}, \
+        { 8192, 30037,  3807,  6345}, \
+        { 8192, 30037,  3109,  7772}, \
+        { 8192, 30037,  2458,  9830}, \
+        {10012, 30037,  4532,  5331}, \
+        {10012, 30037,  3807,  6345}, \
+        {10012, 30037,  3109,  7772}, \
+        {10012, 30037,  2458,  9830}, \
+        {11833, 30037,  4532,  5331}, \
+        {11833, 30037,  3807,  6345}, \
+        {11833, 30037,  3109,  7772}, \
+        {11833, 30037,  2458,  9830}, \
+        {13653, 30037,  4532,  5331}, \
+        {13653, 30037,  3807,  6345}, \
+        {13653, 30037,  3109,  7772}, \
+        {13653, 30037,  2458,  9830}, \
+        {15474, 30037,  4532,  5331}, \
+        {15474, 30037,  3807,  6345}, \
+        {15474, 30037,  3109,  7772}, \
+        {15474, 30037,  2458,  9830}, \
+        {17294, 30037,  4532,  5331}, \
+        {17294, 30037,  3807,  6345}, \
+        {17294, 30037,  3109,  7772}, \
+        {17294, 30037,  2458,  9830}, \
+        {19115, 30037,  4532,  5331}, \
+        {19115, 30037,  3807,  6345}, \
+        {19115, 30037,  3109,  7772}, \
+        {19115, 30037,  2458,  9830}, \
+        {20935, 30037,  4532,  5331}, \
+        {20935, 30037,  3807,  6345}, \
+        {20935, 30037,  3109,  7772}, \
+        {20935, 30037,  2458,  9830}, \
+        {22756, 30037,  4532,  5331}, \
+        {22756, 30037,  3807,  6345}, \
+        {22756, 30037,  3109,  7772}, \
+        {22756, 30037,  2458,  9830}, \
+        {24576, 30037,  4532,  5331}, \
+        {24576, 30037,  3807,  6345}, \
+        {24576, 30037,  3109,  7772}, \
+        {24576, 30037,  2458,  9830}, \
+        {26396, 30037,  4532,  5331}, \
+        {26396, 30037,  3807,  6345}, \
+        {26396, 30037,  3109,  7772}, \
+        {26396, 30037,  2458,  9830}, \
+        {28217, 30037,  4532,  5331}, \
+        {28217, 30037,  3807,  6345}, \
+        {28217, 30037,  3109,  7772}, \
+        {28217, 30037,  2458,  9830}, \
+        {30037, 30037,  4532,  5331}, \
+        {30037, 30037,  3807,  6345}, \
+        {30037, 30037,  3109,  7772}, \
+        {30037, 30037,  2458,  9830}, \
+        {31858, 30037,  4532,  5331}, \
+        {31858, 30037,  3807,  6345}, \
+        {31858, 30037,  3109,  7772}, \
+        {31858, 30037,  2458,  9830}, \
+        {  910, 31858,  4532,  5331}, \
+        {  910, 31858,  3807,  6345}, \
+        {  910, 31858,  3109,  7772}, \
+        {  910, 31858,  2458,  9830}, \
+        { 2731, 31858,  4532,  5331}, \
+        { 2731, 31858,  3807,  6345}, \
+        { 2731, 31858,  3109,  7772}, \
+        { 2731, 31858,  2458,  9830}, \
+        { 4551, 31858,  4532,  5331}, \
+        { 4551, 31858,  3807,  6345}, \
+        { 4551, 31858,  3109,  7772}, \
+        { 4551, 31858,  2458,  9830}, \
+        { 6372, 31858,  4532,  5331}, \
+        { 6372, 31858,  3807,  6345}, \
+        { 6372, 31858,  3109,  7772}, \
+        { 6372, 31858,  2458,  9830}, \
+        { 8192, 31858,  4532,  5331}, \
+        { 8192, 31858,  3807,  6345}, \
+        { 8192, 31858,  3109,  7772}, \
+        { 8192, 31858,  2458,  9830}, \
+        {10012, 31858,  4532,  5331}, \
+        {10012, 31858,  3807,  6345}, \
+        {10012, 31858,  3109,  7772}, \
+        {10012, 31858,  2458,  9830}, \
+        {11833, 31858,  4532,  5331}, \
+        {11833, 31858,  3807,  6345}, \
+        {11833, 31858,  3109,  7772}, \
+        {11833, 31858,  2458,  9830}, \
+        {13653, 31858,  4532,  5331}, \
+        {13653, 31858,  3807,  6345}, \
+        {13653, 31858,  3109,  7772}, \
+        {13653, 31858,  2458,  9830}, \
+        {15474, 31858,  4532,  5331}, \
+        {15474, 31858,  3807,  6345}, \
+        {15474, 31858,  3109,  7772}, \
+        {15474, 31858,  2458,  9830}, \
+        {17294, 31858,  4532,  5331}, \
+        {17294, 31858,  3807,  6345}, \
+        {17294, 31858,  3109,  7772}, \
+        {17294, 31858,  2458,  9830}, \
+        {19115, 31858,  4532,  5331}, \
+        {19115, 31858,  3807,  6345}, \
+        {19115, 31858,  3109,  7772}, \
+        {19115, 31858,  2458,  9830}, \
+        {20935, 31858,  4532,  5331}, \
+        {20935, 31858,  3807,  6345}, \
+        {20935, 31858,  3109,  7772}, \
+        {20935, 31858,  2458,  9830}, \
+        {22756, 31858,  4532,  5331}, \
+        {22756, 31858,  3807,  6345}, \
+        {22756, 31858,  3109,  7772}, \
+        {22756, 31858,  2458,  9830}, \
+        {24576, 31858,  4532,  5331}, \
+        {24576, 31858,  3807,  6345}, \
+        {24576, 31858,  3109,  7772}, \
+        {24576, 31858,  2458,  9830}, \
+        {26396, 31858,  4532,  5331}, \
+        {26396, 31858,  3807,  6345}, \
+        {26396, 31858,  3109,  7772}, \
+        {26396, 31858,  2458,  9830}, \
+        {28217, 31858,  4532,  5331}, \
+        {28217, 31858,  3807,  6345}, \
+        {28217, 31858,  3109,  7772}, \
+        {28217, 31858,  2458,  9830}, \
+        {30037, 31858,  4532,  5331}, \
+        {30037, 31858,  3807,  6345}, \
+        {30037, 31858,  3109,  7772}, \
+        {30037, 31858,  2458,  9830}, \
+        {31858, 31858,  4532,  5331}, \
+        {31858, 31858,  3807,  6345}, \
+        {31858, 31858,  3109,  7772}, \
+        {31858, 31858,  2458,  9830}, \
+        { 1820,  1820, 10574, 12440}, \
+        { 1820,  1820,  8884, 14806}, \
+        { 1820,  1820,  7254, 18134}, \
+        { 1820,  1820,  5734, 22938}, \
+        { 5461,  1820, 10574, 12440}, \
+        { 5461,  1820,  8884, 14806}, \
+        { 5461,  1820,  7254, 18134}, \
+        { 5461,  1820,  5734, 22938}, \
+        { 9102,  1820, 10574, 12440}, \
+        { 9102,  1820,  8884, 14806}, \
+        { 9102,  1820,  7254, 18134}, \
+        { 9102,  1820,  5734, 22938}, \
+        {12743,  1820, 10574, 12440}, \
+        {12743,  1820,  8884, 14806}, \
+        {12743,  1820,  7254, 18134}, \
+        {12743,  1820,  5734, 22938}, \
+        {16384,  1820, 10574, 12440}, \
+        {16384,  1820,  8884, 14806}, \
+        {16384,  1820,  7254, 18134}, \
+        {16384,  1820,  5734, 22938}, \
+        {20025,  1820, 10574, 12440}, \
+        {20025,  1820,  8884, 14806}, \
+        {20025,  1820,  7254, 18134}, \
+        {20025,  1820,  5734, 22938}, \
+        {23666,  1820, 10574, 12440}, \
+        {23666,  1820,  8884, 14806}, \
+        {23666,  1820,  7254, 18134}, \
+        {23666,  1820,  5734, 22938}, \
+        {27307,  1820, 10574, 12440}, \
+        {27307,  1820,  8884, 14806}, \
+        {27307,  1820,  7254, 18134}, \
+        {27307,  1820,  5734, 22938}, \
+        {30948,  1820, 10574, 12440}, \
+        {30948,  1820,  8884, 14806}, \
+        {30948,  1820,  7254, 18134}, \
+        {30948,  1820,  5734, 22938}, \
+        { 1820,  5461, 10574, 12440}, \
+        { 1820,  5461,  8884, 14806}, \
+        { 1820,  5461,  7254, 18134}, \
+        { 1820,  5461,  5734, 22938}, \
+        { 5461,  5461, 10574, 12440}, \
+        { 5461,  5461,  8884, 14806}, \
+        { 5461,  5461,  7254, 18134}, \
+        { 5461,  5461,  5734, 22938}, \
+        { 9102,  5461, 10574, 12440}, \
+        { 9102,  5461,  8884, 14806}, \
+        { 9102,  5461,  7254, 18134}, \
+        { 9102,  5461,  5734, 22938}, \
+        {12743,  5461, 10574, 12440}, \
+        {12743,  5461,  8884, 14806}, \
+        {12743,  5461,  7254, 18134}, \
+        {12743,  5461,  5734, 22938}, \
+        {16384,  5461, 10574, 12440}, \
+        {16384,  5461,  8884, 14806}, \
+        {16384,  5461,  7254, 18134}, \
+        {16384,  5461,  5734, 22938}, \
+        {20025,  5461, 10574, 12440}, \
+        {20025,  5461,  8884, 14806}, \
+        {20025,  5461,  7254, 18134}, \
+        {20025,  5461,  5734, 22938}, \
+        {23666,  5461, 10574, 12440}, \
+        {23666,  5461,  8884, 14806}, \
+        {23666,  5461,  7254, 18134}, \
+        {23666,  5461,  5734, 22938}, \
+        {27307,  5461, 10574, 12440}, \
+        {27307,  5461,  8884, 14806}, \
+        {27307,  5461,  7254, 18134}, \
+        {27307,  5461,  5734, 22938}, \
+        {30948,  5461, 10574, 12440}, \
+        {30948,  5461,  8884, 14806}, \
+        {30948,  5461,  7254, 18134}, \
+        {30948,  5461,  5734, 22938}, \
+        { 1820,  9102, 10574, 12440}, \
+        { 1820,  9102,  8884, 14806}, \
+        { 1820,  9102,  7254, 18134}, \
+        { 1820,  9102,  5734, 22938}, \
+        { 5461,  9102, 10574, 12440}, \
+        { 5461,  9102,  8884, 14806}, \
+        { 5461,  9102,  7254, 18134}, \
+        { 5461,  9102,  5734, 22938}, \
+        { 9102,  9102, 10574, 12440}, \
+        { 9102,  9102,  8884, 14806}, \
+        { 9102,  9102,  7254, 18134}, \
+        { 9102,  9102,  5734, 22938}, \
+        {12743,  9102, 10574, 12440}, \
+        {12743,  9102,  8884, 14806}, \
+        {12743,  9102,  7254, 18134}, \
+        {12743,  9102,  5734, 22938}, \
+        {16384,  9102, 10574, 12440}, \
+        {16384,  9102,  8884, 14806}, \
+        {16384,  9102,  7254, 18134}, \
+        {16384,  9102,  5734, 22938}, \
+        {20025,  9102, 10574, 12440}, \
+        {20025,  9102,  8884, 14806}, \
+        {20025,  9102,  7254, 18134}, \
+        {20025,  9102,  5734, 22938}, \
+        {23666,  9102, 10574, 12440}, \
+        {23666,  9102,  8884, 14806}, \
+        {23666,  9102,  7254, 18134}, \
+        {23666,  9102,  5734, 22938}, \
+        {27307,  9102, 10574, 12440}, \
+        {27307,  9102,  8884, 14806}, \
+        {27307,  9102,  7254, 18134}, \
+        {27307,  9102,  5734, 22938}, \
+        {30948,  9102, 10574, 12440}, \
+        {30948,  9102,  8884, 14806}, \
+        {30948,  9102,  7254, 18134}, \
+        {30948,  9102,  5734, 22938}, \
+        { 1820, 12743, 10574, 12440}, \
+        { 1820, 12743,  8884, 14806}, \
+        { 1820, 12743,  7254, 18134}, \
+        { 1820, 12743,  5734, 22938}, \
+        { 5461, 12743, 10574, 12440}, \
+        { 5461, 12743,  8884, 14806}, \
+        { 5461, 12743,  7254, 18134}, \
+        { 5461, 12743,  5734, 22938}, \
+        { 9102, 12743, 10574, 12440}, \
+        { 9102, 12743,  8884, 14806}, \
+        { 9102, 12743,  7254, 18134}, \
+        { 9102, 12743,  5734, 22938}, \
+        {12743, 12743, 10574, 12440}, \
+        {12743, 12743,  8884, 14806}, \
+        {12743, 12743,  7254, 18134}, \
+        {12743, 12743,  5734, 22938}, \
+        {16384, 12743, 10574, 12440}, \
+        {16384, 12743,  8884, 14806}, \
+        {16384, 12743,  7254, 18134}, \
+        {16384, 12743,  5734, 22938}, \
+        {20025, 12743, 10574, 12440}, \
+        {20025, 12743,  8884, 14806}, \
+        {20025, 12743,  7254, 18134}, \
+        {20025, 12743,  5734, 22938}, \
+        {23666, 12743, 10574, 12440}, \
+        {23666, 12743,  8884, 14806}, \
+        {23666, 12743,  7254, 18134}, \
+        {23666, 12743,  5734, 22938}, \
+        {27307, 12743, 10574, 12440}, \
+        {27307, 12743,  8884, 14806}, \
+        {27307, 12743,  7254, 18134}, \
+        {27307, 12743,  5734, 22938}, \
+        {30948, 12743, 10574, 12440}, \
+        {30948, 12743,  8884, 14806}, \
+        {30948, 12743,  7254, 18134}, \
+        {30948, 12743,  5734, 22938}, \
+        { 1820, 16384, 10574, 12440}, \
+        { 1820, 16384,  8884, 14806}, \
+        { 1820, 16384,  7254, 18134}, \
+        { 1820, 16384,  5734, 22938}, \
+        { 5461, 16384, 10574, 12440}, \
+        { 5461, 16384,  8884, 14806}, \
+        { 5461, 16384,  7254, 18134}, \
+        { 5461, 16384,  5734, 22938}, \
+        { 9102, 16384, 10574, 12440}, \
+        { 9102, 16384,  8884, 14806}, \
+        { 9102, 16384,  7254, 18134}, \
+        { 9102, 16384,  5734, 22938}, \
+        {12743, 16384, 10574, 12440}, \
+        {12743, 16384,  8884, 14806}, \
+        {12743, 16384,  7254, 18134}, \
+        {12743, 16384,  5734, 22938}, \
+        {16384, 16384, 10574, 12440}, \
+        {16384, 16384,  8884, 14806}, \
+        {16384, 16384,  7254, 18134}, \
+        {16384, 16384,  5734, 22938}, \
+        {20025, 16384, 10574, 12440}, \
+        {20025, 16384,  8884, 14806}, \
+        {20025, 16384,  7254, 18134}, \
+        {20025, 16384,  5734, 22938}, \
+        {23666, 16384, 10574, 12440}, \
+        {23666, 16384,  8884, 14806}, \
+        {23666, 16384,  7254, 18134}, \
+        {23666, 16384,  5734, 22938}, \
+        {27307, 16384, 10574, 12440}, \
+        {27307, 16384,  8884, 14806}, \
+        {27307, 16384,  7254, 18134}, \
+        {27307, 16384,  5734, 22938}, \
+        {30948, 16384, 10574, 12440}, \
+        {30948, 16384,  8884, 14806}, \
+        {30948, 16384,  7254, 18134}, \
+        {30948, 16384,  5734, 22938}, \
+        { 1820, 20025, 10574, 12440}, \
+        { 1820, 20025,  8884, 14806}, \
+        { 1820, 20025,  7254, 18134}, \
+        { 1820, 20025,  5734, 22938}, \
+        { 5461, 20025, 10574, 12440}, \
+        { 5461, 20025,  8884, 14806}, \
+        { 5461, 20025,  7254, 18134}, \
+        { 5461, 20025,  5734, 22938}, \
+        { 9102, 20025, 10574, 12440}, \
+        { 9102, 20025,  8884, 14806}, \
+        { 9102, 20025,  7254, 18134}, \
+        { 9102, 20025,  5734, 22938}, \
+        {12743, 20025, 10574, 12440}, \
+        {12743, 20025,  8884, 14806}, \
+        {12743, 20025,  7254, 18134}, \
+        {12743, 20025,  5734, 22938}, \
+        {16384, 20025, 10574, 12440}, \
+        {16384, 20025,  8884, 14806}, \
+        {16384, 20025,  7254, 18134}, \
+        {16384, 20025,  5734, 22938}, \
+        {20025, 20025, 10574, 12440}, \
+        {20025, 20025,  8884, 14806}, \
+        {20025, 20025,  7254, 18134}, \
+        {20025, 20025,  5734, 22938}, \
+        {23666, 20025, 10574, 12440}, \
+        {23666, 20025,  8884, 14806}, \
+        {23666, 20025,  7254, 18134}, \
+        {23666, 20025,  5734, 22938}, \
+        {27307, 20025, 10574, 12440}, \
+        {27307, 20025,  8884, 14806}, \
+        {27307, 20025,  7254, 18134}, \
+        {27307, 20025,  5734, 22938}, \
+        {30948, 20025, 10574, 12440}, \
+        {30948, 20025,  8884, 14806}, \
+        {30948, 20025,  7254, 18134}, \
+        {30948, 20025,  5734, 22938}, \
+        { 1820, 23666, 10574, 12440}, \
+        { 1820, 23666,  8884, 14806}, \
+        { 1820, 23666,  7254, 18134}, \
+        { 1820, 23666,  5734, 22938}, \
+        { 5461, 23666, 10574, 12440}, \
+        { 5461, 23666,  8884, 14806}, \
+        { 5461, 23666,  7254, 18134}, \
+        { 5461, 23666,  5734, 22938}, \
+        { 9102, 23666, 10574, 12440}, \
+        { 9102, 23666,  8884, 14806}, \
+        { 9102, 23666,  7254, 18134}, \
+        { 9102, 23666,  5734, 22938}, \
+        {12743, 23666, 10574, 12440}, \
+        {12743, 23666,  8884, 14806}, \
+        {12743, 23666,  7254, 18134}, \
+        {12743, 23666,  5734, 22938}, \
+        {16384, 23666, 10574, 12440}, \
+        {16384, 23666,  8884, 14806}, \
+        {16384, 23666,  7254, 18134}, \
+        {16384, 23666,  5734, 22938}, \
+        {20025, 23666, 10574, 12440}, \
+        {20025, 23666,  8884, 14806}, \
+        {20025, 23666,  7254, 18134}, \
+        {20025, 23666,  5734, 22938}, \
+        {23666, 23666, 10574, 12440}, \
+        {23666, 23666,  8884, 14806}, \
+        {23666, 23666,  7254, 18134}, \
+        {23666, 23666,  5734, 22938}, \
+        {27307, 23666, 10574, 12440}, \
+        {27307, 23666,  8884, 14806}, \
+        {27307, 23666,  7254, 18134}, \
+        {27307, 23666,  5734, 22938}, \
+        {30948, 23666, 10574, 12440}, \
+        {30948, 23666,  8884, 14806}, \
+        {30948, 23666,  7254, 18134}, \
+        {30948, 23666,  5734, 22938}, \
+        { 1820, 27307, 10574, 12440}, \
+        { 1820, 27307,  8884, 14806}, \
+        { 1820, 27307,  7254, 18134}, \
+        { 1820, 27307,  5734, 22938}, \
+        { 5461, 27307, 10574, 12440}, \
+        { 5461, 27307,  8884, 14806}, \
+        { 5461, 27307,  7254, 18134}, \
+        { 5461, 27307,  5734, 22938}, \
+        { 9102, 27307, 10574, 12440}, \
+        { 9102, 27307,  8884, 14806}, \
+        { 9102, 27307,  7254, 18134}, \
+        { 9102, 27307,  5734, 22938}, \
+        {12743, 27307, 10574, 12440}, \
+        {12743, 27307,  8884, 14806}, \
+        {12743, 27307,  7254, 18134}, \
+        {12743, 27307,  5734, 22938}, \
+        {16384, 27307, 10574, 12440}, \
+        {16384, 27307,  8884, 14806}, \
+        {16384, 27307,  7254, 18134}, \
+        {16384, 27307,  5734, 22938}, \
+        {20025, 27307, 10574, 12440}, \
+        {20025, 27307,  8884, 14806}, \
+        {20025, 27307,  7254, 18134}, \
+        {20025, 27307,  5734, 22938}, \
+        {23666, 27307, 10574, 12440}, \
+        {23666, 27307,  8884, 14806}, \
+        {23666, 27307,  7254, 18134}, \
+        {23666, 27307,  5734, 22938}, \
+        {27307, 27307, 10574, 12440}, \
+        {27307, 27307,  8884, 14806}, \
+        {27307, 27307,  7254, 18134}, \
+        {27307, 27307,  5734, 22938}, \
+        {30948, 27307, 10574, 12440}, \
+        {30948, 27307,  8884, 14806}, \
+        {30948, 27307,  7254, 18134}, \
+        {30948, 27307,  5734, 22938}, \
+        { 1820, 30948, 10574, 12440}, \
+        { 1820, 30948,  8884, 14806}, \
+        { 1820, 30948,  7254, 18134}, \
+        { 1820, 30948,  5734, 22938}, \
+        { 5461, 30948, 10574, 12440}, \
+        { 5461, 30948,  8884, 14806}, \
+        { 5461, 30948,  7254, 18134}, \
+        { 5461, 30948,  5734, 22938}, \
+        { 9102, 30948, 10574, 12440}, \
+        { 9102, 30948,  8884, 14806}, \
+        { 9102, 30948,  7254, 18134}, \
+        { 9102, 30948,  5734, 22938}, \
+        {12743, 30948, 10574, 12440}, \
+        {12743, 30948,  8884, 14806}, \
+        {12743, 30948,  7254, 18134}, \
+        {12743, 30948,  5734, 22938}, \
+        {16384, 30948, 10574, 12440}, \
+        {16384, 30948,  8884, 14806}, \
+        {16384, 30948,  7254, 18134}, \
+        {16384, 30948,  5734, 22938}, \
+        {20025, 30948, 10574, 12440}, \
+        {20025, 30948,  8884, 14806}, \
+        {20025, 30948,  7254, 18134}, \
+        {20025, 30948,  5734, 22938}, \
+        {23666, 30948, 10574, 12440}, \
+        {23666, 30948,  8884, 14806}, \
+        {23666, 30948,  7254, 18134}, \
+        {23666, 30948,  5734, 22938}, \
+        {27307, 30948, 10574, 12440}, \
+        {27307, 30948,  8884, 14806}, \
+        {27307, 30948,  7254, 18134}, \
+        {27307, 30948,  5734, 22938}, \
+        {30948, 30948, 10574, 12440}, \
+        {30948, 30948,  8884, 14806}, \
+        {30948, 30948,  7254, 18134}, \
+        {30948, 30948,  5734, 22938}, \
+        { 4096,  4096, 16616, 19548}, \
+        { 4096,  4096, 13960, 23267}, \
+        { 4096,  4096, 11398, 28496}, \
+        { 4096,  4096,  9011, 32768}, \
+        {12288,  4096, 16616, 19548}, \
+        {12288,  4096, 13960, 23267}, \
+        {12288,  4096, 11398, 28496}, \
+        {12288,  4096,  9011, 32768}, \
+        {20480,  4096, 16616, 19548}, \
+        {20480,  4096, 13960, 23267}, \
+        {20480,  4096, 11398, 28496}, \
+        {20480,  4096,  9011, 32768}, \
+        {28672,  4096, 16616, 19548}, \
+        {28672,  4096, 13960, 23267}, \
+        {28672,  4096, 11398, 28496}, \
+        {28672,  4096,  9011, 32768}, \
+        { 4096, 12288, 16616, 19548}, \
+        { 4096, 12288, 13960, 23267}, \
+        { 4096, 12288, 11398, 28496}, \
+        { 4096, 12288,  9011, 32768}, \
+        {12288, 12288, 16616, 19548}, \
+        {12288, 12288, 13960, 23267}, \
+        {12288, 12288, 11398, 28496}, \
+        {12288, 12288,  9011, 32768}, \
+        {20480, 12288, 16616, 19548}, \
+        {20480, 12288, 13960, 23267}, \
+        {20480, 12288, 11398, 28496}, \
+        {20480, 12288,  9011, 32768}, \
+        {28672, 12288, 16616, 19548}, \
+        {28672, 12288, 13960, 23267}, \
+        {28672, 12288, 11398, 28496}, \
+        {28672, 12288,  9011, 32768}, \
+        { 4096, 20480, 16616, 19548}, \
+        { 4096, 20480, 13960, 23267}, \
+        { 4096, 20480, 11398, 28496}, \
+        { 4096, 20480,  9011, 32768}, \
+        {12288, 20480, 16616, 19548}, \
+        {12288, 20480, 13960, 23267}, \
+        {12288, 20480, 11398, 28496}, \
+        {12288, 20480,  9011, 32768}, \
+        {20480, 20480, 16616, 19548}, \
+        {20480, 20480, 13960, 23267}, \
+        {20480, 20480, 11398, 28496}, \
+        {20480, 20480,  9011, 32768}, \
+        {28672, 20480, 16616, 19548}, \
+        {28672, 20480, 13960, 23267}, \
+        {28672, 20480, 11398, 28496}, \
+        {28672, 20480,  9011, 32768}, \
+        { 4096, 28672, 16616, 19548}, \
+        { 4096, 28672, 13960, 23267}, \
+        { 4096, 28672, 11398, 28496}, \
+        { 4096, 28672,  9011, 32768}, \
+        {12288, 28672, 16616, 19548}, \
+        {12288, 28672, 13960, 23267}, \
+        {12288, 28672, 11398, 28496}, \
+        {12288, 28672,  9011, 32768}, \
+        {20480, 28672, 16616, 19548}, \
+        {20480, 28672, 13960, 23267}, \
+        {20480, 28672, 11398, 28496}, \
+        {20480, 28672,  9011, 32768}, \
+        {28672, 28672, 16616, 19548}, \
+        {28672, 28672, 13960, 23267}, \
+        {28672, 28672, 11398, 28496}, \
+        {28672, 28672,  9011, 32768}, \
+        { 8192,  8192, 21903, 25768}, \
+        { 8192,  8192, 18402, 30670}, \
+        { 8192,  8192, 15025, 32768}, \
+        { 8192,  8192, 11878, 32768}, \
+        {24576,  8192, 21903, 25768}, \
+        {24576,  8192, 18402, 30670}, \
+        {24576,  8192, 15025, 32768}, \
+        {24576,  8192, 11878, 32768}, \
+        { 8192, 24576, 21903, 25768}, \
+        { 8192, 24576, 18402, 30670}, \
+        { 8192, 24576, 15025, 32768}, \
+        { 8192, 24576, 11878, 32768}, \
+        {24576, 24576, 21903, 25768}, \
+        {24576, 24576, 18402, 30670}, \
+        {24576, 24576, 15025, 32768}, \
+        {24576, 24576, 11878, 32768} \
+    }
+
+// exp((x - 127) / 128) for class logit x in [-128, 127]
+#define SOFTMAX_EXP_LUT_Q15 \
+    { \
+         4469,  4505,  4540,  4575,  4611,  4647,  4684,  4721, \
+         4758,  4795,  4833,  4871,  4909,  4947,  4986,  5025, \
+         5065,  5104,  5144,  5185,  5225,  5266,  5308,  5349, \
+         5391,  5433,  5476,  5519,  5562,  5606,  5650,  5694, \
+         5739,  5784,  5829,  5875,  5921,  5967,  6014,  6061, \
+         6109,  6157,  6205,  6254,  6303,  6352,  6402,  6452, \
+         6503,  6554,  6605,  6657,  6709,  6762,  6815,  6869, \
+         6922,  6977,  7031,  7087,  7142,  7198,  7255,  7312, \
+         7369,  7427,  7485,  7544,  7603,  7662,  7723,  7783, \
+         7844,  7906,  7968,  8030,  8093,  8157,  8221,  8285, \
+         8350,  8416,  8482,  8548,  8615,  8683,  8751,  8819, \
+         8889,  8958,  9029,  9099,  9171,  9243,  9315,  9388, \
+         9462,  9536,  9611,  9686,  9762,  9839,  9916,  9994, \
+        10072, 10151, 10231, 10311, 10392, 10473, 10555, 10638, \
+        10722, 10806, 10890, 10976, 11062, 11149, 11236, 11324, \
+        11413, 11503, 11593, 11684, 11775, 11868, 11961, 12055, \
+        12149, 12245, 12341, 12437, 12535, 12633, 12732, 12832, \
+        12933, 13034, 13136, 13239, 13343, 13448, 13553, 13660, \
+        13767, 13875, 13984, 14093, 14204, 14315, 14428, 14541, \
+        14655, 14770, 14886, 15002, 15120, 15239, 15358, 15479, \
+        15600, 15722, 15846, 15970, 16095, 16221, 16349, 16477, \
+        16606, 16736, 16868, 17000, 17133, 17268, 17403, 17539, \
+        17677, 17816, 17955, 18096, 18238, 18381, 18525, 18671, \
+        18817, 18965, 19113, 19263, 19414, 19567, 19720, 19875, \
+        20031, 20188, 20346, 20506, 20667, 20829, 20992, 21157, \
+        21323, 21490, 21658, 21828, 21999, 22172, 22346, 22521, \
+        22698, 22876, 23055, 23236, 23418, 23602, 23787, 23974, \
+        24162, 24351, 24542, 24735, 24929, 25124, 25321, 25520, \
+        25720, 25922, 26125, 26330, 26536, 26744, 26954, 27166, \
+        27379, 27593, 27810, 28028, 28248, 28469, 28693, 28918, \
+        29144, 29373, 29603, 29836, 30070, 30305, 30543, 30783, \
+        31024, 31267, 31513, 31760, 32009, 32260, 32513, 32768 \
+    }
+
+// exp(x / 640) for box size offset x in [-128, 127]
+#define LOC_EXP_LUT_Q15 \
+    { \
+        26828, 26870, 26912, 26954, 26996, 27039, 27081, 27123, \
+        27166, 27208, 27251, 27293, 27336, 27379, 27422, 27464, \
+        27507, 27550, 27593, 27637, 27680, 27723, 27766, 27810, \
+        27853, 27897, 27941, 27984, 28028, 28072, 28116, 28160, \
+        28204, 28248, 28292, 28336, 28381, 28425, 28469, 28514, \
+        28558, 28603, 28648, 28693, 28737, 28782, 28827, 28873, \
+        28918, 28963, 29008, 29054, 29099, 29144, 29190, 29236, \
+        29281, 29327, 29373, 29419, 29465, 29511, 29557, 29603, \
+        29650, 29696, 29743, 29789, 29836, 29882, 29929, 29976, \
+        30023, 30070, 30117, 30164, 30211, 30258, 30305, 30353, \
+        30400, 30448, 30495, 30543, 30591, 30639, 30687, 30735, \
+        30783, 30831, 30879, 30927, 30976, 31024, 31073, 31121, \
+        31170, 31219, 31267, 31316, 31365, 31414, 31463, 31513, \
+        31562, 31611, 31661, 31710, 31760, 31809, 31859, 31909, \
+        31959, 32009, 32059, 32109, 32159, 32210, 32260, 32310, \
+        32361, 32412, 32462, 32513, 32564, 32615, 32666, 32717, \
+        32768, 32819, 32871, 32922, 32973, 33025, 33077, 33128, \
+        33180, 33232, 33284, 33336, 33388, 33440, 33493, 33545, \
+        33598, 33650, 33703, 33755, 33808, 33861, 33914, 33967, \
+        34020, 34073, 34127, 34180, 34233, 34287, 34341, 34394, \
+        34448, 34502, 34556, 34610, 34664, 34718, 34773, 34827, \
+        34881, 34936, 34991, 35045, 35100, 35155, 35210, 35265, \
+        35320, 35375, 35431, 35486, 35542, 35597, 35653, 35709, \
+        35764, 35820, 35876, 35932, 35989, 36045, 36101, 36158, \
+        36214, 36271, 36328, 36384, 36441, 36498, 36555, 36613, \
+        36670, 36727, 36785, 36842, 36900, 36957, 37015, 37073, \
+        37131, 37189, 37247, 37305, 37364, 37422, 37481, 37539, \
+        37598, 37657, 37716, 37775, 37834, 37893, 37952, 38012, \
+        38071, 38131, 38190, 38250, 38310, 38370, 38430, 38490, \
+        38550, 38610, 38671, 38731, 38792, 38852, 38913, 38974, \
+        39035, 39096, 39157, 39218, 39279, 39341, 39402, 39464, \
+        39526, 39588, 39649, 39711, 39774, 39836, 39898, 39960 \
+    }
+
+#endif /* _MAX78000_VIDEO_PRIORS_H_ */
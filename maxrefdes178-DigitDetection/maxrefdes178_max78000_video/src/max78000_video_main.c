@@ -52,6 +52,7 @@
 #include "max78000_debug.h"
 #include "max78000_qspi_slave.h"
 #include "max78000_video_cnn.h"
+#include "max78000_video_postproc.h"
 #include "max78000_video_weights.h"
 #include "maxrefdes178_definitions.h"
 #include "maxrefdes178_utility.h"
@@ -63,6 +64,7 @@
 #define S_MODULE_NAME          "main"
 //#define PRINT_TIME_CNN
 //#define USE_SAMPLEDATA        // shows the sample data
+//#define DUMP_CNN_OUTPUT       // prints CNN outputs in hex for the tests/test_digit_postproc benchmark
 
 #ifdef USE_SAMPLEDATA // Include sample data
 #include "sampledata.h"
@@ -70,34 +72,20 @@
 
 #define IMAGE_HEIGHT 240
 #define IMAGE_WIDTH  240
-#define X_SIZE       74
-#define Y_SIZE       74
 #define X_OFFSET     9
 #define Y_OFFSET     9
 #define SQUARE(x)   ((x) * (x))
-#define MIN(x, y)   (((x) < (y)) ? (x) : (y))
-#define MAX(x, y)   (((x) > (y)) ? (x) : (y))
-#define IMG_SCALE   3
-#define NUM_ARS     4
-#define NUM_SCALES  4
-#define NUM_CLASSES 12
-#define LOC_DIM     4 //(x, y, w, h) or (x1, y1, x2, y2)
-#define NUM_PRIORS_PER_AR   425
-#define NUM_PRIORS          NUM_PRIORS_PER_AR*NUM_ARS
-#define MAX_PRIORS          100
-#define MIN_CLASS_SCORE     16384 // ~0.25*65536
-#define MAX_ALLOWED_OVERLAP 0.3   //170
-#define ML_DATA_SIZE 5
+
+#if POSTPROC_SCRATCH_SIZE > (LCD_DATA_SIZE - 4000)
+#error "post-processing scratch overlaps the QSPI payload buffer at the end of camera_image"
+#endif
+
 //-----------------------------------------------------------------------------
 // Typedefs
 //-----------------------------------------------------------------------------
 
 /* **************************************************************************** */
 static void get_priors(void);
-static void nms(void);
-static void get_cxcy(float* cxcy, int prior_idx);
-static void gcxgcy_to_cxcy(float* cxcy, int prior_idx, float* priors_cxcy);
-static void cxcy_to_xy(float* xy, float* cxcy);
 static void localize_objects(void);
 static uint32_t  camera_image[LCD_DATA_SIZE/4];
 
@@ -111,19 +99,6 @@ const uint32_t input_buffer[] = SAMPLE_INPUT_0;
 mxc_tmr_unit_t units;
 
 static const int dims[NUM_SCALES] = {18, 9, 4, 2}; // NUM_PRIORS_PER_AR = SQUARE(dims[0]) + SQUARE(dims[1]) + SQUARE(dims[2]) + SQUARE(dims[3])
-static const float scales[NUM_SCALES] = {0.15f, 0.35f, 0.55f, 0.725f};
-static const float ars[NUM_ARS]       = {0.85f, 0.60f, 0.40f, 0.25f};
-//Arrays pointers to store model outputs
-static int8_t *prior_cls;  // int8_t prior_cls[NUM_CLASSES * NUM_PRIORS]; // 20400 bytes
-static uint16_t *prior_cls_softmax; // uint16_t prior_cls_softmax[NUM_CLASSES * NUM_PRIORS] // 40800 bytes
-static int8_t *prior_locs; // int8_t prior_locs[LOC_DIM * NUM_PRIORS]; (x, y, w, h) // 6800 bytes
-static uint8_t *objects; // store objects result
-//NMS related array pointer
-static uint8_t *nms_removed; // uint8_t nms_removed[NUM_CLASSES - 2][MAX_PRIORS]; // 1000 bytes
-//NMS related arrays
-static int num_nms_priors[NUM_CLASSES - 2];    // 40 bytes
-static uint16_t nms_scores[NUM_CLASSES - 2][MAX_PRIORS]; // 2000 bytes
-static uint16_t nms_indices[NUM_CLASSES - 2][MAX_PRIORS]; // 2000 bytes
 
 static const mxc_gpio_cfg_t gpio_flash     = MAX78000_VIDEO_FLASH_LED_PIN;
 static const mxc_gpio_cfg_t gpio_camera    = MAX78000_VIDEO_CAMERA_PIN;
@@ -287,11 +262,6 @@ static void send_img(void);
 static void run_cnn(void);
 static void run_demo(void);
 static void get_priors(void);
-static void nms(void);
-static void nms_memory_init(void);
-static void get_cxcy(float* cxcy, int prior_idx);
-static void gcxgcy_to_cxcy(float* cxcy, int prior_idx, float* priors_cxcy);
-static void cxcy_to_xy(float* xy, float* cxcy);
 static void localize_objects(void);
 
 //-----------------------------------------------------------------------------
@@ -475,8 +445,8 @@ int dma_channel;
     // Use end of camera interface buffer for QSPI payload buffer
     qspi_payload_buffer = (uint8_t*)&camera_image[LCD_DATA_SIZE/4 - 1000];
 
-    // Setup NMS algorithm memory
-    nms_memory_init();
+    // Setup NMS algorithm memory, the camera buffer is free while post-processing runs
+    postproc_init((uint8_t*)camera_image);
 
     // Successfully initialize the program
     PR_INFO("Initialization complete");
@@ -854,16 +824,6 @@ static void run_cnn(void)
     //MXC_Delay(MXC_DELAY_MSEC(500));
 }
 
-static void nms_memory_init(void)
-{
-    // Use "camera_image" buffer as a scratch memory to allocate NMS related arrays
-    prior_cls_softmax = (uint16_t*)&camera_image[0];
-    nms_removed = (uint8_t*)&prior_cls_softmax[NUM_CLASSES * NUM_PRIORS];
-    prior_cls = (int8_t*)&nms_removed[(NUM_CLASSES-2) * MAX_PRIORS];
-    prior_locs = (int8_t*)&prior_cls[NUM_CLASSES * NUM_PRIORS];
-    objects = (uint8_t*)&prior_locs[LOC_DIM * NUM_PRIORS];
-}
-
 static int get_prior_idx(int ar_idx, int scale_idx, int rel_idx)
 {
     int prior_idx = 0;
@@ -876,67 +836,10 @@ static int get_prior_idx(int ar_idx, int scale_idx, int rel_idx)
     return prior_idx;
 }
 
-static void get_indices(int* ar_idx, int* scale_idx, int* rel_idx, int prior_idx)
-{
-    int s;
-
-    int prior_count = 0;
-
-    for (s = 0; s < NUM_SCALES; ++s) {
-        prior_count += (NUM_ARS * SQUARE(dims[s]));
-
-        if (prior_idx < prior_count) {
-            *scale_idx = s;
-            break;
-        }
-    }
-
-    int in_scale_idx = prior_idx;
-
-    for (s = 0; s < *scale_idx; ++s) {
-        in_scale_idx -= (NUM_ARS * SQUARE(dims[s]));
-    }
-
-    *ar_idx  = in_scale_idx % NUM_ARS;
-    *rel_idx = in_scale_idx / NUM_ARS; //SQUARE(dims[*scale_idx]);
-}
-
-static void softmax(void)
-{
-    int i, ch, calc_softmax;
-    float sum;
-
-    memset(prior_cls_softmax, 0, 2 * NUM_CLASSES * NUM_PRIORS);
-
-    for (i = 0; i < NUM_PRIORS; ++i) {
-        sum          = 0.;
-        calc_softmax = 0;
-
-        for (ch = 1; ch < (NUM_CLASSES - 1); ++ch) {
-            if (prior_cls[i * NUM_CLASSES + ch] >= prior_cls[i * NUM_CLASSES]) {
-                calc_softmax = 1;
-                break;
-            }
-        }
-
-        if (calc_softmax == 0) {
-            continue;
-        }
-
-        for (ch = 0; ch < (NUM_CLASSES); ++ch) {
-            sum += exp(prior_cls[i * NUM_CLASSES + ch] / 128.);
-        }
-
-        for (ch = 0; ch < (NUM_CLASSES); ++ch) {
-            prior_cls_softmax[i * NUM_CLASSES + ch] =
-                (uint16_t)(65536. * exp(prior_cls[i * NUM_CLASSES + ch] / 128.) / sum);
-        }
-    }
-}
-
 static void get_prior_locs(void)
 {
     int8_t* loc_addr = (int8_t*)0x50403000;
+    int8_t* prior_locs = postproc_get_prior_locs();
 
     int ar_idx, scale_idx, rel_idx, prior_idx, prior_count;
 
@@ -960,6 +863,7 @@ static void get_prior_locs(void)
 static void get_prior_cls(void)
 {
     int8_t* cl_addr = (int8_t*)0x50803000;
+    int8_t* prior_cls = postproc_get_prior_cls();
 
     int ar_idx, cl_idx, scale_idx, rel_idx, prior_idx, prior_count;
 
@@ -984,231 +888,38 @@ static void get_prior_cls(void)
             }
         }
     }
-
-    softmax();
 }
 
 static void get_priors(void)
 {
     get_prior_locs();
     get_prior_cls();
-}
-
-static float calculate_IOU(float* box1, float* box2)
-{
-    float x_left   = MAX(box1[0], box2[0]);
-    float y_top    = MAX(box1[1], box2[1]);
-    float x_right  = MIN(box1[2], box2[2]);
-    float y_bottom = MIN(box1[3], box2[3]);
-    float intersection_area;
-
-    if (x_right < x_left || y_bottom < y_top) {
-        return 0.0;
-    }
-
-    intersection_area = (x_right - x_left) * (y_bottom - y_top);
 
-    float box1_area = (box1[2] - box1[0]) * (box1[3] - box1[1]);
-    float box2_area = (box2[2] - box2[0]) * (box2[3] - box2[1]);
+#ifdef DUMP_CNN_OUTPUT
+    // prior_locs then prior_cls, 32 bytes per line
+    uint8_t* locs = (uint8_t*)postproc_get_prior_locs();
+    uint8_t* cls = (uint8_t*)postproc_get_prior_cls();
 
-    float iou = (float)(intersection_area) / (float)(box1_area + box2_area - intersection_area);
-
-    return iou;
-}
-
-static void get_cxcy(float* cxcy, int prior_idx)
-{
-    int i, scale_idx, ar_idx, rel_idx, cx, cy;
-
-    get_indices(&ar_idx, &scale_idx, &rel_idx, prior_idx);
-
-    cy      = rel_idx / dims[scale_idx];
-    cx      = rel_idx % dims[scale_idx];
-    cxcy[0] = (float)((float)(cx + 0.5) / dims[scale_idx]);
-    cxcy[1] = (float)((float)(cy + 0.5) / dims[scale_idx]);
-    cxcy[2] = scales[scale_idx] * sqrt(ars[ar_idx]);
-    cxcy[3] = scales[scale_idx] / sqrt(ars[ar_idx]);
-
-    for (i = 0; i < 4; ++i) {
-        cxcy[i] = MAX(0.0, cxcy[i]);
-        cxcy[i] = MIN(cxcy[i], 1.0);
-    }
-}
-
-static void gcxgcy_to_cxcy(float* cxcy, int prior_idx, float* priors_cxcy)
-{
-    float gcxgcy[4];
-
-    for (int i = 0; i < 4; i++) {
-        gcxgcy[i] = (float)prior_locs[4 * prior_idx + i] / 128.0;
-    }
-
-    cxcy[0] = priors_cxcy[0] + gcxgcy[0] * priors_cxcy[2] / 10;
-    cxcy[1] = priors_cxcy[1] + gcxgcy[1] * priors_cxcy[3] / 10;
-    cxcy[2] = exp(gcxgcy[2] / 5) * priors_cxcy[2];
-    cxcy[3] = exp(gcxgcy[3] / 5) * priors_cxcy[3];
-}
-
-static void cxcy_to_xy(float* xy, float* cxcy)
-{
-    xy[0] = cxcy[0] - cxcy[2] / 2;
-    xy[1] = cxcy[1] - cxcy[3] / 2;
-    xy[2] = cxcy[0] + cxcy[2] / 2;
-    xy[3] = cxcy[1] + cxcy[3] / 2;
-}
-
-static void insert_val(uint16_t val, uint16_t* arr, int arr_len, int idx)
-{
-    if (arr_len < MAX_PRIORS) {
-        arr[arr_len] = arr[arr_len - 1];
-    }
-
-    for (int j = (arr_len - 1); j > idx; --j) {
-        arr[j] = arr[j - 1];
-    }
-
-    arr[idx] = val;
-}
-
-static void insert_idx(uint16_t val, uint16_t* arr, int arr_len, int idx)
-{
-    if (arr_len < MAX_PRIORS) {
-        arr[arr_len] = arr[arr_len - 1];
-    }
-
-    for (int j = (arr_len - 1); j > idx; --j) {
-        arr[j] = arr[j - 1];
-    }
-
-    arr[idx] = val;
-}
-
-static void insert_nms_prior(uint16_t val, int idx, uint16_t* val_arr, uint16_t* idx_arr, int* arr_len)
-{
-    if ((*arr_len == 0) || ((val <= val_arr[*arr_len - 1]) && (*arr_len != MAX_PRIORS))) {
-        val_arr[*arr_len] = val;
-        idx_arr[*arr_len] = idx;
-    } else {
-        for (int i = 0; i < *arr_len; ++i) {
-            if (val > val_arr[i]) {
-                insert_val(val, val_arr, *arr_len, i);
-                insert_idx(idx, idx_arr, *arr_len, i);
-                break;
-            }
-        }
-    }
-
-    *arr_len = MIN((*arr_len + 1), MAX_PRIORS);
-}
-
-static void reset_nms(void)
-{
-    for (int cl = 0; cl < NUM_CLASSES - 2; ++cl) {
-        num_nms_priors[cl] = 0;
-
-        for (int p_idx = 0; p_idx < MAX_PRIORS; ++p_idx) {
-            nms_scores[cl][p_idx]  = 0;
-            nms_indices[cl][p_idx] = 0;
-            //nms_removed[cl][p_idx] = 0;
-            nms_removed[cl*MAX_PRIORS + p_idx] = 0;
-        }
-    }
-}
-
-static void nms(void)
-{
-    int prior_idx, class_idx, nms_idx1, nms_idx2, prior1_idx, prior2_idx;
-    uint16_t cls_prob;
-    float prior_cxcy1[4];
-    float prior_cxcy2[4];
-    float cxcy1[4];
-    float cxcy2[4];
-    float xy1[4];
-    float xy2[4];
-
-    reset_nms();
-
-    for (prior_idx = 0; prior_idx < NUM_PRIORS; ++prior_idx) {
-        for (class_idx = 0; class_idx < (NUM_CLASSES - 2); ++class_idx) {
-            cls_prob = prior_cls_softmax[prior_idx * NUM_CLASSES + class_idx + 1];
-
-            if (cls_prob < MIN_CLASS_SCORE) {
-                continue;
-            }
-
-            insert_nms_prior(cls_prob, prior_idx, nms_scores[class_idx], nms_indices[class_idx], &num_nms_priors[class_idx]);
-        }
-    }
-
-    for (class_idx = 0; class_idx < (NUM_CLASSES - 2); ++class_idx) {
-        for (nms_idx1 = 0; nms_idx1 < num_nms_priors[class_idx]; ++nms_idx1) {
-            //if (nms_removed[class_idx][nms_idx1] != 1 &&
-            if (nms_removed[class_idx * num_nms_priors[class_idx] + nms_idx1] != 1 &&
-                nms_idx1 != num_nms_priors[class_idx] - 1) {
-                for (nms_idx2 = nms_idx1 + 1; nms_idx2 < num_nms_priors[class_idx]; ++nms_idx2) {
-                    prior1_idx = nms_indices[class_idx][nms_idx1];
-                    prior2_idx = nms_indices[class_idx][nms_idx2];
-
-                    // TODO: Let's implement the box loc finding before this nested loop for 100 priors
-                    get_cxcy(prior_cxcy1, prior1_idx);
-                    get_cxcy(prior_cxcy2, prior2_idx);
-
-                    gcxgcy_to_cxcy(cxcy1, prior1_idx, prior_cxcy1);
-                    gcxgcy_to_cxcy(cxcy2, prior2_idx, prior_cxcy2);
-
-                    cxcy_to_xy(xy1, cxcy1);
-                    cxcy_to_xy(xy2, cxcy2);
-
-                    float iou = calculate_IOU(xy1, xy2);
-
-                    if (iou > MAX_ALLOWED_OVERLAP) {
-                        //nms_removed[class_idx][nms_idx2] = 1;
-                        nms_removed[class_idx * num_nms_priors[class_idx] + nms_idx2] = 1;
-                    }
-                }
-            }
-        }
+    printf("cnn_output\r\n");
+    for (int i = 0; i < (LOC_DIM + NUM_CLASSES) * NUM_PRIORS; ++i) {
+        printf("%02x%s", (i < LOC_DIM * NUM_PRIORS) ? locs[i] : cls[i - LOC_DIM * NUM_PRIORS], ((i % 32) == 31) ? "\r\n" : "");
     }
+    printf("\r\n");
+#endif
 }
 
 static void localize_objects(void)
 {
-    float prior_cxcy[4];
-    float cxcy[4];
-    float xy[4];
-    int class_idx, prior_idx, global_prior_idx;
-    uint8_t obj_number = 0; 
-
-    nms();
-
-    for (class_idx = 0; class_idx < (NUM_CLASSES - 2); ++class_idx) {
-        for (prior_idx = 0; prior_idx < num_nms_priors[class_idx]; ++prior_idx) {
-            //if (nms_removed[class_idx][prior_idx] != 1) {
-            if (nms_removed[class_idx * num_nms_priors[class_idx] + prior_idx] != 1) {
-                global_prior_idx = nms_indices[class_idx][prior_idx];
-                get_cxcy(prior_cxcy, global_prior_idx);
-                gcxgcy_to_cxcy(cxcy, global_prior_idx, prior_cxcy);
-                cxcy_to_xy(xy, cxcy);
-
-                PR_INFO("class: %d, prior_idx: %d, prior: %d, x1: %.2f, y1: %.2f, x2: %.2f, y2: "
-                       "%.2f \n",
-                       class_idx + 1, prior_idx, global_prior_idx, xy[0], xy[1], xy[2], xy[3]);
-                
-                // Save objects box coordinates
-                objects[obj_number*ML_DATA_SIZE + 1] = class_idx;
-                objects[obj_number*ML_DATA_SIZE + 2] = (uint8_t)IMG_SCALE*X_SIZE*xy[0]; // x1
-                objects[obj_number*ML_DATA_SIZE + 3] = (uint8_t)IMG_SCALE*Y_SIZE*xy[1]; // y1
-                objects[obj_number*ML_DATA_SIZE + 4] = (uint8_t)IMG_SCALE*X_SIZE*xy[2]; // x2
-                objects[obj_number*ML_DATA_SIZE + 5] = (uint8_t)IMG_SCALE*Y_SIZE*xy[3]; // y2
-                obj_number++;
-            }
-        }
+    uint8_t* objects = postproc_localize_objects();
+    uint8_t* obj;
+
+    for (int i = 0; i < objects[0]; ++i) {
+        obj = &objects[i * ML_DATA_SIZE + 1];
+        PR_INFO("class: %d, x1: %d, y1: %d, x2: %d, y2: %d", obj[0] + 1, obj[1], obj[2], obj[3], obj[4]);
     }
 
-    if(obj_number) {    
-        // First element is number of detected objects
-        objects[0] = obj_number;
+    if (objects[0]) {
         // Send result to MAX32666
-        qspi_slave_send_packet(&objects[0], ML_DATA_SIZE*obj_number + 1, QSPI_PACKET_TYPE_VIDEO_ML_RES);
+        qspi_slave_send_packet(&objects[0], ML_DATA_SIZE*objects[0] + 1, QSPI_PACKET_TYPE_VIDEO_ML_RES);
     }
 }
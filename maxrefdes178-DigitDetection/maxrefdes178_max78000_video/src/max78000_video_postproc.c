@@ -0,0 +1,325 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2022 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <string.h>
+
+#include "max78000_video_postproc.h"
+#include "max78000_video_priors.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define MIN(x, y)   (((x) < (y)) ? (x) : (y))
+#define MAX(x, y)   (((x) > (y)) ? (x) : (y))
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+// Prior boxes and exp tables generated offline from dims, scales {0.15, 0.35, 0.55, 0.725} and ars {0.85, 0.60, 0.40, 0.25}
+static const uint16_t priors_cxcy[NUM_PRIORS][LOC_DIM] = PRIORS_CXCY_Q15;
+static const uint16_t softmax_exp_lut[256] = SOFTMAX_EXP_LUT_Q15;
+static const uint16_t loc_exp_lut[256] = LOC_EXP_LUT_Q15;
+//Arrays pointers to store model outputs
+static int8_t *prior_cls;  // int8_t prior_cls[NUM_CLASSES * NUM_PRIORS]; // 20400 bytes
+static uint16_t *prior_cls_softmax; // uint16_t prior_cls_softmax[NUM_CLASSES * NUM_PRIORS] // 40800 bytes
+static int8_t *prior_locs; // int8_t prior_locs[LOC_DIM * NUM_PRIORS]; (x, y, w, h) // 6800 bytes
+static uint8_t *objects; // store objects result
+//NMS related array pointer
+static uint8_t *nms_removed; // uint8_t nms_removed[NUM_CLASSES - 2][MAX_PRIORS]; // 1000 bytes
+static float *nms_boxes; // float nms_boxes[NUM_CLASSES - 2][MAX_PRIORS][LOC_DIM]; (x1, y1, x2, y2) // 16000 bytes
+static float *nms_areas; // float nms_areas[NUM_CLASSES - 2][MAX_PRIORS]; // 4000 bytes
+//NMS related arrays
+static int num_nms_priors[NUM_CLASSES - 2];    // 40 bytes
+static uint16_t nms_scores[NUM_CLASSES - 2][MAX_PRIORS]; // 2000 bytes
+static uint16_t nms_indices[NUM_CLASSES - 2][MAX_PRIORS]; // 2000 bytes
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+static void softmax(void);
+static void nms(void);
+static void decode_box(float* xy, int prior_idx);
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+void postproc_init(uint8_t *scratch)
+{
+    // Arrays are carved from the caller's scratch memory, e.g. the camera buffer
+    prior_cls_softmax = (uint16_t*)scratch;
+    nms_boxes = (float*)&prior_cls_softmax[NUM_CLASSES * NUM_PRIORS];
+    nms_areas = &nms_boxes[(NUM_CLASSES-2) * MAX_PRIORS * LOC_DIM];
+    nms_removed = (uint8_t*)&nms_areas[(NUM_CLASSES-2) * MAX_PRIORS];
+    prior_cls = (int8_t*)&nms_removed[(NUM_CLASSES-2) * MAX_PRIORS];
+    prior_locs = (int8_t*)&prior_cls[NUM_CLASSES * NUM_PRIORS];
+    objects = (uint8_t*)&prior_locs[LOC_DIM * NUM_PRIORS];
+}
+
+int8_t *postproc_get_prior_locs(void)
+{
+    return prior_locs;
+}
+
+int8_t *postproc_get_prior_cls(void)
+{
+    return prior_cls;
+}
+
+static void softmax(void)
+{
+    int i, ch, calc_softmax;
+    uint32_t sum;
+    uint16_t exps[NUM_CLASSES];
+    int8_t *cls;
+
+    memset(prior_cls_softmax, 0, 2 * NUM_CLASSES * NUM_PRIORS);
+
+    for (i = 0; i < NUM_PRIORS; ++i) {
+        cls          = &prior_cls[i * NUM_CLASSES];
+        calc_softmax = 0;
+
+        for (ch = 1; ch < (NUM_CLASSES - 1); ++ch) {
+            if (cls[ch] >= cls[0]) {
+                calc_softmax = 1;
+                break;
+            }
+        }
+
+        if (calc_softmax == 0) {
+            continue;
+        }
+
+        // exp(x / 128) from the Q15 table, the common e^-1 scale cancels out in the division
+        sum = 0;
+        for (ch = 0; ch < NUM_CLASSES; ++ch) {
+            exps[ch] = softmax_exp_lut[cls[ch] + 128];
+            sum += exps[ch];
+        }
+
+        for (ch = 0; ch < NUM_CLASSES; ++ch) {
+            prior_cls_softmax[i * NUM_CLASSES + ch] = (uint16_t)(((uint32_t) exps[ch] << 16) / sum);
+        }
+    }
+}
+
+static int is_overlapping(float* box1, float box1_area, float* box2, float box2_area)
+{
+    float x_left   = MAX(box1[0], box2[0]);
+    float y_top    = MAX(box1[1], box2[1]);
+    float x_right  = MIN(box1[2], box2[2]);
+    float y_bottom = MIN(box1[3], box2[3]);
+    float intersection_area;
+
+    if (x_right < x_left || y_bottom < y_top) {
+        return 0;
+    }
+
+    intersection_area = (x_right - x_left) * (y_bottom - y_top);
+
+    // iou > MAX_ALLOWED_OVERLAP without the division
+    return intersection_area > (MAX_ALLOWED_OVERLAP * (box1_area + box2_area - intersection_area));
+}
+
+static void decode_box(float* xy, int prior_idx)
+{
+    const uint16_t* prior = priors_cxcy[prior_idx];
+    const int8_t* loc = &prior_locs[LOC_DIM * prior_idx];
+    float cx, cy, w, h;
+
+    cx = (prior[0] + (loc[0] * prior[2]) / (128.0f * 10.0f)) / 32768.0f;
+    cy = (prior[1] + (loc[1] * prior[3]) / (128.0f * 10.0f)) / 32768.0f;
+    w  = ((float) loc_exp_lut[loc[2] + 128] * prior[2]) / (32768.0f * 32768.0f);
+    h  = ((float) loc_exp_lut[loc[3] + 128] * prior[3]) / (32768.0f * 32768.0f);
+
+    xy[0] = cx - w / 2;
+    xy[1] = cy - h / 2;
+    xy[2] = cx + w / 2;
+    xy[3] = cy + h / 2;
+}
+
+static void insert_val(uint16_t val, uint16_t* arr, int arr_len, int idx)
+{
+    if (arr_len < MAX_PRIORS) {
+        arr[arr_len] = arr[arr_len - 1];
+    }
+
+    for (int j = (arr_len - 1); j > idx; --j) {
+        arr[j] = arr[j - 1];
+    }
+
+    arr[idx] = val;
+}
+
+static void insert_idx(uint16_t val, uint16_t* arr, int arr_len, int idx)
+{
+    if (arr_len < MAX_PRIORS) {
+        arr[arr_len] = arr[arr_len - 1];
+    }
+
+    for (int j = (arr_len - 1); j > idx; --j) {
+        arr[j] = arr[j - 1];
+    }
+
+    arr[idx] = val;
+}
+
+static void insert_nms_prior(uint16_t val, int idx, uint16_t* val_arr, uint16_t* idx_arr, int* arr_len)
+{
+    if ((*arr_len == 0) || ((val <= val_arr[*arr_len - 1]) && (*arr_len != MAX_PRIORS))) {
+        val_arr[*arr_len] = val;
+        idx_arr[*arr_len] = idx;
+    } else {
+        for (int i = 0; i < *arr_len; ++i) {
+            if (val > val_arr[i]) {
+                insert_val(val, val_arr, *arr_len, i);
+                insert_idx(idx, idx_arr, *arr_len, i);
+                break;
+            }
+        }
+    }
+
+    *arr_len = MIN((*arr_len + 1), MAX_PRIORS);
+}
+
+static void reset_nms(void)
+{
+    for (int cl = 0; cl < NUM_CLASSES - 2; ++cl) {
+        num_nms_priors[cl] = 0;
+
+        for (int p_idx = 0; p_idx < MAX_PRIORS; ++p_idx) {
+            nms_scores[cl][p_idx]  = 0;
+            nms_indices[cl][p_idx] = 0;
+            //nms_removed[cl][p_idx] = 0;
+            nms_removed[cl*MAX_PRIORS + p_idx] = 0;
+        }
+    }
+}
+
+static void nms(void)
+{
+    int prior_idx, class_idx, nms_idx1, nms_idx2;
+    uint16_t cls_prob;
+    float* boxes;
+    float* areas;
+    uint8_t* removed;
+
+    reset_nms();
+
+    for (prior_idx = 0; prior_idx < NUM_PRIORS; ++prior_idx) {
+        for (class_idx = 0; class_idx < (NUM_CLASSES - 2); ++class_idx) {
+            cls_prob = prior_cls_softmax[prior_idx * NUM_CLASSES + class_idx + 1];
+
+            if (cls_prob < MIN_CLASS_SCORE) {
+                continue;
+            }
+
+            insert_nms_prior(cls_prob, prior_idx, nms_scores[class_idx], nms_indices[class_idx], &num_nms_priors[class_idx]);
+        }
+    }
+
+    for (class_idx = 0; class_idx < (NUM_CLASSES - 2); ++class_idx) {
+        boxes   = &nms_boxes[class_idx * MAX_PRIORS * LOC_DIM];
+        areas   = &nms_areas[class_idx * MAX_PRIORS];
+        removed = &nms_removed[class_idx * MAX_PRIORS];
+
+        // Decode each candidate once, lists are already sorted by descending score
+        for (nms_idx1 = 0; nms_idx1 < num_nms_priors[class_idx]; ++nms_idx1) {
+            float* box = &boxes[nms_idx1 * LOC_DIM];
+
+            decode_box(box, nms_indices[class_idx][nms_idx1]);
+            areas[nms_idx1] = (box[2] - box[0]) * (box[3] - box[1]);
+        }
+
+        for (nms_idx1 = 0; nms_idx1 < (num_nms_priors[class_idx] - 1); ++nms_idx1) {
+            if (removed[nms_idx1]) {
+                continue;
+            }
+
+            for (nms_idx2 = nms_idx1 + 1; nms_idx2 < num_nms_priors[class_idx]; ++nms_idx2) {
+                if (removed[nms_idx2]) {
+                    continue;
+                }
+
+                if (is_overlapping(&boxes[nms_idx1 * LOC_DIM], areas[nms_idx1], &boxes[nms_idx2 * LOC_DIM], areas[nms_idx2])) {
+                    removed[nms_idx2] = 1;
+                }
+            }
+        }
+    }
+}
+
+uint8_t *postproc_localize_objects(void)
+{
+    float* xy;
+    int class_idx, prior_idx;
+    uint8_t obj_number = 0;
+
+    softmax();
+    nms();
+
+    for (class_idx = 0; class_idx < (NUM_CLASSES - 2); ++class_idx) {
+        for (prior_idx = 0; prior_idx < num_nms_priors[class_idx]; ++prior_idx) {
+            if (nms_removed[class_idx * MAX_PRIORS + prior_idx] != 1) {
+                xy = &nms_boxes[(class_idx * MAX_PRIORS + prior_idx) * LOC_DIM];
+
+                // Save objects box coordinates
+                objects[obj_number*ML_DATA_SIZE + 1] = class_idx;
+                objects[obj_number*ML_DATA_SIZE + 2] = (uint8_t)IMG_SCALE*X_SIZE*xy[0]; // x1
+                objects[obj_number*ML_DATA_SIZE + 3] = (uint8_t)IMG_SCALE*Y_SIZE*xy[1]; // y1
+                objects[obj_number*ML_DATA_SIZE + 4] = (uint8_t)IMG_SCALE*X_SIZE*xy[2]; // x2
+                objects[obj_number*ML_DATA_SIZE + 5] = (uint8_t)IMG_SCALE*Y_SIZE*xy[3]; // y2
+                obj_number++;
+            }
+        }
+    }
+
+    // First element is number of detected objects
+    objects[0] = obj_number;
+
+    return objects;
+}
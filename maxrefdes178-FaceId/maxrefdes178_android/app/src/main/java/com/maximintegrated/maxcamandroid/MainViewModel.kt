@@ -64,6 +64,14 @@ class MainViewModel(private val app: Application) : AndroidViewModel(app) {
     private val _mtuResponse = MutableLiveData<ble_mtu_response>()
     val mtuResponse: LiveData<ble_mtu_response> = _mtuResponse
 
+    private val _deviceTiming = MutableLiveData<device_timing_t>()
+    val deviceTiming: LiveData<device_timing_t> = _deviceTiming
+
+    // Multi packet response being reassembled, null when no payload packet is expected
+    private var rxCommand: ble_command_e? = null
+    private var rxTotalPayloadSize = 0
+    private var rxPayload = byteArrayOf()
+
     private fun setMaxcamVersion(deviceVersion: device_version_t) {
         _maxcamVersion.value = deviceVersion
     }
@@ -104,65 +112,28 @@ class MainViewModel(private val app: Application) : AndroidViewModel(app) {
 
             val commandPacket = ble_command_packet_t.parse(data)
 
-            val blePacket: IBlePacket = commandPacket.header.command.parse(commandPacket.payload)
-
-            when (commandPacket.header.command) {
-                ble_command_e.BLE_COMMAND_GET_VERSION_RES -> {
-                    val packet: device_version_t = blePacket as device_version_t
-                    setMaxcamVersion(packet)
-                    Timber.d(
-                        "MAX32666 version %d.%d.%d".format(
-                            packet.max32666.major,
-                            packet.max32666.minor,
-                            packet.max32666.build
-                        )
-                    )
-                    Timber.d(
-                        "MAX7800 Video version %d.%d.%d".format(
-                            packet.max78000_video.major,
-                            packet.max78000_video.minor,
-                            packet.max78000_video.build
-                        )
-                    )
-                    Timber.d(
-                        "MAX7800 Audio version %d.%d.%d".format(
-                            packet.max78000_audio.major,
-                            packet.max78000_audio.minor,
-                            packet.max78000_audio.build
-                        )
-                    )
-
-                }
-                ble_command_e.BLE_COMMAND_MTU_CHANGE_RES -> {
-                    val packet: ble_mtu_response = blePacket as ble_mtu_response
-                    _mtuResponse.value = packet
-
-                }
-                ble_command_e.BLE_COMMAND_FACEID_EMBED_UPDATE_RES -> {
-                    val packet: faceid_embed_update_status_e =
-                        blePacket as faceid_embed_update_status_e
-                    val context = app.applicationContext
-
-                    Toast.makeText(
-                        context,
-                        if (packet == faceid_embed_update_status_e.FACEID_EMBED_UPDATE_STATUS_SUCCESS)
-                            R.string.signature_update_success
-                        else
-                            R.string.signature_update_fail,
-                        Toast.LENGTH_LONG
-                    ).show()
-                    setEmbeddingsSendInProgress(false)
-                    abortSendTimeout()
-
-                }
-                else -> {
-                }
+            if (commandPacket.payload.size < commandPacket.header.total_payload_size) {
+                // Rest of the payload follows in payload packets
+                rxCommand = commandPacket.header.command
+                rxTotalPayloadSize = commandPacket.header.total_payload_size
+                rxPayload = commandPacket.payload
+            } else {
+                rxCommand = null
+                onBleCommandReceived(commandPacket.header.command, commandPacket.payload)
             }
 
         } else //packet_info.type == ble_packet_type_e.BLE_PACKET_TYPE_PAYLOAD
         {
-
-
+            val command = rxCommand
+            if (command == null) {
+                Timber.e("payload packet is not expected")
+            } else {
+                rxPayload = rxPayload.concatenate(data.sliceArray(ble_payload_packet_header_t.size() until data.size))
+                if (rxPayload.size >= rxTotalPayloadSize) {
+                    rxCommand = null
+                    onBleCommandReceived(command, rxPayload)
+                }
+            }
         }
 
         payload = if (payload != null) {
@@ -171,4 +142,66 @@ class MainViewModel(private val app: Application) : AndroidViewModel(app) {
             data
         }
     }
+
+    @ExperimentalUnsignedTypes
+    private fun onBleCommandReceived(command: ble_command_e, payload: ByteArray) {
+
+        val blePacket: IBlePacket = command.parse(payload)
+
+        when (command) {
+            ble_command_e.BLE_COMMAND_GET_VERSION_RES -> {
+                val packet: device_version_t = blePacket as device_version_t
+                setMaxcamVersion(packet)
+                Timber.d(
+                    "MAX32666 version %d.%d.%d".format(
+                        packet.max32666.major,
+                        packet.max32666.minor,
+                        packet.max32666.build
+                    )
+                )
+                Timber.d(
+                    "MAX7800 Video version %d.%d.%d".format(
+                        packet.max78000_video.major,
+                        packet.max78000_video.minor,
+                        packet.max78000_video.build
+                    )
+                )
+                Timber.d(
+                    "MAX7800 Audio version %d.%d.%d".format(
+                        packet.max78000_audio.major,
+                        packet.max78000_audio.minor,
+                        packet.max78000_audio.build
+                    )
+                )
+
+            }
+            ble_command_e.BLE_COMMAND_MTU_CHANGE_RES -> {
+                val packet: ble_mtu_response = blePacket as ble_mtu_response
+                _mtuResponse.value = packet
+
+            }
+            ble_command_e.BLE_COMMAND_GET_TIMING_RES -> {
+                _deviceTiming.value = blePacket as device_timing_t
+            }
+            ble_command_e.BLE_COMMAND_FACEID_EMBED_UPDATE_RES -> {
+                val packet: faceid_embed_update_status_e =
+                    blePacket as faceid_embed_update_status_e
+                val context = app.applicationContext
+
+                Toast.makeText(
+                    context,
+                    if (packet == faceid_embed_update_status_e.FACEID_EMBED_UPDATE_STATUS_SUCCESS)
+                        R.string.signature_update_success
+                    else
+                        R.string.signature_update_fail,
+                    Toast.LENGTH_LONG
+                ).show()
+                setEmbeddingsSendInProgress(false)
+                abortSendTimeout()
+
+            }
+            else -> {
+            }
+        }
+    }
 }
@@ -240,11 +240,28 @@ enum class faceid_embed_update_status_e : IBlePacket {
     FACEID_EMBED_UPDATE_STATUS_LAST
 }
 
+data class stage_timing_t(
+    var p50_us: Int,
+    var p90_us: Int,
+    var p99_us: Int,
+    var max_us: Int
+)
+
+data class time_sync_status_t(
+    var offset_us: Int,
+    var drift_ppb: Int,
+    var rtt_us: Int
+)
+
 data class max78000_statistics_t(
     var cnn_duration_us: Int,
     var capture_duration_us: Int,
     var communication_duration_us: Int,
-    var total_duration_us: Int
+    var total_duration_us: Int,
+    var latency_us: Int,
+    var cpu_duty_permille: Int,
+    var cnn_duty_permille: Int,
+    var stream_overflow_count: Int
 )
 
 data class device_statistics_t(
@@ -256,6 +273,15 @@ data class device_statistics_t(
     var max78000_audio_power_uw: Int
 ) : IBlePacket
 
+data class device_timing_t(
+    var max78000_video: List<stage_timing_t>, // capture, preprocess, cnn, unload, postprocess, communication
+    var max78000_audio: List<stage_timing_t>,
+    var max32666: List<stage_timing_t>,
+    var max78000_video_time_sync: time_sync_status_t,
+    var max78000_audio_time_sync: time_sync_status_t,
+    var latency: List<stage_timing_t> // video frame, video classification, audio classification
+) : IBlePacket
+
 data class ble_mtu_response(var mtu: Int) : IBlePacket {
     override fun size(): Int {
         return Int.SIZE_BYTES
@@ -304,7 +330,7 @@ enum class ble_command_e {
     //  Command                             Command Payload Description
     // Communication
     BLE_COMMAND_ABORT_CMD,           // None
-    BLE_COMMAND_INVALID_RES,             // None
+    BLE_COMMAND_INVALID_RES,             // uint8_t rejected command
     BLE_COMMAND_NOP_CMD,                 // None
     BLE_COMMAND_MTU_CHANGE_RES {
         override fun parse(arr: ByteArray): ble_mtu_response {
@@ -442,18 +468,14 @@ enum class ble_command_e {
 
     // Statistics
     BLE_COMMAND_GET_STATISTICS_RES {
-        private fun parseStatistics(arr: ByteArray): max78000_statistics_t {
-            val buffer = ByteBuffer.wrap(arr).apply { order(ByteOrder.LITTLE_ENDIAN) }
-            return max78000_statistics_t(buffer.int, buffer.int, buffer.int, buffer.int)
+        private fun parseStatistics(buffer: ByteBuffer): max78000_statistics_t {
+            return max78000_statistics_t(buffer.int, buffer.int, buffer.int, buffer.int, buffer.int, buffer.int, buffer.int, buffer.int)
         }
 
         override fun parse(arr: ByteArray): device_statistics_t {
-
-            var tempArr: ByteArray = arr
-            val video = parseStatistics(arr.sliceArray(0 until 16))
-            val audio = parseStatistics(arr.sliceArray(16 until 32))
-            tempArr = arr.sliceArray(32 until arr.size)
-            val buffer = ByteBuffer.wrap(tempArr).apply { ByteOrder.LITTLE_ENDIAN }
+            val buffer = ByteBuffer.wrap(arr).apply { order(ByteOrder.LITTLE_ENDIAN) }
+            val video = parseStatistics(buffer)
+            val audio = parseStatistics(buffer)
 
             return device_statistics_t(
                 video,
@@ -482,6 +504,36 @@ enum class ble_command_e {
     BLE_COMMAND_ENABLE_MAX78000_VIDEO_VFLIP_CMD,    // None
     BLE_COMMAND_DISABLE_MAX78000_VIDEO_VFLIP_CMD,   // None
 
+    BLE_COMMAND_GET_DEMO_NAME_CMD,         // None
+    BLE_COMMAND_GET_DEMO_NAME_RES,         // Demo string
+
+    // Timing, multi packet response
+    BLE_COMMAND_GET_TIMING_CMD,            // None
+    BLE_COMMAND_GET_TIMING_RES {
+        private fun parseStageTiming(buffer: ByteBuffer, count: Int = BleDefinitions.TIMING_STAGE_LAST): List<stage_timing_t> {
+            return List(count) {
+                stage_timing_t(buffer.int, buffer.int, buffer.int, buffer.int)
+            }
+        }
+
+        private fun parseTimeSync(buffer: ByteBuffer): time_sync_status_t {
+            return time_sync_status_t(buffer.int, buffer.int, buffer.int)
+        }
+
+        override fun parse(arr: ByteArray): device_timing_t {
+            val buffer = ByteBuffer.wrap(arr).apply { order(ByteOrder.LITTLE_ENDIAN) }
+
+            return device_timing_t(
+                parseStageTiming(buffer),
+                parseStageTiming(buffer),
+                parseStageTiming(buffer),
+                parseTimeSync(buffer),
+                parseTimeSync(buffer),
+                parseStageTiming(buffer, BleDefinitions.LATENCY_LAST)
+            )
+        }
+    },            // device_timing_t
+
     BLE_COMMAND_LAST;
 
     open fun parse(arr: ByteArray): IBlePacket {
@@ -500,5 +552,7 @@ class BleDefinitions {
         const val BLE_MAX_MTU_SIZE = 256
         const val BLE_MAX_MTU_REQUEST_SIZE = BLE_MAX_MTU_SIZE - 4
         const val BLE_MAX_PACKET_SIZE = BLE_MAX_MTU_REQUEST_SIZE - 3
+        const val TIMING_STAGE_LAST = 6
+        const val LATENCY_LAST = 3
     }
 }
\ No newline at end of file
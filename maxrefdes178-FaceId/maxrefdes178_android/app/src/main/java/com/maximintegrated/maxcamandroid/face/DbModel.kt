@@ -48,7 +48,7 @@ data class DbModel(
     var dbFolder: File
 ) {
     companion object {
-        const val PERSON_LIMIT = 6
+        const val PERSON_LIMIT = 16
     }
 
 
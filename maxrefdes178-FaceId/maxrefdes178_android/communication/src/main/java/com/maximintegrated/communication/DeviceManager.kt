@@ -113,7 +113,7 @@ class DeviceManager(context: Context) : BleManager<DeviceManagerCallbacks>(conte
 
         override fun initialize() {
             super.initialize()
-            enableCharacteristicIndications()
+            enableCharacteristicNotifications()
         }
 
     }
@@ -135,11 +135,11 @@ class DeviceManager(context: Context) : BleManager<DeviceManagerCallbacks>(conte
         }
     }
 
-    fun enableCharacteristicIndications() {
+    fun enableCharacteristicNotifications() {
         if (isConnected) {
-            setIndicationCallback(writeCharacteristic)
+            setNotificationCallback(writeCharacteristic)
                 .with(dataReceivedCallback)
-            enableIndications(writeCharacteristic)
+            enableNotifications(writeCharacteristic)
                 .done { device ->
                     Timber.i(
                         "Enabled notifications (Device: %s)",
@@ -55,7 +55,6 @@
 //-----------------------------------------------------------------------------
 // Function declarations
 //-----------------------------------------------------------------------------
-int ble_send_indication(uint16_t dataLen, uint8_t *data);
 int ble_init(void);
 int ble_worker(void);
 
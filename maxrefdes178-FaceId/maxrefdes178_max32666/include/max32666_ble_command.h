@@ -57,6 +57,7 @@
 // Function declarations
 //-----------------------------------------------------------------------------
 int ble_command_send_single_packet(ble_command_e ble_command, uint32_t payload_size, uint8_t *payload);
+int ble_command_send_multi_packet(ble_command_e ble_command, uint32_t payload_size, uint8_t *payload);
 
 int ble_command_reset(void);
 
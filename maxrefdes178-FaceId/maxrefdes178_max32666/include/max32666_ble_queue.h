@@ -57,18 +57,30 @@
 // Function declarations
 //-----------------------------------------------------------------------------
 int ble_queue_init(void);
+
+// Should be called from core0
 int ble_queue_flush(void);
 
 // Should be called from core0
 int ble_queue_deq_rx(ble_packet_container_t *ble_packet_container);
+ble_packet_container_t *ble_queue_peek_rx(void);
+int ble_queue_release_rx(void);
 
 // Should be called from core1
 int ble_queue_enq_rx(ble_packet_container_t *ble_packet_container);
+ble_packet_container_t *ble_queue_reserve_rx(void);
+int ble_queue_commit_rx(void);
 
-// Should be called from core0
+// Should be called from core1
 int ble_queue_deq_tx(ble_packet_container_t *ble_packet_container);
+ble_packet_container_t *ble_queue_peek_tx(void);
+// Packets after the oldest are sent before it is released, NULL past the newest or on a flush
+ble_packet_container_t *ble_queue_peek_tx_at(uint32_t index);
+int ble_queue_release_tx(void);
 
-// Should be called from core1
+// Should be called from core0
 int ble_queue_enq_tx(ble_packet_container_t *ble_packet_container);
+ble_packet_container_t *ble_queue_reserve_tx(void);
+int ble_queue_commit_tx(void);
 
 #endif /* _MAX32666_BLE_QUEUE_H_ */
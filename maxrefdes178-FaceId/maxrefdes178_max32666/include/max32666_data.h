@@ -92,9 +92,11 @@ typedef struct {
 
 typedef struct {
     device_statistics_t statistics;
+    device_timing_t timing;
     classification_result_t classification_video;
     classification_result_t classification_audio;
     classification_result_t classification_audio_last;
+    uint32_t video_frame_timestamp_us;  // MAX78000 video clock, capture time of the last frame
     uint8_t faceid_embed_update_status;
     char faceid_embed_subject_names[FACEID_MAX_SUBJECT * (FACEID_MAX_SUBJECT_NAME_SIZE + 1)];
     uint16_t faceid_embed_subject_names_size;
@@ -112,10 +114,11 @@ typedef struct {
     volatile uint16_t ble_max_packet_size; // written by core1
     volatile uint8_t ble_expected_rx_seq;  // written by core1
     volatile uint8_t ble_next_tx_seq;  // written by core1
+    volatile uint32_t ble_tx_completed;  // written by core1
 } device_status_t;
 
 typedef struct {
-    uint8_t buffer[LCD_DATA_SIZE];
+    uint8_t *buffer;  // framebuffer on screen, owned by max32666_framebuffer
     char notification[LCD_NOTIFICATION_MAX_SIZE];
     uint16_t notification_color;
     volatile uint8_t refresh_screen;
@@ -131,6 +134,9 @@ typedef struct {
     uint32_t pmic_check;
     uint32_t led;
     uint32_t powmon;
+    uint32_t qspi_link_statistics;
+    uint32_t time_sync;
+    uint32_t latency_statistics;
     uint32_t activity_detected;
 } timestamps_t;
 
@@ -41,6 +41,8 @@
 //-----------------------------------------------------------------------------
 #include <stdint.h>
 
+#include "maxrefdes178_definitions.h"
+
 
 //-----------------------------------------------------------------------------
 // Defines
@@ -69,6 +71,15 @@
 #define LBBLUE 0X2B12
 #define ADIBLUE 0X001F
 
+// Damaged framebuffer rows are tracked in bands, one bit per band
+#define FONTS_DAMAGE_BAND_HEIGHT 8
+#define FONTS_DAMAGE_BAND_COUNT  (LCD_HEIGHT / FONTS_DAMAGE_BAND_HEIGHT)
+#define FONTS_DAMAGE_ALL         UINT32_C(0xFFFFFFFF)
+
+// Captured overlay runs, runs past the list are dropped
+#define FONTS_MAX_RUNS           2048
+#define FONTS_RUN_NONE           UINT16_C(0xFFFF)
+
 
 //-----------------------------------------------------------------------------
 // Typedefs
@@ -79,6 +90,33 @@ typedef struct {
     const uint16_t *data;
 } FontDef;
 
+typedef struct {
+    uint16_t x1;
+    uint16_t y1;
+    uint16_t x2;
+    uint16_t y2;
+    uint16_t color;
+} fonts_box_t;
+
+// Pixels a primitive would have written, split at damage band boundaries
+typedef struct {
+    uint8_t x;
+    uint8_t y;
+    uint8_t len;      // pixels in each row
+    uint8_t height;   // rows
+    uint16_t color;   // framebuffer byte order
+    uint16_t next;    // next run of the same band, FONTS_RUN_NONE at the end
+} fonts_run_t;
+
+// Drawing captured instead of written, replayed later one band at a time in draw order
+typedef struct {
+    fonts_run_t run[FONTS_MAX_RUNS];
+    uint16_t count;
+    uint16_t head[FONTS_DAMAGE_BAND_COUNT];
+    uint16_t tail[FONTS_DAMAGE_BAND_COUNT];
+    uint32_t damage;  // bands with runs
+} fonts_runs_t;
+
 
 //-----------------------------------------------------------------------------
 // Global variables
@@ -96,6 +134,14 @@ void fonts_putStringCentered(uint16_t y, const char *str, const FontDef *font, u
 void fonts_drawRectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color, uint8_t *buff);
 void fonts_drawThickRectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color, uint8_t thickness, uint8_t *buff);
 void fonts_drawFilledRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color, uint8_t *buff);
+void fonts_drawBoxes(const fonts_box_t *boxes, uint16_t count, uint8_t thickness, uint8_t *buff);
 void fonts_drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color, uint8_t *buff);
+void fonts_markDamage(uint16_t y1, uint16_t y2);
+uint32_t fonts_getDamage(void);
+// Primitives append runs to the list until fonts_captureEnd, buff is not accessed meanwhile
+void fonts_captureBegin(fonts_runs_t *runs);
+void fonts_captureEnd(void);
+// Draw the runs of one band, buff points to the first row of the band
+void fonts_drawRuns(const fonts_runs_t *runs, uint16_t band, uint8_t *buff);
 
 #endif /* _MAX32666_FONT_H_ */
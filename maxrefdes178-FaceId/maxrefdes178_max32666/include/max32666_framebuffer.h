@@ -0,0 +1,82 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _MAX32666_FRAMEBUFFER_H_
+#define _MAX32666_FRAMEBUFFER_H_
+
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+// 2: one frame on screen while the next is received
+// 3: a received frame can also wait for composition while another is received
+#define FRAMEBUFFER_COUNT   2
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+// Owner of each framebuffer, ownership moves FREE -> RECEIVE -> READY -> COMPOSE -> DISPLAY -> FREE
+typedef enum {
+    FRAMEBUFFER_STATE_FREE = 0,
+    FRAMEBUFFER_STATE_RECEIVE,  // QSPI payload DMA writes it
+    FRAMEBUFFER_STATE_READY,    // complete frame waiting for composition
+    FRAMEBUFFER_STATE_COMPOSE,  // overlays are drawn into it
+    FRAMEBUFFER_STATE_DISPLAY,  // on screen, LCD DMA may be reading it
+} framebuffer_state_e;
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+int framebuffer_init(void);
+
+// QSPI receive path, acquire is called from DMA interrupt
+uint8_t *framebuffer_receive_acquire(void);
+void framebuffer_receive_done(uint8_t *buffer, uint32_t capture_time);
+
+// Overlay compositor, main loop context
+uint8_t *framebuffer_compose_acquire(uint32_t *capture_time);
+void framebuffer_display(uint8_t *buffer);
+
+uint32_t framebuffer_dropped_frames(void);
+
+#endif /* _MAX32666_FRAMEBUFFER_H_ */
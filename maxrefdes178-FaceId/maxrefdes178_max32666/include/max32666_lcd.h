@@ -61,8 +61,20 @@
 //-----------------------------------------------------------------------------
 int lcd_init(void);
 int lcd_drawImage(uint8_t *data);
+int lcd_drawRegion(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data);
+int lcd_drawDamage(uint32_t damage, uint8_t *data);
 int lcd_backlight(int on, uint8_t level);
 int lcd_set_rotation(lcd_rotation_e lcd_rotation);
 int lcd_notification(uint16_t color, const char *notification);
 
+// Frame streamed band by band, e.g. straight from QSPI. Arm and disarm from the main loop,
+// the rest from interrupt context. Drawing functions return E_BUSY while a frame is streamed
+int lcd_streamArm(void);
+int lcd_streamDisarm(void);
+int lcd_streamBegin(void);
+int lcd_streamBand(uint8_t *data, uint32_t len, void (*callback)(void));
+void lcd_streamEnd(void);
+// Wait until the streamed frame is sent
+int lcd_streamWait(void);
+
 #endif /* _MAX32666_LCD_H_ */
@@ -0,0 +1,80 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _MAX32666_PASSTHROUGH_H_
+#define _MAX32666_PASSTHROUGH_H_
+
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+
+#include "max32666_fonts.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+// Stream received video frames to the LCD band by band instead of through a framebuffer.
+// Overlays are captured as runs and drawn into each band before it is sent
+//#define LCD_PASSTHROUGH
+
+#define PASSTHROUGH_BAND_SIZE   (LCD_WIDTH * FONTS_DAMAGE_BAND_HEIGHT * LCD_BYTE_PER_PIXEL)
+#define PASSTHROUGH_SLOT_COUNT  2
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+int passthrough_init(void);
+
+// Main loop, keeps the LCD armed for the next frame while video is shown
+void passthrough_worker(void);
+
+// A frame was streamed recently, overlays go to passthrough_overlay_begin/end instead of a canvas
+int passthrough_streaming(void);
+// Overlay drawn between begin and end is shown from the next streamed frame
+int passthrough_overlay_begin(void);
+void passthrough_overlay_end(void);
+
+// Capture time of a streamed frame completed since the last call
+int passthrough_frame_shown(uint32_t *capture_time);
+
+// QSPI video payload consumer, called from interrupt context
+int passthrough_stream_start(uint32_t packet_size);
+void passthrough_stream_chunk(uint8_t *chunk, uint32_t len);
+
+#endif /* _MAX32666_PASSTHROUGH_H_ */
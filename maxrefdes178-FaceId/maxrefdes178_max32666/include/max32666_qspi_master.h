@@ -56,12 +56,23 @@
 //-----------------------------------------------------------------------------
 int qspi_master_init(void);
 int qspi_master_video_tx_worker(void);
+// RX workers return E_NONE_AVAIL until a packet completed in the background
 int qspi_master_video_rx_worker(qspi_packet_type_e *qspi_packet_type_rx);
 int qspi_master_audio_tx_worker(void);
 int qspi_master_audio_rx_worker(qspi_packet_type_e *qspi_packet_type_rx);
+// Blocking receive of the next packet, for use before the main loop
+int qspi_master_video_rx_wait(qspi_packet_type_e *qspi_packet_type_rx);
+int qspi_master_audio_rx_wait(qspi_packet_type_e *qspi_packet_type_rx);
+// An RX transfer is in flight
+int qspi_master_busy(void);
 int qspi_master_send_video(uint8_t *data, uint32_t data_size, uint8_t data_type);
 int qspi_master_send_audio(uint8_t *data, uint32_t data_size, uint8_t data_type);
+// timer_get_us() when the header DMA of the last sent packet started
+uint32_t qspi_master_tx_time(void);
 int qspi_master_wait_video_int(void);
 int qspi_master_wait_audio_int(void);
+// Read the next chunk of a streamed payload, called by its consumer from interrupt context
+int qspi_master_stream_read(uint8_t *buffer, uint32_t len);
+void qspi_master_link_statistics_worker(void);
 
 #endif /* _MAX32666_QSPI_MASTER_H_ */
@@ -0,0 +1,101 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _MAX32666_RENDER_H_
+#define _MAX32666_RENDER_H_
+
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+
+#include "max32666_fonts.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+// Compose overlays and drive the LCD from core1, core0 only queues draw commands.
+// Otherwise commands are executed right away on core0
+//#define RENDER_ON_CORE1
+
+#define RENDER_QUEUE_SIZE   48
+#define RENDER_MAX_BOXES    4
+
+// Commands executed per render_worker call, core1 returns to BLE in between
+#define RENDER_WORKER_BATCH 4
+
+// Frame durations measured on core1 waiting for core0, the stage histograms are not shared between cores
+#define RENDER_TIMING_QUEUE_SIZE 8
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+// Core0, hands the LCD and framebuffers to the renderer after the init screens
+int render_init(void);
+
+// Core1 loop, executes queued commands
+void render_worker(void);
+
+// Core0, renderer is idle and the LCD DMA is done, the next frame can be queued
+int render_ready(void);
+// Core0, wait render_ready before touching framebuffers, fonts or the LCD directly
+void render_sync(void);
+// Core0, around every QSPI transmit. LCD dma disrupts QSPI write, hold waits for the one in flight
+// and keeps the renderer from starting another until release
+void render_lcd_hold(void);
+void render_lcd_release(void);
+
+// Core0, draw commands of one frame, between render_begin and render_present.
+// Strings are copied, buff is the framebuffer drawn into
+void render_begin(void);
+void render_putString(uint16_t x, uint16_t y, const char *str, const FontDef *font, uint16_t color, uint8_t *buff);
+void render_putStringCentered(uint16_t y, const char *str, const FontDef *font, uint16_t color, uint8_t *buff);
+void render_drawBoxes(const fonts_box_t *boxes, uint16_t count, uint8_t thickness, uint8_t *buff);
+void render_drawThickRectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color, uint8_t thickness, uint8_t *buff);
+void render_drawFilledRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color, uint8_t *buff);
+// Sends canvas whole or only its damaged bands, frame is the received framebuffer it holds if any
+void render_present(uint8_t *canvas, uint8_t *frame, uint32_t frame_capture_time, uint8_t full);
+
+// Core0, capture time of a video frame whose LCD DMA completed since the last call
+int render_frame_shown(uint32_t *capture_time);
+// Core0 after render_sync, bands drawn over since the last call
+uint32_t render_take_overlay_damage(void);
+// Core0, adds frame durations measured by the renderer to the TIMING_STAGE_POSTPROCESS histogram
+void render_timing_worker(void);
+
+#endif /* _MAX32666_RENDER_H_ */
@@ -0,0 +1,82 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _MAX32666_TIME_SYNC_H_
+#define _MAX32666_TIME_SYNC_H_
+
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "maxrefdes178_definitions.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+typedef enum {
+    TIME_SYNC_DEVICE_VIDEO = 0,
+    TIME_SYNC_DEVICE_AUDIO,
+    TIME_SYNC_DEVICE_LAST
+} time_sync_device_e;
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+int time_sync_init(void);
+
+// Send sync commands to both MAX78000s, call every MAX32666_TIME_SYNC_INTERVAL.
+// E_BUSY while an RX transfer is in flight, or the send error, then call again on the next loop
+int time_sync_worker(void);
+
+// Sync response received at host_rx_us, pairs with the last command sent to the device
+void time_sync_response(time_sync_device_e device, const time_sync_t *time_sync, uint32_t host_rx_us);
+
+// Convert MAX78000 timestamp to MAX32666 timer_get_us() clock, E_BAD_STATE if not synced yet
+int time_sync_to_host(time_sync_device_e device, uint32_t device_us, uint32_t *host_us);
+
+// Record latency from a MAX78000 timestamp to now, dropped if device is not synced
+void time_sync_record_latency(latency_e latency, time_sync_device_e device, uint32_t device_us);
+
+// Latency percentiles and clock estimates into device timing, max is reset after read
+void time_sync_get_timing(device_timing_t *timing);
+
+#endif /* _MAX32666_TIME_SYNC_H_ */
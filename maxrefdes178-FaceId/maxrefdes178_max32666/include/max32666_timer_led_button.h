@@ -62,6 +62,7 @@ extern volatile uint32_t timer_ms_tick;
 // Function declarations
 //-----------------------------------------------------------------------------
 int timer_led_button_init(void);
+uint32_t timer_get_us(void);
 int led_worker(void);
 int button_worker(void);
 void button_y_int_handler(int state);
@@ -87,6 +87,7 @@
 #include "max32666_ble_queue.h"
 #include "max32666_data.h"
 #include "max32666_debug.h"
+#include "max32666_render.h"
 #include "maxrefdes178_definitions.h"
 
 
@@ -186,8 +187,7 @@ static const attsCccSet_t periphCccSet[PERIPH_NUM_CCC_IDX] =
 {
     /* cccd handle          value range               security level */
     {GATT_SC_CH_CCC_HDL,    ATT_CLIENT_CFG_INDICATE,  DM_SEC_LEVEL_NONE},   /* PERIPH_GATT_SC_CCC_IDX */
-//ty  {WP_DAT_CH_CCC_HDL,     ATT_CLIENT_CFG_NOTIFY,    DM_SEC_LEVEL_NONE}    /* DATS_WP_DAT_CCC_IDX */
-    {WP_DAT_CH_CCC_HDL,     ATT_CLIENT_CFG_INDICATE,    DM_SEC_LEVEL_NONE}    /* DATS_WP_DAT_CCC_IDX */
+    {WP_DAT_CH_CCC_HDL,     ATT_CLIENT_CFG_NOTIFY,    DM_SEC_LEVEL_NONE}    /* DATS_WP_DAT_CCC_IDX */
 };
 
 /*! application control block */
@@ -196,10 +196,19 @@ static struct
     wsfHandlerId_t    handlerId;          /* WSF handler ID */
     dmConnId_t        connId;             /* Connection ID */
     bool_t            connected;          /* Connection state */
-    uint8_t           indicationStatus;   /* Connection state */
     uint16_t          connectionHandle;   /* Connection handle */
 } periphCb;
 
+/*! notifications given to the stack, each one is confirmed by ATTS_HANDLE_VALUE_CNF in order */
+static uint8_t ble_tx_unconfirmed;      // sent from the tx queue, slots are held until confirmed
+static uint8_t ble_tx_stale;            // sent before a tx queue flush, confirmations are ignored
+static uint8_t ble_tx_next;             // tx queue packets after the oldest already sent
+static uint8_t ble_tx_failed;           // a notification was refused, send again from the oldest
+static uint8_t ble_tx_tries;
+static uint8_t ble_mtu_change_response_pending;
+static uint8_t ble_mtu_change_response_sent;  // next confirmation is for the MTU change response
+static ble_packet_container_t ble_mtu_change_response_container;
+
 
 //-----------------------------------------------------------------------------
 // Local Function declarations
@@ -217,7 +226,12 @@ static void PeriphStart(void);
 static void StackInitPeriph(void);
 static void mainWsfInit(void);
 static void ble_receive(uint16_t dataLen, uint8_t *data);
-static void ble_send_mtu_change_response(void);
+static void ble_prepare_mtu_change_response(void);
+static int ble_start_notification(uint16_t dataLen, uint8_t *data);
+static void ble_tx_release(void);
+static void ble_tx_confirmed(uint8_t status);
+static void ble_tx_reset(void);
+static void ble_tx_worker(void);
 
 
 //-----------------------------------------------------------------------------
@@ -251,13 +265,14 @@ static void periphAttCback(attEvt_t *pEvt)
         PR_DEBUG("ATTS_HANDLE_VALUE_CNF");
 
         if (pEvt->handle == WP_DAT_HDL) {
-            periphCb.indicationStatus = pEvt->hdr.status;
+            ble_tx_confirmed(pEvt->hdr.status);
         }
 
         if (pEvt->hdr.status == ATT_SUCCESS) {
             PR_DEBUG("Handle %d confirmation success", pEvt->handle);
         } else if (pEvt->hdr.status == ATT_ERR_OVERFLOW) {
-            PR_ERROR("Handle %d confirmation overflow", pEvt->handle);
+            // Stack is still sending the previous notification, ble_tx_worker sends it again
+            PR_DEBUG("Handle %d confirmation overflow", pEvt->handle);
         } else {
             PR_ERROR("Handle %d confirmation fail 0x%02hhX", pEvt->handle, pEvt->hdr.status);
         }
@@ -374,6 +389,9 @@ static void periphProcMsg(dmEvt_t *pMsg)
         device_status.ble_next_tx_seq = 0;
         memset((uint8_t *)device_status.ble_connected_peer_mac, 0x00, sizeof(device_status.ble_connected_peer_mac));
 
+        // Confirmations of the notifications in flight will not arrive, core0 flushes the tx queue
+        ble_tx_reset();
+
         PR_INFO("disconnected 0x%02hhX 0x%02hhX", pMsg->connClose.status, pMsg->connClose.reason);
         switch (pMsg->connClose.reason)
         {
@@ -391,7 +409,7 @@ static void periphProcMsg(dmEvt_t *pMsg)
          PR_INFO("MTU changed %d tx %d rx %d", AttGetMtu(periphCb.connId),
                  pMsg->dataLenChange.maxTxOctets, pMsg->dataLenChange.maxRxOctets);
          device_status.ble_max_packet_size = AttGetMtu(periphCb.connId) - 3;
-         ble_send_mtu_change_response();
+         ble_mtu_change_response_pending = 1;
          uiEvent = DM_CONN_DATA_LEN_CHANGE_IND;
          break;
 
@@ -610,24 +628,23 @@ static void mainWsfInit(void)
     PeriphStart();
 }
 
-static void ble_send_mtu_change_response(void)
+static void ble_prepare_mtu_change_response(void)
 {
-    ble_command_packet_t command_packet;
+    ble_command_packet_t *command_packet = &ble_mtu_change_response_container.packet.command_packet;
 
-    command_packet.header.packet_info.type = BLE_PACKET_TYPE_COMMAND;
-    command_packet.header.packet_info.seq = device_status.ble_next_tx_seq;
-    command_packet.header.command = BLE_COMMAND_MTU_CHANGE_RES;
-    command_packet.header.total_payload_size = 2;
-    command_packet.payload[0] = AttGetMtu(periphCb.connId) & 0xff;
-    command_packet.payload[1] = (AttGetMtu(periphCb.connId) >> 8) & 0xff;
+    command_packet->header.packet_info.type = BLE_PACKET_TYPE_COMMAND;
+    command_packet->header.command = BLE_COMMAND_MTU_CHANGE_RES;
+    command_packet->header.total_payload_size = 2;
+    command_packet->payload[0] = AttGetMtu(periphCb.connId) & 0xff;
+    command_packet->payload[1] = (AttGetMtu(periphCb.connId) >> 8) & 0xff;
 
-    ble_send_indication(sizeof(ble_command_packet_header_t) + command_packet.header.total_payload_size, (uint8_t *)&command_packet);
+    ble_mtu_change_response_container.size = sizeof(ble_command_packet_header_t) + command_packet->header.total_payload_size;
 }
 
 
 static void ble_receive(uint16_t dataLen, uint8_t *data)
 {
-    ble_packet_container_t ble_packet_container;
+    ble_packet_container_t *ble_packet_container;
 
 //    PR_INFO("BLE RX %d", dataLen);
 //    for (int i = 0; i < dataLen; i++) {
@@ -635,21 +652,27 @@ static void ble_receive(uint16_t dataLen, uint8_t *data)
 //    }
 //    PR("\n");
 
-    if ((dataLen > sizeof(ble_packet_container.packet)) ||
-        (dataLen < sizeof(ble_packet_container.packet.packet_info))) {
+    if ((dataLen > sizeof(ble_packet_container->packet)) ||
+        (dataLen < sizeof(ble_packet_container->packet.packet_info))) {
         PR_ERROR("invalid packet size %u", dataLen);
         return;
     }
 
-    ble_packet_container.size = dataLen;
-    memcpy(&(ble_packet_container.packet), data, dataLen);
-    ble_queue_enq_rx(&ble_packet_container);
+    ble_packet_container = ble_queue_reserve_rx();
+    if (ble_packet_container == NULL) {
+        PR_ERROR("ble rx queue is full");
+        return;
+    }
+
+    ble_packet_container->size = dataLen;
+    memcpy(&(ble_packet_container->packet), data, dataLen);
+    ble_queue_commit_rx();
 
     device_status.ble_expected_rx_seq += 1;
     device_status.ble_expected_rx_seq %= BLE_PACKET_SEQ_MASK;
 }
 
-int ble_send_indication(uint16_t dataLen, uint8_t *data)
+static int ble_start_notification(uint16_t dataLen, uint8_t *data)
 {
     if (!periphCb.connected) {
       PR_ERROR("No connection");
@@ -657,41 +680,166 @@ int ble_send_indication(uint16_t dataLen, uint8_t *data)
     }
 
     if (!AttsCccEnabled(periphCb.connId, PERIPH_WP_DAT_CCC_IDX)) {
-      PR_ERROR("Indications is not enabled");
+      PR_ERROR("Notifications is not enabled");
       return E_BAD_STATE;
     }
 
     if (dataLen > (AttGetMtu(periphCb.connId) - 3)) {
-      PR_ERROR("indication request size is larger than max size %d > %d",
+      PR_ERROR("notification request size is larger than max size %d > %d",
               dataLen, AttGetMtu(periphCb.connId) - 3);
       return E_BAD_STATE;
     }
 
-    PR_INFO("BLE TX %d", dataLen);
+    PR_DEBUG("BLE TX %d", dataLen);
 //    for (int i = 0; i < dataLen; i++) {
 //        PR("%02hhX ", data[i]);
 //    }
 //    PR("\n");
 
-    for (int try = 0; try < 3; try++) {
-        periphCb.indicationStatus = ATT_RSP_PENDING;
+    // Stack copies the data, ATTS_HANDLE_VALUE_CNF follows once it is given to L2CAP
+    AttsHandleValueNtf(periphCb.connId, WP_DAT_HDL, dataLen, data);
 
-        AttsHandleValueInd(periphCb.connId, WP_DAT_HDL, dataLen, data);
+    return E_SUCCESS;
+}
 
-        for (int i = 0; (i < 1000000) && (periphCb.indicationStatus == ATT_RSP_PENDING); i++) {
-            wsfOsDispatcher();
-        }
+static void ble_tx_release(void)
+{
+    // Give the oldest window slot back to core0
+    ble_queue_release_tx();
+    device_status.ble_tx_completed += 1;
+    ble_tx_tries = 0;
+}
+
+static void ble_tx_confirmed(uint8_t status)
+{
+    if (ble_tx_stale) {
+        ble_tx_stale--;
+        return;
+    }
+
+    if (ble_mtu_change_response_sent) {
+        ble_mtu_change_response_sent = 0;
 
-        if (periphCb.indicationStatus == ATT_SUCCESS) {
+        if (status == ATT_SUCCESS) {
             device_status.ble_next_tx_seq += 1;
             device_status.ble_next_tx_seq %= BLE_PACKET_SEQ_MASK;
-            return E_SUCCESS;
+            ble_tx_tries = 0;
+        } else if (++ble_tx_tries < MAX32666_BLE_TX_TRIES) {
+            ble_mtu_change_response_pending = 1;
+        } else {
+            PR_ERROR("notification couldn't be sent");
+            ble_tx_tries = 0;
+        }
+        return;
+    }
+
+    // Sent before a disconnect
+    if (ble_tx_unconfirmed == 0) {
+        return;
+    }
+    ble_tx_unconfirmed--;
+
+    // Notifications sent after a refused one are sent again, confirmed or not
+    if (ble_tx_failed) {
+        return;
+    }
+
+    if (status == ATT_SUCCESS) {
+        device_status.ble_next_tx_seq += 1;
+        device_status.ble_next_tx_seq %= BLE_PACKET_SEQ_MASK;
+        ble_tx_next--;
+        ble_tx_release();
+    } else {
+        ble_tx_failed = 1;
+    }
+}
+
+static void ble_tx_reset(void)
+{
+    ble_tx_unconfirmed = 0;
+    ble_tx_stale = 0;
+    ble_tx_next = 0;
+    ble_tx_failed = 0;
+    ble_tx_tries = 0;
+    ble_mtu_change_response_pending = 0;
+    ble_mtu_change_response_sent = 0;
+}
+
+static void ble_tx_worker(void)
+{
+    ble_packet_container_t *ble_tx_packet;
+
+    // Core0 flushed the tx queue, the held slots are gone with it
+    if (ble_tx_next && (ble_queue_peek_tx() == NULL)) {
+        ble_tx_stale += ble_tx_unconfirmed;
+        ble_tx_unconfirmed = 0;
+        ble_tx_next = 0;
+        ble_tx_failed = 0;
+        ble_tx_tries = 0;
+    }
+
+    if (ble_tx_failed) {
+        // Wait for the rest of the window, then send again from the oldest
+        if (ble_tx_unconfirmed) {
+            return;
+        }
+
+        ble_tx_failed = 0;
+        ble_tx_next = 0;
+
+        if (++ble_tx_tries >= MAX32666_BLE_TX_TRIES) {
+            PR_ERROR("notification couldn't be sent");
+            ble_tx_release();
+        }
+    }
+
+    // Confirmation of the MTU change response is told apart by order, it is sent on an idle window
+    if (ble_mtu_change_response_sent) {
+        return;
+    }
+
+    if (ble_mtu_change_response_pending) {
+        // Let the window drain, packets after the response are sized to the new MTU
+        if (ble_tx_unconfirmed || ble_tx_stale) {
+            return;
+        }
+
+        ble_mtu_change_response_pending = 0;
+        ble_prepare_mtu_change_response();
+        ble_mtu_change_response_container.packet.packet_info.seq = device_status.ble_next_tx_seq;
+
+        if (ble_start_notification(ble_mtu_change_response_container.size,
+                (uint8_t *) &(ble_mtu_change_response_container.packet)) == E_SUCCESS) {
+            ble_mtu_change_response_sent = 1;
+        } else {
+            PR_ERROR("ble_start_notification failed");
         }
+        return;
     }
 
-    PR_ERROR("indication couldn't be sent");
+    // Keep up to MAX32666_BLE_TX_WINDOW notifications in the stack, each confirmation lets the next one go
+    while (ble_tx_unconfirmed < MAX32666_BLE_TX_WINDOW) {
+        ble_tx_packet = ble_queue_peek_tx_at(ble_tx_next);
+        if (ble_tx_packet == NULL) {
+            return;
+        }
+
+        // Sequence number is assigned on air, core0 queues packets ahead of the confirmations
+        ble_tx_packet->packet.packet_info.seq = (device_status.ble_next_tx_seq + ble_tx_next) % BLE_PACKET_SEQ_MASK;
 
-    return E_COMM_ERR;
+        if (ble_start_notification(ble_tx_packet->size, (uint8_t *) &(ble_tx_packet->packet)) != E_SUCCESS) {
+            PR_ERROR("ble_start_notification failed");
+            // Only the oldest can be dropped, later ones are dropped when they get there
+            if (ble_tx_next == 0) {
+                ble_tx_release();
+                continue;
+            }
+            return;
+        }
+
+        ble_tx_unconfirmed++;
+        ble_tx_next++;
+    }
 }
 
 int ble_init(void)
@@ -705,16 +853,10 @@ int ble_init(void)
 
 int ble_worker(void)
 {
-    ble_packet_container_t ble_packet_container;
-
     /* Run the WSF OS */
     wsfOsDispatcher();
 
-    if (ble_queue_deq_tx(&ble_packet_container) == E_SUCCESS) {
-        if (ble_send_indication(ble_packet_container.size, (uint8_t *) &(ble_packet_container.packet)) != E_SUCCESS) {
-            PR_ERROR("ble_send_indication failed");
-        }
-    }
+    ble_tx_worker();
 
     if (!device_settings.enable_ble) {
         PR_INFO("Disconnect BLE");
@@ -741,7 +883,14 @@ int ble_worker(void)
         }
 
         device_status.ble_running_status_changed = 1;
+#ifdef RENDER_ON_CORE1
+        // Core1 keeps running to serve the renderer while BLE is stopped
+        while(!device_settings.enable_ble) {
+            render_worker();
+        }
+#else
         while(!device_settings.enable_ble);
+#endif
         PR_INFO("Run BLE");
 
 //        PalBbEnable();
@@ -50,6 +50,7 @@
 #include "max32666_pmic.h"
 #include "max32666_timer_led_button.h"
 #include "maxrefdes178_definitions.h"
+#include "maxrefdes178_utility.h"
 
 
 //-----------------------------------------------------------------------------
@@ -78,58 +79,177 @@ typedef struct {
     uint8_t total_payload_buffer[MAX32666_BLE_COMMAND_BUFFER_SIZE];
 } ble_command_buffer_t;
 
+typedef struct {
+    uint8_t command;
+    uint8_t payload_size;
+    uint8_t payload[BLE_COMMAND_PACKET_MAX_PAYLOAD_SIZE];
+} ble_command_response_t;
+
 
 //-----------------------------------------------------------------------------
 // Global variables
 //-----------------------------------------------------------------------------
 static ble_packet_container_t tmp_container;
 static ble_command_buffer_t ble_command_buffer;
+static uint32_t ble_tx_enqueued;  // compared with device_status.ble_tx_completed for the tx window
+// Responses waiting for the tx window or for a multi packet transmit to finish, oldest first
+static ble_command_response_t ble_response_queue[MAX32666_BLE_RESPONSE_QUEUE_SIZE];
+static int ble_response_count;
 
 
 //-----------------------------------------------------------------------------
 // Local function declarations
 //-----------------------------------------------------------------------------
 static int ble_command_handle_rx(void);
-//static int ble_command_handle_tx(void);
+static int ble_command_handle_tx(void);
+static ble_packet_container_t *ble_command_reserve_tx(void);
+static void ble_command_commit_tx(void);
+static int ble_command_try_send(ble_command_e ble_command, uint32_t payload_size, uint8_t *payload);
+static int ble_command_queue_response(ble_command_e ble_command, uint32_t payload_size, uint8_t *payload);
+static void ble_command_send_queued_responses(void);
+static void ble_command_reject(uint8_t command);
 
 
 //-----------------------------------------------------------------------------
 // Function definitions
 //-----------------------------------------------------------------------------
-// TODO: handle small MTU, multiple packet cases
+// Returns a tx queue slot to build the packet in, NULL if the tx window or the queue is full
+static ble_packet_container_t *ble_command_reserve_tx(void)
+{
+    // Signed difference, a confirmation can arrive after ble_command_reset
+    if ((int32_t)(ble_tx_enqueued - device_status.ble_tx_completed) >= MAX32666_BLE_TX_WINDOW) {
+        return NULL;
+    }
+
+    return ble_queue_reserve_tx();
+}
+
+static void ble_command_commit_tx(void)
+{
+    ble_queue_commit_tx();
+    ble_tx_enqueued++;
+}
+
+// Sends a response that fits one packet now, E_BUSY if the tx window is full or a multi packet transmit is running
+static int ble_command_try_send(ble_command_e ble_command, uint32_t payload_size, uint8_t *payload)
+{
+    ble_packet_container_t *tx_container;
+
+    if (ble_command_buffer.command_state == BLE_COMMAND_STATE_TX_RUNNING) {
+        return E_BUSY;
+    }
+
+    // Small MTU, fragment the response
+    if (payload_size + sizeof(ble_command_packet_header_t) > device_status.ble_max_packet_size) {
+        if (ble_command_buffer.command_state != BLE_COMMAND_STATE_IDLE) {
+            return E_BUSY;
+        }
+        return ble_command_send_multi_packet(ble_command, payload_size, payload);
+    }
+
+    tx_container = ble_command_reserve_tx();
+    if (tx_container == NULL) {
+        return E_BUSY;
+    }
+
+    tx_container->packet.command_packet.header.packet_info.type = BLE_PACKET_TYPE_COMMAND;
+    tx_container->packet.command_packet.header.command = ble_command;
+    tx_container->packet.command_packet.header.total_payload_size = payload_size;
+    memcpy(tx_container->packet.command_packet.payload, payload, payload_size);
+    tx_container->size = payload_size + sizeof(ble_command_packet_header_t);
+
+    ble_command_commit_tx();
+
+    return E_SUCCESS;
+}
+
+static int ble_command_queue_response(ble_command_e ble_command, uint32_t payload_size, uint8_t *payload)
+{
+    ble_command_response_t *response = NULL;
+
+    // Periodic results are only worth sending as the latest value
+    if ((ble_command == BLE_COMMAND_GET_STATISTICS_RES) ||
+        (ble_command == BLE_COMMAND_GET_MAX78000_VIDEO_CLASSIFICATION_RES) ||
+        (ble_command == BLE_COMMAND_GET_MAX78000_AUDIO_CLASSIFICATION_RES)) {
+        for (int i = 0; i < ble_response_count; i++) {
+            if (ble_response_queue[i].command == ble_command) {
+                response = &ble_response_queue[i];
+                break;
+            }
+        }
+    }
+
+    if (response == NULL) {
+        if (ble_response_count == MAX32666_BLE_RESPONSE_QUEUE_SIZE) {
+            PR_ERROR("response queue is full, %d dropped", ble_command);
+            return E_BUSY;
+        }
+        response = &ble_response_queue[ble_response_count++];
+    }
+
+    response->command = ble_command;
+    response->payload_size = payload_size;
+    memcpy(response->payload, payload, payload_size);
+
+    return E_SUCCESS;
+}
+
+static void ble_command_send_queued_responses(void)
+{
+    int sent = 0;
+
+    while ((sent < ble_response_count) &&
+           (ble_command_try_send(ble_response_queue[sent].command, ble_response_queue[sent].payload_size,
+                                 ble_response_queue[sent].payload) == E_SUCCESS)) {
+        sent++;
+    }
+
+    if (sent) {
+        ble_response_count -= sent;
+        memmove(ble_response_queue, &ble_response_queue[sent], ble_response_count * sizeof(ble_command_response_t));
+    }
+}
+
+// Tells the host a command was not executed, the payload is the rejected command
+static void ble_command_reject(uint8_t command)
+{
+    ble_command_send_single_packet(BLE_COMMAND_INVALID_RES, sizeof(command), &command);
+}
+
 int ble_command_send_single_packet(ble_command_e ble_command, uint32_t payload_size, uint8_t *payload)
 {
-    int ret;
+    if (payload_size > BLE_COMMAND_PACKET_MAX_PAYLOAD_SIZE) {
+        return ble_command_send_multi_packet(ble_command, payload_size, payload);
+    }
+
+    // Responses go out in order, a busy link queues them until ble_command_worker can send them
+    if ((ble_response_count == 0) && (ble_command_try_send(ble_command, payload_size, payload) == E_SUCCESS)) {
+        return E_SUCCESS;
+    }
 
+    return ble_command_queue_response(ble_command, payload_size, payload);
+}
+
+int ble_command_send_multi_packet(ble_command_e ble_command, uint32_t payload_size, uint8_t *payload)
+{
     if (ble_command_buffer.command_state != BLE_COMMAND_STATE_IDLE) {
         PR_ERROR("command state is not idle");
         return E_BAD_STATE;
     }
 
-    if (payload_size + sizeof(ble_command_packet_header_t) > device_status.ble_max_packet_size) {
-        PR_ERROR("command is bigger than ble max packet size %d %d",
-                payload_size + sizeof(ble_command_packet_header_t), device_status.ble_max_packet_size);
-        return E_BAD_PARAM;
-    }
-
-    if (payload_size > sizeof(tmp_container.packet.command_packet.payload)) {
+    if (payload_size > MAX32666_BLE_COMMAND_BUFFER_SIZE) {
         PR_ERROR("invalid command %d payload size %d", ble_command, payload_size);
         return E_BAD_PARAM;
     }
-    tmp_container.packet.command_packet.header.packet_info.type = BLE_PACKET_TYPE_COMMAND;
-    tmp_container.packet.command_packet.header.packet_info.seq = device_status.ble_next_tx_seq;
-    tmp_container.packet.command_packet.header.command = ble_command;
-    tmp_container.packet.command_packet.header.total_payload_size = payload_size;
-    memcpy(tmp_container.packet.command_packet.payload, payload, payload_size);
-    tmp_container.size = payload_size + sizeof(ble_command_packet_header_t);
-
-    ret = ble_queue_enq_tx(&tmp_container);
-    if (ret != E_SUCCESS) {
-        PR_ERROR("ble_queue_enq_tx failed %d", ret);
-        return ret;
-    }
 
-    return ret;
+    // Packets are built from the command buffer by ble_command_handle_tx
+    ble_command_buffer.command = ble_command;
+    ble_command_buffer.total_payload_size = payload_size;
+    ble_command_buffer.transmitted_payload_size = 0;
+    memcpy(ble_command_buffer.total_payload_buffer, payload, payload_size);
+    ble_command_buffer.command_state = BLE_COMMAND_STATE_TX_RUNNING;
+
+    return E_SUCCESS;
 }
 
 static int ble_command_execute_rx_command(void)
@@ -172,8 +292,11 @@ static int ble_command_execute_rx_command(void)
             PR_ERROR("invalid total payload size %d", ble_command_buffer.total_payload_size);
             return E_BAD_PARAM;
         }
-        qspi_master_send_video(ble_command_buffer.total_payload_buffer, ble_command_buffer.total_payload_size,
-                QSPI_PACKET_TYPE_VIDEO_FACEID_EMBED_UPDATE_CMD);
+        // The app is told with an invalid response if the link is stuck
+        if (qspi_master_send_video(ble_command_buffer.total_payload_buffer, ble_command_buffer.total_payload_size,
+                QSPI_PACKET_TYPE_VIDEO_FACEID_EMBED_UPDATE_CMD) != E_NO_ERROR) {
+            return E_BUSY;
+        }
         break;
     case BLE_COMMAND_DISABLE_BLE_CMD:
         if (ble_command_buffer.total_payload_size != 0) {
@@ -404,6 +527,19 @@ static int ble_command_execute_rx_command(void)
         }
         device_settings.enable_ble_send_statistics = 0;
         break;
+    case BLE_COMMAND_GET_TIMING_CMD:
+        if (ble_command_buffer.total_payload_size != 0) {
+            PR_ERROR("invalid total payload size %d", ble_command_buffer.total_payload_size);
+            return E_BAD_PARAM;
+        }
+        // Larger than one packet, the app reassembles the payload packets
+        if (ble_command_send_multi_packet(BLE_COMMAND_GET_TIMING_RES,
+                sizeof(device_status.timing), (uint8_t *) &device_status.timing) != E_SUCCESS) {
+            // A previous multi packet response is still being sent, the caller rejects the command
+            PR_ERROR("timing response couldn't be sent");
+            return E_BAD_STATE;
+        }
+        break;
     case BLE_COMMAND_ENABLE_SEND_CLASSIFICATION_CMD:
         if (ble_command_buffer.total_payload_size != 0) {
             PR_ERROR("invalid total payload size %d", ble_command_buffer.total_payload_size);
@@ -461,7 +597,7 @@ static int ble_command_execute_rx_command(void)
         break;
     default:
         PR_ERROR("Unknown command");
-        break;
+        return E_NOT_SUPPORTED;
     }
 
     timestamps.activity_detected = timer_ms_tick;
@@ -472,12 +608,26 @@ static int ble_command_execute_rx_command(void)
 static int ble_command_handle_rx(void)
 {
     uint8_t packet_payload_size;
+    ble_packet_container_t *rx_container;
 
     // BLE RX, check new packet on ble rx queue
-    if (ble_queue_deq_rx(&tmp_container) != E_SUCCESS) {
+    rx_container = ble_queue_peek_rx();
+    if (rx_container == NULL) {
         return E_NO_ERROR;
     }
 
+    // Commands share the command buffer with a multi packet transmit and may need a queued response,
+    // they wait in the rx queue until both are available. Abort is never held back
+    if ((rx_container->packet.packet_info.type == BLE_PACKET_TYPE_COMMAND) &&
+        (rx_container->packet.command_packet.header.command != BLE_COMMAND_ABORT_CMD) &&
+        ((ble_command_buffer.command_state == BLE_COMMAND_STATE_TX_RUNNING) ||
+         (ble_response_count == MAX32666_BLE_RESPONSE_QUEUE_SIZE))) {
+        return E_BUSY;
+    }
+
+    memcpy(&tmp_container, rx_container, sizeof(tmp_container));
+    ble_queue_release_rx();
+
     // Check sequence number of the packet
     if (device_status.ble_expected_rx_seq != tmp_container.packet.packet_info.seq) {
 //        PR_ERROR("Incorrect seq expected %d received %d", device_status.ble_expected_rx_seq,
@@ -504,15 +654,18 @@ static int ble_command_handle_rx(void)
             return E_SUCCESS;
         }
 
-        // Check state
+        // Check state, the payload of the previous command is incomplete. Drop it so the host can retry
         if (ble_command_buffer.command_state != BLE_COMMAND_STATE_IDLE) {
             PR_ERROR("command packet is not expected");
+            ble_command_buffer.command_state = BLE_COMMAND_STATE_IDLE;
+            ble_command_reject(tmp_container.packet.command_packet.header.command);
             return E_BAD_STATE;
         }
 
         // Check size
         if (packet_payload_size > tmp_container.packet.command_packet.header.total_payload_size) {
             PR_ERROR("packet payload size is larger than total payload size");
+            ble_command_reject(tmp_container.packet.command_packet.header.command);
             return E_BAD_PARAM;
         }
 
@@ -520,6 +673,7 @@ static int ble_command_handle_rx(void)
         // Check max size
         if (tmp_container.packet.command_packet.header.total_payload_size > MAX32666_BLE_COMMAND_BUFFER_SIZE) {
             PR_ERROR("total payload size is too big");
+            ble_command_reject(tmp_container.packet.command_packet.header.command);
             return E_BAD_PARAM;
         }
 
@@ -533,7 +687,9 @@ static int ble_command_handle_rx(void)
         // Check if single packet command
         if (ble_command_buffer.total_payload_size <= ble_command_buffer.received_payload_size) {
             ble_command_buffer.command_state = BLE_COMMAND_STATE_IDLE;
-            ble_command_execute_rx_command();
+            if (ble_command_execute_rx_command() != E_SUCCESS) {
+                ble_command_reject(ble_command_buffer.command);
+            }
         }
 
         return E_SUCCESS;
@@ -546,7 +702,7 @@ static int ble_command_handle_rx(void)
 //        }
 //        PR("\n");
 
-        // Check state
+        // Check state, the command was rejected already or never received
         if (ble_command_buffer.command_state != BLE_COMMAND_STATE_RX_RUNNING) {
             PR_ERROR("payload packet is not expected");
             return E_BAD_STATE;
@@ -554,6 +710,8 @@ static int ble_command_handle_rx(void)
 
         if (ble_command_buffer.received_payload_size + packet_payload_size > MAX32666_BLE_COMMAND_BUFFER_SIZE) {
             PR_ERROR("payload overflow");
+            ble_command_buffer.command_state = BLE_COMMAND_STATE_IDLE;
+            ble_command_reject(ble_command_buffer.command);
             return E_OVERFLOW;
         }
 
@@ -565,7 +723,9 @@ static int ble_command_handle_rx(void)
         // Check if payload receive is completed
         if (ble_command_buffer.total_payload_size <= ble_command_buffer.received_payload_size) {
             ble_command_buffer.command_state = BLE_COMMAND_STATE_IDLE;
-            ble_command_execute_rx_command();
+            if (ble_command_execute_rx_command() != E_SUCCESS) {
+                ble_command_reject(ble_command_buffer.command);
+            }
         }
 
         return E_SUCCESS;
@@ -574,21 +734,70 @@ static int ble_command_handle_rx(void)
     return E_SUCCESS;
 }
 
-//static int ble_command_handle_tx(void)
-//{
-//    // BLE TX, check new packet to enqueue ble tx queue
-//    if (ble_command_buffer.command_state != BLE_COMMAND_STATE_TX_RUNNING) {
-//        return E_NO_ERROR;
-//    }
-//    // TODO
-//
-//    return E_SUCCESS;
-//}
+static int ble_command_handle_tx(void)
+{
+    uint32_t packet_payload_size;
+    uint32_t remaining_payload_size;
+    ble_packet_container_t *tx_container;
+
+    // BLE TX, check new packet to enqueue ble tx queue
+    if (ble_command_buffer.command_state != BLE_COMMAND_STATE_TX_RUNNING) {
+        return E_NO_ERROR;
+    }
+
+    // Keep up to MAX32666_BLE_TX_WINDOW packets queued or waiting for confirmation on core1,
+    // packets are built in place in the tx queue
+    while ((tx_container = ble_command_reserve_tx()) != NULL) {
+        remaining_payload_size = ble_command_buffer.total_payload_size - ble_command_buffer.transmitted_payload_size;
+
+        if (ble_command_buffer.transmitted_payload_size == 0) {
+            // First packet carries the command header
+            packet_payload_size = MIN(remaining_payload_size,
+                    device_status.ble_max_packet_size - sizeof(ble_command_packet_header_t));
+            packet_payload_size = MIN(packet_payload_size, BLE_COMMAND_PACKET_MAX_PAYLOAD_SIZE);
+
+            tx_container->packet.command_packet.header.packet_info.type = BLE_PACKET_TYPE_COMMAND;
+            tx_container->packet.command_packet.header.command = ble_command_buffer.command;
+            tx_container->packet.command_packet.header.total_payload_size = ble_command_buffer.total_payload_size;
+            memcpy(tx_container->packet.command_packet.payload, ble_command_buffer.total_payload_buffer,
+                    packet_payload_size);
+            tx_container->size = packet_payload_size + sizeof(ble_command_packet_header_t);
+        } else {
+            packet_payload_size = MIN(remaining_payload_size,
+                    device_status.ble_max_packet_size - sizeof(ble_payload_packet_header_t));
+            packet_payload_size = MIN(packet_payload_size, BLE_PAYLOAD_PACKET_MAX_PAYLOAD_SIZE);
+
+            tx_container->packet.payload_packet.header.packet_info.type = BLE_PACKET_TYPE_PAYLOAD;
+            memcpy(tx_container->packet.payload_packet.payload,
+                    &ble_command_buffer.total_payload_buffer[ble_command_buffer.transmitted_payload_size],
+                    packet_payload_size);
+            tx_container->size = packet_payload_size + sizeof(ble_payload_packet_header_t);
+        }
+
+        ble_command_commit_tx();
+
+        ble_command_buffer.transmitted_payload_size += packet_payload_size;
+        PR_DEBUG("T %d (%d/%d)", packet_payload_size, ble_command_buffer.transmitted_payload_size,
+                ble_command_buffer.total_payload_size);
+
+        // Check if payload transmit is completed
+        if (ble_command_buffer.transmitted_payload_size >= ble_command_buffer.total_payload_size) {
+            ble_command_buffer.command_state = BLE_COMMAND_STATE_IDLE;
+            break;
+        }
+    }
+
+    return E_SUCCESS;
+}
 
 int ble_command_reset(void)
 {
     ble_command_buffer.command_state = BLE_COMMAND_STATE_IDLE;
 
+    // Packets flushed from the tx queue will not be confirmed
+    ble_tx_enqueued = device_status.ble_tx_completed;
+    ble_response_count = 0;
+
     // TODO close open files
 
     return E_NO_ERROR;
@@ -596,8 +805,9 @@ int ble_command_reset(void)
 
 int ble_command_worker(void)
 {
+    ble_command_send_queued_responses();
     ble_command_handle_rx();
-//    ble_command_handle_tx();
+    ble_command_handle_tx();
 
     return E_SUCCESS;
 }
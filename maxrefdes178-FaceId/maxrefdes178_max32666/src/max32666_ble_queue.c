@@ -36,6 +36,7 @@
 //-----------------------------------------------------------------------------
 // Includes
 //-----------------------------------------------------------------------------
+#include <mxc_device.h>
 #include <string.h>
 
 #include "max32666_ble_queue.h"
@@ -52,11 +53,16 @@
 //-----------------------------------------------------------------------------
 // Typedefs
 //-----------------------------------------------------------------------------
-// Circular buffer queue implementation, overwrite is not permitted
+// Single producer single consumer circular buffer, overwrite is not permitted
+// head is written only by the producer core, tail only by the consumer core.
+// Slot ownership is transferred by the index store after a memory barrier.
 typedef struct {
     ble_packet_container_t container_array[MAX32666_BLE_QUEUE_SIZE];
-    uint32_t head;
-    uint32_t tail;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t flush_index;    // written by the producer
+    volatile uint32_t flush_request;  // written by the producer
+    volatile uint32_t flush_ack;      // written by the consumer
 } ble_queue_t;
 
 
@@ -66,15 +72,20 @@ typedef struct {
 //static const mxc_gpio_cfg_t core0_int_pin = MAX32666_CORE0_INT_PIN;
 //static const mxc_gpio_cfg_t core1_int_pin = MAX32666_CORE1_INT_PIN;
 
-static volatile ble_queue_t ble_queue_rx;
-static volatile ble_queue_t ble_queue_tx;
+// rx: core1 -> core0, tx: core0 -> core1
+static ble_queue_t ble_queue_rx;
+static ble_queue_t ble_queue_tx;
 
 
 //-----------------------------------------------------------------------------
 // Local function declarations
 //-----------------------------------------------------------------------------
-static int ble_queue_enq(volatile ble_queue_t *ble_queue, ble_packet_container_t *ble_packet_container);
-static int ble_queue_deq(volatile ble_queue_t *ble_queue, ble_packet_container_t *ble_packet_container);
+static ble_packet_container_t *ble_queue_reserve(ble_queue_t *ble_queue);
+static int ble_queue_commit(ble_queue_t *ble_queue);
+static ble_packet_container_t *ble_queue_peek(ble_queue_t *ble_queue, uint32_t index);
+static int ble_queue_release(ble_queue_t *ble_queue);
+static int ble_queue_enq(ble_queue_t *ble_queue, ble_packet_container_t *ble_packet_container);
+static int ble_queue_deq(ble_queue_t *ble_queue, ble_packet_container_t *ble_packet_container);
 //static int ble_queue_trigger_interrupt(void)
 
 
@@ -86,46 +97,93 @@ static int ble_queue_deq(volatile ble_queue_t *ble_queue, ble_packet_container_t
 //
 //}
 
-static int ble_queue_enq(volatile ble_queue_t *ble_queue, ble_packet_container_t *ble_packet_container)
+// Producer, returns the free slot at head or NULL if the queue is full
+static ble_packet_container_t *ble_queue_reserve(ble_queue_t *ble_queue)
 {
-    uint32_t next;
+    uint32_t head = ble_queue->head;
 
-    while(MXC_SEMA_GetSema(MAX32666_SEMAPHORE_BLE_QUEUE) == E_BUSY) {};
+    if (((head + 1) % MAX32666_BLE_QUEUE_SIZE) == ble_queue->tail) {
+        return NULL;
+    }
 
-    next = (ble_queue->head + 1) % MAX32666_BLE_QUEUE_SIZE;
+    // Consumer is done with the slot before tail moved
+    __DMB();
 
-    if (next == ble_queue->tail) {
-        MXC_SEMA_FreeSema(MAX32666_SEMAPHORE_BLE_QUEUE);
-        return E_OVERFLOW;
+    return &ble_queue->container_array[head];
+}
+
+// Producer, publishes the slot returned by ble_queue_reserve
+static int ble_queue_commit(ble_queue_t *ble_queue)
+{
+    // Slot content must be visible before the new head
+    __DMB();
+    ble_queue->head = (ble_queue->head + 1) % MAX32666_BLE_QUEUE_SIZE;
+
+    return E_SUCCESS;
+}
+
+// Consumer, returns the slot index places after the oldest or NULL if the queue holds fewer
+static ble_packet_container_t *ble_queue_peek(ble_queue_t *ble_queue, uint32_t index)
+{
+    uint32_t head = ble_queue->head;
+    uint32_t flush_request;
+
+    // A head read before an unseen flush request is never past flush_index
+    __DMB();
+    flush_request = ble_queue->flush_request;
+
+    // Producer asked to drop everything it committed before the flush
+    if (flush_request != ble_queue->flush_ack) {
+        __DMB();
+        ble_queue->tail = ble_queue->flush_index;
+        ble_queue->flush_ack = flush_request;
+        return NULL;
     }
 
-    memcpy((uint8_t *) &(ble_queue->container_array[ble_queue->head]), ble_packet_container, sizeof(ble_packet_container_t));
-    ble_queue->head = next;
+    if (index >= ((head + MAX32666_BLE_QUEUE_SIZE - ble_queue->tail) % MAX32666_BLE_QUEUE_SIZE)) {
+        return NULL;
+    }
 
-    MXC_SEMA_FreeSema(MAX32666_SEMAPHORE_BLE_QUEUE);
+    // Slot content is read after head
+    __DMB();
 
-    return E_SUCCESS;
+    return &ble_queue->container_array[(ble_queue->tail + index) % MAX32666_BLE_QUEUE_SIZE];
 }
 
-static int ble_queue_deq(volatile ble_queue_t *ble_queue, ble_packet_container_t *ble_packet_container)
+// Consumer, gives the slot returned by ble_queue_peek back to the producer
+static int ble_queue_release(ble_queue_t *ble_queue)
 {
-    uint32_t next;
+    // Slot reads must complete before the producer can reuse it
+    __DMB();
+    ble_queue->tail = (ble_queue->tail + 1) % MAX32666_BLE_QUEUE_SIZE;
 
-    while(MXC_SEMA_GetSema(MAX32666_SEMAPHORE_BLE_QUEUE) == E_BUSY) {};
+    return E_SUCCESS;
+}
 
-    if (ble_queue->head == ble_queue->tail) {
-        MXC_SEMA_FreeSema(MAX32666_SEMAPHORE_BLE_QUEUE);
-        return E_UNDERFLOW;
+static int ble_queue_enq(ble_queue_t *ble_queue, ble_packet_container_t *ble_packet_container)
+{
+    ble_packet_container_t *slot = ble_queue_reserve(ble_queue);
+
+    if (slot == NULL) {
+        return E_OVERFLOW;
     }
 
-    next = (ble_queue->tail + 1) % MAX32666_BLE_QUEUE_SIZE;
+    memcpy(slot, ble_packet_container, sizeof(ble_packet_container_t));
 
-    memcpy(ble_packet_container, (uint8_t *) &(ble_queue->container_array[ble_queue->tail]), sizeof(ble_packet_container_t));
-    ble_queue->tail = next;
+    return ble_queue_commit(ble_queue);
+}
 
-    MXC_SEMA_FreeSema(MAX32666_SEMAPHORE_BLE_QUEUE);
+static int ble_queue_deq(ble_queue_t *ble_queue, ble_packet_container_t *ble_packet_container)
+{
+    ble_packet_container_t *slot = ble_queue_peek(ble_queue, 0);
 
-    return E_SUCCESS;
+    if (slot == NULL) {
+        return E_UNDERFLOW;
+    }
+
+    memcpy(ble_packet_container, slot, sizeof(ble_packet_container_t));
+
+    return ble_queue_release(ble_queue);
 }
 
 int ble_queue_deq_rx(ble_packet_container_t *ble_packet_container)
@@ -148,16 +206,60 @@ int ble_queue_enq_tx(ble_packet_container_t *ble_packet_container)
     return ble_queue_enq(&ble_queue_tx, ble_packet_container);
 }
 
-int ble_queue_flush(void)
+ble_packet_container_t *ble_queue_peek_rx(void)
 {
-    while(MXC_SEMA_GetSema(MAX32666_SEMAPHORE_BLE_QUEUE) == E_BUSY) {};
+    return ble_queue_peek(&ble_queue_rx, 0);
+}
 
-    ble_queue_rx.head = 0;
-    ble_queue_rx.tail = 0;
-    ble_queue_tx.head = 0;
-    ble_queue_tx.tail = 0;
+int ble_queue_release_rx(void)
+{
+    return ble_queue_release(&ble_queue_rx);
+}
+
+ble_packet_container_t *ble_queue_reserve_rx(void)
+{
+    return ble_queue_reserve(&ble_queue_rx);
+}
+
+int ble_queue_commit_rx(void)
+{
+    return ble_queue_commit(&ble_queue_rx);
+}
+
+ble_packet_container_t *ble_queue_reserve_tx(void)
+{
+    return ble_queue_reserve(&ble_queue_tx);
+}
+
+int ble_queue_commit_tx(void)
+{
+    return ble_queue_commit(&ble_queue_tx);
+}
+
+ble_packet_container_t *ble_queue_peek_tx(void)
+{
+    return ble_queue_peek(&ble_queue_tx, 0);
+}
+
+ble_packet_container_t *ble_queue_peek_tx_at(uint32_t index)
+{
+    return ble_queue_peek(&ble_queue_tx, index);
+}
+
+int ble_queue_release_tx(void)
+{
+    return ble_queue_release(&ble_queue_tx);
+}
+
+int ble_queue_flush(void)
+{
+    // core0 consumes rx, drop in place
+    ble_queue_rx.tail = ble_queue_rx.head;
 
-    MXC_SEMA_FreeSema(MAX32666_SEMAPHORE_BLE_QUEUE);
+    // core0 produces tx, core1 drops up to the current head on its next peek
+    ble_queue_tx.flush_index = ble_queue_tx.head;
+    __DMB();
+    ble_queue_tx.flush_request++;
 
     return E_SUCCESS;
 }
@@ -49,15 +49,47 @@
 //-----------------------------------------------------------------------------
 #define S_MODULE_NAME   "fonts"
 
+// Render text from cached glyph spans instead of testing every glyph bit, comment out to compare
+#define FONTS_USE_GLYPH_CACHE
+
+#define FONTS_FIRST_CHAR            ' '
+#define FONTS_LAST_CHAR             '~'
+
+// Cache is 4-way set associative with LRU eviction, about 5 KB
+#define FONTS_GLYPH_CACHE_WAYS      4
+#define FONTS_GLYPH_CACHE_SETS      8
+#define FONTS_GLYPH_MAX_SPANS       48  // largest built-in glyph, larger ones use the bit path
+
 
 //-----------------------------------------------------------------------------
 // Typedefs
 //-----------------------------------------------------------------------------
+// Horizontal run of set pixels in a glyph, the gaps are transparent
+typedef struct {
+    uint8_t row;
+    uint8_t x;
+    uint8_t len;
+} fonts_span_t;
+
+typedef struct {
+    const FontDef *font;  // NULL if the slot is empty
+    char ch;
+    uint8_t span_count;
+    uint32_t last_used;
+    fonts_span_t spans[FONTS_GLYPH_MAX_SPANS];
+} fonts_glyph_t;
 
 
 //-----------------------------------------------------------------------------
 // Global variables
 //-----------------------------------------------------------------------------
+static uint32_t fonts_damage = 0;
+static fonts_runs_t *fonts_capture = NULL;  // primitives append runs here instead of writing pixels
+#ifdef FONTS_USE_GLYPH_CACHE
+static fonts_glyph_t fonts_glyph_cache[FONTS_GLYPH_CACHE_SETS][FONTS_GLYPH_CACHE_WAYS];
+static uint32_t fonts_glyph_clock = 0;
+#endif
+
 static const uint16_t Font7x10 [] = {
     0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // sp
     0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x0000, 0x1000, 0x0000, 0x0000,  // !
@@ -360,6 +392,14 @@ const FontDef Font_16x26 = {16, 26, Font16x26};
 // Local function declarations
 //-----------------------------------------------------------------------------
 static void fonts_putChar(uint16_t x, uint16_t y, char ch, const FontDef *font, uint16_t color, uint8_t bg, uint16_t bgcolor, uint8_t *buff);
+static void fonts_fillSpan(uint16_t *p, uint32_t len, uint16_t color);
+static void fonts_fillRow(int32_t x1, int32_t x2, int32_t y, uint16_t color, uint16_t *p);
+static void fonts_fillColumn(int32_t x, int32_t y1, int32_t y2, uint16_t color, uint16_t *p);
+static void fonts_captureRun(int32_t x, int32_t y, int32_t len, int32_t height, uint16_t color);
+#ifdef FONTS_USE_GLYPH_CACHE
+static const fonts_glyph_t *fonts_getGlyph(char ch, const FontDef *font);
+static void fonts_putGlyph(uint16_t x, uint16_t y, const fonts_glyph_t *glyph, uint16_t color, uint8_t bg, uint16_t bgcolor, uint8_t *buff);
+#endif
 
 
 //-----------------------------------------------------------------------------
@@ -371,9 +411,19 @@ static void fonts_putChar(uint16_t x, uint16_t y, char ch, const FontDef *font,
 
     uint16_t *p = (uint16_t *) buff;
 
+    fonts_markDamage(y, y + font->height - 1);
+
     for (i = 0; i < font->height; i++) {
         b = font->data[(ch - 32) * font->height + i];
         for (j = 0; j < font->width; j++) {
+            if (fonts_capture) {
+                if ((b << j) & 0x8000) {
+                    fonts_captureRun(j + x, i + y, 1, 1, __builtin_bswap16(color));
+                } else if (bg) {
+                    fonts_captureRun(j + x, i + y, 1, 1, __builtin_bswap16(bgcolor));
+                }
+                continue;
+            }
             pos = (((i + y) * LCD_WIDTH) + (j + x));
             if ((b << j) & 0x8000) {
                 p[pos] = __builtin_bswap16 (color);
@@ -405,12 +455,204 @@ void fonts_putString(uint16_t x, uint16_t y, const char *str, const FontDef *fon
                 continue;
             }
         }
+#ifdef FONTS_USE_GLYPH_CACHE
+        const fonts_glyph_t *glyph = fonts_getGlyph(*str, font);
+        if (glyph) {
+            fonts_putGlyph(x, y, glyph, color, bg, bgcolor, buff);
+        } else {
+            fonts_putChar(x, y, *str, font, color, bg, bgcolor, buff);
+        }
+#else
         fonts_putChar(x, y, *str, font, color, bg, bgcolor, buff);
+#endif
         x += font->width;
         str++;
     }
 }
 
+/**
+ * @brief Fill a run of pixels, two pixels per store
+ * @param p -> first pixel in the framebuffer
+ * @param len -> number of pixels
+ * @param color -> color in framebuffer byte order
+ * @return none
+ */
+static void fonts_fillSpan(uint16_t *p, uint32_t len, uint16_t color)
+{
+    uint32_t pair = ((uint32_t) color << 16) | color;
+    uint32_t *p32;
+
+    if (len && ((uintptr_t) p & 0x2)) {
+        *p++ = color;
+        len--;
+    }
+
+    for (p32 = (uint32_t *) p; len >= 2; len -= 2) {
+        *p32++ = pair;
+    }
+
+    if (len) {
+        *(uint16_t *) p32 = color;
+    }
+}
+
+/**
+ * @brief Fill an inclusive horizontal span clipped to the LCD
+ * @param x1&x2 -> first and last column, any order
+ * @param y -> row
+ * @param color -> color in framebuffer byte order
+ * @return none
+ */
+static void fonts_fillRow(int32_t x1, int32_t x2, int32_t y, uint16_t color, uint16_t *p)
+{
+    int32_t swap;
+
+    if (x1 > x2) {
+        swap = x1;
+        x1 = x2;
+        x2 = swap;
+    }
+
+    if ((y < 0) || (y >= LCD_HEIGHT) || (x2 < 0) || (x1 >= LCD_WIDTH)) {
+        return;
+    }
+
+    x1 = (x1 < 0) ? 0 : x1;
+    x2 = (x2 >= LCD_WIDTH) ? (LCD_WIDTH - 1) : x2;
+
+    if (fonts_capture) {
+        fonts_captureRun(x1, y, x2 - x1 + 1, 1, color);
+        return;
+    }
+
+    fonts_fillSpan(&p[(y * LCD_WIDTH) + x1], x2 - x1 + 1, color);
+}
+
+/**
+ * @brief Fill an inclusive vertical span clipped to the LCD
+ * @param x -> column
+ * @param y1&y2 -> first and last row, any order
+ * @param color -> color in framebuffer byte order
+ * @return none
+ */
+static void fonts_fillColumn(int32_t x, int32_t y1, int32_t y2, uint16_t color, uint16_t *p)
+{
+    int32_t swap;
+
+    if (y1 > y2) {
+        swap = y1;
+        y1 = y2;
+        y2 = swap;
+    }
+
+    if ((x < 0) || (x >= LCD_WIDTH) || (y2 < 0) || (y1 >= LCD_HEIGHT)) {
+        return;
+    }
+
+    y1 = (y1 < 0) ? 0 : y1;
+    y2 = (y2 >= LCD_HEIGHT) ? (LCD_HEIGHT - 1) : y2;
+
+    if (fonts_capture) {
+        fonts_captureRun(x, y1, 1, y2 - y1 + 1, color);
+        return;
+    }
+
+    for (p = &p[(y1 * LCD_WIDTH) + x]; y1 <= y2; y1++, p += LCD_WIDTH) {
+        *p = color;
+    }
+}
+
+#ifdef FONTS_USE_GLYPH_CACHE
+/**
+ * @brief Find a glyph in the span cache, converting it on a miss
+ * @param ch -> character
+ * @param font -> font of the character
+ * @return cached glyph, NULL if the glyph can not be cached
+ */
+static const fonts_glyph_t *fonts_getGlyph(char ch, const FontDef *font)
+{
+    fonts_glyph_t *set;
+    fonts_glyph_t *glyph;
+    uint32_t b, i, j, start;
+
+    if ((ch < FONTS_FIRST_CHAR) || (ch > FONTS_LAST_CHAR)) {
+        return NULL;
+    }
+
+    fonts_glyph_clock++;
+
+    set = fonts_glyph_cache[(ch + font->height) % FONTS_GLYPH_CACHE_SETS];
+    glyph = &set[0];
+    for (i = 0; i < FONTS_GLYPH_CACHE_WAYS; i++) {
+        if ((set[i].font == font) && (set[i].ch == ch)) {
+            set[i].last_used = fonts_glyph_clock;
+            return &set[i];
+        }
+        // Evict the least recently used way, empty ways first
+        if (!set[i].font || (glyph->font && (set[i].last_used < glyph->last_used))) {
+            glyph = &set[i];
+        }
+    }
+
+    glyph->font = NULL;
+    glyph->ch = ch;
+    glyph->span_count = 0;
+
+    for (i = 0; i < font->height; i++) {
+        b = font->data[(ch - FONTS_FIRST_CHAR) * font->height + i];
+        for (j = 0; j < font->width; ) {
+            if (!((b << j) & 0x8000)) {
+                j++;
+                continue;
+            }
+            for (start = j; (j < font->width) && ((b << j) & 0x8000); j++);
+            if (glyph->span_count == FONTS_GLYPH_MAX_SPANS) {
+                return NULL;
+            }
+            glyph->spans[glyph->span_count].row = i;
+            glyph->spans[glyph->span_count].x = start;
+            glyph->spans[glyph->span_count].len = j - start;
+            glyph->span_count++;
+        }
+    }
+
+    glyph->font = font;
+    glyph->last_used = fonts_glyph_clock;
+
+    return glyph;
+}
+
+static void fonts_putGlyph(uint16_t x, uint16_t y, const fonts_glyph_t *glyph, uint16_t color, uint8_t bg, uint16_t bgcolor, uint8_t *buff)
+{
+    uint16_t *p = (uint16_t *) buff;
+    const fonts_span_t *span = glyph->spans;
+    const fonts_span_t *end = &glyph->spans[glyph->span_count];
+
+    fonts_markDamage(y, y + glyph->font->height - 1);
+
+    if (fonts_capture) {
+        if (bg) {
+            fonts_captureRun(x, y, glyph->font->width, glyph->font->height, __builtin_bswap16(bgcolor));
+        }
+        for (color = __builtin_bswap16(color); span < end; span++) {
+            fonts_captureRun(x + span->x, y + span->row, span->len, 1, color);
+        }
+        return;
+    }
+
+    if (bg) {
+        for (uint32_t i = 0; i < glyph->font->height; i++) {
+            fonts_fillSpan(&p[((i + y) * LCD_WIDTH) + x], glyph->font->width, __builtin_bswap16(bgcolor));
+        }
+    }
+
+    color = __builtin_bswap16(color);
+    for (; span < end; span++) {
+        fonts_fillSpan(&p[((span->row + y) * LCD_WIDTH) + x + span->x], span->len, color);
+    }
+}
+#endif
+
 void fonts_putStringCentered(uint16_t y, const char *str, const FontDef *font, uint16_t color, uint8_t *buff)
 {
     uint16_t x = (LCD_WIDTH - (font->width * strlen(str))) / 2;
@@ -427,10 +669,24 @@ void fonts_putStringCentered(uint16_t y, const char *str, const FontDef *font, u
  */
 void fonts_drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color, uint8_t *buff)
 {
-    uint16_t swap;
-    uint16_t steep = abs(y1 - y0) > abs(x1 - x0);
-    uint32_t pos;
     uint16_t *p = (uint16_t *) buff;
+    int32_t dx, dy, err, ystep, x, y, run;
+    int32_t steep = abs(y1 - y0) > abs(x1 - x0);
+    int32_t swap;
+
+    fonts_markDamage(y0, y1);
+
+    color = __builtin_bswap16(color);
+
+    // Axis aligned lines are a single span
+    if (y0 == y1) {
+        fonts_fillRow(x0, x1, y0, color, p);
+        return;
+    }
+    if (x0 == x1) {
+        fonts_fillColumn(x0, y0, y1, color, p);
+        return;
+    }
 
     if (steep) {
         swap = x0;
@@ -440,8 +696,6 @@ void fonts_drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t
         swap = x1;
         x1 = y1;
         y1 = swap;
-        //_swap_int16_t(x0, y0);
-        //_swap_int16_t(x1, y1);
     }
 
     if (x0 > x1) {
@@ -452,34 +706,44 @@ void fonts_drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t
         swap = y0;
         y0 = y1;
         y1 = swap;
-        //_swap_int16_t(x0, x1);
-        //_swap_int16_t(y0, y1);
     }
 
-    int16_t dx, dy;
     dx = x1 - x0;
     dy = abs(y1 - y0);
-
-    int16_t err = dx / 2;
-    int16_t ystep;
-
-    if (y0 < y1) {
-        ystep = 1;
-    } else {
-        ystep = -1;
+    err = dx / 2;
+    ystep = (y0 < y1) ? 1 : -1;
+
+    // Whole line on screen, step the pixel address instead of clipping every run
+    if (!fonts_capture && ((steep ? y1 : x1) < LCD_WIDTH) && ((steep ? x1 : y1) < LCD_HEIGHT) &&
+        ((steep ? y0 : x0) < LCD_WIDTH) && ((steep ? x0 : y0) < LCD_HEIGHT)) {
+        int32_t major = steep ? LCD_WIDTH : 1;
+        int32_t minor = steep ? ystep : (ystep * LCD_WIDTH);
+
+        p = steep ? &p[(x0 * LCD_WIDTH) + y0] : &p[(y0 * LCD_WIDTH) + x0];
+        for (x = x0; x <= x1; x++, p += major) {
+            *p = color;
+            err -= dy;
+            if (err < 0) {
+                p += minor;
+                err += dx;
+            }
+        }
+        return;
     }
 
-    for (; x0<=x1; x0++) {
-        if (steep) {
-            pos = ((x0 * LCD_WIDTH) + y0);
-            p[pos] = __builtin_bswap16 (color);
-        } else {
-            pos = ((y0 * LCD_WIDTH) + x0);
-            p[pos] = __builtin_bswap16 (color);
-        }
+    // Bresenham, pixels sharing a major axis step are written as one clipped run
+    for (x = x0, y = y0, run = x0; x <= x1; x++) {
         err -= dy;
+        if ((err < 0) || (x == x1)) {
+            if (steep) {
+                fonts_fillColumn(y, run, x, color, p);
+            } else {
+                fonts_fillRow(run, x, y, color, p);
+            }
+            run = x + 1;
+        }
         if (err < 0) {
-            y0 += ystep;
+            y += ystep;
             err += dx;
         }
     }
@@ -493,23 +757,55 @@ void fonts_drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t
  */
 void fonts_drawRectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color, uint8_t *buff)
 {
-    fonts_drawLine(x1, y1, x2, y1, color, buff);
-    fonts_drawLine(x1, y1, x1, y2, color, buff);
-    fonts_drawLine(x1, y2, x2, y2, color, buff);
-    fonts_drawLine(x2, y1, x2, y2, color, buff);
+    fonts_drawThickRectangle(x1, y1, x2, y2, color, 1, buff);
 }
 
 /**
- * @brief Draw a thick rectangle with single color
- * @param xi&yi -> 2 coordinates of 2 top points.
- * @param thickness -> thickness in pixel.
+ * @brief Draw a thick rectangle with single color, clipped to the LCD
+ * @param xi&yi -> 2 opposite corners in any order, the edges grow inwards from them.
+ * @param thickness -> thickness in pixel. A box narrower or lower than twice the thickness is filled solid.
  * @param color -> color of the Rectangle line
  * @return none
  */
 void fonts_drawThickRectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color, uint8_t thickness, uint8_t *buff)
 {
-    for (uint8_t i = 0; i < thickness; i++) {
-        fonts_drawRectangle(x1 + i, y1 + i, x2 - i, y2 - i, color, buff);
+    uint16_t *p = (uint16_t *) buff;
+    uint16_t swap;
+
+    if (!thickness) {
+        return;
+    }
+
+    if (x1 > x2) {
+        swap = x1;
+        x1 = x2;
+        x2 = swap;
+    }
+
+    if (y1 > y2) {
+        swap = y1;
+        y1 = y2;
+        y2 = swap;
+    }
+
+    fonts_markDamage(y1, y2);
+
+    color = __builtin_bswap16(color);
+
+    // Edges are thicker than the inside, solid block
+    if (((x2 - x1) < (2 * thickness)) || ((y2 - y1) < (2 * thickness))) {
+        for (int32_t y = y1; y <= y2; y++) {
+            fonts_fillRow(x1, x2, y, color, p);
+        }
+        return;
+    }
+
+    // Top and bottom edges are full width rows, the sides are columns between them
+    for (int32_t i = 0; i < thickness; i++) {
+        fonts_fillRow(x1, x2, y1 + i, color, p);
+        fonts_fillRow(x1, x2, y2 - i, color, p);
+        fonts_fillColumn(x1 + i, y1 + thickness, y2 - thickness, color, p);
+        fonts_fillColumn(x2 - i, y1 + thickness, y2 - thickness, color, p);
     }
 }
 
@@ -522,7 +818,163 @@ void fonts_drawThickRectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2
  */
 void fonts_drawFilledRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color, uint8_t *buff)
 {
+    uint16_t *p = (uint16_t *) buff;
+
+    fonts_markDamage(y, y + h);
+
+    color = __builtin_bswap16(color);
+
     for (uint32_t i = 0; i <= h; i++) {
-        fonts_drawLine(x, y + i, x + w, y + i, color, buff);
+        fonts_fillRow(x, x + w, y + i, color, p);
+    }
+}
+
+/**
+ * @brief Draw a list of rectangles, e.g. all detections of a frame
+ * @param boxes -> rectangles with their own color
+ * @param count -> number of rectangles
+ * @param thickness -> thickness in pixel.
+ * @return none
+ */
+void fonts_drawBoxes(const fonts_box_t *boxes, uint16_t count, uint8_t thickness, uint8_t *buff)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        fonts_drawThickRectangle(boxes[i].x1, boxes[i].y1, boxes[i].x2, boxes[i].y2, boxes[i].color, thickness, buff);
+    }
+}
+
+/**
+ * @brief Mark framebuffer rows as changed since the last fonts_getDamage call
+ * @param y1&y2 -> first and last changed row
+ * @return none
+ */
+void fonts_markDamage(uint16_t y1, uint16_t y2)
+{
+    uint16_t swap;
+
+    if (y1 > y2) {
+        swap = y1;
+        y1 = y2;
+        y2 = swap;
+    }
+
+    if (y1 >= LCD_HEIGHT) {
+        return;
+    }
+
+    if (y2 >= LCD_HEIGHT) {
+        y2 = LCD_HEIGHT - 1;
+    }
+
+    for (uint16_t band = y1 / FONTS_DAMAGE_BAND_HEIGHT; band <= y2 / FONTS_DAMAGE_BAND_HEIGHT; band++) {
+        fonts_damage |= (UINT32_C(1) << band);
+    }
+}
+
+/**
+ * @brief Get and clear damaged row bands
+ * @return bit mask of bands changed by drawing primitives
+ */
+uint32_t fonts_getDamage(void)
+{
+    uint32_t damage = fonts_damage;
+
+    fonts_damage = 0;
+
+    return damage;
+}
+
+/**
+ * @brief Capture drawing as runs instead of writing pixels
+ * @param runs -> run list, cleared here
+ * @return none
+ */
+void fonts_captureBegin(fonts_runs_t *runs)
+{
+    runs->count = 0;
+    runs->damage = 0;
+    for (uint16_t band = 0; band < FONTS_DAMAGE_BAND_COUNT; band++) {
+        runs->head[band] = FONTS_RUN_NONE;
+        runs->tail[band] = FONTS_RUN_NONE;
+    }
+
+    fonts_capture = runs;
+}
+
+void fonts_captureEnd(void)
+{
+    fonts_capture = NULL;
+}
+
+/**
+ * @brief Append a run to the captured list, one per damage band it covers
+ * @param x&y -> first pixel
+ * @param len -> pixels in each row
+ * @param height -> rows
+ * @param color -> color in framebuffer byte order
+ * @return none
+ */
+static void fonts_captureRun(int32_t x, int32_t y, int32_t len, int32_t height, uint16_t color)
+{
+    fonts_runs_t *runs = fonts_capture;
+    fonts_run_t *run;
+    int32_t band, rows;
+
+    // Glyphs are not clipped by their callers
+    len = ((x + len) > LCD_WIDTH) ? (LCD_WIDTH - x) : len;
+    height = ((y + height) > LCD_HEIGHT) ? (LCD_HEIGHT - y) : height;
+
+    if ((x < 0) || (y < 0) || (len <= 0)) {
+        return;
+    }
+
+    for (; height > 0; y += rows, height -= rows) {
+        band = y / FONTS_DAMAGE_BAND_HEIGHT;
+        rows = ((band + 1) * FONTS_DAMAGE_BAND_HEIGHT) - y;
+        rows = (rows > height) ? height : rows;
+
+        if (runs->count == FONTS_MAX_RUNS) {
+            return;
+        }
+
+        run = &runs->run[runs->count];
+        run->x = x;
+        run->y = y;
+        run->len = len;
+        run->height = rows;
+        run->color = color;
+        run->next = FONTS_RUN_NONE;
+
+        // Bands keep draw order, later runs overwrite earlier ones
+        if (runs->head[band] == FONTS_RUN_NONE) {
+            runs->head[band] = runs->count;
+        } else {
+            runs->run[runs->tail[band]].next = runs->count;
+        }
+        runs->tail[band] = runs->count;
+        runs->damage |= (UINT32_C(1) << band);
+        runs->count++;
+    }
+}
+
+/**
+ * @brief Draw the captured runs of one band
+ * @param runs -> captured run list
+ * @param band -> damage band
+ * @param buff -> first row of the band, FONTS_DAMAGE_BAND_HEIGHT rows of LCD_WIDTH pixels
+ * @return none
+ */
+void fonts_drawRuns(const fonts_runs_t *runs, uint16_t band, uint8_t *buff)
+{
+    uint16_t *p = (uint16_t *) buff;
+    uint16_t *row;
+    const fonts_run_t *run;
+
+    for (uint16_t i = runs->head[band]; i != FONTS_RUN_NONE; i = run->next) {
+        run = &runs->run[i];
+        row = &p[((run->y - (band * FONTS_DAMAGE_BAND_HEIGHT)) * LCD_WIDTH) + run->x];
+        for (uint32_t j = 0; j < run->height; j++, row += LCD_WIDTH) {
+            fonts_fillSpan(row, run->len, run->color);
+        }
     }
 }
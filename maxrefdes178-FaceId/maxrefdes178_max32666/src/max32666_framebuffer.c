@@ -0,0 +1,228 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <mxc_errors.h>
+#include <mxc_device.h>
+#include <sema.h>
+
+#include "max32666_data.h"
+#include "max32666_debug.h"
+#include "max32666_framebuffer.h"
+#include "maxrefdes178_definitions.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define S_MODULE_NAME   "fb"
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+// External SRAM shares the QSPI bus with the MAX78000 link and is not memory mapped, frames stay in internal RAM
+static uint8_t framebuffer_pool[FRAMEBUFFER_COUNT][LCD_DATA_SIZE];
+static volatile framebuffer_state_e framebuffer_state[FRAMEBUFFER_COUNT];
+static uint32_t framebuffer_capture_time[FRAMEBUFFER_COUNT];  // MAX78000 video clock
+static volatile uint32_t framebuffer_dropped = 0;
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+static int framebuffer_index(uint8_t *buffer);
+static void framebuffer_lock(void);
+static void framebuffer_unlock(void);
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+int framebuffer_init(void)
+{
+    for (int i = 0; i < FRAMEBUFFER_COUNT; i++) {
+        framebuffer_state[i] = FRAMEBUFFER_STATE_FREE;
+    }
+
+    // First buffer is the screen canvas until a frame is received
+    framebuffer_state[0] = FRAMEBUFFER_STATE_DISPLAY;
+    lcd_data.buffer = framebuffer_pool[0];
+
+    return E_NO_ERROR;
+}
+
+uint8_t *framebuffer_receive_acquire(void)
+{
+    uint8_t *buffer = NULL;
+    int i;
+
+    framebuffer_lock();
+
+    // One QSPI receive is in flight at a time, a buffer left in RECEIVE belongs to a failed transfer
+    for (i = 0; i < FRAMEBUFFER_COUNT; i++) {
+        if (framebuffer_state[i] == FRAMEBUFFER_STATE_RECEIVE) {
+            framebuffer_state[i] = FRAMEBUFFER_STATE_FREE;
+        }
+    }
+
+    for (i = 0; (i < FRAMEBUFFER_COUNT) && !buffer; i++) {
+        if (framebuffer_state[i] == FRAMEBUFFER_STATE_FREE) {
+            framebuffer_state[i] = FRAMEBUFFER_STATE_RECEIVE;
+            buffer = framebuffer_pool[i];
+        }
+    }
+
+    // Newer frame replaces the one not composed yet
+    for (i = 0; (i < FRAMEBUFFER_COUNT) && !buffer; i++) {
+        if (framebuffer_state[i] == FRAMEBUFFER_STATE_READY) {
+            framebuffer_state[i] = FRAMEBUFFER_STATE_RECEIVE;
+            framebuffer_dropped++;
+            buffer = framebuffer_pool[i];
+        }
+    }
+
+    // Compositor and LCD own every buffer, the frame is drained
+    if (!buffer) {
+        framebuffer_dropped++;
+    }
+
+    framebuffer_unlock();
+
+    return buffer;
+}
+
+void framebuffer_receive_done(uint8_t *buffer, uint32_t capture_time)
+{
+    int index = framebuffer_index(buffer);
+
+    if (index < 0) {
+        PR_ERROR("unknown buffer %p", buffer);
+        return;
+    }
+
+    framebuffer_lock();
+    if (framebuffer_state[index] == FRAMEBUFFER_STATE_RECEIVE) {
+        // Only the latest frame waits for composition
+        for (int i = 0; i < FRAMEBUFFER_COUNT; i++) {
+            if (framebuffer_state[i] == FRAMEBUFFER_STATE_READY) {
+                framebuffer_state[i] = FRAMEBUFFER_STATE_FREE;
+                framebuffer_dropped++;
+            }
+        }
+        framebuffer_capture_time[index] = capture_time;
+        framebuffer_state[index] = FRAMEBUFFER_STATE_READY;
+    }
+    framebuffer_unlock();
+}
+
+uint8_t *framebuffer_compose_acquire(uint32_t *capture_time)
+{
+    uint8_t *buffer = NULL;
+
+    framebuffer_lock();
+    for (int i = 0; i < FRAMEBUFFER_COUNT; i++) {
+        if (framebuffer_state[i] == FRAMEBUFFER_STATE_READY) {
+            framebuffer_state[i] = FRAMEBUFFER_STATE_COMPOSE;
+            *capture_time = framebuffer_capture_time[i];
+            buffer = framebuffer_pool[i];
+            break;
+        }
+    }
+    framebuffer_unlock();
+
+    return buffer;
+}
+
+void framebuffer_display(uint8_t *buffer)
+{
+    int index = framebuffer_index(buffer);
+
+    if (index < 0) {
+        PR_ERROR("unknown buffer %p", buffer);
+        return;
+    }
+
+    // Called once the previous LCD DMA completed, the buffer it read is released.
+    // The renderer may call it from core1
+    framebuffer_lock();
+    for (int i = 0; i < FRAMEBUFFER_COUNT; i++) {
+        if ((i != index) && (framebuffer_state[i] == FRAMEBUFFER_STATE_DISPLAY)) {
+            framebuffer_state[i] = FRAMEBUFFER_STATE_FREE;
+        }
+    }
+    framebuffer_state[index] = FRAMEBUFFER_STATE_DISPLAY;
+    framebuffer_unlock();
+
+    lcd_data.buffer = buffer;
+}
+
+uint32_t framebuffer_dropped_frames(void)
+{
+    return framebuffer_dropped;
+}
+
+static int framebuffer_index(uint8_t *buffer)
+{
+    for (int i = 0; i < FRAMEBUFFER_COUNT; i++) {
+        if (buffer == framebuffer_pool[i]) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+// States are changed from the QSPI DMA interrupt on core0 and by the renderer on core1.
+// Interrupts are masked first, so an interrupt never spins on the semaphore held by its own core
+static void framebuffer_lock(void)
+{
+    __disable_irq();
+    while(MXC_SEMA_GetSema(MAX32666_SEMAPHORE_FRAMEBUFFER) == E_BUSY) {}
+}
+
+static void framebuffer_unlock(void)
+{
+    MXC_SEMA_FreeSema(MAX32666_SEMAPHORE_FRAMEBUFFER);
+    __enable_irq();
+}
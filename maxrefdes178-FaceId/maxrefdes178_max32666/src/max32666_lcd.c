@@ -43,6 +43,7 @@
 #include "max32666_data.h"
 #include "max32666_debug.h"
 #include "max32666_expander.h"
+#include "max32666_fonts.h"
 #include "max32666_lcd.h"
 #include "max32666_pmic.h"
 #include "max32666_spi_dma.h"
@@ -99,6 +100,11 @@
 //-----------------------------------------------------------------------------
 // Typedefs
 //-----------------------------------------------------------------------------
+typedef enum {
+    LCD_STREAM_IDLE = 0,
+    LCD_STREAM_ARMED,     // full screen window is open and CS asserted, waiting a frame
+    LCD_STREAM_ACTIVE,    // frame is being written band by band
+} lcd_stream_state_e;
 
 
 //-----------------------------------------------------------------------------
@@ -108,6 +114,7 @@ static const mxc_gpio_cfg_t lcd_dc_pin = MAX32666_LCD_DC_PIN;
 static const mxc_gpio_cfg_t lcd_cs_pin = MAX32666_LCD_CS_PIN;
 static uint8_t lcd_x_shift = 0;
 static uint8_t lcd_y_shift = 0;
+static volatile lcd_stream_state_e lcd_stream_state = LCD_STREAM_IDLE;
 
 
 //-----------------------------------------------------------------------------
@@ -280,6 +287,9 @@ static int lcd_setAddrWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
 
 int lcd_set_rotation(lcd_rotation_e lcd_rotation)
 {
+    lcd_streamWait();
+    lcd_streamDisarm();
+
     for (int i = 0; (i < 1000000) && (spi_dma_busy_flag(MAX32666_LCD_DMA_CHANNEL)); i++);
 
     spi_assert_cs();
@@ -341,7 +351,7 @@ int lcd_drawImage(uint8_t *data)
     static const uint16_t w = LCD_WIDTH;
     static const uint16_t h = LCD_HEIGHT;
 
-    if (spi_dma_busy_flag(MAX32666_LCD_DMA_CHANNEL)) {
+    if ((lcd_streamDisarm() != E_NO_ERROR) || spi_dma_busy_flag(MAX32666_LCD_DMA_CHANNEL)) {
         PR_WARN("lcd spi busy");
         return E_BUSY;
     }
@@ -353,8 +363,6 @@ int lcd_drawImage(uint8_t *data)
 
     spi_dma(MAX32666_LCD_DMA_CHANNEL, MAX32666_LCD_SPI, data, NULL, (w * h * LCD_BYTE_PER_PIXEL), MAX32666_LCD_DMA_REQSEL_SPITX, spi_deassert_cs);
 
-    lcd_data.refresh_screen = 0;
-
 //    spi_dma(MAX32666_LCD_DMA_CHANNEL, MAX32666_LCD_SPI, data, NULL, (w * h * LCD_BYTE_PER_PIXEL), MAX32666_LCD_DMA_REQSEL_SPITX, NULL);
 //    spi_dma_wait(MAX32666_LCD_DMA_CHANNEL, MAX32666_LCD_SPI);
 //    spi_deassert_cs();
@@ -362,6 +370,186 @@ int lcd_drawImage(uint8_t *data)
     return E_NO_ERROR;
 }
 
+/**
+ * @brief Draw a region of a framebuffer on the screen
+ * @param x&y -> start point of the region
+ * @param w&h -> width & height of the region
+ * @param data -> pointer of the LCD_WIDTH x LCD_HEIGHT framebuffer
+ * @return error code
+ */
+int lcd_drawRegion(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data)
+{
+    if ((lcd_streamDisarm() != E_NO_ERROR) || spi_dma_busy_flag(MAX32666_LCD_DMA_CHANNEL)) {
+        PR_WARN("lcd spi busy");
+        return E_BUSY;
+    }
+
+    if ((w == 0) || (h == 0) || ((x + w) > LCD_WIDTH) || ((y + h) > LCD_HEIGHT)) {
+        return E_BAD_PARAM;
+    }
+
+    lcd_setAddrWindow(x, y, x + w - 1, y + h - 1);
+
+    GPIO_SET(lcd_dc_pin);
+    spi_assert_cs();
+
+    if (w == LCD_WIDTH) {
+        // Full width rows are contiguous in the framebuffer
+        spi_dma(MAX32666_LCD_DMA_CHANNEL, MAX32666_LCD_SPI, &data[y * LCD_WIDTH * LCD_BYTE_PER_PIXEL], NULL,
+                (w * h * LCD_BYTE_PER_PIXEL), MAX32666_LCD_DMA_REQSEL_SPITX, NULL);
+        spi_dma_wait(MAX32666_LCD_DMA_CHANNEL, MAX32666_LCD_SPI);
+    } else {
+        // Controller wraps rows inside the address window, send one row at a time
+        for (uint16_t row = y; row < (y + h); row++) {
+            spi_dma(MAX32666_LCD_DMA_CHANNEL, MAX32666_LCD_SPI, &data[((row * LCD_WIDTH) + x) * LCD_BYTE_PER_PIXEL], NULL,
+                    (w * LCD_BYTE_PER_PIXEL), MAX32666_LCD_DMA_REQSEL_SPITX, NULL);
+            spi_dma_wait(MAX32666_LCD_DMA_CHANNEL, MAX32666_LCD_SPI);
+        }
+    }
+
+    spi_deassert_cs();
+
+    return E_NO_ERROR;
+}
+
+/**
+ * @brief Draw only the damaged row bands of a framebuffer
+ * @param damage -> band mask from fonts_getDamage
+ * @param data -> pointer of the LCD_WIDTH x LCD_HEIGHT framebuffer
+ * @return error code
+ */
+int lcd_drawDamage(uint32_t damage, uint8_t *data)
+{
+    int ret;
+    uint16_t band = 0;
+    uint16_t run;
+
+    while (band < FONTS_DAMAGE_BAND_COUNT) {
+        if (!(damage & (UINT32_C(1) << band))) {
+            band++;
+            continue;
+        }
+
+        // Merge consecutive damaged bands into one window
+        for (run = 1; ((band + run) < FONTS_DAMAGE_BAND_COUNT) && (damage & (UINT32_C(1) << (band + run))); run++);
+
+        ret = lcd_drawRegion(0, band * FONTS_DAMAGE_BAND_HEIGHT, LCD_WIDTH, run * FONTS_DAMAGE_BAND_HEIGHT, data);
+        if (ret != E_NO_ERROR) {
+            return ret;
+        }
+
+        band += run;
+    }
+
+    return E_NO_ERROR;
+}
+
+/**
+ * @brief Open a full screen window for a frame streamed from interrupt context
+ * @return error code, E_BUSY while the LCD is drawing
+ */
+int lcd_streamArm(void)
+{
+    if (lcd_stream_state != LCD_STREAM_IDLE) {
+        return (lcd_stream_state == LCD_STREAM_ARMED) ? E_NO_ERROR : E_BUSY;
+    }
+
+    if (spi_dma_busy_flag(MAX32666_LCD_DMA_CHANNEL)) {
+        return E_BUSY;
+    }
+
+    lcd_setAddrWindow(0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1);
+
+    // RAMWR continues with every byte while CS stays asserted
+    GPIO_SET(lcd_dc_pin);
+    spi_assert_cs();
+
+    lcd_stream_state = LCD_STREAM_ARMED;
+
+    return E_NO_ERROR;
+}
+
+/**
+ * @brief Close an armed window, drawing functions do this before they take the LCD
+ * @return error code, E_BUSY while a frame is being streamed
+ */
+int lcd_streamDisarm(void)
+{
+    int ret = E_NO_ERROR;
+
+    __disable_irq();
+    if (lcd_stream_state == LCD_STREAM_ACTIVE) {
+        ret = E_BUSY;
+    } else if (lcd_stream_state == LCD_STREAM_ARMED) {
+        spi_deassert_cs();
+        lcd_stream_state = LCD_STREAM_IDLE;
+    }
+    __enable_irq();
+
+    return ret;
+}
+
+/**
+ * @brief Take the armed window for one frame, interrupt context
+ * @return error code, E_BUSY if the LCD is not armed
+ */
+int lcd_streamBegin(void)
+{
+    if (lcd_stream_state != LCD_STREAM_ARMED) {
+        return E_BUSY;
+    }
+
+    lcd_stream_state = LCD_STREAM_ACTIVE;
+
+    return E_NO_ERROR;
+}
+
+/**
+ * @brief Send the next rows of the streamed frame, interrupt context
+ * @param data -> pixels, whole rows
+ * @param len -> bytes
+ * @param callback -> called from the LCD DMA interrupt once sent
+ * @return error code
+ */
+int lcd_streamBand(uint8_t *data, uint32_t len, void (*callback)(void))
+{
+    if (lcd_stream_state != LCD_STREAM_ACTIVE) {
+        return E_BAD_STATE;
+    }
+
+    return spi_dma(MAX32666_LCD_DMA_CHANNEL, MAX32666_LCD_SPI, data, NULL, len, MAX32666_LCD_DMA_REQSEL_SPITX, callback);
+}
+
+/**
+ * @brief End the streamed frame, the LCD has to be armed again for the next one
+ * @return none
+ */
+void lcd_streamEnd(void)
+{
+    spi_deassert_cs();
+    lcd_stream_state = LCD_STREAM_IDLE;
+}
+
+/**
+ * @brief Wait until the streamed frame is sent, e.g. before QSPI writes
+ * @return error code
+ */
+int lcd_streamWait(void)
+{
+    uint32_t cnt = SPI_TIMEOUT_CNT;
+
+    while ((lcd_stream_state == LCD_STREAM_ACTIVE) && cnt) {
+        cnt--;
+    }
+
+    if (cnt == 0) {
+        PR_WARN("stream timeout");
+        return E_TIME_OUT;
+    }
+
+    return E_NO_ERROR;
+}
+
 int lcd_notification(uint16_t color, const char *notification)
 {
     snprintf(lcd_data.notification, sizeof(lcd_data.notification) - 1, notification);
@@ -58,19 +58,24 @@
 #include "max32666_ext_flash.h"
 #include "max32666_ext_sram.h"
 #include "max32666_fonts.h"
+#include "max32666_framebuffer.h"
 #include "max32666_fuel_gauge.h"
 #include "max32666_i2c.h"
 #include "max32666_lcd.h"
 #include "max32666_lcd_images.h"
+#include "max32666_passthrough.h"
 #include "max32666_pmic.h"
 #include "max32666_powmon.h"
 #include "max32666_qspi_master.h"
+#include "max32666_render.h"
 #include "max32666_sdcard.h"
 #include "max32666_spi_dma.h"
+#include "max32666_time_sync.h"
 #include "max32666_timer_led_button.h"
 #include "max32666_touch.h"
 #include "max32666_usb.h"
 #include "maxrefdes178_definitions.h"
+#include "maxrefdes178_timing.h"
 #include "maxrefdes178_version.h"
 
 
@@ -107,6 +112,7 @@ static void core0_icc(int enable);
 static void core1_icc(int enable);
 static void run_application(void);
 static int refresh_screen(void);
+static void restore_logo(uint32_t damage);
 
 
 //-----------------------------------------------------------------------------
@@ -130,6 +136,8 @@ int main(void)
         MXC_SYS_Reset_Periph(MXC_SYS_RESET_SYSTEM);
     }
 
+    timing_init();
+
     device_info.device_version.max32666.major = S_VERSION_MAJOR;
     device_info.device_version.max32666.minor = S_VERSION_MINOR;
     device_info.device_version.max32666.build = S_VERSION_BUILD;
@@ -198,6 +206,8 @@ int main(void)
 //        pmic_led_red(1);
 //    }
 
+    framebuffer_init();
+
     ret = lcd_init();
     if (ret != E_NO_ERROR) {
         PR_ERROR("lcd_init failed %d", ret);
@@ -238,6 +248,12 @@ int main(void)
         pmic_led_red(1);
     }
 
+    ret = time_sync_init();
+    if (ret != E_NO_ERROR) {
+        PR_ERROR("time_sync_init failed %d", ret);
+        pmic_led_red(1);
+    }
+
 //    ret = usb_init();
 //    if (ret != E_NO_ERROR) {
 //        PR_ERROR("usb_init failed %d", ret);
@@ -328,8 +344,7 @@ int main(void)
         qspi_packet_type_e qspi_packet_type_rx = 0;
         for (int try = 0; try < 3; try++) {
             qspi_master_send_video(NULL, 0, QSPI_PACKET_TYPE_VIDEO_FACEID_SUBJECTS_CMD);
-            qspi_master_wait_video_int();
-            qspi_master_video_rx_worker(&qspi_packet_type_rx);
+            qspi_master_video_rx_wait(&qspi_packet_type_rx);
             if (device_status.faceid_embed_subject_names_size) {
                 break;
             }
@@ -337,16 +352,14 @@ int main(void)
 
         for (int try = 0; try < 3; try++) {
             qspi_master_send_video(NULL, 0, QSPI_PACKET_TYPE_VIDEO_VERSION_CMD);
-            qspi_master_wait_video_int();
-            qspi_master_video_rx_worker(&qspi_packet_type_rx);
+            qspi_master_video_rx_wait(&qspi_packet_type_rx);
             if (device_info.device_version.max78000_video.major || device_info.device_version.max78000_video.minor) {
                 break;
             }
         }
         for (int try = 0; try < 3; try++) {
             qspi_master_send_audio(NULL, 0, QSPI_PACKET_TYPE_AUDIO_VERSION_CMD);
-            qspi_master_wait_audio_int();
-            qspi_master_audio_rx_worker(&qspi_packet_type_rx);
+            qspi_master_audio_rx_wait(&qspi_packet_type_rx);
             if (device_info.device_version.max78000_audio.major || device_info.device_version.max78000_audio.minor) {
                 break;
             }
@@ -354,16 +367,14 @@ int main(void)
 
         for (int try = 0; try < 3; try++) {
             qspi_master_send_video(NULL, 0, QSPI_PACKET_TYPE_VIDEO_DEMO_NAME_CMD);
-            qspi_master_wait_video_int();
-            qspi_master_video_rx_worker(&qspi_packet_type_rx);
+            qspi_master_video_rx_wait(&qspi_packet_type_rx);
             if (device_info.max78000_video_demo_name[0]) {
                 break;
             }
         }
         for (int try = 0; try < 3; try++) {
             qspi_master_send_audio(NULL, 0, QSPI_PACKET_TYPE_AUDIO_DEMO_NAME_CMD);
-            qspi_master_wait_audio_int();
-            qspi_master_audio_rx_worker(&qspi_packet_type_rx);
+            qspi_master_audio_rx_wait(&qspi_packet_type_rx);
             if (device_info.max78000_audio_demo_name[0]) {
                 break;
             }
@@ -421,18 +432,29 @@ int main(void)
                 expander_worker();
 
                 if (lcd_data.refresh_screen && !spi_dma_busy_flag(MAX32666_LCD_DMA_CHANNEL)) {
-                    memcpy(lcd_data.buffer, adi_logo, sizeof(lcd_data.buffer));
+                    memcpy(lcd_data.buffer, adi_logo, LCD_DATA_SIZE);
                     if (strlen(lcd_data.notification) < (LCD_WIDTH / Font_11x18.width)) {
                         fonts_putStringCentered(LCD_HEIGHT - Font_11x18.height - 3, lcd_data.notification, &Font_11x18, lcd_data.notification_color, lcd_data.buffer);
                     } else {
                         fonts_putStringCentered(LCD_HEIGHT - Font_7x10.height - 3, lcd_data.notification, &Font_7x10, lcd_data.notification_color, lcd_data.buffer);
                     }
                     lcd_drawImage(lcd_data.buffer);
+                    lcd_data.refresh_screen = 0;
                 }
             }
         }
     }
 
+    ret = render_init();
+    if (ret != E_NO_ERROR) {
+        PR_ERROR("render_init failed %d", ret);
+    }
+
+    ret = passthrough_init();
+    if (ret != E_NO_ERROR) {
+        PR_ERROR("passthrough_init failed %d", ret);
+    }
+
     PR_INFO("core 0 init completed");
 
     run_application();
@@ -445,6 +467,7 @@ static void run_application(void)
     qspi_packet_type_e qspi_packet_type_rx = 0;
     video_frame_color = WHITE;
     uint16_t touch_x1, touch_y1;
+    uint32_t frame_capture_time;
 
     core0_icc(1);
 
@@ -460,6 +483,8 @@ static void run_application(void)
                 break;
             case QSPI_PACKET_TYPE_VIDEO_CLASSIFICATION_RES:
                 timestamps.activity_detected = timer_ms_tick;
+                time_sync_record_latency(LATENCY_VIDEO_CLASSIFICATION, TIME_SYNC_DEVICE_VIDEO,
+                        device_status.classification_video.capture_timestamp_us);
                 if (device_status.classification_video.classification == CLASSIFICATION_UNKNOWN) {
                     video_string_color = RED;
                     video_frame_color = RED;
@@ -554,6 +579,10 @@ static void run_application(void)
                 if (!device_settings.enable_max78000_video) {
                     lcd_data.refresh_screen = 1;
                 }
+
+                // Voice command is applied
+                time_sync_record_latency(LATENCY_AUDIO_CLASSIFICATION, TIME_SYNC_DEVICE_AUDIO,
+                        device_status.classification_audio.capture_timestamp_us);
                 break;
             default:
                 break;
@@ -564,6 +593,20 @@ static void run_application(void)
         qspi_master_video_tx_worker();
         qspi_master_audio_tx_worker();
 
+        // Synchronize MAX78000 clocks
+        if ((timer_ms_tick - timestamps.time_sync) > MAX32666_TIME_SYNC_INTERVAL) {
+            if (time_sync_worker() == E_NO_ERROR) {
+                timestamps.time_sync = timer_ms_tick;
+            }
+        }
+
+        // Update stage and latency percentiles for LCD and BLE timing command
+        if ((timer_ms_tick - timestamps.latency_statistics) > BLE_STATISTICS_INTERVAL) {
+            timestamps.latency_statistics = timer_ms_tick;
+            timing_get(device_status.timing.max32666);
+            time_sync_get_timing(&device_status.timing);
+        }
+
         // Send BLE periodic statistics
         if (device_settings.enable_ble_send_statistics && device_status.ble_connected) {
             if ((timer_ms_tick - timestamps.statistics_sent) > BLE_STATISTICS_INTERVAL) {
@@ -577,15 +620,17 @@ static void run_application(void)
             // If video is not available for a long time, draw logo and refresh periodically
             if ((timer_ms_tick - timestamps.video_data_received) > LCD_NO_VIDEO_REFRESH_DURATION) {
                 timestamps.video_data_received = timer_ms_tick;
-                memcpy(lcd_data.buffer, adi_logo, sizeof(lcd_data.buffer));
+                render_sync();
+                memcpy(lcd_data.buffer, adi_logo, LCD_DATA_SIZE);
                 snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "No video!");
                 fonts_putStringCentered(16, lcd_string_buff, &Font_11x18, RED, lcd_data.buffer);
                 lcd_data.refresh_screen = 1;
             }
         } else {
-            // If video is disabled, draw logo and refresh periodically
+            // If video is disabled, restore logo under the last overlay and refresh periodically
             if ((timer_ms_tick - timestamps.screen_drew) > LCD_VIDEO_DISABLE_REFRESH_DURATION) {
-                memcpy(lcd_data.buffer, adi_logo, sizeof(lcd_data.buffer));
+                render_sync();
+                restore_logo(render_take_overlay_damage());
                 snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "Video disabled");
                 fonts_putStringCentered(15, lcd_string_buff, &Font_11x18, RED, lcd_data.buffer);
                 lcd_data.refresh_screen = 1;
@@ -619,6 +664,7 @@ static void run_application(void)
         }
 
         if (device_status.ble_running_status_changed) {
+#ifndef RENDER_ON_CORE1
             if (device_settings.enable_ble) {
                 PR_INFO("Enable Core1");
                 Core1_Start();
@@ -626,6 +672,7 @@ static void run_application(void)
                 PR_INFO("Disable Core1");
                 Core1_Stop();
             }
+#endif
             device_status.ble_running_status_changed = 0;
         }
 
@@ -678,6 +725,12 @@ static void run_application(void)
             powmon_worker();
         }
 
+        // QSPI link statistics worker
+        if ((timer_ms_tick - timestamps.qspi_link_statistics) > MAX32666_QSPI_LINK_STATISTICS_INTERVAL) {
+            timestamps.qspi_link_statistics = timer_ms_tick;
+            qspi_master_link_statistics_worker();
+        }
+
         // LED worker
         if ((timer_ms_tick - timestamps.led) > MAX32666_LED_INTERVAL) {
             timestamps.led = timer_ms_tick;
@@ -710,8 +763,20 @@ static void run_application(void)
         // USB worker
 //        usb_worker();
 
+        // Frame durations measured on core1
+        render_timing_worker();
+
+        // Video frame is on LCD when its DMA completes, or its last band when streamed
+        if (render_frame_shown(&frame_capture_time) || passthrough_frame_shown(&frame_capture_time)) {
+            time_sync_record_latency(LATENCY_VIDEO_FRAME, TIME_SYNC_DEVICE_VIDEO, frame_capture_time);
+        }
+
+        // Keep the LCD ready for the next streamed frame
+        passthrough_worker();
+
         // Refresh LCD
-        if (lcd_data.refresh_screen && device_settings.enable_lcd && !spi_dma_busy_flag(MAX32666_LCD_DMA_CHANNEL)) {
+        // Frames are received into their own framebuffer, composition does not wait the QSPI link
+        if (lcd_data.refresh_screen && device_settings.enable_lcd && render_ready()) {
             refresh_screen();
         }
 
@@ -722,14 +787,38 @@ static void run_application(void)
 
 static int refresh_screen(void)
 {
+    uint32_t frame_capture_time = 0;
+    uint8_t *frame = NULL;
+    uint8_t *canvas;
+    int overlay_only;
+
+    render_begin();
+    lcd_data.refresh_screen = 0;
+
+    // Latest received frame is composed, otherwise overlays are redrawn on the frame on screen
+    if (device_settings.enable_max78000_video) {
+        frame = framebuffer_compose_acquire(&frame_capture_time);
+    }
+    canvas = frame ? frame : lcd_data.buffer;
+
+    // Streamed frames bypass the framebuffers, the overlay is captured and drawn into the next one
+    overlay_only = !frame && device_settings.enable_max78000_video && passthrough_streaming();
+    if (overlay_only) {
+        if (passthrough_overlay_begin() != E_NO_ERROR) {
+            lcd_data.refresh_screen = 1;
+            return E_BUSY;
+        }
+        canvas = NULL;
+    }
+
     if (device_status.fuel_gauge_working) {
         snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "%3d%%", device_status.statistics.battery_soc);
         if (device_status.usb_chgin) {
-            fonts_putString(LCD_WIDTH - 31, 3, lcd_string_buff, &Font_7x10, ORANGE, 0, 0, lcd_data.buffer);
+            render_putString(LCD_WIDTH - 31, 3, lcd_string_buff, &Font_7x10, ORANGE, canvas);
         } else if (device_status.statistics.battery_soc <= MAX32666_SOC_WARNING_LEVEL) {
-            fonts_putString(LCD_WIDTH - 31, 3, lcd_string_buff, &Font_7x10, RED, 0, 0, lcd_data.buffer);
+            render_putString(LCD_WIDTH - 31, 3, lcd_string_buff, &Font_7x10, RED, canvas);
         } else {
-            fonts_putString(LCD_WIDTH - 31, 3, lcd_string_buff, &Font_7x10, GREEN, 0, 0, lcd_data.buffer);
+            render_putString(LCD_WIDTH - 31, 3, lcd_string_buff, &Font_7x10, GREEN, canvas);
         }
     }
 
@@ -737,12 +826,14 @@ static int refresh_screen(void)
     if (device_settings.enable_max78000_video && device_settings.enable_max78000_video_cnn) {
         if (device_status.classification_video.classification != CLASSIFICATION_NOTHING) {
             strncpy(lcd_string_buff, device_status.classification_video.result, sizeof(lcd_string_buff) - 1);
-            fonts_putStringCentered(LCD_HEIGHT - 29, lcd_string_buff, &Font_16x26, video_string_color, lcd_data.buffer);
+            render_putStringCentered(LCD_HEIGHT - 29, lcd_string_buff, &Font_16x26, video_string_color, canvas);
         }
-        fonts_drawRectangle(FACEID_RECTANGLE_X1 - 0, FACEID_RECTANGLE_Y1 - 0, FACEID_RECTANGLE_X2 + 0, FACEID_RECTANGLE_Y2 + 0, video_frame_color, lcd_data.buffer);
-        fonts_drawRectangle(FACEID_RECTANGLE_X1 - 1, FACEID_RECTANGLE_Y1 - 1, FACEID_RECTANGLE_X2 + 1, FACEID_RECTANGLE_Y2 + 1, video_frame_color, lcd_data.buffer);
-        fonts_drawRectangle(FACEID_RECTANGLE_X1 - 2, FACEID_RECTANGLE_Y1 - 2, FACEID_RECTANGLE_X2 + 2, FACEID_RECTANGLE_Y2 + 2, BLACK, lcd_data.buffer);
-        fonts_drawRectangle(FACEID_RECTANGLE_X1 - 3, FACEID_RECTANGLE_Y1 - 3, FACEID_RECTANGLE_X2 + 3, FACEID_RECTANGLE_Y2 + 3, BLACK, lcd_data.buffer);
+        // 2 pixel result colored frame inside a 2 pixel black outline
+        const fonts_box_t faceid_boxes[] = {
+            {FACEID_RECTANGLE_X1 - 1, FACEID_RECTANGLE_Y1 - 1, FACEID_RECTANGLE_X2 + 1, FACEID_RECTANGLE_Y2 + 1, video_frame_color},
+            {FACEID_RECTANGLE_X1 - 3, FACEID_RECTANGLE_Y1 - 3, FACEID_RECTANGLE_X2 + 3, FACEID_RECTANGLE_Y2 + 3, BLACK},
+        };
+        render_drawBoxes(faceid_boxes, sizeof(faceid_boxes) / sizeof(faceid_boxes[0]), 2, canvas);
     }
 
     if (device_settings.enable_lcd_statistics) {
@@ -750,44 +841,58 @@ static int refresh_screen(void)
 
         // LCD frame per seconds
         snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "FPS:%.2f", (double)device_status.statistics.lcd_fps);
-        fonts_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, 0, 0, lcd_data.buffer);
+        render_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, canvas);
         line_pos += 12;
 
         // FaceID duration (MAX78000 Video CNN + embeddings calculation)
         snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "FaceID:%d ms", device_status.statistics.max78000_video.cnn_duration_us / 1000);
-        fonts_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, 0, 0, lcd_data.buffer);
+        render_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, canvas);
         line_pos += 12;
 
         // KWS duration (MAX78000 Audio CNN)
         snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "KWS:%d us", device_status.statistics.max78000_audio.cnn_duration_us);
-        fonts_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, 0, 0, lcd_data.buffer);
+        render_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, canvas);
         line_pos += 12;
 
         // Video camera capture duration (frame capture)
         snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "VidCap:%d ms", device_status.statistics.max78000_video.capture_duration_us / 1000);
-        fonts_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, 0, 0, lcd_data.buffer);
+        render_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, canvas);
         line_pos += 12;
 
         // Video communication duration (frame transfer from MAX78000 to MAX32666 over QSPI)
         snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "VidComm:%d ms", device_status.statistics.max78000_video.communication_duration_us / 1000);
-        fonts_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, 0, 0, lcd_data.buffer);
+        render_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, canvas);
+        line_pos += 12;
+
+        // Camera to LCD latency p50/p99 (synchronized MAX78000 video timestamps)
+        snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "E2E:%d/%d ms", device_status.timing.latency[LATENCY_VIDEO_FRAME].p50_us / 1000,
+                device_status.timing.latency[LATENCY_VIDEO_FRAME].p99_us / 1000);
+        render_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, canvas);
+        line_pos += 12;
+
+        // End of keyword to voice command latency p50/p99
+        snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "KWS E2E:%d/%d ms", device_status.timing.latency[LATENCY_AUDIO_CLASSIFICATION].p50_us / 1000,
+                device_status.timing.latency[LATENCY_AUDIO_CLASSIFICATION].p99_us / 1000);
+        render_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, canvas);
         line_pos += 12;
 
         // MAX78000 Video power
         snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "Vid:%d mW", device_status.statistics.max78000_video_power_mw);
-        fonts_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, 0, 0, lcd_data.buffer);
+        render_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, canvas);
         line_pos += 12;
 
         // MAX78000 Audio power
         snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "Aud:%d mW", device_status.statistics.max78000_audio_power_mw);
-        fonts_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, 0, 0, lcd_data.buffer);
+        render_putString(3, line_pos, lcd_string_buff, &Font_7x10, MAGENTA, canvas);
         line_pos += 12;
 
         if ((timestamps.screen_drew - timestamps.faceid_subject_names_received) < LCD_NOTIFICATION_DURATION) {
             line_pos += 5;
-            for (int i = 0; i < device_status.faceid_embed_subject_names_size; i += strlen(&device_status.faceid_embed_subject_names[i]) + 1) {
+            // Up to FACEID_MAX_SUBJECT names, as many as fit below the statistics
+            for (int i = 0; (i < device_status.faceid_embed_subject_names_size) && ((line_pos + 12) <= LCD_HEIGHT);
+                    i += strlen(&device_status.faceid_embed_subject_names[i]) + 1) {
                 snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "%s", &device_status.faceid_embed_subject_names[i]);
-                fonts_putString(3, line_pos, lcd_string_buff, &Font_7x10, CYAN, 0, 0, lcd_data.buffer);
+                render_putString(3, line_pos, lcd_string_buff, &Font_7x10, CYAN, canvas);
                 line_pos += 12;
             }
         }
@@ -797,13 +902,13 @@ static int refresh_screen(void)
     if (device_settings.enable_max78000_video == 0) {
         // Print Instruction            
 	    snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "Say 'Cube'+ a command");
-	    fonts_putStringCentered(59, lcd_string_buff, &Font_11x18, ORANGE, adi_logo);
+	    render_putStringCentered(59, lcd_string_buff, &Font_11x18, ORANGE, adi_logo);
         // Start button
-        fonts_drawFilledRectangle(LCD_START_BUTTON_X1, LCD_START_BUTTON_Y1, LCD_START_BUTTON_X2 - LCD_START_BUTTON_X1,
-                                  LCD_START_BUTTON_Y2 - LCD_START_BUTTON_Y1, LGRAY, lcd_data.buffer);
-        fonts_drawThickRectangle(LCD_START_BUTTON_X1, LCD_START_BUTTON_Y1, LCD_START_BUTTON_X2, LCD_START_BUTTON_Y2, LIGHTBLUE, 4, lcd_data.buffer);
+        render_drawFilledRectangle(LCD_START_BUTTON_X1, LCD_START_BUTTON_Y1, LCD_START_BUTTON_X2 - LCD_START_BUTTON_X1,
+                                   LCD_START_BUTTON_Y2 - LCD_START_BUTTON_Y1, LGRAY, canvas);
+        render_drawThickRectangle(LCD_START_BUTTON_X1, LCD_START_BUTTON_Y1, LCD_START_BUTTON_X2, LCD_START_BUTTON_Y2, LIGHTBLUE, 4, canvas);
         snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "Start Video");
-        fonts_putStringCentered(LCD_START_BUTTON_Y1 + 10, lcd_string_buff, &Font_16x26, ADIBLUE, lcd_data.buffer);
+        render_putStringCentered(LCD_START_BUTTON_Y1 + 10, lcd_string_buff, &Font_16x26, ADIBLUE, canvas);
     }
 	
 	// If the status of voice command enable is changed, show on screen for 2sec
@@ -814,7 +919,7 @@ static int refresh_screen(void)
 		   voicecommand_time = timestamps.screen_drew ;	
 		if ((timestamps.screen_drew - voicecommand_time) < 2*LCD_CLASSIFICATION_DURATION) {
 			snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "Voice Command Enable:%d", device_settings.enable_voicecommand&0x1);
-			fonts_putStringCentered(3, lcd_string_buff, &Font_16x26, YELLOW, lcd_data.buffer);
+			render_putStringCentered(3, lcd_string_buff, &Font_16x26, YELLOW, canvas);
 		} else {
 			device_settings.enable_voicecommand &= 0x01; // clear bit 1 which represents a status change
 			voicecommand_time = 0;
@@ -833,29 +938,44 @@ static int refresh_screen(void)
 			// if UNKNOWN, or low confidence, don't bother showing them when voice command is enabled
 			if ((device_status.classification_audio.classification != CLASSIFICATION_UNKNOWN) &&
 			   (device_status.classification_audio.classification != CLASSIFICATION_LOW_CONFIDENCE)) 
-				fonts_putStringCentered(3, lcd_string_buff, &Font_16x26, audio_string_color, lcd_data.buffer);
+				render_putStringCentered(3, lcd_string_buff, &Font_16x26, audio_string_color, canvas);
         }
     } else {
         snprintf(lcd_string_buff, sizeof(lcd_string_buff) - 1, "Audio disabled");
-        fonts_putStringCentered(3, lcd_string_buff, &Font_11x18, RED, lcd_data.buffer);
+        render_putStringCentered(3, lcd_string_buff, &Font_11x18, RED, canvas);
     }
 
     if ((timestamps.screen_drew - timestamps.notification_received) < LCD_NOTIFICATION_DURATION) {
         if (strlen(lcd_data.notification) < (LCD_WIDTH / Font_11x18.width)) {
-            fonts_putStringCentered(LCD_HEIGHT - Font_11x18.height - 3, lcd_data.notification, &Font_11x18, lcd_data.notification_color, lcd_data.buffer);
+            render_putStringCentered(LCD_HEIGHT - Font_11x18.height - 3, lcd_data.notification, &Font_11x18, lcd_data.notification_color, canvas);
         } else {
-            fonts_putStringCentered(LCD_HEIGHT - Font_7x10.height - 3, lcd_data.notification, &Font_7x10, lcd_data.notification_color, lcd_data.buffer);
+            render_putStringCentered(LCD_HEIGHT - Font_7x10.height - 3, lcd_data.notification, &Font_7x10, lcd_data.notification_color, canvas);
         }
     }
 
-    if (lcd_drawImage(lcd_data.buffer) == E_NO_ERROR) {
-        device_status.statistics.lcd_fps = (float) 1000.0 / (float)(timer_ms_tick - timestamps.screen_drew);
-        timestamps.screen_drew = timer_ms_tick;
+    if (overlay_only) {
+        passthrough_overlay_end();
+        return E_NO_ERROR;
     }
 
+    // Video frames replace the whole buffer, otherwise only the bands changed by the overlay are sent
+    render_present(canvas, frame, frame_capture_time, device_settings.enable_max78000_video);
+
     return E_NO_ERROR;
 }
 
+static void restore_logo(uint32_t damage)
+{
+    uint32_t band_size = FONTS_DAMAGE_BAND_HEIGHT * LCD_WIDTH * LCD_BYTE_PER_PIXEL;
+
+    for (uint16_t band = 0; band < FONTS_DAMAGE_BAND_COUNT; band++) {
+        if (damage & (UINT32_C(1) << band)) {
+            memcpy(&lcd_data.buffer[band * band_size], &adi_logo[band * band_size], band_size);
+            fonts_markDamage(band * FONTS_DAMAGE_BAND_HEIGHT, ((band + 1) * FONTS_DAMAGE_BAND_HEIGHT) - 1);
+        }
+    }
+}
+
 // Similar to Core 0, the entry point for Core 1
 // is Core1Main()
 // Execution begins when the CPU1 Clock is enabled
@@ -885,6 +1005,9 @@ int Core1_Main(void)
 
     while (1) {
         ble_worker();
+#ifdef RENDER_ON_CORE1
+        render_worker();
+#endif
     }
 
     return E_NO_ERROR;
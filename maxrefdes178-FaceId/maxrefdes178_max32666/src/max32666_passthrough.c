@@ -0,0 +1,331 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <mxc_device.h>
+#include <mxc_errors.h>
+
+#include "max32666_data.h"
+#include "max32666_debug.h"
+#include "max32666_fonts.h"
+#include "max32666_lcd.h"
+#include "max32666_passthrough.h"
+#include "max32666_qspi_master.h"
+#include "max32666_render.h"
+#include "max32666_timer_led_button.h"
+#include "maxrefdes178_definitions.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define S_MODULE_NAME   "passthrough"
+
+#if defined(LCD_PASSTHROUGH) && defined(RENDER_ON_CORE1)
+#error "LCD_PASSTHROUGH drives the LCD from core0 interrupts, it can not be used with RENDER_ON_CORE1"
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+#ifdef LCD_PASSTHROUGH
+// Band N is received into slot N % 2 while the other one is sent to the LCD
+static uint8_t passthrough_slot[PASSTHROUGH_SLOT_COUNT][PASSTHROUGH_BAND_SIZE];
+
+// Main loop captures one overlay while the other is drawn into the frame being streamed
+static fonts_runs_t passthrough_overlay[2];
+static volatile uint8_t passthrough_published = 0;              // overlay taken by the next frame
+static const fonts_runs_t *volatile passthrough_frame_overlay = NULL; // overlay of the frame in flight, NULL if none
+
+// Interrupt context, frame in flight
+static uint16_t passthrough_rx_band = 0;    // bands whose QSPI read is posted
+static uint16_t passthrough_rx_done = 0;    // bands received
+static uint16_t passthrough_tx_band = 0;    // bands sent to the LCD
+static uint8_t passthrough_qspi_busy = 0;
+static uint8_t passthrough_lcd_busy = 0;
+static uint8_t passthrough_aborted = 0;
+static uint32_t passthrough_stream_capture_time = 0;
+
+// Written at the end of each streamed frame
+static volatile uint32_t passthrough_frame_count = 0;
+static volatile uint32_t passthrough_frame_capture_time = 0;   // MAX78000 video clock of the last one
+static volatile uint32_t passthrough_last_frame_tick = 0;
+
+// Core0 main loop only
+static uint32_t passthrough_frame_seen = 0;
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+#ifdef LCD_PASSTHROUGH
+static void passthrough_kick(void);
+static void passthrough_lcd_done(void);
+static void passthrough_frame_end(void);
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+int passthrough_init(void)
+{
+#ifdef LCD_PASSTHROUGH
+    // Start with empty overlays
+    for (int i = 0; i < 2; i++) {
+        fonts_captureBegin(&passthrough_overlay[i]);
+        fonts_captureEnd();
+    }
+
+    PR_INFO("band %d bytes", PASSTHROUGH_BAND_SIZE);
+#endif
+
+    return E_NO_ERROR;
+}
+
+void passthrough_worker(void)
+{
+#ifdef LCD_PASSTHROUGH
+    // Window is opened ahead so the next frame header can take the LCD from interrupt context
+    if (device_settings.enable_max78000_video && device_settings.enable_lcd) {
+        lcd_streamArm();
+    } else {
+        lcd_streamDisarm();
+    }
+#endif
+}
+
+int passthrough_streaming(void)
+{
+#ifdef LCD_PASSTHROUGH
+    return passthrough_frame_count && ((timer_ms_tick - passthrough_last_frame_tick) < LCD_NO_VIDEO_REFRESH_DURATION);
+#else
+    return 0;
+#endif
+}
+
+int passthrough_overlay_begin(void)
+{
+#ifdef LCD_PASSTHROUGH
+    fonts_runs_t *overlay = &passthrough_overlay[!passthrough_published];
+
+    // Previous overlay can still be drawn into a frame started before it was replaced
+    if (overlay == passthrough_frame_overlay) {
+        return E_BUSY;
+    }
+
+    fonts_captureBegin(overlay);
+
+    return E_NO_ERROR;
+#else
+    return E_NOT_SUPPORTED;
+#endif
+}
+
+void passthrough_overlay_end(void)
+{
+#ifdef LCD_PASSTHROUGH
+    fonts_captureEnd();
+
+    // Runs are complete before the next frame can take them
+    __DMB();
+    passthrough_published = !passthrough_published;
+#endif
+}
+
+int passthrough_frame_shown(uint32_t *capture_time)
+{
+#ifdef LCD_PASSTHROUGH
+    uint32_t count = passthrough_frame_count;
+
+    if (count == passthrough_frame_seen) {
+        return 0;
+    }
+
+    // Capture time was written before the count
+    __DMB();
+    *capture_time = passthrough_frame_capture_time;
+    passthrough_frame_seen = count;
+
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+int passthrough_stream_start(uint32_t packet_size)
+{
+#ifdef LCD_PASSTHROUGH
+    if (packet_size != LCD_DATA_SIZE) {
+        return E_INVALID;
+    }
+
+    // Frames go to a framebuffer while the LCD is not armed
+    if (lcd_streamBegin() != E_NO_ERROR) {
+        return E_BUSY;
+    }
+
+    passthrough_rx_band = 0;
+    passthrough_rx_done = 0;
+    passthrough_tx_band = 0;
+    passthrough_qspi_busy = 0;
+    passthrough_lcd_busy = 0;
+    passthrough_aborted = 0;
+
+    // Frame timestamp packet precedes its frame
+    passthrough_stream_capture_time = device_status.video_frame_timestamp_us;
+    passthrough_frame_overlay = &passthrough_overlay[passthrough_published];
+
+    // First read is posted until the slave has the payload ready
+    passthrough_kick();
+
+    return E_NO_ERROR;
+#else
+    return E_NOT_SUPPORTED;
+#endif
+}
+
+void passthrough_stream_chunk(uint8_t *chunk, uint32_t len)
+{
+#ifdef LCD_PASSTHROUGH
+    if (!passthrough_frame_overlay) {
+        return;
+    }
+
+    passthrough_qspi_busy = 0;
+
+    if (chunk) {
+        passthrough_rx_done++;
+    } else {
+        passthrough_aborted = 1;
+    }
+
+    if (passthrough_aborted) {
+        if (!passthrough_lcd_busy) {
+            passthrough_frame_end();
+        }
+        return;
+    }
+
+    passthrough_kick();
+#endif
+}
+
+#ifdef LCD_PASSTHROUGH
+static void passthrough_kick(void)
+{
+    uint8_t *slot;
+
+    // Send the oldest received band with the overlay drawn into it
+    if (!passthrough_lcd_busy && (passthrough_tx_band < passthrough_rx_done)) {
+        slot = passthrough_slot[passthrough_tx_band % PASSTHROUGH_SLOT_COUNT];
+        fonts_drawRuns(passthrough_frame_overlay, passthrough_tx_band, slot);
+
+        passthrough_lcd_busy = 1;
+        if (lcd_streamBand(slot, PASSTHROUGH_BAND_SIZE, passthrough_lcd_done) != E_NO_ERROR) {
+            passthrough_lcd_busy = 0;
+            passthrough_aborted = 1;
+        }
+    }
+
+    // Receive the next band into the slot freed by the LCD
+    if (!passthrough_aborted && !passthrough_qspi_busy && (passthrough_rx_band < FONTS_DAMAGE_BAND_COUNT) &&
+        ((passthrough_rx_band - passthrough_tx_band) < PASSTHROUGH_SLOT_COUNT)) {
+        slot = passthrough_slot[passthrough_rx_band % PASSTHROUGH_SLOT_COUNT];
+
+        passthrough_qspi_busy = 1;
+        if (qspi_master_stream_read(slot, PASSTHROUGH_BAND_SIZE) == E_NO_ERROR) {
+            passthrough_rx_band++;
+        } else {
+            passthrough_qspi_busy = 0;
+            passthrough_aborted = 1;
+        }
+    }
+
+    // Neither side has anything left in flight
+    if (passthrough_aborted && !passthrough_lcd_busy && !passthrough_qspi_busy) {
+        passthrough_frame_end();
+    }
+}
+
+static void passthrough_lcd_done(void)
+{
+    passthrough_lcd_busy = 0;
+    passthrough_tx_band++;
+
+    if (passthrough_tx_band >= FONTS_DAMAGE_BAND_COUNT) {
+        passthrough_frame_end();
+        return;
+    }
+
+    if (passthrough_aborted) {
+        // Wait the QSPI read in flight, the link times out the stream otherwise
+        if (!passthrough_qspi_busy) {
+            passthrough_frame_end();
+        }
+        return;
+    }
+
+    passthrough_kick();
+}
+
+static void passthrough_frame_end(void)
+{
+    lcd_streamEnd();
+
+    if (!passthrough_aborted) {
+        device_status.statistics.lcd_fps = (float) 1000.0 / (float)(timer_ms_tick - timestamps.screen_drew);
+        timestamps.screen_drew = timer_ms_tick;
+
+        passthrough_frame_capture_time = passthrough_stream_capture_time;
+        passthrough_last_frame_tick = timer_ms_tick;
+        __DMB();
+        passthrough_frame_count++;
+    }
+
+    passthrough_frame_overlay = NULL;
+}
+#endif
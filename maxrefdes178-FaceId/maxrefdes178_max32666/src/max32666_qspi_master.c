@@ -37,17 +37,21 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <gpio.h>
-#include <mxc_delay.h>
 #include <string.h>
 
 #include "max32666_debug.h"
 #include "max32666_data.h"
 #include "max32666_fonts.h"
+#include "max32666_framebuffer.h"
 #include "max32666_lcd.h"
+#include "max32666_passthrough.h"
 #include "max32666_qspi_master.h"
+#include "max32666_render.h"
 #include "max32666_spi_dma.h"
+#include "max32666_time_sync.h"
 #include "max32666_timer_led_button.h"
 #include "maxrefdes178_definitions.h"
+#include "maxrefdes178_timing.h"
 #include "maxrefdes178_utility.h"
 
 
@@ -56,10 +60,88 @@
 //-----------------------------------------------------------------------------
 #define S_MODULE_NAME   "qspi"
 
+//#define PRINT_QSPI_LINK_STATISTICS
+
 
 //-----------------------------------------------------------------------------
 // Typedefs
 //-----------------------------------------------------------------------------
+typedef struct {
+    uint32_t packets;
+    uint32_t bytes;
+} qspi_link_counter_t;
+
+typedef struct {
+    qspi_link_counter_t rx[QSPI_PACKET_TYPE_LAST];
+    qspi_link_counter_t tx[QSPI_PACKET_TYPE_LAST];
+    uint32_t rx_errors;
+    uint32_t period_start;
+} qspi_link_statistics_t;
+
+// Video and audio share the QSPI bus and its DMA channel, one RX transfer is in flight at a time
+typedef enum {
+    QSPI_MASTER_STATE_IDLE = 0,
+    QSPI_MASTER_STATE_HEADER,        // header DMA in flight
+    QSPI_MASTER_STATE_PAYLOAD_WAIT,  // waiting slave payload ready interrupt
+    QSPI_MASTER_STATE_PAYLOAD,       // payload DMA in flight
+    QSPI_MASTER_STATE_STREAM,        // payload is read in chunks posted by its consumer
+} qspi_master_state_e;
+
+struct qspi_master_link;
+
+// Receive registration of one packet type. A fixed destination is live state read by the main loop,
+// its payload is received into the link staging buffer and copied there once the crc passed.
+// Provided buffers and streams are written in place. Registered types have a payload (max_size)
+// or a handler, others are drained
+typedef struct {
+    uint8_t *buffer;                                // fixed destination, max_size fits qspi_master_staging_t
+    uint8_t *(*get_buffer)(uint32_t packet_size);   // or destination provider, called from DMA interrupt
+    // Consumer may take the payload in chunks instead, reading each with qspi_master_stream_read.
+    // stream_start returns E_NO_ERROR to take it, stream_chunk gets each chunk and NULL on abort.
+    // Both are called from interrupt context
+    int (*stream_start)(uint32_t packet_size);
+    void (*stream_chunk)(uint8_t *chunk, uint32_t len);
+    uint32_t min_size;
+    uint32_t max_size;
+    void (*handler)(struct qspi_master_link *link); // main loop context, optional
+} qspi_master_rx_entry_t;
+
+// Largest fixed destination payload
+typedef union {
+    classification_result_t classification;
+    max78000_statistics_t statistics;
+    version_t version;
+    char demo_name[DEMO_STRING_SIZE];
+    serial_num_t serial;
+    uint8_t faceid_embed_update_status;
+    char faceid_embed_subject_names[sizeof(device_status.faceid_embed_subject_names)];
+    time_sync_t time_sync;
+    uint8_t timing[sizeof(device_status.timing.max78000_video)];
+    uint32_t video_frame_timestamp_us;
+} qspi_master_staging_t;
+
+typedef struct qspi_master_link {
+    const char *name;
+    const mxc_gpio_cfg_t *cs_pin;
+    const mxc_gpio_cfg_t *rw_pin;
+    volatile int *int_flag;
+    qspi_link_statistics_t *statistics;
+    const qspi_master_rx_entry_t *rx_table;     // indexed by packet type
+
+    qspi_packet_header_t header;
+    uint8_t *buffer;
+    qspi_master_staging_t staging;
+    const qspi_master_rx_entry_t *stream;   // entry streaming the payload, NULL if it has a buffer
+    uint8_t *stream_buffer;                 // posted or in flight chunk read
+    volatile uint32_t stream_len;
+    uint32_t stream_offset;                 // payload bytes read
+    uint16_t stream_crc;                    // running payload crc of the chunks read
+    uint32_t rx_time;                   // host time the slave request was served, us
+    uint32_t start_tick;
+    uint32_t payload_us;                // payload DMA start, its duration once done. Core sleeps meanwhile, DWT would stop
+    volatile int status;
+    volatile uint8_t done;              // packet is waiting for its worker
+} qspi_master_link_t;
 
 
 //-----------------------------------------------------------------------------
@@ -80,10 +162,153 @@ static qspi_packet_header_info_t qspi_header_buff_audio_tx = {0};
 static uint8_t qspi_payload_buff_video_tx[MAX32666_BLE_COMMAND_BUFFER_SIZE];
 static uint8_t qspi_payload_buff_audio_tx[100];
 
+static qspi_link_statistics_t qspi_link_statistics_video = {0};
+static qspi_link_statistics_t qspi_link_statistics_audio = {0};
+
+static time_sync_t qspi_time_sync_video;
+static time_sync_t qspi_time_sync_audio;
+static uint32_t qspi_master_tx_us;      // header DMA start of the last sent packet
+
+static volatile qspi_master_state_e qspi_master_state = QSPI_MASTER_STATE_IDLE;
+static qspi_master_link_t *volatile qspi_master_active = NULL;
+
+// Packet handlers, defined below
+static uint8_t *qspi_master_rx_video_frame_buffer(uint32_t packet_size);
+static void qspi_master_rx_video_data(qspi_master_link_t *link);
+static void qspi_master_rx_video_classification(qspi_master_link_t *link);
+static void qspi_master_rx_video_statistics(qspi_master_link_t *link);
+static void qspi_master_rx_video_version(qspi_master_link_t *link);
+static void qspi_master_rx_video_demo_name(qspi_master_link_t *link);
+static void qspi_master_rx_video_serial(qspi_master_link_t *link);
+static void qspi_master_rx_video_faceid_embed_update(qspi_master_link_t *link);
+static void qspi_master_rx_video_faceid_subjects(qspi_master_link_t *link);
+static void qspi_master_rx_video_time_sync(qspi_master_link_t *link);
+static void qspi_master_rx_video_button_press(qspi_master_link_t *link);
+static void qspi_master_rx_audio_classification(qspi_master_link_t *link);
+static void qspi_master_rx_audio_statistics(qspi_master_link_t *link);
+static void qspi_master_rx_audio_version(qspi_master_link_t *link);
+static void qspi_master_rx_audio_demo_name(qspi_master_link_t *link);
+static void qspi_master_rx_audio_serial(qspi_master_link_t *link);
+static void qspi_master_rx_audio_time_sync(qspi_master_link_t *link);
+static void qspi_master_rx_audio_button_press(qspi_master_link_t *link);
+
+static const qspi_master_rx_entry_t qspi_rx_table_video[QSPI_PACKET_TYPE_LAST] = {
+    [QSPI_PACKET_TYPE_VIDEO_DATA_RES] = {
+        .get_buffer = qspi_master_rx_video_frame_buffer,
+        .stream_start = passthrough_stream_start,
+        .stream_chunk = passthrough_stream_chunk,
+        .min_size = LCD_DATA_SIZE, .max_size = LCD_DATA_SIZE,
+        .handler = qspi_master_rx_video_data},
+    [QSPI_PACKET_TYPE_VIDEO_CLASSIFICATION_RES] = {
+        .buffer = (uint8_t *) &device_status.classification_video,
+        .min_size = sizeof(classification_result_t), .max_size = sizeof(classification_result_t),
+        .handler = qspi_master_rx_video_classification},
+    [QSPI_PACKET_TYPE_VIDEO_STATISTICS_RES] = {
+        .buffer = (uint8_t *) &device_status.statistics.max78000_video,
+        .min_size = sizeof(max78000_statistics_t), .max_size = sizeof(max78000_statistics_t),
+        .handler = qspi_master_rx_video_statistics},
+    [QSPI_PACKET_TYPE_VIDEO_VERSION_RES] = {
+        .buffer = (uint8_t *) &device_info.device_version.max78000_video,
+        .min_size = sizeof(version_t), .max_size = sizeof(version_t),
+        .handler = qspi_master_rx_video_version},
+    [QSPI_PACKET_TYPE_VIDEO_DEMO_NAME_RES] = {
+        .buffer = (uint8_t *) device_info.max78000_video_demo_name,
+        .min_size = 1, .max_size = DEMO_STRING_SIZE,
+        .handler = qspi_master_rx_video_demo_name},
+    [QSPI_PACKET_TYPE_VIDEO_SERIAL_RES] = {
+        .buffer = (uint8_t *) &device_info.device_serial_num.max78000_video,
+        .min_size = sizeof(serial_num_t), .max_size = sizeof(serial_num_t),
+        .handler = qspi_master_rx_video_serial},
+    [QSPI_PACKET_TYPE_VIDEO_FACEID_EMBED_UPDATE_RES] = {
+        .buffer = (uint8_t *) &device_status.faceid_embed_update_status,
+        .min_size = sizeof(faceid_embed_update_status_e), .max_size = sizeof(faceid_embed_update_status_e),
+        .handler = qspi_master_rx_video_faceid_embed_update},
+    [QSPI_PACKET_TYPE_VIDEO_FACEID_SUBJECTS_RES] = {
+        .buffer = (uint8_t *) &device_status.faceid_embed_subject_names,
+        .min_size = 0, .max_size = sizeof(device_status.faceid_embed_subject_names),
+        .handler = qspi_master_rx_video_faceid_subjects},
+    [QSPI_PACKET_TYPE_VIDEO_TIME_SYNC_RES] = {
+        .buffer = (uint8_t *) &qspi_time_sync_video,
+        .min_size = sizeof(time_sync_t), .max_size = sizeof(time_sync_t),
+        .handler = qspi_master_rx_video_time_sync},
+    [QSPI_PACKET_TYPE_VIDEO_TIMING_RES] = {
+        .buffer = (uint8_t *) device_status.timing.max78000_video,
+        .min_size = sizeof(device_status.timing.max78000_video), .max_size = sizeof(device_status.timing.max78000_video)},
+    [QSPI_PACKET_TYPE_VIDEO_FRAME_TIMESTAMP_RES] = {
+        .buffer = (uint8_t *) &device_status.video_frame_timestamp_us,
+        .min_size = sizeof(device_status.video_frame_timestamp_us), .max_size = sizeof(device_status.video_frame_timestamp_us)},
+    [QSPI_PACKET_TYPE_VIDEO_BUTTON_PRESS_RES] = {
+        .handler = qspi_master_rx_video_button_press},
+};
+
+static const qspi_master_rx_entry_t qspi_rx_table_audio[QSPI_PACKET_TYPE_LAST] = {
+    [QSPI_PACKET_TYPE_AUDIO_CLASSIFICATION_RES] = {
+        .buffer = (uint8_t *) &device_status.classification_audio,
+        .min_size = sizeof(classification_result_t), .max_size = sizeof(classification_result_t),
+        .handler = qspi_master_rx_audio_classification},
+    [QSPI_PACKET_TYPE_AUDIO_STATISTICS_RES] = {
+        .buffer = (uint8_t *) &device_status.statistics.max78000_audio,
+        .min_size = sizeof(max78000_statistics_t), .max_size = sizeof(max78000_statistics_t),
+        .handler = qspi_master_rx_audio_statistics},
+    [QSPI_PACKET_TYPE_AUDIO_VERSION_RES] = {
+        .buffer = (uint8_t *) &device_info.device_version.max78000_audio,
+        .min_size = sizeof(version_t), .max_size = sizeof(version_t),
+        .handler = qspi_master_rx_audio_version},
+    [QSPI_PACKET_TYPE_AUDIO_DEMO_NAME_RES] = {
+        .buffer = (uint8_t *) device_info.max78000_audio_demo_name,
+        .min_size = 1, .max_size = DEMO_STRING_SIZE,
+        .handler = qspi_master_rx_audio_demo_name},
+    [QSPI_PACKET_TYPE_AUDIO_SERIAL_RES] = {
+        .buffer = (uint8_t *) &device_info.device_serial_num.max78000_audio,
+        .min_size = sizeof(serial_num_t), .max_size = sizeof(serial_num_t),
+        .handler = qspi_master_rx_audio_serial},
+    [QSPI_PACKET_TYPE_AUDIO_TIME_SYNC_RES] = {
+        .buffer = (uint8_t *) &qspi_time_sync_audio,
+        .min_size = sizeof(time_sync_t), .max_size = sizeof(time_sync_t),
+        .handler = qspi_master_rx_audio_time_sync},
+    [QSPI_PACKET_TYPE_AUDIO_TIMING_RES] = {
+        .buffer = (uint8_t *) device_status.timing.max78000_audio,
+        .min_size = sizeof(device_status.timing.max78000_audio), .max_size = sizeof(device_status.timing.max78000_audio)},
+    [QSPI_PACKET_TYPE_AUDIO_BUTTON_PRESS_RES] = {
+        .handler = qspi_master_rx_audio_button_press},
+};
+
+static qspi_master_link_t qspi_link_video = {
+    .name = "video",
+    .cs_pin = &video_cs_pin,
+    .rw_pin = &video_rw_pin,
+    .int_flag = &qspi_video_int_flag,
+    .statistics = &qspi_link_statistics_video,
+    .rx_table = qspi_rx_table_video,
+};
+
+static qspi_master_link_t qspi_link_audio = {
+    .name = "audio",
+    .cs_pin = &audio_cs_pin,
+    .rw_pin = &audio_rw_pin,
+    .int_flag = &qspi_audio_int_flag,
+    .statistics = &qspi_link_statistics_audio,
+    .rx_table = qspi_rx_table_audio,
+};
 
 //-----------------------------------------------------------------------------
 // Local function declarations
 //-----------------------------------------------------------------------------
+static void qspi_master_cs_assert(const mxc_gpio_cfg_t *cs_pin);
+static int qspi_master_rx_worker(qspi_master_link_t *link, qspi_packet_type_e *qspi_packet_type_rx);
+static int qspi_master_rx_wait(qspi_master_link_t *link, qspi_packet_type_e *qspi_packet_type_rx);
+static void qspi_master_rx_start(qspi_master_link_t *link);
+static int qspi_master_rx_lookup(qspi_master_link_t *link);
+static void qspi_master_rx_int(qspi_master_link_t *link);
+static void qspi_master_rx_dma_callback(void);
+static void qspi_master_rx_done(qspi_master_link_t *link, int status);
+static void qspi_master_rx_stream_dma(qspi_master_link_t *link);
+static void qspi_master_rx_stream_chunk(qspi_master_link_t *link);
+static void qspi_master_rx_timeout(void);
+static void qspi_master_rx_error(qspi_master_link_t *link, int status);
+static int qspi_master_wait_idle(void);
+static void qspi_master_link_count(qspi_link_counter_t *counter, uint8_t packet_type, uint32_t packet_size);
+static void qspi_master_link_print(const char *name, qspi_link_statistics_t *link_statistics);
 
 
 //-----------------------------------------------------------------------------
@@ -96,12 +321,12 @@ void MAX32666_QSPI_DMA_IRQ_HAND(void)
 
 void qspi_video_int(void *cbdata)
 {
-    qspi_video_int_flag = 1;
+    qspi_master_rx_int(&qspi_link_video);
 }
 
 void qspi_audio_int(void *cbdata)
 {
-    qspi_audio_int_flag = 1;
+    qspi_master_rx_int(&qspi_link_audio);
 }
 
 int qspi_master_wait_video_int(void)
@@ -157,6 +382,11 @@ int qspi_master_init(void)
         return ret;
     }
 
+    qspi_master_state = QSPI_MASTER_STATE_IDLE;
+    qspi_master_active = NULL;
+    qspi_link_video.done = 0;
+    qspi_link_audio.done = 0;
+
     NVIC_EnableIRQ(MAX32666_QSPI_DMA_IRQ);
 
     qspi_video_int_flag = 0;
@@ -176,195 +406,111 @@ int qspi_master_init(void)
     return E_NO_ERROR;
 }
 
-int qspi_master_video_rx_worker(qspi_packet_type_e *qspi_packet_type_rx)
+int qspi_master_busy(void)
 {
-    qspi_packet_header_t qspi_packet_header_rx;
-
-    if (!qspi_video_int_flag) {
-        return E_NONE_AVAIL;
-    }
-    qspi_video_int_flag = 0;
+    return qspi_master_state != QSPI_MASTER_STATE_IDLE;
+}
 
-    GPIO_SET(video_rw_pin); // RX request
+uint32_t qspi_master_tx_time(void)
+{
+    return qspi_master_tx_us;
+}
 
-    GPIO_CLR(video_cs_pin);
-    MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-    spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &qspi_packet_header_rx, sizeof(qspi_packet_header_t), MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-    spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-    GPIO_SET(video_cs_pin);
-    *qspi_packet_type_rx = qspi_packet_header_rx.info.packet_type;
+int qspi_master_video_rx_worker(qspi_packet_type_e *qspi_packet_type_rx)
+{
+    return qspi_master_rx_worker(&qspi_link_video, qspi_packet_type_rx);
+}
 
-    if (qspi_packet_header_rx.start_symbol != QSPI_START_SYMBOL) {
-        PR_ERROR("Invalid QSPI start byte 0x%08hhX", qspi_packet_header_rx.start_symbol);
-        return E_COMM_ERR;
-    }
+int qspi_master_video_rx_wait(qspi_packet_type_e *qspi_packet_type_rx)
+{
+    return qspi_master_rx_wait(&qspi_link_video, qspi_packet_type_rx);
+}
 
-    if (qspi_packet_header_rx.header_crc16 != crc16_sw((uint8_t *) &qspi_packet_header_rx.info, sizeof(qspi_packet_header_rx.info))) {
-        PR_ERROR("Invalid header crc 0x%x", qspi_packet_header_rx.header_crc16);
-        return E_COMM_ERR;
-    }
+static uint8_t *qspi_master_rx_video_frame_buffer(uint32_t packet_size)
+{
+    // NULL drains the frame when no framebuffer is free
+    return framebuffer_receive_acquire();
+}
 
-    if (qspi_packet_header_rx.info.packet_size) {
-        qspi_master_wait_video_int();
-        qspi_video_int_flag = 0;
+static void qspi_master_rx_video_data(qspi_master_link_t *link)
+{
+    // Streamed frames went to the LCD band by band, the payload time is paced by the LCD
+    if (link->stream) {
+        PR_DEBUG("video %u streamed", link->header.info.packet_size);
+        return;
     }
 
-    switch(qspi_packet_header_rx.info.packet_type) {
-    case QSPI_PACKET_TYPE_VIDEO_DATA_RES:
-        if (qspi_packet_header_rx.info.packet_size != LCD_DATA_SIZE) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *)lcd_data.buffer, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
+    timing_record_us(TIMING_STAGE_COMMUNICATION, link->payload_us);
 
-        PR_DEBUG("video %u", qspi_packet_header_rx.info.packet_size);
+    // Frame timestamp packet precedes its frame
+    framebuffer_receive_done(link->buffer, device_status.video_frame_timestamp_us);
 
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_CLASSIFICATION_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(classification_result_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_status.classification_video, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
-
-        PR_INFO("video %s %d %0.1f", device_status.classification_video.result, device_status.classification_video.classification, (double)device_status.classification_video.probability);
-
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_STATISTICS_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(max78000_statistics_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_status.statistics.max78000_video, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
-
-        PR_DEBUG("video capture : %lu", device_status.statistics.max78000_video.capture_duration_us);
-        PR_DEBUG("video cnn     : %lu", device_status.statistics.max78000_video.cnn_duration_us);
-        PR_DEBUG("video qspi    : %lu", device_status.statistics.max78000_video.communication_duration_us);
-        PR_DEBUG("video total   : %lu", device_status.statistics.max78000_video.total_duration_us);
-
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_VERSION_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(version_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_info.device_version.max78000_video, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
-
-        PR_INFO("MAX78000 Video v%d.%d.%d", device_info.device_version.max78000_video.major, device_info.device_version.max78000_video.minor, device_info.device_version.max78000_video.build);
-
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_DEMO_NAME_RES:
-        if (qspi_packet_header_rx.info.packet_size == 0 || qspi_packet_header_rx.info.packet_size > DEMO_STRING_SIZE) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) device_info.max78000_video_demo_name, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
-
-        PR_INFO("MAX78000 Video demo %s", device_info.max78000_video_demo_name);
-
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_SERIAL_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(serial_num_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_info.device_serial_num.max78000_video, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
-
-        PR_INFO("MAX78000 Video serial: ");
-        for (int i = 0; i < sizeof(device_info.device_serial_num.max78000_video); i++) {
-            PR("%02X", device_info.device_serial_num.max78000_video[i]);
-        }
-        PR("\n");
-
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_FACEID_EMBED_UPDATE_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(faceid_embed_update_status_e)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
+    PR_DEBUG("video %u", link->header.info.packet_size);
+}
 
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_status.faceid_embed_update_status, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
+static void qspi_master_rx_video_classification(qspi_master_link_t *link)
+{
+    PR_INFO("video %s %d %0.1f", device_status.classification_video.result, device_status.classification_video.classification, (double)device_status.classification_video.probability);
+}
 
-        PR_INFO("FaceID stat %d", device_status.faceid_embed_update_status);
+static void qspi_master_rx_video_statistics(qspi_master_link_t *link)
+{
+    PR_DEBUG("video capture : %lu", device_status.statistics.max78000_video.capture_duration_us);
+    PR_DEBUG("video cnn     : %lu", device_status.statistics.max78000_video.cnn_duration_us);
+    PR_DEBUG("video qspi    : %lu", device_status.statistics.max78000_video.communication_duration_us);
+    PR_DEBUG("video total   : %lu", device_status.statistics.max78000_video.total_duration_us);
+    PR_DEBUG("video overflow: %lu", device_status.statistics.max78000_video.stream_overflow_count);
+}
 
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_FACEID_SUBJECTS_RES:
-        if (qspi_packet_header_rx.info.packet_size > sizeof(device_status.faceid_embed_subject_names)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
+static void qspi_master_rx_video_version(qspi_master_link_t *link)
+{
+    PR_INFO("MAX78000 Video v%d.%d.%d", device_info.device_version.max78000_video.major, device_info.device_version.max78000_video.minor, device_info.device_version.max78000_video.build);
+}
 
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_status.faceid_embed_subject_names, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(video_cs_pin);
+static void qspi_master_rx_video_demo_name(qspi_master_link_t *link)
+{
+    PR_INFO("MAX78000 Video demo %s", device_info.max78000_video_demo_name);
+}
 
-        device_status.faceid_embed_subject_names_size = qspi_packet_header_rx.info.packet_size;
+static void qspi_master_rx_video_serial(qspi_master_link_t *link)
+{
+    PR_INFO("MAX78000 Video serial: ");
+    for (int i = 0; i < sizeof(device_info.device_serial_num.max78000_video); i++) {
+        PR("%02X", device_info.device_serial_num.max78000_video[i]);
+    }
+    PR("\n");
+}
 
-        PR_INFO("FaceID names %d", device_status.faceid_embed_subject_names_size);
-        for (int i = 0; i < device_status.faceid_embed_subject_names_size;
-                i += printf("%s\n", &device_status.faceid_embed_subject_names[i])) {}
+static void qspi_master_rx_video_faceid_embed_update(qspi_master_link_t *link)
+{
+    PR_INFO("FaceID stat %d", device_status.faceid_embed_update_status);
+}
 
-        break;
-    case QSPI_PACKET_TYPE_VIDEO_BUTTON_PRESS_RES:
-        if (qspi_packet_header_rx.info.packet_size != 0) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
+static void qspi_master_rx_video_faceid_subjects(qspi_master_link_t *link)
+{
+    device_status.faceid_embed_subject_names_size = link->header.info.packet_size;
 
-        PR_INFO("Video button A pressed");
-        timestamps.activity_detected = timer_ms_tick;
-        device_settings.enable_max78000_video_flash_led = !device_settings.enable_max78000_video_flash_led;
+    PR_INFO("FaceID names %d", device_status.faceid_embed_subject_names_size);
+    for (int i = 0; i < device_status.faceid_embed_subject_names_size;
+            i += printf("%s\n", &device_status.faceid_embed_subject_names[i])) {}
+}
 
-        if (device_settings.enable_max78000_video_flash_led) {
-            lcd_notification(MAGENTA, "Video flash LED enabled");
-        } else {
-            lcd_notification(MAGENTA, "Video flash LED disabled");
-        }
+static void qspi_master_rx_video_time_sync(qspi_master_link_t *link)
+{
+    time_sync_response(TIME_SYNC_DEVICE_VIDEO, &qspi_time_sync_video, link->rx_time);
+}
 
-        break;
-    default:
-        PR_ERROR("Unknown qspi video packet");
-        return E_INVALID;
-        break;
+static void qspi_master_rx_video_button_press(qspi_master_link_t *link)
+{
+    PR_INFO("Video button A pressed");
+    timestamps.activity_detected = timer_ms_tick;
+    device_settings.enable_max78000_video_flash_led = !device_settings.enable_max78000_video_flash_led;
+
+    if (device_settings.enable_max78000_video_flash_led) {
+        lcd_notification(MAGENTA, "Video flash LED enabled");
+    } else {
+        lcd_notification(MAGENTA, "Video flash LED disabled");
     }
-
-    return E_NO_ERROR;
 }
 
 int qspi_master_video_tx_worker(void)
@@ -381,140 +527,58 @@ int qspi_master_video_tx_worker(void)
 
 int qspi_master_audio_rx_worker(qspi_packet_type_e *qspi_packet_type_rx)
 {
-    qspi_packet_header_t qspi_packet_header_rx;
+    return qspi_master_rx_worker(&qspi_link_audio, qspi_packet_type_rx);
+}
 
-    if (!qspi_audio_int_flag) {
-        return E_NONE_AVAIL;
-    }
-    qspi_audio_int_flag = 0;
+int qspi_master_audio_rx_wait(qspi_packet_type_e *qspi_packet_type_rx)
+{
+    return qspi_master_rx_wait(&qspi_link_audio, qspi_packet_type_rx);
+}
 
-    GPIO_SET(audio_rw_pin); // RX request
+static void qspi_master_rx_audio_classification(qspi_master_link_t *link)
+{
+    PR_INFO("audio %s %d %0.1f", device_status.classification_audio.result, device_status.classification_audio.classification, (double)device_status.classification_audio.probability);
+}
 
-    GPIO_CLR(audio_cs_pin);
-    MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-    spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &qspi_packet_header_rx, sizeof(qspi_packet_header_t), MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-    spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-    GPIO_SET(audio_cs_pin);
-    *qspi_packet_type_rx = qspi_packet_header_rx.info.packet_type;
+static void qspi_master_rx_audio_statistics(qspi_master_link_t *link)
+{
+    PR_DEBUG("audio cnn: %lu", device_status.statistics.max78000_audio.cnn_duration_us);
+}
 
-    if (qspi_packet_header_rx.start_symbol != QSPI_START_SYMBOL) {
-        PR_ERROR("Invalid QSPI start byte 0x%08hhX", qspi_packet_header_rx.start_symbol);
-        return E_COMM_ERR;
-    }
+static void qspi_master_rx_audio_version(qspi_master_link_t *link)
+{
+    PR_INFO("MAX78000 Audio v%d.%d.%d", device_info.device_version.max78000_audio.major, device_info.device_version.max78000_audio.minor, device_info.device_version.max78000_audio.build);
+}
 
-    if (qspi_packet_header_rx.header_crc16 != crc16_sw((uint8_t *) &qspi_packet_header_rx.info, sizeof(qspi_packet_header_rx.info))) {
-        PR_ERROR("Invalid header crc 0x%x", qspi_packet_header_rx.header_crc16);
-        return E_COMM_ERR;
-    }
+static void qspi_master_rx_audio_demo_name(qspi_master_link_t *link)
+{
+    PR_INFO("MAX78000 Audio demo %s", device_info.max78000_audio_demo_name);
+}
 
-    if (qspi_packet_header_rx.info.packet_size) {
-        qspi_master_wait_audio_int();
-        qspi_audio_int_flag = 0;
+static void qspi_master_rx_audio_serial(qspi_master_link_t *link)
+{
+    PR_INFO("MAX78000 Audio serial: ");
+    for (int i = 0; i < sizeof(device_info.device_serial_num.max78000_audio); i++) {
+        PR("%02X", device_info.device_serial_num.max78000_audio[i]);
     }
+    PR("\n");
+}
 
-    switch(qspi_packet_header_rx.info.packet_type) {
-    case QSPI_PACKET_TYPE_AUDIO_CLASSIFICATION_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(classification_result_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(audio_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_status.classification_audio, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(audio_cs_pin);
-
-        PR_INFO("audio %s %d %0.1f", device_status.classification_audio.result, device_status.classification_audio.classification, (double)device_status.classification_audio.probability);
-
-        break;
-    case QSPI_PACKET_TYPE_AUDIO_STATISTICS_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(max78000_statistics_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(audio_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_status.statistics.max78000_audio, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(audio_cs_pin);
-
-        PR_DEBUG("audio cnn: %lu", device_status.statistics.max78000_audio.cnn_duration_us);
-
-        break;
-    case QSPI_PACKET_TYPE_AUDIO_VERSION_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(version_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(audio_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_info.device_version.max78000_audio, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(audio_cs_pin);
-
-        PR_INFO("MAX78000 Audio v%d.%d.%d", device_info.device_version.max78000_audio.major, device_info.device_version.max78000_audio.minor, device_info.device_version.max78000_audio.build);
-
-        break;
-    case QSPI_PACKET_TYPE_AUDIO_DEMO_NAME_RES:
-        if (qspi_packet_header_rx.info.packet_size == 0 || qspi_packet_header_rx.info.packet_size > DEMO_STRING_SIZE) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(audio_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) device_info.max78000_audio_demo_name, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(audio_cs_pin);
-
-        PR_INFO("MAX78000 Audio demo %s", device_info.max78000_audio_demo_name);
-
-        break;
-    case QSPI_PACKET_TYPE_AUDIO_SERIAL_RES:
-        if (qspi_packet_header_rx.info.packet_size != sizeof(serial_num_t)) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
-
-        GPIO_CLR(audio_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
-        spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &device_info.device_serial_num.max78000_audio, qspi_packet_header_rx.info.packet_size, MAX32666_QSPI_DMA_REQSEL_SPIRX, NULL);
-        spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
-        GPIO_SET(audio_cs_pin);
-
-        PR_INFO("MAX78000 Audio serial: ");
-        for (int i = 0; i < sizeof(device_info.device_serial_num.max78000_audio); i++) {
-            PR("%02X", device_info.device_serial_num.max78000_audio[i]);
-        }
-        PR("\n");
+static void qspi_master_rx_audio_time_sync(qspi_master_link_t *link)
+{
+    time_sync_response(TIME_SYNC_DEVICE_AUDIO, &qspi_time_sync_audio, link->rx_time);
+}
 
-        break;
-    case QSPI_PACKET_TYPE_AUDIO_BUTTON_PRESS_RES:
-        if (qspi_packet_header_rx.info.packet_size != 0) {
-            PR_ERROR("Invalid QSPI data len %u", qspi_packet_header_rx.info.packet_size);
-            return E_INVALID;
-        }
+static void qspi_master_rx_audio_button_press(qspi_master_link_t *link)
+{
+    PR_INFO("Audio button B pressed");
 
-        PR_INFO("Audio button B pressed");
-		
-		device_settings.enable_voicecommand ^= 1;
-		device_settings.enable_voicecommand += 0x2; // second bit shows there is a change in settings
-		
-		PR_INFO("Voice Command changed to: %d", device_settings.enable_voicecommand);
-		
-        timestamps.activity_detected = timer_ms_tick;
+	device_settings.enable_voicecommand ^= 1;
+	device_settings.enable_voicecommand += 0x2; // second bit shows there is a change in settings
 
-        break;
-    default:
-        PR_ERROR("Unknown qspi audio packet");
-        return E_INVALID;
-        break;
-    }
+	PR_INFO("Voice Command changed to: %d", device_settings.enable_voicecommand);
 
-    return E_NO_ERROR;
+    timestamps.activity_detected = timer_ms_tick;
 }
 
 int qspi_master_audio_tx_worker(void)
@@ -531,6 +595,7 @@ int qspi_master_audio_tx_worker(void)
 
 int qspi_master_send_video(uint8_t *data, uint32_t data_size, uint8_t data_type)
 {
+    int ret;
     qspi_packet_header_t qspi_packet_header_tx = {
             .start_dummy = 0,
             .start_symbol = QSPI_START_SYMBOL,
@@ -541,8 +606,14 @@ int qspi_master_send_video(uint8_t *data, uint32_t data_size, uint8_t data_type)
             .stop_dummy = 0,
     };
 
-    // Wait LCD dma since it disrupts QSPI write
-    spi_dma_wait(MAX32666_LCD_DMA_CHANNEL, MAX32666_LCD_SPI);
+    // Let the RX transfer in flight finish, the DMA channel and CS lines are still in use if it did not
+    ret = qspi_master_wait_idle();
+    if (ret != E_NO_ERROR) {
+        return ret;
+    }
+
+    // Wait the last bands of a streamed frame, LCD dma disrupts QSPI write
+    lcd_streamWait();
 
     GPIO_CLR(video_rw_pin); // TX request
 
@@ -567,8 +638,12 @@ int qspi_master_send_video(uint8_t *data, uint32_t data_size, uint8_t data_type)
         }
     }
 
-    GPIO_CLR(video_cs_pin);
-    MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
+    // No LCD dma starts, on either core, until the packet is sent
+    render_lcd_hold();
+
+    // Sent from here, the send may have waited for the idle link and the LCD before
+    qspi_master_tx_us = timer_get_us();
+    qspi_master_cs_assert(&video_cs_pin);
     spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, (uint8_t *) &qspi_packet_header_tx, NULL, sizeof(qspi_packet_header_t), MAX32666_QSPI_DMA_REQSEL_SPITX, NULL);
     spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
     GPIO_SET(video_cs_pin);
@@ -578,18 +653,22 @@ int qspi_master_send_video(uint8_t *data, uint32_t data_size, uint8_t data_type)
         qspi_master_wait_video_int();
         qspi_video_int_flag = 0;
 
-        GPIO_CLR(video_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
+        qspi_master_cs_assert(&video_cs_pin);
         spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, data, NULL, data_size, MAX32666_QSPI_DMA_REQSEL_SPITX, NULL);
         spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
         GPIO_SET(video_cs_pin);
     }
 
+    render_lcd_release();
+
+    qspi_master_link_count(qspi_link_statistics_video.tx, data_type, data_size);
+
     return E_NO_ERROR;
 }
 
 int qspi_master_send_audio(uint8_t *data, uint32_t data_size, uint8_t data_type)
 {
+    int ret;
     qspi_packet_header_t qspi_packet_header_tx = {
             .start_dummy = 0,
             .start_symbol = QSPI_START_SYMBOL,
@@ -600,8 +679,14 @@ int qspi_master_send_audio(uint8_t *data, uint32_t data_size, uint8_t data_type)
             .stop_dummy = 0,
     };
 
-    // Wait LCD dma since it disrupts QSPI write
-    spi_dma_wait(MAX32666_LCD_DMA_CHANNEL, MAX32666_LCD_SPI);
+    // Let the RX transfer in flight finish, the DMA channel and CS lines are still in use if it did not
+    ret = qspi_master_wait_idle();
+    if (ret != E_NO_ERROR) {
+        return ret;
+    }
+
+    // Wait the last bands of a streamed frame, LCD dma disrupts QSPI write
+    lcd_streamWait();
 
     GPIO_CLR(audio_rw_pin); // TX request
 
@@ -626,8 +711,12 @@ int qspi_master_send_audio(uint8_t *data, uint32_t data_size, uint8_t data_type)
         }
     }
 
-    GPIO_CLR(audio_cs_pin);
-    MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
+    // No LCD dma starts, on either core, until the packet is sent
+    render_lcd_hold();
+
+    // Sent from here, the send may have waited for the idle link and the LCD before
+    qspi_master_tx_us = timer_get_us();
+    qspi_master_cs_assert(&audio_cs_pin);
     spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, (uint8_t *) &qspi_packet_header_tx, NULL, sizeof(qspi_packet_header_t), MAX32666_QSPI_DMA_REQSEL_SPITX, NULL);
     spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
     GPIO_SET(audio_cs_pin);
@@ -637,12 +726,397 @@ int qspi_master_send_audio(uint8_t *data, uint32_t data_size, uint8_t data_type)
         qspi_master_wait_audio_int();
         qspi_audio_int_flag = 0;
 
-        GPIO_CLR(audio_cs_pin);
-        MXC_Delay(MXC_DELAY_USEC(QSPI_CS_ASSERT_WAIT));
+        qspi_master_cs_assert(&audio_cs_pin);
         spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, data, NULL, data_size, MAX32666_QSPI_DMA_REQSEL_SPITX, NULL);
         spi_dma_wait(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI);
         GPIO_SET(audio_cs_pin);
     }
 
+    render_lcd_release();
+
+    qspi_master_link_count(qspi_link_statistics_audio.tx, data_type, data_size);
+
     return E_NO_ERROR;
 }
+
+int qspi_master_stream_read(uint8_t *buffer, uint32_t len)
+{
+    qspi_master_link_t *link = qspi_master_active;
+
+    if (!link || !link->stream || link->stream_len) {
+        return E_BAD_STATE;
+    }
+
+    if (!len || ((link->stream_offset + len) > link->header.info.packet_size)) {
+        return E_BAD_PARAM;
+    }
+
+    link->stream_buffer = buffer;
+    link->stream_len = len;
+
+    // Until the slave has the payload ready the read stays posted
+    if (qspi_master_state == QSPI_MASTER_STATE_STREAM) {
+        qspi_master_rx_stream_dma(link);
+    }
+
+    return E_NO_ERROR;
+}
+
+void qspi_master_link_statistics_worker(void)
+{
+#ifdef PRINT_QSPI_LINK_STATISTICS
+    qspi_master_link_print("video", &qspi_link_statistics_video);
+    qspi_master_link_print("audio", &qspi_link_statistics_audio);
+    PR_INFO("video frames dropped %u", framebuffer_dropped_frames());
+#endif
+
+    memset(&qspi_link_statistics_video, 0, sizeof(qspi_link_statistics_video));
+    memset(&qspi_link_statistics_audio, 0, sizeof(qspi_link_statistics_audio));
+    qspi_link_statistics_video.period_start = timer_ms_tick;
+    qspi_link_statistics_audio.period_start = timer_ms_tick;
+}
+
+// Asserts CS and busy-waits QSPI_CS_ASSERT_WAIT so the slave can arm its DMA before the clock starts.
+// The payload of a received packet is started from the slave GPIO interrupt, so once per packet with
+// payload this holds off interrupts of the same or lower priority for 10 us (960 cycles at 96 MHz).
+// Starting it from the worker instead would add up to a main loop iteration to every packet
+static void qspi_master_cs_assert(const mxc_gpio_cfg_t *cs_pin)
+{
+    uint32_t start = timing_cycles();
+
+    MXC_GPIO_OutClr(cs_pin->port, cs_pin->mask);
+
+    // MXC_Delay is not reentrant and this also runs in interrupt context
+    while (timing_cycles_to_us(timing_cycles() - start) < QSPI_CS_ASSERT_WAIT);
+}
+
+static int qspi_master_rx_worker(qspi_master_link_t *link, qspi_packet_type_e *qspi_packet_type_rx)
+{
+    const qspi_master_rx_entry_t *entry;
+    int ret;
+
+    qspi_master_rx_timeout();
+
+    if (!link->done) {
+        // Only this context leaves IDLE, interrupts only return to it
+        if ((qspi_master_state == QSPI_MASTER_STATE_IDLE) && *link->int_flag) {
+            qspi_master_rx_start(link);
+        }
+        return E_NONE_AVAIL;
+    }
+
+    *qspi_packet_type_rx = link->header.info.packet_type;
+    ret = link->status;
+
+    if (ret == E_NO_ERROR) {
+        entry = &link->rx_table[link->header.info.packet_type];
+        // Publish the staged payload, checked and complete
+        if (entry->buffer && link->header.info.packet_size) {
+            memcpy(entry->buffer, &link->staging, link->header.info.packet_size);
+        }
+        if (entry->handler) {
+            entry->handler(link);
+        }
+        qspi_master_link_count(link->statistics->rx, link->header.info.packet_type, link->header.info.packet_size);
+    } else {
+        qspi_master_rx_error(link, ret);
+        link->statistics->rx_errors++;
+    }
+
+    // Header and buffers may be reused from here
+    link->done = 0;
+
+    return ret;
+}
+
+static int qspi_master_rx_wait(qspi_master_link_t *link, qspi_packet_type_e *qspi_packet_type_rx)
+{
+    uint32_t start_tick = timer_ms_tick;
+    int ret;
+
+    while ((ret = qspi_master_rx_worker(link, qspi_packet_type_rx)) == E_NONE_AVAIL) {
+        if ((timer_ms_tick - start_tick) > MAX32666_QSPI_RX_TIMEOUT) {
+            PR_WARN("%s timeout", link->name);
+            return E_TIME_OUT;
+        }
+    }
+
+    return ret;
+}
+
+static void qspi_master_rx_start(qspi_master_link_t *link)
+{
+    *link->int_flag = 0;
+    link->rx_time = timer_get_us();
+    link->start_tick = timer_ms_tick;
+    link->buffer = NULL;
+    link->stream = NULL;
+    link->stream_len = 0;
+
+    qspi_master_active = link;
+    qspi_master_state = QSPI_MASTER_STATE_HEADER;
+
+    MXC_GPIO_OutSet(link->rw_pin->port, link->rw_pin->mask); // RX request
+
+    qspi_master_cs_assert(link->cs_pin);
+    spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, (uint8_t *) &link->header, sizeof(qspi_packet_header_t),
+            MAX32666_QSPI_DMA_REQSEL_SPIRX, qspi_master_rx_dma_callback);
+}
+
+static int qspi_master_rx_lookup(qspi_master_link_t *link)
+{
+    const qspi_master_rx_entry_t *entry;
+    uint32_t packet_size = link->header.info.packet_size;
+
+    link->buffer = NULL;
+
+    if (link->header.info.packet_type >= QSPI_PACKET_TYPE_LAST) {
+        return E_NOT_SUPPORTED;
+    }
+
+    entry = &link->rx_table[link->header.info.packet_type];
+    if (!entry->max_size && !entry->handler) {
+        return E_NOT_SUPPORTED;
+    }
+
+    if ((packet_size < entry->min_size) || (packet_size > entry->max_size)) {
+        return E_INVALID;
+    }
+
+    if (packet_size) {
+        if (entry->stream_start) {
+            link->stream = entry;
+            link->stream_offset = 0;
+            link->stream_crc = crc16_init();
+            if (entry->stream_start(packet_size) == E_NO_ERROR) {
+                return E_NO_ERROR;
+            }
+            link->stream = NULL;
+        }
+
+        if (entry->get_buffer) {
+            link->buffer = entry->get_buffer(packet_size);
+        } else if (entry->buffer && (packet_size <= sizeof(link->staging))) {
+            link->buffer = (uint8_t *) &link->staging;
+        }
+        if (!link->buffer) {
+            return E_BUSY;
+        }
+    }
+
+    return E_NO_ERROR;
+}
+
+static void qspi_master_rx_int(qspi_master_link_t *link)
+{
+    // Slave has the payload ready, start it right away
+    if ((qspi_master_active == link) && (qspi_master_state == QSPI_MASTER_STATE_PAYLOAD_WAIT)) {
+        link->payload_us = timer_get_us();
+
+        if (link->stream) {
+            // CS stays asserted between chunks, the slave waits for the clock
+            qspi_master_state = QSPI_MASTER_STATE_STREAM;
+            link->start_tick = timer_ms_tick;
+            qspi_master_cs_assert(link->cs_pin);
+            if (link->stream_len) {
+                qspi_master_rx_stream_dma(link);
+            }
+            return;
+        }
+
+        qspi_master_state = QSPI_MASTER_STATE_PAYLOAD;
+
+        qspi_master_cs_assert(link->cs_pin);
+        if (link->status == E_NO_ERROR) {
+            spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, link->buffer, link->header.info.packet_size,
+                    MAX32666_QSPI_DMA_REQSEL_SPIRX, qspi_master_rx_dma_callback);
+        } else {
+            // Clock the rejected payload out so the slave is released, nothing is stored
+            spi_dma_drain(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, link->header.info.packet_size,
+                    MAX32666_QSPI_DMA_REQSEL_SPIRX, qspi_master_rx_dma_callback);
+        }
+        return;
+    }
+
+    // New packet request or TX payload ready
+    *link->int_flag = 1;
+}
+
+static void qspi_master_rx_dma_callback(void)
+{
+    qspi_master_link_t *link = qspi_master_active;
+
+    if (!link) {
+        return;
+    }
+
+    if (qspi_master_state != QSPI_MASTER_STATE_STREAM) {
+        MXC_GPIO_OutSet(link->cs_pin->port, link->cs_pin->mask);
+    }
+
+    switch(qspi_master_state) {
+    case QSPI_MASTER_STATE_HEADER:
+        if ((link->header.start_symbol != QSPI_START_SYMBOL) ||
+            (link->header.header_crc16 != crc16_sw((uint8_t *) &link->header.info, sizeof(link->header.info)))) {
+            qspi_master_rx_done(link, E_COMM_ERR);
+            break;
+        }
+
+        link->status = qspi_master_rx_lookup(link);
+
+        // Rejected packets with payload are drained once the slave has it ready
+        if (link->header.info.packet_size) {
+            qspi_master_state = QSPI_MASTER_STATE_PAYLOAD_WAIT;
+        } else {
+            qspi_master_rx_done(link, link->status);
+        }
+        break;
+    case QSPI_MASTER_STATE_PAYLOAD:
+        link->payload_us = timer_get_us() - link->payload_us;
+        // Drained payloads are not checked
+        if ((link->status == E_NO_ERROR) &&
+            (link->header.payload_crc16 != crc16_sw(link->buffer, link->header.info.packet_size))) {
+            link->status = E_COMM_ERR;
+        }
+        qspi_master_rx_done(link, link->status);
+        break;
+    case QSPI_MASTER_STATE_STREAM:
+        qspi_master_rx_stream_chunk(link);
+        break;
+    default:
+        break;
+    }
+}
+
+static void qspi_master_rx_done(qspi_master_link_t *link, int status)
+{
+    link->status = status;
+    link->done = 1;
+
+    qspi_master_active = NULL;
+    qspi_master_state = QSPI_MASTER_STATE_IDLE;
+}
+
+static void qspi_master_rx_stream_dma(qspi_master_link_t *link)
+{
+    spi_dma(MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI, NULL, link->stream_buffer, link->stream_len,
+            MAX32666_QSPI_DMA_REQSEL_SPIRX, qspi_master_rx_dma_callback);
+}
+
+static void qspi_master_rx_stream_chunk(qspi_master_link_t *link)
+{
+    const qspi_master_rx_entry_t *stream = link->stream;
+    uint8_t *chunk = link->stream_buffer;
+    uint32_t len = link->stream_len;
+
+    link->stream_offset += len;
+    link->stream_len = 0;
+    link->start_tick = timer_ms_tick;
+    link->stream_crc = crc16_update(link->stream_crc, chunk, len);
+
+    // Chunks are consumed as they arrive, a bad crc fails the packet once the last one is in
+    if (link->stream_offset >= link->header.info.packet_size) {
+        MXC_GPIO_OutSet(link->cs_pin->port, link->cs_pin->mask);
+        link->payload_us = timer_get_us() - link->payload_us;
+        qspi_master_rx_done(link, (crc16_final(link->stream_crc) == link->header.payload_crc16) ? E_NO_ERROR : E_COMM_ERR);
+    }
+
+    // Consumer posts the next read from here or once it has room for it
+    stream->stream_chunk(chunk, len);
+}
+
+static void qspi_master_rx_timeout(void)
+{
+    qspi_master_link_t *link;
+
+    __disable_irq();
+    link = qspi_master_active;
+    // A stream also times out when its consumer stops posting reads
+    if (link && ((timer_ms_tick - link->start_tick) > MAX32666_QSPI_RX_TIMEOUT) &&
+        ((qspi_master_state == QSPI_MASTER_STATE_PAYLOAD_WAIT) ||
+         ((qspi_master_state == QSPI_MASTER_STATE_STREAM) && !link->stream_len))) {
+        MXC_GPIO_OutSet(link->cs_pin->port, link->cs_pin->mask);
+        qspi_master_rx_done(link, E_TIME_OUT);
+        if (link->stream) {
+            link->stream->stream_chunk(NULL, 0);
+        }
+    }
+    __enable_irq();
+}
+
+static void qspi_master_rx_error(qspi_master_link_t *link, int status)
+{
+    switch(status) {
+    case E_COMM_ERR:
+        if (link->header.start_symbol != QSPI_START_SYMBOL) {
+            PR_ERROR("Invalid QSPI start byte 0x%08hhX", link->header.start_symbol);
+        } else if (link->header.header_crc16 != crc16_sw((uint8_t *) &link->header.info, sizeof(link->header.info))) {
+            PR_ERROR("Invalid header crc 0x%x", link->header.header_crc16);
+        } else {
+            PR_ERROR("Invalid %s payload crc 0x%x", link->name, link->header.payload_crc16);
+        }
+        break;
+    case E_INVALID:
+        PR_ERROR("Invalid QSPI data len %u", link->header.info.packet_size);
+        break;
+    case E_NOT_SUPPORTED:
+        PR_ERROR("Unknown qspi %s packet", link->name);
+        break;
+    case E_TIME_OUT:
+        PR_WARN("%s payload timeout", link->name);
+        break;
+    case E_BUSY:
+        PR_WARN("no %s buffer for packet %d, dropped", link->name, link->header.info.packet_type);
+        break;
+    default:
+        break;
+    }
+}
+
+static int qspi_master_wait_idle(void)
+{
+    uint32_t cnt = SPI_TIMEOUT_CNT;
+
+    while ((qspi_master_state != QSPI_MASTER_STATE_IDLE) && cnt) {
+        qspi_master_rx_timeout();
+        cnt--;
+    }
+
+    if (cnt == 0) {
+        PR_WARN("timeout");
+        return E_TIME_OUT;
+    }
+
+    return E_NO_ERROR;
+}
+
+static void qspi_master_link_count(qspi_link_counter_t *counter, uint8_t packet_type, uint32_t packet_size)
+{
+    if (packet_type < QSPI_PACKET_TYPE_LAST) {
+        counter[packet_type].packets++;
+        counter[packet_type].bytes += packet_size;
+    }
+}
+
+static void qspi_master_link_print(const char *name, qspi_link_statistics_t *link_statistics)
+{
+    uint32_t duration = timer_ms_tick - link_statistics->period_start;
+
+    if (duration == 0) {
+        return;
+    }
+
+    PR_INFO("%s link errors %lu in %lu ms", name, link_statistics->rx_errors, duration);
+    for (int i = 0; i < QSPI_PACKET_TYPE_LAST; i++) {
+        if (link_statistics->rx[i].packets) {
+            PR_INFO("  rx %2d: %lu pkt/s %lu B/s", i,
+                    (link_statistics->rx[i].packets * 1000) / duration,
+                    (uint32_t) (((uint64_t) link_statistics->rx[i].bytes * 1000) / duration));
+        }
+        if (link_statistics->tx[i].packets) {
+            PR_INFO("  tx %2d: %lu pkt/s %lu B/s", i,
+                    (link_statistics->tx[i].packets * 1000) / duration,
+                    (uint32_t) (((uint64_t) link_statistics->tx[i].bytes * 1000) / duration));
+        }
+    }
+}
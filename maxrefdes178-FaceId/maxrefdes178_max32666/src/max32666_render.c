@@ -0,0 +1,520 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <mxc_device.h>
+#include <mxc_errors.h>
+#include <sema.h>
+#include <string.h>
+
+#include "max32666_data.h"
+#include "max32666_debug.h"
+#include "max32666_fonts.h"
+#include "max32666_framebuffer.h"
+#include "max32666_lcd.h"
+#include "max32666_render.h"
+#include "max32666_spi_dma.h"
+#include "max32666_timer_led_button.h"
+#include "maxrefdes178_definitions.h"
+#include "maxrefdes178_timing.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define S_MODULE_NAME   "render"
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+typedef enum {
+    RENDER_COMMAND_BEGIN = 0,
+    RENDER_COMMAND_STRING,
+    RENDER_COMMAND_STRING_CENTERED,
+    RENDER_COMMAND_BOXES,
+    RENDER_COMMAND_THICK_RECTANGLE,
+    RENDER_COMMAND_FILLED_RECTANGLE,
+    RENDER_COMMAND_PRESENT,
+} render_command_e;
+
+typedef struct {
+    render_command_e command;
+    uint8_t *buff;
+    union {
+        struct {
+            uint16_t x;
+            uint16_t y;
+            const FontDef *font;
+            uint16_t color;
+            char text[LCD_NOTIFICATION_MAX_SIZE];
+        } string;
+        struct {
+            fonts_box_t boxes[RENDER_MAX_BOXES];
+            uint16_t count;
+            uint8_t thickness;
+        } boxes;
+        struct {
+            uint16_t x1;  // or x of filled rectangle
+            uint16_t y1;  // or y
+            uint16_t x2;  // or w
+            uint16_t y2;  // or h
+            uint16_t color;
+            uint8_t thickness;
+        } rectangle;
+        struct {
+            uint8_t *frame;
+            uint32_t frame_capture_time;
+            uint8_t full;
+        } present;
+    } arg;
+} render_command_t;
+
+// Single producer single consumer circular buffer, core0 -> core1.
+// tail moves after the command is executed, an empty queue means the renderer is idle
+typedef struct {
+    render_command_t command_array[RENDER_QUEUE_SIZE];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+} render_queue_t;
+
+// Single producer single consumer circular buffer, core1 -> core0
+typedef struct {
+    uint32_t duration_us[RENDER_TIMING_QUEUE_SIZE];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+} render_timing_queue_t;
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+#ifdef RENDER_ON_CORE1
+static render_queue_t render_queue;
+static render_timing_queue_t render_timing_queue;
+static volatile uint8_t render_started = 0;    // core1 owns the LCD, written by core0
+static uint8_t render_core1_init_done = 0;     // core1 only
+static uint8_t render_lcd_locked = 0;          // core1 only, LCD_QSPI semaphore held for an LCD dma
+#endif
+
+// Written by the renderer
+static uint32_t render_start_cycles = 0;
+static volatile uint32_t render_overlay_damage = FONTS_DAMAGE_ALL;
+static volatile uint32_t render_frame_count = 0;        // video frames whose LCD DMA started
+static volatile uint32_t render_frame_capture_time = 0; // MAX78000 video clock of the last one
+
+// Core0 only
+static uint32_t render_frame_seen = 0;
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+static void render_submit(render_command_t *command);
+static int render_execute(const render_command_t *command);
+static int render_execute_present(const render_command_t *command);
+static void render_lcd_unlock(void);
+static void render_timing_submit(uint32_t start_cycles);
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+int render_init(void)
+{
+#ifdef RENDER_ON_CORE1
+    // LCD DMA interrupt moves to core1 with the LCD
+    spi_dma_wait(MAX32666_LCD_DMA_CHANNEL, MAX32666_LCD_SPI);
+    NVIC_DisableIRQ(MAX32666_LCD_DMA_IRQ);
+
+    render_queue.head = 0;
+    render_queue.tail = 0;
+    render_timing_queue.head = 0;
+    render_timing_queue.tail = 0;
+    __DMB();
+    render_started = 1;
+
+    PR_INFO("rendering on core1");
+#endif
+
+    return E_NO_ERROR;
+}
+
+void render_worker(void)
+{
+#ifdef RENDER_ON_CORE1
+    uint32_t tail;
+    uint32_t batch = RENDER_WORKER_BATCH;
+
+    if (!render_started) {
+        return;
+    }
+
+    if (!render_core1_init_done) {
+        timing_cycles_init();
+        NVIC_EnableIRQ(MAX32666_LCD_DMA_IRQ);
+        render_core1_init_done = 1;
+    }
+
+    render_lcd_unlock();
+
+    // A long frame is executed over several calls, BLE is served in between
+    for (tail = render_queue.tail; (tail != render_queue.head) && batch; tail = render_queue.tail, batch--) {
+        // Command is read after head
+        __DMB();
+        if (render_execute(&render_queue.command_array[tail]) == E_BUSY) {
+            // Present waits for the QSPI transmit, the command stays queued
+            break;
+        }
+        // Effects, including the LCD DMA busy flag, are visible before the slot is released
+        __DMB();
+        render_queue.tail = (tail + 1) % RENDER_QUEUE_SIZE;
+    }
+#endif
+}
+
+int render_ready(void)
+{
+#ifdef RENDER_ON_CORE1
+    if (render_queue.head != render_queue.tail) {
+        return 0;
+    }
+#endif
+
+    return !spi_dma_busy_flag(MAX32666_LCD_DMA_CHANNEL);
+}
+
+void render_sync(void)
+{
+#ifdef RENDER_ON_CORE1
+    while (render_queue.head != render_queue.tail) {}
+#endif
+
+    spi_dma_wait(MAX32666_LCD_DMA_CHANNEL, MAX32666_LCD_SPI);
+}
+
+void render_lcd_hold(void)
+{
+#ifdef RENDER_ON_CORE1
+    if (render_started) {
+        // Core1 holds the semaphore from the start of an LCD dma until it is done
+        while(MXC_SEMA_GetSema(MAX32666_SEMAPHORE_LCD_QSPI) == E_BUSY) {}
+        return;
+    }
+#endif
+
+    spi_dma_wait(MAX32666_LCD_DMA_CHANNEL, MAX32666_LCD_SPI);
+}
+
+void render_lcd_release(void)
+{
+#ifdef RENDER_ON_CORE1
+    if (render_started) {
+        MXC_SEMA_FreeSema(MAX32666_SEMAPHORE_LCD_QSPI);
+    }
+#endif
+}
+
+void render_begin(void)
+{
+    render_command_t command = {.command = RENDER_COMMAND_BEGIN};
+
+    render_submit(&command);
+}
+
+void render_putString(uint16_t x, uint16_t y, const char *str, const FontDef *font, uint16_t color, uint8_t *buff)
+{
+    render_command_t command = {.command = RENDER_COMMAND_STRING, .buff = buff};
+
+    command.arg.string.x = x;
+    command.arg.string.y = y;
+    command.arg.string.font = font;
+    command.arg.string.color = color;
+    strncpy(command.arg.string.text, str, sizeof(command.arg.string.text) - 1);
+
+    render_submit(&command);
+}
+
+void render_putStringCentered(uint16_t y, const char *str, const FontDef *font, uint16_t color, uint8_t *buff)
+{
+    render_command_t command = {.command = RENDER_COMMAND_STRING_CENTERED, .buff = buff};
+
+    command.arg.string.y = y;
+    command.arg.string.font = font;
+    command.arg.string.color = color;
+    strncpy(command.arg.string.text, str, sizeof(command.arg.string.text) - 1);
+
+    render_submit(&command);
+}
+
+void render_drawBoxes(const fonts_box_t *boxes, uint16_t count, uint8_t thickness, uint8_t *buff)
+{
+    render_command_t command = {.command = RENDER_COMMAND_BOXES, .buff = buff};
+
+    // Longer lists are split
+    while (count) {
+        command.arg.boxes.count = (count > RENDER_MAX_BOXES) ? RENDER_MAX_BOXES : count;
+        command.arg.boxes.thickness = thickness;
+        memcpy(command.arg.boxes.boxes, boxes, command.arg.boxes.count * sizeof(fonts_box_t));
+
+        render_submit(&command);
+
+        boxes += command.arg.boxes.count;
+        count -= command.arg.boxes.count;
+    }
+}
+
+void render_drawThickRectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color, uint8_t thickness, uint8_t *buff)
+{
+    render_command_t command = {.command = RENDER_COMMAND_THICK_RECTANGLE, .buff = buff};
+
+    command.arg.rectangle.x1 = x1;
+    command.arg.rectangle.y1 = y1;
+    command.arg.rectangle.x2 = x2;
+    command.arg.rectangle.y2 = y2;
+    command.arg.rectangle.color = color;
+    command.arg.rectangle.thickness = thickness;
+
+    render_submit(&command);
+}
+
+void render_drawFilledRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color, uint8_t *buff)
+{
+    render_command_t command = {.command = RENDER_COMMAND_FILLED_RECTANGLE, .buff = buff};
+
+    command.arg.rectangle.x1 = x;
+    command.arg.rectangle.y1 = y;
+    command.arg.rectangle.x2 = w;
+    command.arg.rectangle.y2 = h;
+    command.arg.rectangle.color = color;
+
+    render_submit(&command);
+}
+
+void render_present(uint8_t *canvas, uint8_t *frame, uint32_t frame_capture_time, uint8_t full)
+{
+    render_command_t command = {.command = RENDER_COMMAND_PRESENT, .buff = canvas};
+
+    command.arg.present.frame = frame;
+    command.arg.present.frame_capture_time = frame_capture_time;
+    command.arg.present.full = full;
+
+    render_submit(&command);
+}
+
+int render_frame_shown(uint32_t *capture_time)
+{
+    uint32_t count = render_frame_count;
+
+    if ((count == render_frame_seen) || spi_dma_busy_flag(MAX32666_LCD_DMA_CHANNEL)) {
+        return 0;
+    }
+
+    // Capture time was written before the count
+    __DMB();
+    *capture_time = render_frame_capture_time;
+    render_frame_seen = count;
+
+    return 1;
+}
+
+uint32_t render_take_overlay_damage(void)
+{
+    uint32_t damage = render_overlay_damage;
+
+    render_overlay_damage = 0;
+
+    return damage;
+}
+
+void render_timing_worker(void)
+{
+#ifdef RENDER_ON_CORE1
+    uint32_t tail;
+
+    for (tail = render_timing_queue.tail; tail != render_timing_queue.head; tail = render_timing_queue.tail) {
+        // Sample is read after head
+        __DMB();
+        timing_record_us(TIMING_STAGE_POSTPROCESS, render_timing_queue.duration_us[tail]);
+        __DMB();
+        render_timing_queue.tail = (tail + 1) % RENDER_TIMING_QUEUE_SIZE;
+    }
+#endif
+}
+
+static void render_submit(render_command_t *command)
+{
+#ifdef RENDER_ON_CORE1
+    uint32_t head;
+
+    if (render_started) {
+        head = render_queue.head;
+
+        // Only a frame with more commands than slots waits for core1 here
+        while (((head + 1) % RENDER_QUEUE_SIZE) == render_queue.tail) {}
+
+        // Core1 is done with the slot before tail moved
+        __DMB();
+        memcpy(&render_queue.command_array[head], command, sizeof(render_command_t));
+
+        // Slot content must be visible before the new head
+        __DMB();
+        render_queue.head = (head + 1) % RENDER_QUEUE_SIZE;
+        return;
+    }
+#endif
+
+    render_execute(command);
+}
+
+static int render_execute(const render_command_t *command)
+{
+    switch (command->command) {
+    case RENDER_COMMAND_BEGIN:
+        render_start_cycles = timing_cycles();
+        break;
+    case RENDER_COMMAND_STRING:
+        fonts_putString(command->arg.string.x, command->arg.string.y, command->arg.string.text, command->arg.string.font,
+                command->arg.string.color, 0, 0, command->buff);
+        break;
+    case RENDER_COMMAND_STRING_CENTERED:
+        fonts_putStringCentered(command->arg.string.y, command->arg.string.text, command->arg.string.font,
+                command->arg.string.color, command->buff);
+        break;
+    case RENDER_COMMAND_BOXES:
+        fonts_drawBoxes(command->arg.boxes.boxes, command->arg.boxes.count, command->arg.boxes.thickness, command->buff);
+        break;
+    case RENDER_COMMAND_THICK_RECTANGLE:
+        fonts_drawThickRectangle(command->arg.rectangle.x1, command->arg.rectangle.y1, command->arg.rectangle.x2,
+                command->arg.rectangle.y2, command->arg.rectangle.color, command->arg.rectangle.thickness, command->buff);
+        break;
+    case RENDER_COMMAND_FILLED_RECTANGLE:
+        fonts_drawFilledRectangle(command->arg.rectangle.x1, command->arg.rectangle.y1, command->arg.rectangle.x2,
+                command->arg.rectangle.y2, command->arg.rectangle.color, command->buff);
+        break;
+    case RENDER_COMMAND_PRESENT:
+        return render_execute_present(command);
+    default:
+        PR_ERROR("unknown command %d", command->command);
+        break;
+    }
+
+    return E_NO_ERROR;
+}
+
+static int render_execute_present(const render_command_t *command)
+{
+    int ret;
+    uint32_t damage;
+
+#ifdef RENDER_ON_CORE1
+    if (render_started) {
+        // Core0 is sending on QSPI, or the last LCD dma is not released yet
+        if (MXC_SEMA_GetSema(MAX32666_SEMAPHORE_LCD_QSPI) == E_BUSY) {
+            return E_BUSY;
+        }
+        render_lcd_locked = 1;
+    }
+#endif
+
+    // Video frames replace the whole buffer, otherwise send only the bands changed by the overlay
+    if (command->arg.present.full) {
+        fonts_getDamage();
+        render_overlay_damage = FONTS_DAMAGE_ALL;
+        ret = lcd_drawImage(command->buff);
+        if (command->arg.present.frame) {
+            framebuffer_display(command->arg.present.frame);
+            if (ret == E_NO_ERROR) {
+                render_frame_capture_time = command->arg.present.frame_capture_time;
+                __DMB();
+                render_frame_count++;
+            }
+        }
+    } else {
+        damage = fonts_getDamage();
+        render_overlay_damage |= damage;
+        ret = lcd_drawDamage(damage, command->buff);
+    }
+
+    if (ret == E_NO_ERROR) {
+        device_status.statistics.lcd_fps = (float) 1000.0 / (float)(timer_ms_tick - timestamps.screen_drew);
+        timestamps.screen_drew = timer_ms_tick;
+        render_timing_submit(render_start_cycles);
+    }
+
+    // Damaged bands are sent synchronously, a whole image when its dma is done
+    render_lcd_unlock();
+
+    return E_NO_ERROR;
+}
+
+static void render_lcd_unlock(void)
+{
+#ifdef RENDER_ON_CORE1
+    if (render_lcd_locked && !spi_dma_busy_flag(MAX32666_LCD_DMA_CHANNEL)) {
+        MXC_SEMA_FreeSema(MAX32666_SEMAPHORE_LCD_QSPI);
+        render_lcd_locked = 0;
+    }
+#endif
+}
+
+static void render_timing_submit(uint32_t start_cycles)
+{
+#ifdef RENDER_ON_CORE1
+    uint32_t head;
+
+    // Executed on core1 once started, core0 records the sample
+    if (render_started) {
+        head = render_timing_queue.head;
+
+        // Core0 drains every main loop iteration, a sample is dropped rather than waited for
+        if (((head + 1) % RENDER_TIMING_QUEUE_SIZE) == render_timing_queue.tail) {
+            return;
+        }
+
+        render_timing_queue.duration_us[head] = timing_cycles_to_us(timing_cycles() - start_cycles);
+
+        // Sample must be visible before the new head
+        __DMB();
+        render_timing_queue.head = (head + 1) % RENDER_TIMING_QUEUE_SIZE;
+        return;
+    }
+#endif
+
+    timing_record(TIMING_STAGE_POSTPROCESS, start_cycles);
+}
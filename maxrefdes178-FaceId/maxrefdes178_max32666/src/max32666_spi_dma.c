@@ -57,6 +57,14 @@
 //-----------------------------------------------------------------------------
 // Typedefs
 //-----------------------------------------------------------------------------
+// Transfers longer than one SPI character count are split into segments, the next one
+// is written to the reload registers each time the DMA reloads
+typedef struct {
+    uint32_t next;          // address of the segment after the one in the reload registers
+    uint32_t remaining;     // bytes after the segment in the reload registers
+    uint8_t tx;
+    uint8_t inc;
+} spi_dma_chain_t;
 
 
 //-----------------------------------------------------------------------------
@@ -64,11 +72,17 @@
 //-----------------------------------------------------------------------------
 static volatile uint8_t dma_busy_flag[MXC_DMA_CHANNELS] = {0};
 static void (*dma_callback[MXC_DMA_CHANNELS]) (void) = {0};
+// Discarded RX bytes all land here
+static volatile uint8_t dma_drain_sink;
+static volatile spi_dma_chain_t dma_chain[MXC_DMA_CHANNELS] = {0};
 
 
 //-----------------------------------------------------------------------------
 // Local function declarations
 //-----------------------------------------------------------------------------
+static int spi_dma_transfer(uint8_t ch, mxc_spi_regs_t *spi, uint8_t *data_out, uint8_t *data_in, uint8_t data_in_inc,
+                            uint32_t len, mxc_dma_reqsel_t reqsel, void (*callback)(void));
+static void spi_dma_chain_load(uint8_t ch);
 
 
 //-----------------------------------------------------------------------------
@@ -96,6 +110,12 @@ void spi_dma_int_handler(uint8_t ch, mxc_spi_regs_t *spi)
 
             // Reload occurred, start the SPI transaction
             spi->ctrl0 |= (MXC_F_SPI_CTRL0_EN | MXC_F_SPI_CTRL0_START);
+
+            // Queue the following segment
+            if (dma_chain[ch].remaining) {
+                spi_dma_chain_load(ch);
+                MXC_DMA0->ch[ch].cfg |= MXC_F_DMA_CFG_RLDEN;
+            }
         } else {
             if (MXC_DMA0->ch[ch].cnt) {
                 PR_WARN("dma is not empty %d", MXC_DMA0->ch[ch].cnt);
@@ -157,6 +177,17 @@ int spi_dma_master_init(mxc_spi_regs_t *spi, sys_map_t map, uint32_t speed, uint
 }
 
 int spi_dma(uint8_t ch, mxc_spi_regs_t *spi, uint8_t *data_out, uint8_t *data_in, uint32_t len, mxc_dma_reqsel_t reqsel, void (*callback)(void))
+{
+    return spi_dma_transfer(ch, spi, data_out, data_in, 1, len, reqsel, callback);
+}
+
+int spi_dma_drain(uint8_t ch, mxc_spi_regs_t *spi, uint32_t len, mxc_dma_reqsel_t reqsel, void (*callback)(void))
+{
+    return spi_dma_transfer(ch, spi, NULL, (uint8_t *) &dma_drain_sink, 0, len, reqsel, callback);
+}
+
+static int spi_dma_transfer(uint8_t ch, mxc_spi_regs_t *spi, uint8_t *data_out, uint8_t *data_in, uint8_t data_in_inc,
+                            uint32_t len, mxc_dma_reqsel_t reqsel, void (*callback)(void))
 {
     if (dma_busy_flag[ch]) {
         PR_ERROR("dma is busy %d", ch);
@@ -230,7 +261,7 @@ int spi_dma(uint8_t ch, mxc_spi_regs_t *spi, uint8_t *data_out, uint8_t *data_in
                                MXC_F_DMA_CFG_CTZIEN);
     }
     if (data_in) {
-        MXC_DMA0->ch[ch].cfg = (MXC_F_DMA_CFG_DISTINC |
+        MXC_DMA0->ch[ch].cfg = ((data_in_inc ? MXC_F_DMA_CFG_DISTINC : 0) |
                                reqsel |
                                MXC_S_DMA_CFG_SRCWD_BYTE |
                                MXC_S_DMA_CFG_DSTWD_BYTE |
@@ -250,18 +281,18 @@ int spi_dma(uint8_t ch, mxc_spi_regs_t *spi, uint8_t *data_out, uint8_t *data_in
         MXC_DMA0->ch[ch].dst = (unsigned int) data_in;
     }
 
-    // if too big, set reload registers
+    // if too big, chain segments through the reload registers
+    dma_chain[ch].remaining = 0;
     if (len > SPI_DMA_COUNTER_MAX) {
         MXC_DMA0->ch[ch].cnt = SPI_DMA_COUNTER_MAX;
-        if (data_out) {
-            MXC_DMA0->ch[ch].src_rld = (unsigned int) (data_out + SPI_DMA_COUNTER_MAX);
-            MXC_DMA0->ch[ch].dst_rld = 0;
+        dma_chain[ch].tx = (data_out != NULL);
+        dma_chain[ch].inc = data_out || data_in_inc;
+        dma_chain[ch].next = (unsigned int) (data_out ? data_out : data_in);
+        if (dma_chain[ch].inc) {
+            dma_chain[ch].next += SPI_DMA_COUNTER_MAX;
         }
-        if (data_in) {
-            MXC_DMA0->ch[ch].src_rld = 0;
-            MXC_DMA0->ch[ch].dst_rld = (unsigned int) (data_in + SPI_DMA_COUNTER_MAX);
-        }
-        MXC_DMA0->ch[ch].cnt_rld = len - SPI_DMA_COUNTER_MAX;
+        dma_chain[ch].remaining = len - SPI_DMA_COUNTER_MAX;
+        spi_dma_chain_load(ch);
     }
 
     // Enable DMA int
@@ -306,3 +337,26 @@ uint8_t spi_dma_busy_flag(uint8_t ch)
 {
     return dma_busy_flag[ch];
 }
+
+static void spi_dma_chain_load(uint8_t ch)
+{
+    uint32_t len = dma_chain[ch].remaining;
+
+    if (len > SPI_DMA_COUNTER_MAX) {
+        len = SPI_DMA_COUNTER_MAX;
+    }
+
+    if (dma_chain[ch].tx) {
+        MXC_DMA0->ch[ch].src_rld = dma_chain[ch].next;
+        MXC_DMA0->ch[ch].dst_rld = 0;
+    } else {
+        MXC_DMA0->ch[ch].src_rld = 0;
+        MXC_DMA0->ch[ch].dst_rld = dma_chain[ch].next;
+    }
+    MXC_DMA0->ch[ch].cnt_rld = len;
+
+    if (dma_chain[ch].inc) {
+        dma_chain[ch].next += len;
+    }
+    dma_chain[ch].remaining -= len;
+}
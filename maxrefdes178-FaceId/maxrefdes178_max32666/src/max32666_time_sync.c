@@ -0,0 +1,272 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <mxc_errors.h>
+#include <string.h>
+
+#include "max32666_debug.h"
+#include "max32666_qspi_master.h"
+#include "max32666_time_sync.h"
+#include "max32666_timer_led_button.h"
+#include "maxrefdes178_definitions.h"
+#include "maxrefdes178_timing.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define S_MODULE_NAME   "sync"
+
+// Larger offset changes are MAX78000 resets or RTC steps, not drift
+#define TIME_SYNC_MAX_DRIFT_PPB     (1000 * 1000)
+// Drift is averaged over this many windows
+#define TIME_SYNC_DRIFT_SMOOTHING   4
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+// NTP style exchange: host sends at t1, device receives at t2 and responds at t3, host receives at t4.
+// Offset error is half the path asymmetry, so the exchange with the shortest round trip of a window is kept.
+typedef struct {
+    uint8_t pending;
+    uint32_t host_tx_us;        // t1 of the command in flight
+
+    uint32_t window_count;
+    uint32_t window_rtt_us;     // best round trip of the window, 0 if none
+    uint32_t window_offset_us;
+    uint32_t window_ref_us;
+
+    uint8_t synced;
+    uint8_t drift_valid;
+    uint32_t offset_us;         // host - device at ref_us, modulo 2^32
+    uint32_t ref_us;            // device clock
+    int32_t drift_ppb;
+    uint32_t rtt_us;
+} time_sync_clock_t;
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static time_sync_clock_t clocks[TIME_SYNC_DEVICE_LAST];
+static timing_histogram_t latency_histogram[LATENCY_LAST];
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+static void time_sync_update(time_sync_clock_t *clock);
+static void time_sync_get_status(time_sync_clock_t *clock, time_sync_status_t *status);
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+int time_sync_init(void)
+{
+    memset(clocks, 0, sizeof(clocks));
+    memset(latency_histogram, 0, sizeof(latency_histogram));
+
+    return E_NO_ERROR;
+}
+
+int time_sync_worker(void)
+{
+    int ret_video;
+    int ret_audio;
+
+    // Send would wait for the RX transfer in flight and inflate the round trip
+    if (qspi_master_busy()) {
+        return E_BUSY;
+    }
+
+    // A lost response is replaced by the next command. Responses are handled by the main loop after
+    // the send returned, t1 is the header DMA start taken by the send
+    clocks[TIME_SYNC_DEVICE_VIDEO].pending = 0;
+    ret_video = qspi_master_send_video(NULL, 0, QSPI_PACKET_TYPE_VIDEO_TIME_SYNC_CMD);
+    if (ret_video == E_NO_ERROR) {
+        clocks[TIME_SYNC_DEVICE_VIDEO].host_tx_us = qspi_master_tx_time();
+        clocks[TIME_SYNC_DEVICE_VIDEO].pending = 1;
+    }
+
+    clocks[TIME_SYNC_DEVICE_AUDIO].pending = 0;
+    ret_audio = qspi_master_send_audio(NULL, 0, QSPI_PACKET_TYPE_AUDIO_TIME_SYNC_CMD);
+    if (ret_audio == E_NO_ERROR) {
+        clocks[TIME_SYNC_DEVICE_AUDIO].host_tx_us = qspi_master_tx_time();
+        clocks[TIME_SYNC_DEVICE_AUDIO].pending = 1;
+    }
+
+    return (ret_video == E_NO_ERROR) ? ret_audio : ret_video;
+}
+
+void time_sync_response(time_sync_device_e device, const time_sync_t *time_sync, uint32_t host_rx_us)
+{
+    time_sync_clock_t *clock;
+    uint32_t forward_us;
+    uint32_t rtt_us;
+
+    if (device >= TIME_SYNC_DEVICE_LAST) {
+        return;
+    }
+    clock = &clocks[device];
+
+    if (!clock->pending) {
+        PR_DEBUG("unexpected response %d", device);
+        return;
+    }
+    clock->pending = 0;
+
+    // t1 - t2 is offset minus forward delay, t4 - t3 is offset plus return delay
+    forward_us = clock->host_tx_us - time_sync->device_rx_us;
+    rtt_us = (host_rx_us - clock->host_tx_us) - (time_sync->device_tx_us - time_sync->device_rx_us);
+
+    if (((int32_t) rtt_us >= 0) && (rtt_us <= MAX32666_TIME_SYNC_MAX_RTT) &&
+        (!clock->window_rtt_us || (rtt_us < clock->window_rtt_us))) {
+        clock->window_rtt_us = rtt_us ? rtt_us : 1;
+        clock->window_offset_us = forward_us + (uint32_t)((int32_t)((host_rx_us - time_sync->device_tx_us) - forward_us) / 2);
+        clock->window_ref_us = time_sync->device_rx_us + ((time_sync->device_tx_us - time_sync->device_rx_us) / 2);
+    }
+
+    if (++clock->window_count >= MAX32666_TIME_SYNC_WINDOW) {
+        time_sync_update(clock);
+    }
+}
+
+int time_sync_to_host(time_sync_device_e device, uint32_t device_us, uint32_t *host_us)
+{
+    time_sync_clock_t *clock;
+    int32_t elapsed_us;
+
+    if (device >= TIME_SYNC_DEVICE_LAST) {
+        return E_BAD_PARAM;
+    }
+    clock = &clocks[device];
+
+    if (!clock->synced) {
+        return E_BAD_STATE;
+    }
+
+    elapsed_us = (int32_t)(device_us - clock->ref_us);
+    *host_us = device_us + clock->offset_us + (int32_t)(((int64_t) elapsed_us * clock->drift_ppb) / 1000000000);
+
+    return E_NO_ERROR;
+}
+
+void time_sync_record_latency(latency_e latency, time_sync_device_e device, uint32_t device_us)
+{
+    uint32_t host_us;
+    int32_t latency_us;
+
+    if (latency >= LATENCY_LAST) {
+        return;
+    }
+
+    if (time_sync_to_host(device, device_us, &host_us) != E_NO_ERROR) {
+        return;
+    }
+
+    // Negative within sync error for very short latencies
+    latency_us = (int32_t)(timer_get_us() - host_us);
+    if (latency_us < 0) {
+        latency_us = 0;
+    }
+
+    timing_histogram_record(&latency_histogram[latency], latency_us);
+}
+
+void time_sync_get_timing(device_timing_t *timing)
+{
+    for (uint32_t latency = 0; latency < LATENCY_LAST; latency++) {
+        timing_histogram_get(&latency_histogram[latency], &timing->latency[latency]);
+    }
+
+    time_sync_get_status(&clocks[TIME_SYNC_DEVICE_VIDEO], &timing->max78000_video_time_sync);
+    time_sync_get_status(&clocks[TIME_SYNC_DEVICE_AUDIO], &timing->max78000_audio_time_sync);
+}
+
+static void time_sync_update(time_sync_clock_t *clock)
+{
+    int32_t elapsed_us;
+    int32_t offset_change_us;
+    int64_t drift_ppb;
+
+    clock->window_count = 0;
+
+    // Keep the previous estimate if every exchange of the window was too slow
+    if (!clock->window_rtt_us) {
+        PR_DEBUG("no usable exchange in window");
+        return;
+    }
+
+    if (clock->synced) {
+        elapsed_us = (int32_t)(clock->window_ref_us - clock->ref_us);
+        offset_change_us = (int32_t)(clock->window_offset_us - clock->offset_us);
+
+        if (elapsed_us > 0) {
+            drift_ppb = ((int64_t) offset_change_us * 1000000000) / elapsed_us;
+
+            if ((drift_ppb > TIME_SYNC_MAX_DRIFT_PPB) || (drift_ppb < -TIME_SYNC_MAX_DRIFT_PPB)) {
+                PR_WARN("clock step %d us", offset_change_us);
+                clock->drift_ppb = 0;
+                clock->drift_valid = 0;
+            } else if (!clock->drift_valid) {
+                clock->drift_ppb = (int32_t) drift_ppb;
+                clock->drift_valid = 1;
+            } else {
+                clock->drift_ppb += ((int32_t) drift_ppb - clock->drift_ppb) / TIME_SYNC_DRIFT_SMOOTHING;
+            }
+        }
+    }
+
+    clock->offset_us = clock->window_offset_us;
+    clock->ref_us = clock->window_ref_us;
+    clock->rtt_us = clock->window_rtt_us;
+    clock->synced = 1;
+
+    clock->window_rtt_us = 0;
+
+    PR_DEBUG("offset %d us drift %d ppb rtt %u us", (int32_t) clock->offset_us, clock->drift_ppb, clock->rtt_us);
+}
+
+static void time_sync_get_status(time_sync_clock_t *clock, time_sync_status_t *status)
+{
+    status->offset_us = (int32_t) clock->offset_us;
+    status->drift_ppb = clock->drift_ppb;
+    status->rtt_us = clock->synced ? clock->rtt_us : 0;
+}
@@ -110,6 +110,21 @@ void ms_timer(void)
     timer_ms_tick += 1;
 }
 
+// Microseconds from ms tick and timer count, keeps running while core sleeps
+uint32_t timer_get_us(void)
+{
+    uint32_t ms;
+    uint32_t count;
+
+    // Retry if ms tick interrupt hits between the two reads
+    do {
+        ms = timer_ms_tick;
+        count = MXC_TMR_GetCount(MAX32666_TIMER_MS);
+    } while (ms != timer_ms_tick);
+
+    return (ms * 1000) + (count / (PeripheralClock / 1000000));
+}
+
 void power_off_timer(void)
 {
     // Clear interrupt
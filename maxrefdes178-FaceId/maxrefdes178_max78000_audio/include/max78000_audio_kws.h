@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+#ifndef _MAX78000_AUDIO_KWS_H_
+#define _MAX78000_AUDIO_KWS_H_
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define KWS_NUM_OUTPUTS             22      // same as CNN_NUM_OUTPUTS
+#define KWS_SMOOTHING_HOPS          3       // number of inferences posteriors are averaged over
+#define KWS_SUPPRESS_HOPS           8       // number of inferences the same keyword is not reported again
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+// Continuous keyword spotting decision state, posteriors of the last inferences and the suppression
+typedef struct {
+    int16_t posteriors[KWS_SMOOTHING_HOPS][KWS_NUM_OUTPUTS];
+    uint16_t posterior_counter;
+    uint16_t inference_counter;
+    uint16_t suppress_counter;
+    int16_t last_class;
+    int16_t unknown_class;
+    uint8_t threshold;
+} kws_decision_t;
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+// threshold -> min smoothed probability (0-100) of a keyword, unknown_class -> class that is never reported
+void kws_decision_init(kws_decision_t *kws, uint8_t threshold, int16_t unknown_class);
+// Add Q15 softmax of one inference. Returns the keyword to report, -1 if none.
+// out_class and probability get the smoothed winner, reported or not
+int kws_decision_update(kws_decision_t *kws, const int16_t *softmax, int16_t *out_class, double *probability);
+
+
+#endif /* _MAX78000_AUDIO_KWS_H_ */
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <string.h>
+
+#include "max78000_audio_kws.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+void kws_decision_init(kws_decision_t *kws, uint8_t threshold, int16_t unknown_class)
+{
+    memset(kws, 0, sizeof(kws_decision_t));
+    kws->last_class = -1;
+    kws->unknown_class = unknown_class;
+    kws->threshold = threshold;
+}
+
+int kws_decision_update(kws_decision_t *kws, const int16_t *softmax, int16_t *out_class, double *probability)
+{
+    int32_t sum, max_sum = -1;
+    int report = -1;
+
+    /* average posteriors of the last inferences */
+    memcpy(kws->posteriors[kws->posterior_counter], softmax, sizeof(kws->posteriors[0]));
+    kws->posterior_counter = (kws->posterior_counter + 1) % KWS_SMOOTHING_HOPS;
+    if (kws->inference_counter < KWS_SMOOTHING_HOPS) {
+        kws->inference_counter++;
+    }
+
+    *out_class = -1;
+    for (int i = 0; i < KWS_NUM_OUTPUTS; i++) {
+        sum = 0;
+        for (int hops = 0; hops < kws->inference_counter; hops++) {
+            sum += kws->posteriors[hops][i];
+        }
+        if (sum > max_sum) {
+            max_sum = sum;
+            *out_class = i;
+        }
+    }
+    *probability = 100.0 * max_sum / kws->inference_counter / 32768.0;
+
+    if (kws->suppress_counter) {
+        kws->suppress_counter--;
+    }
+
+    /* report only confident keywords, once per utterance */
+    if ((*probability > kws->threshold) && (*out_class != kws->unknown_class)) {
+        if ((*out_class != kws->last_class) || (kws->suppress_counter == 0)) {
+            report = *out_class;
+            kws->last_class = *out_class;
+        }
+
+        /* keep suppressing while the same keyword is still heard */
+        kws->suppress_counter = KWS_SUPPRESS_HOPS;
+    }
+
+    return report;
+}
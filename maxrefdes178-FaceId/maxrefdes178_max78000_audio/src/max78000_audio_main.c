@@ -48,15 +48,20 @@
 #include <mxc_device.h>
 #include <mxc_sys.h>
 #include <nvic_table.h>
+#include <rtc.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <tmr.h>
 
 #include "max78000_audio_cnn.h"
+#include "max78000_audio_kws.h"
+#include "max78000_cnn_loader.h"
 #include "max78000_debug.h"
 #include "max78000_qspi_slave.h"
 #include "maxrefdes178_definitions.h"
+#include "maxrefdes178_mic.h"
+#include "maxrefdes178_timing.h"
 #include "maxrefdes178_utility.h"
 #include "maxrefdes178_version.h"
 
@@ -70,15 +75,16 @@
 //#define ENABLE_PRINT_ENVELOPE            // enables printing average waveform envelope for samples
 //#define ENABLE_CLASSIFICATION_DISPLAY    // enables printing classification result
 #define ENABLE_SILENCE_DETECTION         // Starts collecting only after avg > THRESHOLD_HIGH, otherwise starts from first sample
+//#define ENABLE_CONTINUOUS_KWS            // runs CNN on a sliding SAMPLE_SIZE window every KWS_HOP_CHUNKS, silence detection is bypassed
 #undef EIGHT_BIT_SAMPLES                 // samples from Mic or Test vectors are eight bit, otherwise 16-bit
 
 /*-----------------------------*/
 /* keep following unchanged */
 #define SAMPLE_SIZE         16384   // size of input vector for CNN, keep it multiple of 128
+#define SAMPLE_RATE         16000   // microphone sample rate in Hz
 #define CHUNK               128     // number of data points to read at a time and average for threshold, keep multiple of 128
 #define TRANSPOSE_WIDTH     128     // width of 2d data model to be used for transpose
 #define NUM_OUTPUTS         CNN_NUM_OUTPUTS      // number of classes
-#define I2S_RX_BUFFER_SIZE  64      // I2S buffer size
 #define TFT_BUFF_SIZE       50      // TFT buffer size
 /*-----------------------------*/
 
@@ -89,6 +95,18 @@
 #define SILENCE_COUNTER_THRESHOLD   20      // [>20] number of back to back CHUNK periods with avg < THRESHOLD_LOW to declare the end of a word
 #define PREAMBLE_SIZE               30*CHUNK// how many samples before beginning of a keyword to include
 #define INFERENCE_THRESHOLD         75      // min probability (0-100) to accept an inference
+#define MIC_DISCARD_SAMPLES         10000   // number of samples discarded at start due to microphone charging cap effect
+
+/* Continuous mode adjustables */
+#define KWS_HOP_CHUNKS              16      // number of CHUNK periods between inferences, 16 -> 128 ms
+#define KWS_STATISTICS_HOPS         8       // number of inferences between statistics packets
+
+#if defined(ENABLE_CONTINUOUS_KWS) && (NUM_OUTPUTS != KWS_NUM_OUTPUTS)
+#error "KWS_NUM_OUTPUTS does not match the CNN outputs"
+#endif
+
+/* First DMA block is shortened so that following CHUNK blocks start right after the discarded samples */
+#define MIC_DISCARD_FIRST_BLOCK     ((MIC_DISCARD_SAMPLES % CHUNK) ? (MIC_DISCARD_SAMPLES % CHUNK) : CHUNK)
 
 /* MAX9867 Audio Codec */
 #define MAX9867_I2C        MXC_I2C1
@@ -127,18 +145,35 @@ static int32_t ml_data[NUM_OUTPUTS];
 static q15_t ml_softmax[NUM_OUTPUTS];
 static uint8_t pAI85Buffer[SAMPLE_SIZE];
 static uint8_t pPreambleCircBuffer[PREAMBLE_SIZE];
+#ifdef ENABLE_CONTINUOUS_KWS
+static uint8_t pKwsCircBuffer[SAMPLE_SIZE];
+static kws_decision_t kws_decision;
+#endif
 static int16_t Max, Min;
 static uint16_t thresholdHigh = THRESHOLD_HIGH;
 static uint16_t thresholdLow = THRESHOLD_LOW;
-static int16_t  x0, x1, Coeff;
-static int32_t  y0, y1;
+static mic_hpf_t hpf;
 static int8_t enable_audio = 1;
 static int8_t enable_sleep = 0;
 static volatile int8_t button_pressed = 0;
 
-static volatile uint8_t i2s_flag = 0;
-static int32_t i2s_rx_buffer[I2S_RX_BUFFER_SIZE];
+static const uint8_t i2s_ch = MAX78000_AUDIO_I2S_DMA_CHANNEL;
+static int32_t i2s_dma_buffer[2][CHUNK];       // ping-pong microphone sample buffers
+static uint16_t i2s_dma_size[2];               // number of samples DMA writes to each buffer
+static uint8_t i2s_dma_active_buffer = 0;      // buffer DMA is writing to
+static volatile uint8_t i2s_dma_ready = 0;
+static volatile uint8_t i2s_dma_ready_buffer = 0;
+static volatile uint16_t i2s_dma_ready_size = 0;
+static volatile uint32_t i2s_dma_overrun = 0;
 static max78000_statistics_t max78000_statistics = {0};
+// Statistics window in RTC us, it keeps running while the core sleeps on CNN load and inference
+static uint64_t stat_total_us = 0;
+static uint64_t stat_idle_us = 0;
+static uint64_t stat_cnn_us = 0;
+static uint32_t stat_last_us = 0;
+static uint32_t stat_idle_start_us = 0;    // first poll that found no microphone chunk
+static uint8_t stat_idle = 0;
+static uint32_t chunk_time = 0;  // RTC us when the last microphone chunk was read
 static version_t version = {S_VERSION_MAJOR, S_VERSION_MINOR, S_VERSION_BUILD};
 static char demo_name[] = FACEID_DEMO_NAME;
 static uint8_t qspi_rx_buffer[100];
@@ -162,25 +197,52 @@ static const char keywords[NUM_OUTPUTS][10] = { "UP", "DOWN", "LEFT", "RIGHT", "
 //-----------------------------------------------------------------------------
 static void fail(void);
 static uint8_t cnn_load_data(uint8_t* pIn);
+static void run_cnn(void);
+static void send_statistics(uint32_t latency_us);
+#ifdef ENABLE_CONTINUOUS_KWS
+static void kws_continuous(uint8_t* pChunk);
+#endif
 static uint8_t MicReadChunk(uint8_t* pBuff, uint16_t* avg);
 static uint8_t AddTranspose(uint8_t* pIn, uint8_t* pOut, uint16_t inSize,
                      uint16_t outSize, uint16_t width);
 static uint8_t check_inference(q15_t* ml_soft, int32_t* ml_data,
                         int16_t* out_class, double* out_prob);
 static void I2SInit();
-static void HPF_init(void);
-static int16_t HPF(int16_t input);
 static int max9867_init(void);
 
 
 //-----------------------------------------------------------------------------
 // Function definitions
 //-----------------------------------------------------------------------------
-void i2s_isr(void)
+void MAX78000_AUDIO_I2S_DMA_IRQ_HAND(void)
 {
-    i2s_flag = 1;
-    /* Clear I2S interrupt flag */
-    MXC_I2S_ClearFlags(MXC_F_I2S_INTFL_RX_THD_CH0);
+    uint8_t completed_buffer;
+
+    if (MXC_DMA->intfl & (0x1 << i2s_ch)) {
+        if (MXC_DMA->ch[i2s_ch].status & (MXC_F_DMA_STATUS_TO_IF | MXC_F_DMA_STATUS_BUS_ERR)) {
+            PR_ERROR("dma error %d", MXC_DMA->ch[i2s_ch].status);
+        }
+
+        /* DMA already moved to the other buffer, reload the completed one after it */
+        completed_buffer = i2s_dma_active_buffer;
+        i2s_dma_active_buffer ^= 1;
+        MXC_DMA->ch[i2s_ch].dstrld = (unsigned int) i2s_dma_buffer[completed_buffer];
+        MXC_DMA->ch[i2s_ch].cntrld = CHUNK * sizeof(int32_t);
+        MXC_DMA->ch[i2s_ch].ctrl |= MXC_F_DMA_CTRL_RLDEN;
+
+        /* previous block is not processed yet */
+        if (i2s_dma_ready) {
+            i2s_dma_overrun++;
+        }
+
+        i2s_dma_ready_buffer = completed_buffer;
+        i2s_dma_ready_size = i2s_dma_size[completed_buffer];
+        i2s_dma_size[completed_buffer] = CHUNK;
+        i2s_dma_ready = 1;
+
+        // Clear DMA int flags
+        MXC_DMA->ch[i2s_ch].status = MXC_DMA->ch[i2s_ch].status;
+    }
 }
 
 void button_int(void *cbdata)
@@ -201,7 +263,8 @@ int main(void)
     MXC_Delay(MXC_DELAY_MSEC(500)); // Wait supply to be ready
 
     uint32_t sampleCounter = 0;
-    mxc_tmr_unit_t units;
+    uint32_t chunk_cycles = 0;
+    uint32_t cycles = 0;
 
     uint8_t pChunkBuff[CHUNK];
 
@@ -211,10 +274,12 @@ int main(void)
     uint16_t wordCounter = 0;
 
     uint16_t avgSilenceCounter = 0;
+    uint32_t silenceSamples = 0;
 
     classification_result_t classification_result = {0};
     qspi_state_e qspi_rx_state;
     qspi_packet_header_t qspi_rx_header;
+    time_sync_t time_sync;
 
     mic_processing_state procState = STOP;
 
@@ -283,6 +348,22 @@ int main(void)
         fail();
     }
 
+    if (cnn_loader_init() != E_NO_ERROR) {
+        PR_ERROR("cnn_loader_init fail");
+        fail();
+    }
+
+    /* RTC is the timebase for host time sync and keyword timestamps */
+    if (MXC_RTC_Init(0, 0) != E_NO_ERROR) {
+        PR_ERROR("Could not initialize rtc");
+        fail();
+    }
+
+    if (MXC_RTC_Start() != E_NO_ERROR) {
+        PR_ERROR("Could not start rtc");
+        fail();
+    }
+
     /* Bring state machine into consistent state */
     cnn_init();
     /* Load kernels */
@@ -317,6 +398,13 @@ int main(void)
     MXC_TMR_EnableInt(MAX78000_AUDIO_SLEEP_DEFER_TMR);
     MXC_TMR_Start(MAX78000_AUDIO_SLEEP_DEFER_TMR);
 
+    /* Enable cycle counter for latency, duty cycle and stage timing statistics */
+    timing_init();
+    stat_last_us = GET_RTC_US();
+#ifdef ENABLE_CONTINUOUS_KWS
+    kws_decision_init(&kws_decision, INFERENCE_THRESHOLD, NUM_OUTPUTS - 1);  // last class is "Unknown"
+#endif
+
     PR_INFO("** READY ***");
 
     /* Read samples */
@@ -387,6 +475,8 @@ int main(void)
 //                cnn_enable(MXC_S_GCR_PCLKDIV_CNNCLKSEL_PCLK, MXC_S_GCR_PCLKDIV_CNNCLKDIV_DIV1);
 
                 enable_audio = 1;
+                stat_last_us = GET_RTC_US();
+                stat_idle = 0;
                 break;
             case QSPI_PACKET_TYPE_AUDIO_DISABLE_CMD:
                 PR_INFO("disable audio");
@@ -409,6 +499,13 @@ int main(void)
                 enable_sleep = 0;
                 MXC_TMR_Start(MAX78000_VIDEO_SLEEP_DEFER_TMR);
                 break;
+            case QSPI_PACKET_TYPE_AUDIO_TIME_SYNC_CMD:
+                time_sync.device_rx_us = qspi_slave_get_rx_header_time();
+                qspi_slave_set_rx_state(QSPI_STATE_IDLE);
+                time_sync.device_tx_us = GET_RTC_US();
+                qspi_slave_send_packet((uint8_t *) &time_sync, sizeof(time_sync),
+                        QSPI_PACKET_TYPE_AUDIO_TIME_SYNC_RES);
+                break;
             default:
                 PR_ERROR("Invalid packet %d", qspi_rx_header.info.packet_type);
                 break;
@@ -434,12 +531,33 @@ int main(void)
         }
 
         /* Read from Mic driver to get CHUNK worth of samples, otherwise next sample*/
+        chunk_cycles = timing_cycles();
         if (MicReadChunk(pChunkBuff, &avg) == 0) {
+            /* polls are shorter than the RTC resolution, the whole wait for a chunk is measured */
+            if (!stat_idle) {
+                stat_idle = 1;
+                stat_idle_start_us = GET_RTC_US();
+            }
             continue;
         }
+        timing_record(TIMING_STAGE_PREPROCESS, chunk_cycles);
+        chunk_time = GET_RTC_US();
+
+        /* accumulate per chunk so that the disabled periods are left out */
+        if (stat_idle) {
+            stat_idle = 0;
+            stat_idle_us += chunk_time - stat_idle_start_us;
+        }
+        stat_total_us += chunk_time - stat_last_us;
+        stat_last_us = chunk_time;
 
         sampleCounter += CHUNK;
 
+#ifdef ENABLE_CONTINUOUS_KWS
+        kws_continuous(pChunkBuff);
+        continue;
+#endif
+
 #ifdef ENABLE_SILENCE_DETECTION       // disable to start collecting data immediately.
 
         /* copy the preamble data*/
@@ -529,6 +647,9 @@ int main(void)
              */
             if (avgSilenceCounter > SILENCE_COUNTER_THRESHOLD)
             {
+                /* word actually ended silence chunks ago */
+                silenceSamples = avgSilenceCounter * CHUNK;
+
                 memset(pChunkBuff,0,CHUNK);
                 PR_DEBUG("%.6d: Word ends, Appends %d zeros", sampleCounter,
                         SAMPLE_SIZE - ai85Counter);
@@ -566,49 +687,9 @@ int main(void)
                 //----------------------------------  : invoke AI85 CNN
                 PR_DEBUG("%.6d: Starts CNN: %d", sampleCounter, wordCounter);
 
-                /* load to CNN */
-                if (!cnn_load_data(pAI85Buffer)) {
-                    PR_ERROR("ERROR: Loading data to CNN!");
-                    fail();
-                }
-
-                /* Start CNN */
-                if (!cnn_start()) {
-                    PR_ERROR("ERROR: Starting CNN!");
-                    fail();
-                }
-
-                /* Wait for CNN  to complete */
-                while (cnn_time == 0) {
-                    __WFI();
-                }
-
-                /* read data */
-                cnn_unload((uint32_t *)ml_data);
-
-                /* Get time */
-                MXC_TMR_GetTime(MXC_TMR0, cnn_time, (uint32_t*) &cnn_time, &units);
+                run_cnn();
                 PR_DEBUG("%.6d: Completes CNN: %d", sampleCounter, wordCounter);
 
-                switch (units) {
-                case TMR_UNIT_NANOSEC:
-                    cnn_time /= 1000;
-                    break;
-                case TMR_UNIT_MILLISEC:
-                    cnn_time *= 1000;
-                    break;
-                case TMR_UNIT_SEC:
-                    cnn_time *= 1000000;
-                    break;
-                default:
-                    break;
-                }
-                PR_DEBUG("CNN Time: %d us", cnn_time);
-
-                /* run softmax */
-                softmax_q17p14_q15((const q31_t*) ml_data, NUM_OUTPUTS,
-                        ml_softmax);
-
 #ifdef ENABLE_CLASSIFICATION_DISPLAY
                 PR_INFO("Classification results:");
                 for (int i = 0; i < NUM_OUTPUTS; i++) {
@@ -637,13 +718,18 @@ int main(void)
 
                 memcpy(classification_result.result, keywords[out_class], sizeof(classification_result.result));
                 classification_result.probability = probability;
+                /* word actually ended silence chunks before the last one */
+                classification_result.capture_timestamp_us = chunk_time -
+                        (uint32_t)((uint64_t) silenceSamples * 1000000 / SAMPLE_RATE);
 
+                cycles = timing_cycles();
                 qspi_slave_send_packet((uint8_t *) &classification_result, sizeof(classification_result),
                         QSPI_PACKET_TYPE_AUDIO_CLASSIFICATION_RES);
+                timing_record(TIMING_STAGE_COMMUNICATION, cycles);
 
-                max78000_statistics.cnn_duration_us = cnn_time;
-                qspi_slave_send_packet((uint8_t *) &max78000_statistics, sizeof(max78000_statistics),
-                        QSPI_PACKET_TYPE_AUDIO_STATISTICS_RES);
+                send_statistics((GET_RTC_US() - chunk_time) +
+                        (uint32_t)((uint64_t) silenceSamples * 1000000 / SAMPLE_RATE));
+                silenceSamples = 0;
 
 #ifdef ENABLE_CLASSIFICATION_DISPLAY
                 printf("\n----------------------------------------- \n");
@@ -665,9 +751,9 @@ static void I2SInit()
 
     PR_INFO("*** I2S & Mic Init ***");
     /* Initialize High Pass Filter */
-    HPF_init();
-    /* Initialize I2S RX buffer */
-    memset(i2s_rx_buffer, 0, sizeof(i2s_rx_buffer));
+    mic_hpf_init(&hpf);
+    /* Initialize I2S RX buffers */
+    memset(i2s_dma_buffer, 0, sizeof(i2s_dma_buffer));
     /* Configure I2S interface parameters */
     req.wordSize    = MXC_I2S_DATASIZE_WORD;
     req.sampleSize  = MXC_I2S_SAMPLESIZE_THIRTYTWO;
@@ -682,8 +768,8 @@ static void I2SInit()
     req.clkdiv      = 5;
     req.rawData     = NULL;
     req.txData      = NULL;
-    req.rxData      = i2s_rx_buffer;
-    req.length      = I2S_RX_BUFFER_SIZE;
+    req.rxData      = i2s_dma_buffer[0];
+    req.length      = CHUNK;
 
 
     if((err = MXC_I2S_Init(&req)) != E_NO_ERROR) {
@@ -691,12 +777,41 @@ static void I2SInit()
         fail();
     }
 
-    /* Set I2S RX FIFO threshold to generate interrupt */
+    /* DMA fills one buffer while the other one is processed. First block covers
+     * the remainder of the discarded samples, then each block is one CHUNK */
+    i2s_dma_size[0] = MIC_DISCARD_FIRST_BLOCK;
+    i2s_dma_size[1] = CHUNK;
+    i2s_dma_active_buffer = 0;
+    i2s_dma_ready = 0;
+
+    // Clear DMA int flags
+    MXC_DMA->ch[i2s_ch].status = MXC_DMA->ch[i2s_ch].status;
+
+    // Enable DST increment, set request, set source and destination width, Count-To-Zero int enable
+    MXC_DMA->ch[i2s_ch].ctrl = (MXC_F_DMA_CTRL_DSTINC |
+                                MXC_S_DMA_CTRL_REQUEST_I2SRX |
+                                MXC_S_DMA_CTRL_SRCWD_WORD |
+                                MXC_S_DMA_CTRL_DSTWD_WORD |
+                                MXC_F_DMA_CTRL_CTZ_IE);
+
+    // Set DMA source, destination, counter and reload registers for the second buffer
+    MXC_DMA->ch[i2s_ch].src = 0;
+    MXC_DMA->ch[i2s_ch].dst = (unsigned int) i2s_dma_buffer[0];
+    MXC_DMA->ch[i2s_ch].cnt = i2s_dma_size[0] * sizeof(int32_t);
+    MXC_DMA->ch[i2s_ch].srcrld = 0;
+    MXC_DMA->ch[i2s_ch].dstrld = (unsigned int) i2s_dma_buffer[1];
+    MXC_DMA->ch[i2s_ch].cntrld = i2s_dma_size[1] * sizeof(int32_t);
+
+    // Enable DMA int
+    MXC_DMA->inten |= (1 << i2s_ch);
+    NVIC_EnableIRQ(MAX78000_AUDIO_I2S_DMA_IRQ);
+
+    // Enable DMA
+    MXC_DMA->ch[i2s_ch].ctrl |= (MXC_F_DMA_CTRL_EN | MXC_F_DMA_CTRL_RLDEN);
+
+    /* Set I2S RX FIFO threshold to generate DMA request */
     MXC_I2S_SetRXThreshold(4);
-    MXC_NVIC_SetVector(I2S_IRQn, i2s_isr);
-    NVIC_EnableIRQ(I2S_IRQn);
-    /* Enable RX FIFO Threshold Interrupt */
-    MXC_I2S_EnableInt(MXC_F_I2S_INTEN_RX_THD_CH0);
+    MXC_I2S->dmach0 |= MXC_F_I2S_DMACH0_DMA_RX_EN;
     MXC_I2S_RXEnable();
     __enable_irq();
 }
@@ -742,224 +857,246 @@ static uint8_t check_inference(q15_t *ml_soft, int32_t *ml_data,
     }
 }
 
-static uint8_t cnn_load_data(uint8_t* pIn)
+static void run_cnn(void)
 {
-    uint32_t mem;
-    uint16_t index = 0;
-
-    /* data should already be formatted correctly */
-    /* pIn is 16KB, each 1KB belongs to a memory group */
-    for (mem = 0x50400000; mem <= 0x50418000; mem += 0x8000) {
-        memcpy((uint8_t*)mem, &pIn[index], 1024);
-        //printf("%.10X \n",(uint8_t *)mem);
-        index += 1024;
+    mxc_tmr_unit_t units;
+    uint32_t cycles;
+    uint32_t cnn_us;
+    /* load and inference sleep until their interrupt, DWT stops meanwhile */
+    uint32_t start_us = GET_RTC_US();
+
+    /* load to CNN */
+    if (!cnn_load_data(pAI85Buffer)) {
+        PR_ERROR("ERROR: Loading data to CNN!");
+        fail();
     }
 
-    for (mem = 0x50800000; mem <= 0x50818000; mem += 0x8000) {
-        memcpy((uint8_t*)mem, &pIn[index], 1024);
-        index += 1024;
+    /* Start CNN */
+    if (!cnn_start()) {
+        PR_ERROR("ERROR: Starting CNN!");
+        fail();
     }
 
-    for (mem = 0x50C00000; mem <= 0x50C18000; mem += 0x8000) {
-        memcpy((uint8_t*)mem, &pIn[index], 1024);
-        index += 1024;
+    /* Wait for CNN  to complete */
+    while (cnn_time == 0) {
+        __WFI();
     }
-
-    for (mem = 0x51000000; mem <= 0x51018000; mem += 0x8000) {
-        memcpy((uint8_t*)mem, &pIn[index], 1024);
-        index += 1024;
+    cnn_us = GET_RTC_US() - start_us;
+    timing_record_us(TIMING_STAGE_CNN, cnn_us);
+    stat_cnn_us += cnn_us;
+    cycles = timing_cycles();
+
+    /* read data */
+    cnn_unload((uint32_t *)ml_data);
+    cycles = timing_record(TIMING_STAGE_UNLOAD, cycles);
+
+    /* Get time */
+    MXC_TMR_GetTime(MXC_TMR0, cnn_time, (uint32_t*) &cnn_time, &units);
+
+    switch (units) {
+    case TMR_UNIT_NANOSEC:
+        cnn_time /= 1000;
+        break;
+    case TMR_UNIT_MILLISEC:
+        cnn_time *= 1000;
+        break;
+    case TMR_UNIT_SEC:
+        cnn_time *= 1000000;
+        break;
+    default:
+        break;
     }
+    PR_DEBUG("CNN Time: %d us", cnn_time);
 
-    return CNN_OK;
-}
+    max78000_statistics.cnn_duration_us = cnn_time;
 
-static uint8_t AddTranspose(uint8_t *pIn, uint8_t *pOut, uint16_t inSize,
-        uint16_t outSize, uint16_t width) {
-    /* Data order in Ai85 memory (transpose is included):
-	input(series of 8 bit samples): (0,0) ...  (0,127)  (1,0) ... (1,127) ...... (127,0)...(127,127)    16384 samples
-	output (32bit word): 16K samples in a buffer. Later, each 1K goes to a separate CNN memory group
-	0x0000:
-		(0,3)(0,2)(0,1)(0,0)
-		(0,67)(0,66)(0,65)(0,64)
-		(1,3)(1,2)(1,1)(1,0)
-		(1,67)(1,66)(1,65)(1,64)
-		....
-		(127,67)(127,66)(127,65)(127,64)
-	0x0400:
-		(0,7)(0,6)(0,5)(0,4)
-		(0,71)(0,70)(0,69)(0,68)
-		....
-		(127,71)(127,70)(127,69)(127,68)
-	...
-	0x3C00:
-		(0,63)(0,62)(0,61)(0,60)
-		(0,127)(0,126)(0,125)(0,124)
-		....
-		(127,127)(127,126)(127,125)(127,124)
-     */
-
-    static uint16_t row = 0, col = 0, total = 0;
-    uint16_t  secondHalf = 0, wordRow = 0, byteInWord = 0, group = 0, index = 0;
-    for (int i = 0; i < inSize; i++) {
-        /* is it above 63? */
-        if (col >= (width >> 1)) {
-            secondHalf = 1; // odd word rows
-        } else {
-            secondHalf = 0; // even word rows
-        }
-
-        /* which group (0-15) it should be */
-        group = (col % (width >> 1)) / 4;
-
-        /* which word row (0-255) within the group */
-        wordRow = secondHalf + (row << 1);
-
-        /* which byte (0-3) in the word */
-        byteInWord = col % 4;
+    /* run softmax */
+    cycles = timing_cycles();
+    softmax_q17p14_q15((const q31_t*) ml_data, NUM_OUTPUTS,
+            ml_softmax);
+    timing_record(TIMING_STAGE_POSTPROCESS, cycles);
+}
 
-        /* find output index */
-        index = 1024 * group + 4 * wordRow + byteInWord;
+static void send_statistics(uint32_t latency_us)
+{
+    stage_timing_t stage_timing[TIMING_STAGE_LAST];
+    uint32_t now_us = GET_RTC_US();
+
+    /* close the window now, CNN time of the current chunk is already counted */
+    stat_total_us += now_us - stat_last_us;
+    stat_last_us = now_us;
+
+    /* busy is everything but the wait for microphone chunks, sleeping on CNN included */
+    max78000_statistics.latency_us = latency_us;
+    if (stat_total_us) {
+        max78000_statistics.cpu_duty_permille = (uint32_t)(((stat_total_us - MIN(stat_idle_us, stat_total_us)) * 1000) / stat_total_us);
+        max78000_statistics.cnn_duty_permille = (uint32_t)((MIN(stat_cnn_us, stat_total_us) * 1000) / stat_total_us);
+    }
 
-        /* place sample in correct output location */
-        pOut[index] = pIn[i];
+    timing_get(stage_timing);
 
-        total++;
+    PR_DEBUG("latency %d us, cpu %d, cnn %d permille", max78000_statistics.latency_us,
+            max78000_statistics.cpu_duty_permille, max78000_statistics.cnn_duty_permille);
 
-        /* increment row and col index */
-        col++;
-        if (col >= width) {
-            col = 0;
-            row++;
-        }
-    }
+    qspi_slave_send_packet((uint8_t *) &max78000_statistics, sizeof(max78000_statistics),
+            QSPI_PACKET_TYPE_AUDIO_STATISTICS_RES);
+    qspi_slave_send_packet((uint8_t *) stage_timing, sizeof(stage_timing),
+            QSPI_PACKET_TYPE_AUDIO_TIMING_RES);
 
-    if (total >= outSize) {
-        /* sanity check */
-        if (row != width) {
-            PR_ERROR("ERROR: Rearranging!");
-        }
-
-        total = 0;
-        row = 0;
-        col = 0;
-        return 1;
-    } else {
-        return 0;
-    }
+    stat_total_us = 0;
+    stat_idle_us = 0;
+    stat_cnn_us = 0;
 }
 
-static uint8_t MicReadChunk(uint8_t *pBuff, uint16_t * avg)
+#ifdef ENABLE_CONTINUOUS_KWS
+static void kws_continuous(uint8_t* pChunk)
 {
-    static uint16_t chunkCount = 0;
-    static uint16_t sum = 0;
+    static uint16_t circCounter = 0;
+    static uint16_t fillCounter = 0;
+    static uint16_t hopCounter = 0;
+    static uint16_t statisticsCounter = 0;
 
-    static uint32_t index = 0;
-
-    int32_t sample = 0;
-    int16_t temp = 0;
-    uint32_t rx_size = 0;
+    classification_result_t classification_result = {0};
+    int16_t out_class;
+    uint32_t cycles;
+    uint8_t ret;
+    double probability;
+
+    /* add the new chunk to the end of circular buffer */
+    memcpy(&pKwsCircBuffer[circCounter], pChunk, CHUNK);
+    circCounter = (circCounter + CHUNK) % SAMPLE_SIZE;
+
+    /* wait until window is filled and a hop is passed */
+    if (fillCounter < SAMPLE_SIZE) {
+        fillCounter += CHUNK;
+        return;
+    }
 
-    /* sample not ready */
-    if (!i2s_flag) {
-        *avg = 0;
-        return 0;
+    if (++hopCounter < KWS_HOP_CHUNKS) {
+        return;
     }
+    hopCounter = 0;
 
-    /* Clear flag */
-    i2s_flag = 0;
-    /* Read number of samples in I2S RX FIFO */
-    rx_size = MXC_I2S->dmach0 >> MXC_F_I2S_DMACH0_RX_LVL_POS;
-    //	printf("%d ", rx_size);
+    GPIO_SET(gpio_green);
 
-    /* read until fifo is empty or enough samples are collected */
-    while ((rx_size--) && (chunkCount < CHUNK)) {
-        /* Read microphone sample from I2S FIFO */
-        sample = (int32_t)MXC_I2S->fifoch0;
-        /* The actual value is 18 MSB of 32-bit word */
-        temp = sample >> 14;
+    /* reorder circular buffer according to time, oldest samples first */
+    ret = AddTranspose(&pKwsCircBuffer[circCounter], pAI85Buffer, SAMPLE_SIZE - circCounter,
+            SAMPLE_SIZE, TRANSPOSE_WIDTH);
+    if (circCounter) {
+        ret = AddTranspose(&pKwsCircBuffer[0], pAI85Buffer, circCounter, SAMPLE_SIZE,
+                TRANSPOSE_WIDTH);
+    }
+    if (ret != 1) {
+        PR_ERROR("ERROR: Transpose incomplete!");
+        fail();
+    }
 
-        /* Remove DC from microphone signal */
-        sample = HPF((int16_t)temp); // filter needs about 1K sample to converge
+    run_cnn();
 
-        /* Discard first 10k samples due to microphone charging cap effect */
-        if (index++ < 10000)
-            continue;
+    /* smoothed posteriors, a keyword is reported once per utterance */
+    if (kws_decision_update(&kws_decision, ml_softmax, &out_class, &probability) >= 0) {
+        PR_INFO("Detected: %s (%0.1f%%)", keywords[out_class], probability);
 
-        /* absolute for averaging */
-        if (sample >= 0)
-            sum += sample;
-        else
-            sum -= sample;
+        classification_result.classification = CLASSIFICATION_DETECTED;
+        memcpy(classification_result.result, keywords[out_class], sizeof(classification_result.result));
+        classification_result.probability = probability;
+        classification_result.capture_timestamp_us = chunk_time;
 
-        /* Convert to 8 bit unsigned */
-        pBuff[chunkCount] = (uint8_t)((sample)*SAMPLE_SCALE_FACTOR/256);
+        cycles = timing_cycles();
+        qspi_slave_send_packet((uint8_t *) &classification_result, sizeof(classification_result),
+                QSPI_PACKET_TYPE_AUDIO_CLASSIFICATION_RES);
+        timing_record(TIMING_STAGE_COMMUNICATION, cycles);
+    }
 
-        temp=(int8_t)pBuff[chunkCount];
+    if (++statisticsCounter >= KWS_STATISTICS_HOPS) {
+        statisticsCounter = 0;
+        send_statistics(GET_RTC_US() - chunk_time);
+    }
 
-        chunkCount++;
+    GPIO_CLR(gpio_green);
+}
+#endif
 
-        /* record max and min */
-        if (temp > Max) {
-            Max = temp;
-        }
+static uint8_t cnn_load_data(uint8_t* pIn)
+{
+    static cnn_loader_desc_t desc[SAMPLE_SIZE / 1024];
+    uint32_t quadrant, mem;
+    uint16_t index = 0;
 
-        if (temp < Min) {
-            Min = temp;
+    /* data should already be formatted correctly */
+    /* pIn is 16KB, each 1KB belongs to a memory group, 4 groups in each quadrant */
+    for (quadrant = 0x50400000; quadrant <= 0x51000000; quadrant += 0x400000) {
+        for (mem = quadrant; mem <= quadrant + 0x18000; mem += 0x8000) {
+            desc[index].dst = mem;
+            desc[index].src = &pIn[1024 * index];
+            desc[index].size = 1024;
+            index++;
         }
-
     }
 
-    /* if not enough samples, return 0 */
-    if (chunkCount < CHUNK) {
-        *avg = 0;
-        return 0;
+    /* DMA copies all groups, sleep until it is done */
+    if (cnn_loader_start(desc, index) != E_NO_ERROR) {
+        return CNN_FAIL;
     }
+    cnn_loader_wait();
 
-    /* enough samples are collected, calculate average and return 1 */
-    *avg = ((uint16_t)(sum / CHUNK));
-
-    chunkCount = 0;
-    sum = 0;
-    return 1;
+    return CNN_OK;
 }
 
-static void HPF_init(void) {
-    Coeff = 32604; //0.995
-    x0 = 0;
-    y0 = 0;
-    y1 = y0;
-    x1 = x0;
-}
+static uint8_t AddTranspose(uint8_t *pIn, uint8_t *pOut, uint16_t inSize,
+        uint16_t outSize, uint16_t width) {
+    static uint16_t row = 0;
+    int ret;
 
-static int16_t HPF(int16_t input) {
-    int16_t Acc, output;
-    int32_t tmp;
+    ret = mic_transpose(&row, pIn, pOut, inSize, outSize, width);
+    if (ret == MIC_TRANSPOSE_ERROR) {
+        PR_ERROR("ERROR: Rearranging!");
+        return 0;
+    }
 
-    /* a 1st order IIR high pass filter (100 Hz cutoff frequency)  */
-    /* y(n)=x(n)-x(n-1)+A*y(n-1) and A =.995*2^15 */
+    return ret;
+}
 
-    x0 = input;
+static uint8_t MicReadChunk(uint8_t *pBuff, uint16_t * avg)
+{
+    static uint32_t index = 0;
+    static uint32_t overrun = 0;
 
-    tmp = (Coeff * y1);
-    Acc = (int16_t)((tmp + (1 << 14)) >> 15);
-    y0 = x0 - x1 + Acc;
+    int16_t hpf_block[CHUNK];
+    uint8_t buffer;
+    uint16_t size;
 
-    /* Clipping */
-    if (y0 > 32767) {
-        y0 = 32767;
+    /* block not ready */
+    if (!i2s_dma_ready) {
+        *avg = 0;
+        return 0;
     }
 
-    if (y0 < -32768) {
-        y0 = -32768;
+    __disable_irq();
+    buffer = i2s_dma_ready_buffer;
+    size = i2s_dma_ready_size;
+    i2s_dma_ready = 0;
+    __enable_irq();
+
+    if (overrun != i2s_dma_overrun) {
+        overrun = i2s_dma_overrun;
+        PR_DEBUG("i2s dma overrun %d", overrun);
     }
 
-    /* Update filter state */
-    y1 = y0;
-    x1 = x0;
+    /* Remove DC from microphone signal */
+    mic_hpf(&hpf, i2s_dma_buffer[buffer], hpf_block, size); // filter needs about 1K sample to converge
 
-    output = (int16_t)y0;
+    /* Discard first samples due to microphone charging cap effect */
+    if (index < MIC_DISCARD_SAMPLES) {
+        index += size;
+        *avg = 0;
+        return 0;
+    }
+
+    /* Convert to 8 bit unsigned, record max and min, calculate average and return 1 */
+    *avg = mic_chunk(hpf_block, pBuff, CHUNK, SAMPLE_SCALE_FACTOR, &Max, &Min);
 
-    return (output);
+    return 1;
 }
 
 static void fail(void)
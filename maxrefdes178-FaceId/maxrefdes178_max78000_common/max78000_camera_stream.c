@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2023 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <camera.h>
+#include <mxc.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "max78000_camera_stream.h"
+#include "max78000_debug.h"
+#include "maxrefdes178_definitions.h"
+#include "maxrefdes178_timing.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define S_MODULE_NAME   "camera_stream"
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static uint32_t overflow_count = 0;
+static int capture_started = 0;
+static uint32_t capture_start_cycles = 0;
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+int camera_stream_frame(const camera_stream_config_t *config)
+{
+    uint8_t *data;
+    uint32_t cnn_next_row = config->cnn_y;
+    uint32_t cnn_end_row = config->cnn_y + config->cnn_height;
+    uint32_t cnn_x_offset = config->cnn_x * LCD_BYTE_PER_PIXEL;
+    uint32_t preprocess_cycles = 0;
+    uint32_t timeout_cycles = MAX78000_VIDEO_CAMERA_FRAME_TIMEOUT * (SystemCoreClock / 1000);
+    uint32_t start_cycles;
+    stream_stat_t *stat;
+    int ret = E_NO_ERROR;
+
+    // Capture may already be running, restarted while the previous frame was post-processed
+    camera_stream_start();
+
+    for (uint32_t row = 0; row < config->row_count; row++) {
+        // Wait until camera streaming buffer is full
+        while ((data = get_camera_stream_buffer()) == NULL) {
+            if (camera_is_image_rcv()) {
+                // Last row may complete together with the frame
+                data = get_camera_stream_buffer();
+                break;
+            }
+            if ((timing_cycles() - capture_start_cycles) > timeout_cycles) {
+                PR_ERROR("camera timeout at row %d", row);
+                camera_stream_stop();
+                break;
+            }
+        }
+
+        if (data == NULL) {
+            // Frame ended, or camera stopped, before all rows are received
+            ret = E_TIME_OUT;
+            break;
+        }
+
+        if (config->frame) {
+            // Copy and release stream buffer first, then feed CNN from the copy
+            memcpy(&config->frame[row * config->row_size], data, config->row_size);
+            release_camera_stream_buffer();
+            data = &config->frame[row * config->row_size];
+        }
+
+        if (config->cnn_row && (row == cnn_next_row) && (row < cnn_end_row)) {
+            start_cycles = timing_cycles();
+            config->cnn_row(data + cnn_x_offset);
+            preprocess_cycles += timing_cycles() - start_cycles;
+            cnn_next_row += config->cnn_step;
+        }
+
+        if (!config->frame) {
+            release_camera_stream_buffer();
+        }
+    }
+
+    capture_started = 0;
+
+    if (config->cnn_row) {
+        timing_record_us(TIMING_STAGE_PREPROCESS, timing_cycles_to_us(preprocess_cycles));
+    }
+
+    stat = get_camera_stream_statistic();
+    if (stat->overflow_count > 0) {
+        PR_DEBUG("overflow %d", stat->overflow_count);
+        overflow_count += stat->overflow_count;
+        if (ret == E_NO_ERROR) {
+            ret = E_OVERFLOW;
+        }
+    }
+
+    return ret;
+}
+
+void camera_stream_start(void)
+{
+    if (capture_started) {
+        return;
+    }
+
+    camera_start_capture_image();
+    capture_start_cycles = timing_cycles();
+    capture_started = 1;
+}
+
+void camera_stream_stop(void)
+{
+    MXC_PCIF_Stop();
+    capture_started = 0;
+}
+
+uint32_t camera_stream_get_overflow_count(void)
+{
+    uint32_t count = overflow_count;
+
+    overflow_count = 0;
+
+    return count;
+}
@@ -65,6 +65,8 @@ int qspi_slave_send_packet(uint8_t *data, uint32_t data_size, uint8_t packet_typ
 void qspi_slave_set_rx_state(qspi_state_e rx_state);
 qspi_state_e qspi_slave_get_rx_state(void);
 qspi_packet_header_t qspi_slave_get_rx_header(void);
+// RTC time in us when the last rx header was received
+uint32_t qspi_slave_get_rx_header_time(void);
 int qspi_slave_set_rx_data(uint8_t *data, uint32_t data_size);
 int qspi_slave_wait_rx(void);
 int qspi_slave_trigger(void);
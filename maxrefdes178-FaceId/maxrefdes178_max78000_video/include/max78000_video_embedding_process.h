@@ -49,6 +49,8 @@
 #define thresh_for_unknown_subject 9993
 //#define thresh_for_unknown_subject 313600
 #define closest_sub_buffer_size 3*7  // TODO ????
+// Subjects rescored exactly after the centroid prefilter
+#define FACEID_PREFILTER_CANDIDATES 8
 
 
 //-----------------------------------------------------------------------------
@@ -51,6 +51,7 @@
 #include "max78000_debug.h"
 #include "max78000_video_embedding_process.h"
 #include "maxrefdes178_definitions.h"
+#include "maxrefdes178_utility.h"
 
 
 //-----------------------------------------------------------------------------
@@ -58,6 +59,14 @@
 //-----------------------------------------------------------------------------
 #define S_MODULE_NAME   "embed"
 
+#define FACEID_INDEX_MAGIC      0x49444946  // "FIDI"
+#define FACEID_INDEX_VERSION    1
+#define FACEID_INDEX_ALIGN      16  // flash write granularity
+#define FACEID_CENTROID_CHUNK   64  // centroid dimensions accumulated per pass
+#define FACEID_L1_BLOCK         64  // bytes compared between early abandon checks
+
+#define MAX_DISTANCE 1000000
+
 
 //-----------------------------------------------------------------------------
 // Typedefs
@@ -72,10 +81,15 @@ typedef struct  __attribute__((packed)) {
 
 }tsFaceIDFile;
 
-typedef struct  __attribute__((packed)) sDistance {
-        uint8_t subID;
-        int32_t distance;
-}tsDistance;
+// Naturally aligned, written to flash from an aligned stack copy
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t databaseCrc16;
+    uint32_t databaseSize;
+    uint8_t numberOfCentroids;
+    uint8_t reserved[3];
+}tsFaceIDIndex;
 
 
 //-----------------------------------------------------------------------------
@@ -84,19 +98,30 @@ typedef struct  __attribute__((packed)) sDistance {
 extern uint32_t _embeddings_start_, _embeddings_end_;
 static const uint8_t *embeddings = (uint8_t *) &_embeddings_start_;
 
-static tsMeanDistance gMeanDistance[FACEID_MAX_SUBJECT];
+static tsMeanDistance gMeanDistance[FACEID_PREFILTER_CANDIDATES];
+static tsMinDistance gCandidates[FACEID_PREFILTER_CANDIDATES];
 static tsMinDistance gMinDistance[sizeof(tsMinDistance) * 3];
-static int8_t gClosestSubId[closest_sub_buffer_size];
-static uint8_t gMinDistanceCounter[FACEID_MAX_SUBJECT];
-static tsDistance gDistance[FACEID_MAX_SUBJECT * FACEID_MAX_PHOTO_PER_SUBJECT];
+static int16_t gClosestSubId[closest_sub_buffer_size];
+static uint8_t gMinDistanceCounter[UINT8_MAX + 1];
 
 static tsFaceIDFile *pDatabaseInfo = NULL;
+static const tsFaceIDIndex *pIndex = NULL;
 static uint32_t gClosestSubIdBufIdx = 0;
 
 
 //-----------------------------------------------------------------------------
 // Local function declarations
 //-----------------------------------------------------------------------------
+static uint32_t get_database_size(void);
+static const int8_t *get_embeddings_data(void);
+static const int8_t *get_centroids(void);
+static int is_index_valid(void);
+static int build_index(void);
+static void flash_begin(void);
+static void flash_end(void);
+static int32_t l1_distance(const int8_t *a, const int8_t *b, int len, int32_t limit);
+static void insert_min_distance(uint8_t subID, int32_t distance);
+static int select_candidates(const int8_t *embedding);
 
 
 //-----------------------------------------------------------------------------
@@ -117,19 +142,34 @@ static uint32_t gClosestSubIdBufIdx = 0;
  *  (W*H*3)*N bytes: image
  *
  *  embeddings maximum sizes:
- *  1         1 byte : number of subjects (S)        6
+ *  1         1 byte : number of subjects (S)        16 (FACEID_MAX_SUBJECT)
  *  2-3       2 bytes: length of embeddings (L)      512
- *  4-5       2 bytes: number of embeddings (N)      6*8=48
+ *  4-5       2 bytes: number of embeddings (N)      16*8=128
  *  6-7       2 bytes: length of image width (W)     120
  *  8-9       2 bytes: length of image height (H)    160
- *  10-11     2 bytes: length of subject names (K)   (15+1)*6 + 1 = 97
- *  12-108    K=97 bytes: subject names
- *  109-24732 (L+1)*N=24624 bytes: embeddings
+ *  10-11     2 bytes: length of subject names (K)   (15+1)*16 + 1 = 257
+ *  12-268    K=257 bytes: subject names
+ *  269-65932 (L+1)*N=65664 bytes: embeddings
+ *
+ *  centroid index, 16 byte aligned after the db in the same flash region:
+ *  16 bytes: tsFaceIDIndex header (magic, version, db crc16, db size, S)
+ *  S*L bytes: per subject mean embedding
+ *
+ *  The index is rebuilt whenever its header does not match the db, so the
+ *  db format sent by the host is unchanged. Db and index must fit
+ *  FACEID_EMBEDDINGS_FLASH_SIZE, 74144 bytes at the maximum sizes above.
  */
 
 int init_database(void)
 {
 	pDatabaseInfo = (tsFaceIDFile *)embeddings;
+    pIndex = NULL;
+
+    if (get_database_size() > ((&_embeddings_end_ - &_embeddings_start_) * 4)) {
+        PR_ERROR("invalid db size %d", get_database_size());
+        pDatabaseInfo = NULL;
+        return E_BAD_STATE;
+    }
 
     for(int i=0; i<closest_sub_buffer_size; ++i){
         gClosestSubId[i] = -1;
@@ -139,12 +179,26 @@ int init_database(void)
         gMinDistanceCounter[i] = 0;
     }
 
+    if (!is_index_valid() && (build_index() != E_NO_ERROR)) {
+        // Without centroids every subject has to be rescored each frame
+        if (pDatabaseInfo->numberOfSubjects > FACEID_PREFILTER_CANDIDATES) {
+            PR_ERROR("index required for %d subjects", pDatabaseInfo->numberOfSubjects);
+            pDatabaseInfo = NULL;
+            return E_BAD_STATE;
+        }
+        PR_WARN("db index not available");
+        return E_NO_ERROR;
+    }
+
+    pIndex = (const tsFaceIDIndex *)(embeddings + ((get_database_size() + FACEID_INDEX_ALIGN - 1) & ~(FACEID_INDEX_ALIGN - 1)));
+
 	return 0;
 }
 
 int uninit_database(void)
 {
     pDatabaseInfo = NULL;
+    pIndex = NULL;
     gClosestSubIdBufIdx = 0;
 
     return E_NO_ERROR;
@@ -164,15 +218,8 @@ void FLC0_IRQHandler(void)
     }
 }
 
-int update_database(uint8_t *db, uint32_t db_size)
+static void flash_begin(void)
 {
-    int ret = E_NO_ERROR;
-
-    if (db_size > ((&_embeddings_end_ - &_embeddings_start_) * 4)) {
-        PR_ERROR("db_size too big %d > %d", db_size, ((&_embeddings_end_ - &_embeddings_start_) * 4));
-        return E_BAD_PARAM;
-    }
-
     // Set flash clock divider to generate a 1MHz clock from the APB clock
     // APB clock is 54MHz on the real silicon
     MXC_FLC0->clkdiv = 24;
@@ -185,7 +232,25 @@ int update_database(uint8_t *db, uint32_t db_size)
     MXC_FLC_EnableInt(MXC_F_FLC_INTR_DONEIE | MXC_F_FLC_INTR_AFIE);
 
     MXC_ICC_Disable(MXC_ICC0);
+}
+
+static void flash_end(void)
+{
+    MXC_ICC_Enable(MXC_ICC0);
+}
+
+int update_database(uint8_t *db, uint32_t db_size)
+{
+    int ret = E_NO_ERROR;
 
+    if (db_size > ((&_embeddings_end_ - &_embeddings_start_) * 4)) {
+        PR_ERROR("db_size too big %d > %d", db_size, (int) ((&_embeddings_end_ - &_embeddings_start_) * 4));
+        return E_BAD_PARAM;
+    }
+
+    flash_begin();
+
+    // Erasing the whole region also drops the index of the previous db
     for (uint32_t page_addr = (uint32_t)&_embeddings_start_; page_addr < (uint32_t)&_embeddings_end_; page_addr += MXC_FLASH_PAGE_SIZE) {
         ret = MXC_FLC_PageErase(page_addr);
         if (ret != E_NO_ERROR) {
@@ -208,7 +273,123 @@ int update_database(uint8_t *db, uint32_t db_size)
     }
 
 bail:
-    MXC_ICC_Enable(MXC_ICC0);
+    flash_end();
+
+    return ret;
+}
+
+static uint32_t get_database_size(void)
+{
+    return sizeof(tsFaceIDFile) + pDatabaseInfo->lengthOfSubjectNames +
+           ((pDatabaseInfo->lengthOfEmbeddings + 1) * pDatabaseInfo->numberOfEmbeddings);
+}
+
+static const int8_t *get_embeddings_data(void)
+{
+    return (const int8_t *)((uint32_t)(pDatabaseInfo+1) + pDatabaseInfo->lengthOfSubjectNames);
+}
+
+static const int8_t *get_centroids(void)
+{
+    return (const int8_t *)(pIndex + 1);
+}
+
+static int is_index_valid(void)
+{
+    uint32_t db_size = get_database_size();
+    const tsFaceIDIndex *index = (const tsFaceIDIndex *)(embeddings + ((db_size + FACEID_INDEX_ALIGN - 1) & ~(FACEID_INDEX_ALIGN - 1)));
+    uint32_t index_end = (uint32_t)(index + 1) + (pDatabaseInfo->numberOfSubjects * pDatabaseInfo->lengthOfEmbeddings);
+
+    if (index_end > (uint32_t)&_embeddings_end_) {
+        return 0;
+    }
+
+    return (index->magic == FACEID_INDEX_MAGIC) &&
+           (index->version == FACEID_INDEX_VERSION) &&
+           (index->databaseSize == db_size) &&
+           (index->numberOfCentroids == pDatabaseInfo->numberOfSubjects) &&
+           (index->databaseCrc16 == crc16_sw(embeddings, db_size));
+}
+
+static int build_index(void)
+{
+    int ret = E_NO_ERROR;
+    uint32_t db_size = get_database_size();
+    uint32_t index_addr = (uint32_t)embeddings + ((db_size + FACEID_INDEX_ALIGN - 1) & ~(FACEID_INDEX_ALIGN - 1));
+    uint32_t index_end = index_addr + sizeof(tsFaceIDIndex) + (pDatabaseInfo->numberOfSubjects * pDatabaseInfo->lengthOfEmbeddings);
+    uint32_t centroid_addr = index_addr + sizeof(tsFaceIDIndex);
+    uint16_t length = pDatabaseInfo->lengthOfEmbeddings;
+    int32_t sum[FACEID_CENTROID_CHUNK];
+    int8_t centroid[FACEID_CENTROID_CHUNK] __attribute__((aligned(4)));
+    tsFaceIDIndex header __attribute__((aligned(4))) = {0};
+
+    if ((length % FACEID_CENTROID_CHUNK) || (index_end > (uint32_t)&_embeddings_end_)) {
+        PR_ERROR("no room for db index");
+        return E_NONE_AVAIL;
+    }
+
+    // Index area is erased together with the db, it can not be rewritten in place
+    for (uint32_t addr = index_addr; addr < index_end; addr += 4) {
+        if (*(uint32_t *)addr != 0xFFFFFFFF) {
+            PR_ERROR("db index area is not erased");
+            return E_BAD_STATE;
+        }
+    }
+
+    PR_INFO("building db index for %d subjects", pDatabaseInfo->numberOfSubjects);
+
+    flash_begin();
+
+    for (int subject = 0; subject < pDatabaseInfo->numberOfSubjects; subject++) {
+        for (int offset = 0; offset < length; offset += FACEID_CENTROID_CHUNK) {
+            const int8_t *pData = get_embeddings_data();
+            int count = 0;
+
+            memset(sum, 0, sizeof(sum));
+
+            for (int i = 0; i < pDatabaseInfo->numberOfEmbeddings; i++) {
+                if ((uint8_t)pData[0] == subject) {
+                    for (int j = 0; j < FACEID_CENTROID_CHUNK; j++) {
+                        sum[j] += pData[1 + offset + j];
+                    }
+                    count++;
+                }
+                pData += length + 1;
+            }
+
+            for (int j = 0; j < FACEID_CENTROID_CHUNK; j++) {
+                if (count == 0) {
+                    centroid[j] = 0;
+                } else if (sum[j] >= 0) {
+                    centroid[j] = (sum[j] + (count / 2)) / count;
+                } else {
+                    centroid[j] = (sum[j] - (count / 2)) / count;
+                }
+            }
+
+            ret = MXC_FLC_Write(centroid_addr, FACEID_CENTROID_CHUNK, (uint32_t *)centroid);
+            if (ret != E_NO_ERROR) {
+                PR_ERROR("MXC_FLC_Write failed %d", ret);
+                goto bail;
+            }
+            centroid_addr += FACEID_CENTROID_CHUNK;
+        }
+    }
+
+    // Header goes last so an interrupted build is never taken as valid
+    header.magic = FACEID_INDEX_MAGIC;
+    header.version = FACEID_INDEX_VERSION;
+    header.databaseCrc16 = crc16_sw(embeddings, db_size);
+    header.databaseSize = db_size;
+    header.numberOfCentroids = pDatabaseInfo->numberOfSubjects;
+
+    ret = MXC_FLC_Write(index_addr, sizeof(header), (uint32_t *)&header);
+    if (ret != E_NO_ERROR) {
+        PR_ERROR("MXC_FLC_Write failed %d", ret);
+    }
+
+bail:
+    flash_end();
 
     return ret;
 }
@@ -257,79 +438,158 @@ tsMinDistance *get_min_distance(){
     return gMinDistance;
 }
 
-int calculate_minDistance(const uint8_t *embedding)
+// Sum of absolute differences, returns early with a partial sum above limit once it is exceeded
+static int32_t l1_distance(const int8_t *a, const int8_t *b, int len, int32_t limit)
 {
-    int8_t *theEmbedding = (int8_t *)embedding;
-    int8_t *theEmbeddingOrigin = theEmbedding;
+    int32_t total = 0;
+    int block_end;
+    int j = 0;
+#if defined(__ARM_FEATURE_DSP)
+    uint32_t word_a, word_b;
+#endif
+
+    while (j < len) {
+        block_end = ((j + FACEID_L1_BLOCK) < len) ? (j + FACEID_L1_BLOCK) : len;
+
+#if defined(__ARM_FEATURE_DSP)
+        for (; (j + 4) <= block_end; j += 4) {
+            memcpy(&word_a, &a[j], sizeof(word_a));
+            memcpy(&word_b, &b[j], sizeof(word_b));
+            // Flipping the sign bits maps int8 to uint8 with the same differences
+            total = (int32_t) __USADA8(word_a ^ 0x80808080, word_b ^ 0x80808080, (uint32_t) total);
+        }
+#endif
+        for (; j < block_end; j++) {
+            total += abs(a[j] - b[j]);
+        }
 
-    tsDistance *dist = gDistance;
-    tsMeanDistance *meanDist = gMeanDistance;
+        if (total > limit) {
+            break;
+        }
+    }
 
-    int8_t *pData =  (int8_t *)((uint32_t)(pDatabaseInfo+1) + pDatabaseInfo->lengthOfSubjectNames);
+    return total;
+}
 
-    // Calculate min distance for each embedding
-    for (int i = 0; i < pDatabaseInfo->numberOfEmbeddings; i++) {
-        int total = 0;
-        dist->subID = (uint8_t)(*(pData++));
-        theEmbedding = theEmbeddingOrigin;
-        for (int j = 0; j < pDatabaseInfo->lengthOfEmbeddings;j++) {
-            total += abs((*(theEmbedding++))-(*(pData++)));
-        }
+static void insert_min_distance(uint8_t subID, int32_t distance)
+{
+    if (distance < gMinDistance[0].distance) {         /* Check if current element is less than firstMin, then update first, second and third */
+        gMinDistance[2].distance = gMinDistance[1].distance;
+        gMinDistance[2].subID = gMinDistance[1].subID;
+        gMinDistance[1].distance = gMinDistance[0].distance;
+        gMinDistance[1].subID = gMinDistance[0].subID;
+        gMinDistance[0].distance = distance;
+        gMinDistance[0].subID  = subID;
+    } else if (distance < gMinDistance[1].distance) {    /* Check if current element is less than secmin then update second and third */
+        gMinDistance[2].distance = gMinDistance[1].distance;
+        gMinDistance[2].subID = gMinDistance[1].subID;
+        gMinDistance[1].distance = distance;
+        gMinDistance[1].subID  = subID;
+    } else if (distance < gMinDistance[2].distance) {  /* Check if current element is less than then update third */
+        gMinDistance[2].distance = distance;
+        gMinDistance[2].subID  = subID;
+    }
+}
 
-        dist->distance = total;
-        dist++;
+// Stage 1: keep the subjects with the closest centroids, or all of them if they fit
+static int select_candidates(const int8_t *embedding)
+{
+    const int8_t *centroid;
+    int32_t distance;
+    int count = 0;
+    int i, j;
+
+    if ((pIndex == NULL) || (pDatabaseInfo->numberOfSubjects <= FACEID_PREFILTER_CANDIDATES)) {
+        for (i = 0; (i < pDatabaseInfo->numberOfSubjects) && (i < FACEID_PREFILTER_CANDIDATES); i++) {
+            gCandidates[i].subID = i;
+            gCandidates[i].distance = 0;
+        }
+        return i;
     }
 
-    dist = gDistance;
+    centroid = get_centroids();
+
+    for (i = 0; i < pDatabaseInfo->numberOfSubjects; i++) {
+        distance = l1_distance(embedding, centroid, pDatabaseInfo->lengthOfEmbeddings,
+                               (count == FACEID_PREFILTER_CANDIDATES) ? gCandidates[count - 1].distance : INT32_MAX);
+        centroid += pDatabaseInfo->lengthOfEmbeddings;
+
+        if ((count == FACEID_PREFILTER_CANDIDATES) && (distance >= gCandidates[count - 1].distance)) {
+            continue;
+        }
 
-    for (int i = 0; i < pDatabaseInfo->numberOfSubjects; i++) {
-        meanDist[i].subID = i;
-        meanDist[i].number = 0;
-        meanDist[i].distance = 0;
+        // Insertion into the list sorted by ascending distance
+        j = (count < FACEID_PREFILTER_CANDIDATES) ? count++ : (count - 1);
+        for (; (j > 0) && (gCandidates[j - 1].distance > distance); j--) {
+            gCandidates[j] = gCandidates[j - 1];
+        }
+        gCandidates[j].subID = i;
+        gCandidates[j].distance = distance;
     }
 
-    for (int i = 0; i < pDatabaseInfo->numberOfEmbeddings; i++) {
-        meanDist = gMeanDistance + dist->subID;
-        meanDist->distance += dist->distance;
-        meanDist->number++;
-        dist++;
+    return count;
+}
+
+int calculate_minDistance(const uint8_t *embedding)
+{
+    const int8_t *theEmbedding = (const int8_t *)embedding;
+    const int8_t *pData;
+    tsMeanDistance *meanDist = gMeanDistance;
+    int candidate_count;
+    int c;
+
+    if (pDatabaseInfo == NULL) {
+        return -1;
     }
 
-    meanDist = gMeanDistance;
+    pData = get_embeddings_data();
+    candidate_count = select_candidates(theEmbedding);
 
-    for (int i = 0; i < pDatabaseInfo->numberOfSubjects; i++) {
-        meanDist->distance = meanDist->distance / meanDist->number;
-        meanDist++;
+    for (c = 0; c < candidate_count; c++) {
+        meanDist[c].subID = gCandidates[c].subID;
+        meanDist[c].number = 0;
+        meanDist[c].distance = 0;
     }
 
-    meanDist = gMeanDistance;
+    // Count embeddings of each candidate subject
+    for (int i = 0; i < pDatabaseInfo->numberOfEmbeddings; i++) {
+        for (c = 0; (c < candidate_count) && (meanDist[c].subID != (uint8_t)pData[0]); c++);
+
+        if (c < candidate_count) {
+            meanDist[c].number++;
+        }
 
-#define MAX_DISTANCE 1000000
+        pData += pDatabaseInfo->lengthOfEmbeddings + 1;
+    }
 
     for (int i = 0; i < 3; i++) {
         gMinDistance[i].subID = 0xFF;
         gMinDistance[i].distance = MAX_DISTANCE;
     }
 
-    for (int i = 0; i < pDatabaseInfo->numberOfSubjects; i++)
-    {
-        if (meanDist[i].distance < gMinDistance[0].distance) {         /* Check if current element is less than firstMin, then update first, second and third */
-            gMinDistance[2].distance = gMinDistance[1].distance;
-            gMinDistance[2].subID = gMinDistance[1].subID;
-            gMinDistance[1].distance = gMinDistance[0].distance;
-            gMinDistance[1].subID = gMinDistance[0].subID;
-            gMinDistance[0].distance = meanDist[i].distance;
-            gMinDistance[0].subID  = meanDist[i].subID;
-        } else if (meanDist[i].distance < gMinDistance[1].distance) {    /* Check if current element is less than secmin then update second and third */
-            gMinDistance[2].distance = gMinDistance[1].distance;
-            gMinDistance[2].subID = gMinDistance[1].subID;
-            gMinDistance[1].distance = meanDist[i].distance;
-            gMinDistance[1].subID  = meanDist[i].subID;
-        } else if (meanDist[i].distance < gMinDistance[2].distance) {  /* Check if current element is less than then update third */
-            gMinDistance[2].distance = meanDist[i].distance;
-            gMinDistance[2].subID  = meanDist[i].subID;
+    // Stage 2: exact mean distance of the candidates, closest centroid first. A subject whose
+    // distance sum reaches third best mean * number of embeddings can not enter the top 3
+    for (c = 0; c < candidate_count; c++) {
+        int32_t limit = gMinDistance[2].distance * meanDist[c].number;
+
+        if (meanDist[c].number == 0) {
+            continue;
+        }
+
+        pData = get_embeddings_data();
+        for (int i = 0; (i < pDatabaseInfo->numberOfEmbeddings) && (meanDist[c].distance < limit); i++) {
+            if ((uint8_t)pData[0] == meanDist[c].subID) {
+                meanDist[c].distance += l1_distance(theEmbedding, &pData[1], pDatabaseInfo->lengthOfEmbeddings,
+                                                    limit - meanDist[c].distance);
+            }
+
+            pData += pDatabaseInfo->lengthOfEmbeddings + 1;
         }
 
+        if (meanDist[c].distance < limit) {
+            meanDist[c].distance = meanDist[c].distance / meanDist[c].number;
+            insert_min_distance(meanDist[c].subID, meanDist[c].distance);
+        }
     }
 
     uint32_t bufferIdx = gClosestSubIdBufIdx % (closest_sub_buffer_size);
@@ -47,12 +47,16 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "max78000_camera_stream.h"
+#include "max78000_cnn_loader.h"
 #include "max78000_debug.h"
 #include "max78000_qspi_slave.h"
 #include "max78000_video_cnn.h"
 #include "max78000_video_embedding_process.h"
 #include "max78000_video_weights.h"
 #include "maxrefdes178_definitions.h"
+#include "maxrefdes178_rgb565.h"
+#include "maxrefdes178_timing.h"
 #include "maxrefdes178_utility.h"
 #include "maxrefdes178_version.h"
 
@@ -64,6 +68,11 @@
 
 //#define PRINT_TIME_CNN
 
+// QSPI payloads are received into the camera frame buffer
+#if FACEID_MAX_EMBEDDINGS_SIZE > LCD_DATA_SIZE
+#error "FaceID embeddings do not fit the QSPI payload buffer"
+#endif
+
 
 //-----------------------------------------------------------------------------
 // Typedefs
@@ -73,6 +82,9 @@
 //-----------------------------------------------------------------------------
 // Global variables
 //-----------------------------------------------------------------------------
+static uint32_t camera_image[LCD_DATA_SIZE / 4];  // QSPI frame buffer, camera streams rows into it
+static uint32_t cnn_start_us = 0;  // RTC us, DWT stops while the core sleeps waiting for the CNN
+
 static const mxc_gpio_cfg_t gpio_flash     = MAX78000_VIDEO_FLASH_LED_PIN;
 static const mxc_gpio_cfg_t gpio_camera    = MAX78000_VIDEO_CAMERA_PIN;
 static const mxc_gpio_cfg_t gpio_sram_cs   = MAX78000_VIDEO_SRAM_CS_PIN;
@@ -223,6 +235,8 @@ static uint8_t *qspi_payload_buffer = NULL;
 static version_t version = {S_VERSION_MAJOR, S_VERSION_MINOR, S_VERSION_BUILD};
 static char demo_name[] = FACEID_DEMO_NAME;
 static uint32_t camera_clock = 15 * 1000 * 1000;
+static uint8_t embedding[CNN_NUM_OUTPUTS] __attribute__((aligned(4)));  // CNN output, kept out of camera buffer
+static uint32_t frame_capture_time = 0;  // RTC us, start of current frame readout
 
 #ifdef PRINT_TIME_CNN
 #define PR_TIMER(fmt, args...) if((time_counter % 10) == 0) printf("T[%-5s:%4d] " fmt "\r\n", S_MODULE_NAME, __LINE__, ##args )
@@ -234,7 +248,9 @@ static uint32_t camera_clock = 15 * 1000 * 1000;
 //-----------------------------------------------------------------------------
 static void fail(void);
 static void send_img(void);
-static void run_cnn(int x_offset, int y_offset);
+static void cnn_start_frame(void);
+static void cnn_load_row(const uint8_t *row);
+static void cnn_process_result(void);
 static void run_demo(void);
 
 
@@ -341,6 +357,8 @@ int main(void)
         fail();
     }
 
+    timing_init();
+
     ret = qspi_slave_init();
     if (ret != E_NO_ERROR) {
         PR_ERROR("qspi_dma_slave_init fail %d", ret);
@@ -380,7 +398,7 @@ int main(void)
     }
 
     // Setup the camera image dimensions, pixel format and data acquiring details.
-    ret = camera_setup(CAMERA_WIDTH, CAMERA_HEIGHT, CAMERA_FORMAT, FIFO_FOUR_BYTE, USE_DMA, MAX78000_VIDEO_CAMERA_DMA_CHANNEL);
+    ret = camera_setup(CAMERA_WIDTH, CAMERA_HEIGHT, CAMERA_FORMAT, FIFO_FOUR_BYTE, STREAMING_DMA, MAX78000_VIDEO_CAMERA_DMA_CHANNEL);
     if (ret != STATUS_OK) {
         PR_ERROR("Error returned from setting up camera. Error : %d", ret);
         fail();
@@ -404,12 +422,8 @@ int main(void)
     MXC_TMR_EnableInt(MAX78000_VIDEO_SLEEP_DEFER_TMR);
     MXC_TMR_Start(MAX78000_VIDEO_SLEEP_DEFER_TMR);
 
-    // Use camera interface buffer for QSPI payload buffer
-    {
-        uint32_t  imgLen;
-        uint32_t  w, h;
-        camera_get_image(&qspi_payload_buffer, &imgLen, &w, &h);
-    }
+    // Use camera frame buffer for QSPI payload buffer
+    qspi_payload_buffer = (uint8_t *) camera_image;
 
     // Successfully initialize the program
     PR_INFO("Program initialized successfully");
@@ -433,20 +447,33 @@ static void fail(void)
 static void run_demo(void)
 {
     uint32_t capture_started_time = GET_RTC_MS();
-    uint32_t cnn_completed_time = 0;
-    uint32_t qspi_completed_time = 0;
     uint32_t capture_completed_time = 0;
+    uint32_t prev_capture_completed_time = capture_started_time;
+    uint32_t qspi_completed_time = 0;
+    uint32_t cnn_completed_time = 0;
     max78000_statistics_t max78000_statistics = {0};
+    stage_timing_t stage_timing[TIMING_STAGE_LAST];
     qspi_packet_header_t qspi_rx_header;
     qspi_state_e qspi_rx_state;
+    time_sync_t time_sync;
+    camera_stream_config_t stream_config = {
+        .frame = (uint8_t *) camera_image,
+        .row_size = CAMERA_WIDTH * LCD_BYTE_PER_PIXEL,
+        .row_count = CAMERA_HEIGHT,
+        .cnn_x = (CAMERA_WIDTH - FACEID_WIDTH) / 2,
+        .cnn_y = (CAMERA_HEIGHT - FACEID_HEIGHT) / 2,
+        .cnn_height = FACEID_HEIGHT,
+        .cnn_step = 1,
+        .cnn_row = NULL,
+    };
+    uint32_t cycles;
+    int ret;
 
     PR_INFO("Embeddings subject names:");
     for (int i = 0; i < get_subject_count(); i++) {
           PR_INFO("  %s", get_subject_name(i));
     }
 
-    camera_start_capture_image();
-
     while (1) { //Capture image and run CNN
 
         /* Check if QSPI RX has data */
@@ -454,9 +481,15 @@ static void run_demo(void)
         if (qspi_rx_state == QSPI_STATE_CS_DEASSERTED_HEADER) {
             qspi_rx_header = qspi_slave_get_rx_header();
 
-            // Use camera interface buffer for QSPI payload
-            MXC_PCIF_Stop();
+            if (qspi_rx_header.info.packet_size > LCD_DATA_SIZE) {
+                PR_ERROR("Invalid payload size %d", qspi_rx_header.info.packet_size);
+                qspi_slave_set_rx_state(QSPI_STATE_IDLE);
+                continue;
+            }
 
+            // Use camera frame buffer for QSPI payload. Rows are only copied into it by camera_stream_frame(),
+            // stop the early started capture as long payload handling, e.g. flash update, would overflow it
+            camera_stream_stop();
             qspi_slave_set_rx_data(qspi_payload_buffer, qspi_rx_header.info.packet_size);
             qspi_slave_trigger();
             qspi_slave_wait_rx();
@@ -465,7 +498,6 @@ static void run_demo(void)
             if (qspi_rx_header.payload_crc16 != crc16_sw(qspi_payload_buffer, qspi_rx_header.info.packet_size)) {
                 PR_ERROR("Invalid payload crc %x", qspi_rx_header.payload_crc16);
                 qspi_slave_set_rx_state(QSPI_STATE_IDLE);
-                camera_start_capture_image();
                 continue;
             }
 
@@ -507,7 +539,6 @@ static void run_demo(void)
             }
 
             qspi_slave_set_rx_state(QSPI_STATE_IDLE);
-            camera_start_capture_image();
 
         } else if (qspi_rx_state == QSPI_STATE_COMPLETED) {
             qspi_rx_header = qspi_slave_get_rx_header();
@@ -532,12 +563,11 @@ static void run_demo(void)
                 enable_video = 1;
                 // Enable camera
                 GPIO_CLR(gpio_camera);
-                camera_start_capture_image();
                 break;
             case QSPI_PACKET_TYPE_VIDEO_DISABLE_CMD:
                 PR_INFO("disable video");
                 enable_video = 0;
-                MXC_PCIF_Stop();
+                camera_stream_stop();
                 // Disable camera
                 GPIO_SET(gpio_camera);
                 GPIO_CLR(gpio_red);
@@ -554,14 +584,10 @@ static void run_demo(void)
                 GPIO_CLR(gpio_green);
                 break;
             case QSPI_PACKET_TYPE_VIDEO_FACEID_SUBJECTS_CMD:
-                // Use camera interface buffer for FaceID embeddings subject names
-                MXC_PCIF_Stop();
-
+                // Use camera frame buffer for FaceID embeddings subject names
                 memcpy(qspi_payload_buffer, get_subject_name(0), get_subject_names_len());
                 qspi_slave_set_rx_state(QSPI_STATE_IDLE);
                 qspi_slave_send_packet(qspi_payload_buffer, get_subject_names_len(), QSPI_PACKET_TYPE_VIDEO_FACEID_SUBJECTS_RES);
-
-                camera_start_capture_image();
                 break;
             case QSPI_PACKET_TYPE_VIDEO_ENABLE_FLASH_LED_CMD:
                 PR_INFO("enable flash");
@@ -609,6 +635,13 @@ static void run_demo(void)
                 enable_sleep = 0;
                 MXC_TMR_Start(MAX78000_VIDEO_SLEEP_DEFER_TMR);
                 break;
+            case QSPI_PACKET_TYPE_VIDEO_TIME_SYNC_CMD:
+                time_sync.device_rx_us = qspi_slave_get_rx_header_time();
+                qspi_slave_set_rx_state(QSPI_STATE_IDLE);
+                time_sync.device_tx_us = GET_RTC_US();
+                qspi_slave_send_packet((uint8_t *) &time_sync, sizeof(time_sync),
+                        QSPI_PACKET_TYPE_VIDEO_TIME_SYNC_RES);
+                break;
             default:
                 PR_ERROR("Invalid packet %d", qspi_rx_header.info.packet_type);
                 break;
@@ -639,69 +672,86 @@ static void run_demo(void)
             continue;
         }
 
-        if (camera_is_image_rcv()) { // Check whether image is ready
-            capture_completed_time = GET_RTC_MS();
+        /*
+         * Frame pipeline, camera rows are processed as they arrive:
+         *  1. Each row is copied into QSPI frame buffer and its crop is streamed into CNN FIFO
+         *  2. Frame is sent to MAX32666 over QSPI while CNN is processing
+         *  3. CNN result is unloaded and post-processed
+         */
+        capture_started_time = GET_RTC_MS();
 
-            send_img();
+        if (enable_cnn) {
+            cnn_start_frame();
+        }
 
-            qspi_completed_time = GET_RTC_MS();
+        stream_config.cnn_row = enable_cnn ? cnn_load_row : NULL;
+        frame_capture_time = GET_RTC_US();
+        cycles = timing_cycles();
+        ret = camera_stream_frame(&stream_config);
+        cycles = timing_record(TIMING_STAGE_CAPTURE, cycles);
+        if (ret == E_TIME_OUT) {
+            PR_ERROR("incomplete camera frame");
+        }
 
-            if (enable_cnn) {
-                run_cnn(0, 0);
-            }
+        capture_completed_time = GET_RTC_MS();
 
-            cnn_completed_time = GET_RTC_MS();
+        send_img();
+        timing_record(TIMING_STAGE_COMMUNICATION, cycles);
 
-            if (time_counter % 10 == 0) {
-                max78000_statistics.capture_duration_us = (capture_completed_time - capture_started_time) * 1000;
-                max78000_statistics.communication_duration_us = (qspi_completed_time - capture_completed_time) * 1000;
-                max78000_statistics.cnn_duration_us = (cnn_completed_time - qspi_completed_time) * 1000;
-                max78000_statistics.total_duration_us = (cnn_completed_time - capture_started_time) * 1000;
+        // Frame buffer is free again, camera waits for the next frame start while the CNN result is processed
+        camera_stream_start();
 
-                PR_DEBUG("Capture : %lu", max78000_statistics.capture_duration_us);
-                PR_DEBUG("CNN     : %lu", max78000_statistics.cnn_duration_us);
-                PR_DEBUG("QSPI    : %lu", max78000_statistics.communication_duration_us);
-                PR_DEBUG("Total   : %lu\n\n", max78000_statistics.total_duration_us);
+        qspi_completed_time = GET_RTC_MS();
 
-                qspi_slave_send_packet((uint8_t *) &max78000_statistics, sizeof(max78000_statistics),
-                        QSPI_PACKET_TYPE_VIDEO_STATISTICS_RES);
+        if (enable_cnn) {
+            if (ret == E_TIME_OUT) {
+                // CNN did not receive all rows, it would never finish
+                cnn_stop();
+                MXC_SYS_ClockDisable(MXC_SYS_PERIPH_CLOCK_CNN);
+            } else {
+                cnn_process_result();
             }
+        }
 
-            time_counter++;
-
-            camera_start_capture_image();
-            capture_started_time = GET_RTC_MS();
-
+        cnn_completed_time = GET_RTC_MS();
+
+        if (time_counter % 10 == 0) {
+            max78000_statistics.capture_duration_us = (capture_completed_time - capture_started_time) * 1000;
+            max78000_statistics.communication_duration_us = (qspi_completed_time - capture_completed_time) * 1000;
+            max78000_statistics.cnn_duration_us = (cnn_completed_time - qspi_completed_time) * 1000;
+            max78000_statistics.total_duration_us = (capture_completed_time - prev_capture_completed_time) * 1000;
+            max78000_statistics.stream_overflow_count = camera_stream_get_overflow_count();
+            timing_get(stage_timing);
+
+            PR_DEBUG("Capture : %lu", max78000_statistics.capture_duration_us);
+            PR_DEBUG("CNN     : %lu", max78000_statistics.cnn_duration_us);
+            PR_DEBUG("QSPI    : %lu", max78000_statistics.communication_duration_us);
+            PR_DEBUG("Total   : %lu", max78000_statistics.total_duration_us);
+            PR_DEBUG("Overflow: %lu", max78000_statistics.stream_overflow_count);
+            PR_DEBUG("CNN p50/p99/max: %lu/%lu/%lu\n\n", stage_timing[TIMING_STAGE_CNN].p50_us,
+                    stage_timing[TIMING_STAGE_CNN].p99_us, stage_timing[TIMING_STAGE_CNN].max_us);
+
+            qspi_slave_send_packet((uint8_t *) &max78000_statistics, sizeof(max78000_statistics),
+                    QSPI_PACKET_TYPE_VIDEO_STATISTICS_RES);
+            qspi_slave_send_packet((uint8_t *) stage_timing, sizeof(stage_timing),
+                    QSPI_PACKET_TYPE_VIDEO_TIMING_RES);
         }
+
+        prev_capture_completed_time = capture_completed_time;
+        time_counter++;
     }
 }
 
 static void send_img(void)
 {
-    uint8_t   *raw;
-    uint32_t  imgLen;
-    uint32_t  w, h;
-
-    // Get the details of the image from the camera driver.
-    camera_get_image(&raw, &imgLen, &w, &h);
-
-    qspi_slave_send_packet(raw, imgLen, QSPI_PACKET_TYPE_VIDEO_DATA_RES);
+    // Host pairs the timestamp with the next frame for camera to LCD latency
+    qspi_slave_send_packet((uint8_t *) &frame_capture_time, sizeof(frame_capture_time), QSPI_PACKET_TYPE_VIDEO_FRAME_TIMESTAMP_RES);
+    qspi_slave_send_packet((uint8_t *) camera_image, LCD_DATA_SIZE, QSPI_PACKET_TYPE_VIDEO_DATA_RES);
 //    MXC_Delay(MXC_DELAY_MSEC(3)); // Yield SPI DMA RAM read
 }
 
-static void run_cnn(int x_offset, int y_offset)
+static void cnn_start_frame(void)
 {
-    uint8_t *data;
-    uint8_t *raw;
-    uint8_t ur, ug, ub;
-    int8_t r, g, b;
-    uint32_t number;
-    uint32_t w, h;
-    static uint32_t noface_count = 0;
-
-    // Get the details of the image from the camera driver.
-    camera_get_image(&raw, &number, &w, &h);
-
 #ifdef PRINT_TIME_CNN
     uint32_t pass_time = GET_RTC_MS();
 #endif
@@ -714,60 +764,58 @@ static void run_cnn(int x_offset, int y_offset)
     cnn_configure(); // Configure state machine
 
     cnn_start();
+    cnn_start_us = GET_RTC_US();
 
 #ifdef PRINT_TIME_CNN
     PR_TIMER("CNN init : %d", GET_RTC_MS() - pass_time);
-    pass_time = GET_RTC_MS();
 #endif
+}
 
-    for (int i = y_offset; i < FACEID_HEIGHT + y_offset; i++) {
-        data = raw + (((LCD_HEIGHT - FACEID_HEIGHT) / 2) + i) * LCD_WIDTH * LCD_BYTE_PER_PIXEL;  // down
-        data += ((LCD_WIDTH - FACEID_WIDTH) / 2) * LCD_BYTE_PER_PIXEL;  // right
-
-        for(int j = x_offset; j < FACEID_WIDTH + x_offset; j++) {
-            // RGB565, |RRRRRGGG|GGGBBBBB|
-            ub = (data[j * LCD_BYTE_PER_PIXEL + 1] << 3);
-            ug = ((data[j * LCD_BYTE_PER_PIXEL] << 5) | ((data[j * LCD_BYTE_PER_PIXEL + 1] & 0xE0) >> 3));
-            ur = (data[j * LCD_BYTE_PER_PIXEL] & 0xF8);
-
-            b = ub - 128;
-            g = ug - 128;
-            r = ur - 128;
-
-            // Loading data into the CNN fifo
-            while (((*((volatile uint32_t *) 0x50000004) & 1)) != 0); // Wait for FIFO 0
+static void cnn_load_row(const uint8_t *row)
+{
+    static uint32_t cnn_row[FACEID_WIDTH];
 
-            number = 0x00FFFFFF & ((((uint8_t)b) << 16) | (((uint8_t)g) << 8) | ((uint8_t) r));
+    // RGB565 to 0x00bbggrr
+    rgb565_to_cnn_hwc(row, cnn_row, FACEID_WIDTH, 1);
 
-            *((volatile uint32_t *) 0x50000008) = number; // Write FIFO 0
-        }
+    // Loading data into the CNN fifo
+    for (int j = 0; j < FACEID_WIDTH; j++) {
+        cnn_loader_fifo_write(0, cnn_row[j]); // Write FIFO 0
     }
+}
+
+static void cnn_process_result(void)
+{
+    uint32_t cycles;
+    static uint32_t noface_count = 0;
 
 #ifdef PRINT_TIME_CNN
-    PR_TIMER("CNN load : %d", GET_RTC_MS() - pass_time);
-    pass_time = GET_RTC_MS();
+    uint32_t pass_time = GET_RTC_MS();
 #endif
 
     while (cnn_time == 0)
         __WFI(); // Wait for CNN done
+    timing_record_us(TIMING_STAGE_CNN, GET_RTC_US() - cnn_start_us);
+    cycles = timing_cycles();
 
 #ifdef PRINT_TIME_CNN
     PR_TIMER("CNN wait : %d", GET_RTC_MS() - pass_time);
     pass_time = GET_RTC_MS();
 #endif
 
-    cnn_unload((uint32_t*)(raw));
+    cnn_unload((uint32_t *) embedding);
 
     cnn_stop();
     // Disable CNN clock to save power
     MXC_SYS_ClockDisable(MXC_SYS_PERIPH_CLOCK_CNN);
+    cycles = timing_record(TIMING_STAGE_UNLOAD, cycles);
 
 #ifdef PRINT_TIME_CNN
     PR_TIMER("CNN unload : %d", GET_RTC_MS() - pass_time);
     pass_time = GET_RTC_MS();
 #endif
 
-    int pResult = calculate_minDistance((uint8_t*)(raw));
+    int pResult = calculate_minDistance(embedding);
 
 #ifdef PRINT_TIME_CNN
     PR_TIMER("Embedding calc : %d", GET_RTC_MS() - pass_time);
@@ -832,12 +880,15 @@ static void run_cnn(int x_offset, int y_offset)
         }
 
         if(decision != prev_decision){
+            classification_result.capture_timestamp_us = frame_capture_time;
             qspi_slave_send_packet((uint8_t *) &classification_result, sizeof(classification_result),
                     QSPI_PACKET_TYPE_VIDEO_CLASSIFICATION_RES);
             PR_DEBUG("Result : %s\n", classification_result.result);
         }
     }
 
+    timing_record(TIMING_STAGE_POSTPROCESS, cycles);
+
 #ifdef PRINT_TIME_CNN
     PR_TIMER("Embedding result : %d", GET_RTC_MS() - pass_time);
     pass_time = GET_RTC_MS();
@@ -176,6 +176,8 @@ void qspi_slave_cs_handler(void *cbdata)
                 } else {
                     g_qspi_state_rx = QSPI_STATE_COMPLETED;
                 }
+                // Set again for each packet, a stale buffer must not take the payload of the next one
+                g_rx_data = NULL;
                 break;
             default:
                 PR_ERROR("invalid rx state %d", g_qspi_state_rx);
@@ -211,6 +213,11 @@ void qspi_slave_cs_handler(void *cbdata)
             // RX request
             switch (g_qspi_state_rx) {
             case QSPI_STATE_IDLE:
+                // Master only sends on an idle link, the TX packet it was reading lost a CS edge
+                if ((g_qspi_state_tx == QSPI_STATE_CS_ASSERTED_HEADER) || (g_qspi_state_tx == QSPI_STATE_CS_DEASSERTED_HEADER) ||
+                        (g_qspi_state_tx == QSPI_STATE_CS_ASSERTED_DATA)) {
+                    g_qspi_state_tx = QSPI_STATE_IDLE;
+                }
                 qspi_slave_dma(NULL, (uint8_t *) &g_qspi_packet_header_rx, sizeof(g_qspi_packet_header_rx));
                 g_qspi_state_rx = QSPI_STATE_CS_ASSERTED_HEADER;
                 break;
@@ -438,6 +445,12 @@ static int qspi_slave_wait_tx(qspi_state_e qspi_state)
     uint32_t cnt = SPI_TIMEOUT_CNT * 10;
 
     while((g_qspi_state_tx != qspi_state) && cnt) {
+        // Dropped by the CS handler, or the master sent a data header instead of reading ours and took
+        // our INT for its payload request
+        if ((g_qspi_state_tx == QSPI_STATE_IDLE) ||
+                ((g_qspi_state_tx == QSPI_STATE_STARTED) && (g_qspi_state_rx == QSPI_STATE_CS_DEASSERTED_HEADER))) {
+            return E_BUSY;
+        }
         cnt--;
     }
 
@@ -451,6 +464,11 @@ static int qspi_slave_wait_tx(qspi_state_e qspi_state)
 
 int qspi_slave_send_packet(uint8_t *data, uint32_t data_size, uint8_t data_type)
 {
+    int ret;
+
+    // Computed before the idle checks, a frame takes milliseconds and the master may start a transfer meanwhile
+    uint16_t payload_crc16 = data_size ? crc16_sw(data, data_size) : 0;
+
     if (g_qspi_state_tx != QSPI_STATE_IDLE) {
         PR_WARN("qspi is not idle %d", g_qspi_state_tx);
         return E_BUSY;
@@ -467,7 +485,7 @@ int qspi_slave_send_packet(uint8_t *data, uint32_t data_size, uint8_t data_type)
     g_qspi_packet_header_tx.info.packet_size = data_size;
     g_qspi_packet_header_tx.info.packet_type = data_type;
     g_qspi_packet_header_tx.header_crc16 = crc16_sw((uint8_t *) &g_qspi_packet_header_tx.info, sizeof(g_qspi_packet_header_tx.info));
-//    g_qspi_packet_header_tx.payload_crc16 = crc16_sw(data, data_size);
+    g_qspi_packet_header_tx.payload_crc16 = payload_crc16;
     g_tx_data = data;
     g_tx_data_size = data_size;
 
@@ -477,7 +495,13 @@ int qspi_slave_send_packet(uint8_t *data, uint32_t data_size, uint8_t data_type)
     qspi_slave_trigger();
 
     if (data_size) {
-        if (qspi_slave_wait_tx(QSPI_STATE_CS_DEASSERTED_HEADER) != E_NO_ERROR) {
+        ret = qspi_slave_wait_tx(QSPI_STATE_CS_DEASSERTED_HEADER);
+        if (ret == E_BUSY) {
+            // Master dropped it or sent its own packet first, the caller sends again
+            g_qspi_state_tx = QSPI_STATE_IDLE;
+            PR_WARN("tx dropped %d", data_type);
+            return E_BUSY;
+        } else if (ret != E_NO_ERROR) {
             g_qspi_state_tx = QSPI_STATE_IDLE;
             PR_ERROR("wait fail %d %d", data_size, data_type);
             return E_BAD_STATE;
@@ -487,7 +511,13 @@ int qspi_slave_send_packet(uint8_t *data, uint32_t data_size, uint8_t data_type)
         qspi_slave_trigger();
     }
 
-    if (qspi_slave_wait_tx(QSPI_STATE_COMPLETED) != E_NO_ERROR) {
+    ret = qspi_slave_wait_tx(QSPI_STATE_COMPLETED);
+    if (ret == E_BUSY) {
+        // Master dropped it or sent its own packet first, the caller sends again
+        g_qspi_state_tx = QSPI_STATE_IDLE;
+        PR_WARN("tx dropped %d", data_type);
+        return E_BUSY;
+    } else if (ret != E_NO_ERROR) {
         g_qspi_state_tx = QSPI_STATE_IDLE;
         PR_ERROR("wait fail %d %d", data_size, data_type);
         return E_BAD_STATE;
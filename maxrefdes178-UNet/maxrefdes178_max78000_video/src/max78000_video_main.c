@@ -52,6 +52,7 @@
 #include "max78000_video_cnn.h"
 #include "max78000_video_weights.h"
 #include "maxrefdes178_definitions.h"
+#include "maxrefdes178_rgb565.h"
 #include "maxrefdes178_utility.h"
 #include "maxrefdes178_version.h"
 
@@ -227,6 +228,9 @@ static int8_t enable_cnn = 0;
 static int8_t flash_led = 0;
 static int8_t camera_vflip = 1;
 static int8_t enable_video = 0;
+static int8_t ml_credit = 0;
+static uint8_t *ml_result = NULL;  // mask waiting for a credit
+static uint32_t ml_result_time = 0;
 
 static int8_t enable_sleep = 0;
 static uint8_t *qspi_payload_buffer = NULL;
@@ -246,6 +250,7 @@ static uint32_t camera_clock = 15 * 1000 * 1000;
 static void fail(void);
 static void send_img(void);
 static void run_cnn(int x_offset, int y_offset);
+static int send_ml_result(void);
 static void run_demo(void);
 
 
@@ -460,8 +465,9 @@ static void run_demo(void)
         if (qspi_rx_state == QSPI_STATE_CS_DEASSERTED_HEADER) {
             qspi_rx_header = qspi_slave_get_rx_header();
 
-            // Use camera interface buffer for QSPI payload
+            // Use camera interface buffer for QSPI payload, it overwrites a mask waiting for a credit
             MXC_PCIF_Stop();
+            ml_result = NULL;
 
             qspi_slave_set_rx_data(qspi_payload_buffer, qspi_rx_header.info.packet_size);
             qspi_slave_trigger();
@@ -521,6 +527,7 @@ static void run_demo(void)
                 enable_cnn = 1;
                 // Enable camera
                 GPIO_CLR(gpio_camera);
+                ml_result = NULL;
                 camera_start_capture_image();
                 break;
             case QSPI_PACKET_TYPE_VIDEO_DISABLE_CMD:
@@ -595,6 +602,9 @@ static void run_demo(void)
                 enable_sleep = 0;
                 MXC_TMR_Start(MAX78000_VIDEO_SLEEP_DEFER_TMR);
                 break;
+            case QSPI_PACKET_TYPE_VIDEO_ML_CREDIT_CMD:
+                ml_credit = 1;
+                break;
             default:
                 PR_ERROR("Invalid packet %d", qspi_rx_header.info.packet_type);
                 break;
@@ -625,6 +635,15 @@ static void run_demo(void)
             continue;
         }
 
+        // Mask stays in the camera buffer until it is sent or dropped, commands are served meanwhile
+        if (ml_result != NULL) {
+            if (send_ml_result() == E_BUSY) {
+                continue;
+            }
+            camera_start_capture_image();
+            capture_started_time = GET_RTC_MS();
+        }
+
         if (camera_is_image_rcv()) { // Check whether image is ready
             capture_completed_time = GET_RTC_MS();
 
@@ -662,8 +681,11 @@ static void run_demo(void)
 
             time_counter++;
 
-            camera_start_capture_image();
-            capture_started_time = GET_RTC_MS();
+            // Capture restarts once a pending mask has left the camera buffer
+            if (ml_result == NULL) {
+                camera_start_capture_image();
+                capture_started_time = GET_RTC_MS();
+            }
 
         }
     }
@@ -686,8 +708,6 @@ static void run_cnn(int x_offset, int y_offset)
 {
     uint8_t *data;
     uint8_t *raw;
-    uint8_t ur, ug, ub;
-    int8_t r, g, b;
     uint32_t number;
     uint32_t w, h;
 
@@ -712,32 +732,17 @@ static void run_cnn(int x_offset, int y_offset)
 #endif
 
     int cnt = 0;
-    uint32_t sample;
-	uint32_t *dst = (uint32_t *) 0x50408000; 
+    uint32_t *dst = (uint32_t *) 0x50408000;
 
-	// Read 240x240, pick one out of 3 pixels to make it 80x80
-	// CNN needs RGB888, pack for bytes into 1 int for each color
+    // Read 240x240, pick one out of 3 pixels to make it 80x80
+    // CNN needs RGB888 as 0x00bbggrr, write directly to CNN data memory
     for (int i = y_offset; i < IMAGE_HEIGHT + y_offset; i+=3) {
         data = raw + (((CAMERA_HEIGHT - IMAGE_HEIGHT) / 2) + i) * CAMERA_WIDTH * LCD_BYTE_PER_PIXEL;  // down
         data += ((CAMERA_WIDTH - IMAGE_WIDTH) / 2) * LCD_BYTE_PER_PIXEL;  // right
 
-        for(int j = x_offset; j < IMAGE_WIDTH + x_offset; j+=3) {
-
-        	// RGB565, |RRRRRGGG|GGGBBBBB|
-            ub = (data[j * LCD_BYTE_PER_PIXEL + 1] << 3);
-            ug = ((data[j * LCD_BYTE_PER_PIXEL] << 5) | ((data[j * LCD_BYTE_PER_PIXEL + 1] & 0xE0) >> 3));
-            ur = (data[j * LCD_BYTE_PER_PIXEL] & 0xF8);
-
-            b = ub - 128;
-            g = ug - 128;
-            r = ur - 128;
-			
-			sample = r | (g << 8) | (b<<16);
-			// // Load sample to CNN
-			*dst++ = sample;
-			cnt ++;
-
-        }
+        rgb565_to_cnn_hwc(data + x_offset * LCD_BYTE_PER_PIXEL, dst, IMAGE_WIDTH / 3, 3);
+        dst += IMAGE_WIDTH / 3;
+        cnt += IMAGE_WIDTH / 3;
     }
 	printf("Total samples loaded: %d \r\n", cnt);
 
@@ -786,8 +791,32 @@ static void run_cnn(int x_offset, int y_offset)
 #endif
 
 
-    MXC_Delay(MXC_DELAY_MSEC(500));
-    qspi_slave_send_packet(raw, UNET_IMAGE_SIZE_X*UNET_IMAGE_SIZE_Y*4, QSPI_PACKET_TYPE_VIDEO_ML_RES); // r,g,b,unknown per pixel
+    // Send the mask when host has a free mask buffer, otherwise main loop retries until the timeout
+    ml_result = raw;
+    ml_result_time = GET_RTC_MS();
+    send_ml_result();
+}
+
+// Sends the pending mask if host granted a credit, E_BUSY while it is still waiting for one
+static int send_ml_result(void)
+{
+    if (ml_result == NULL) {
+        return E_NO_ERROR;
+    }
+
+    if (!ml_credit) {
+        if ((GET_RTC_MS() - ml_result_time) <= MAX78000_VIDEO_ML_CREDIT_TIMEOUT) {
+            return E_BUSY;
+        }
+        PR_DEBUG("no ml credit, drop result");
+        ml_result = NULL;
+        return E_TIME_OUT;
+    }
+
+    ml_credit = 0;
+    qspi_slave_send_packet(ml_result, UNET_IMAGE_SIZE_X*UNET_IMAGE_SIZE_Y*4, QSPI_PACKET_TYPE_VIDEO_ML_RES); // r,g,b,unknown per pixel
 	//qspi_slave_send_packet(raw, 115200/4, QSPI_PACKET_TYPE_VIDEO_ML_RES);
-    MXC_Delay(MXC_DELAY_MSEC(500));
+    ml_result = NULL;
+
+    return E_NO_ERROR;
 }
@@ -13,6 +13,7 @@
 #include "i2s.h"
 #include "led.h"
 #include "nvic_table.h"
+#include "maxrefdes178_mic.h"
 
 //-----------------------------------------------------------------------------
 // Defines
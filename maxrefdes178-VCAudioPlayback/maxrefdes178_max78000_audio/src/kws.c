@@ -145,49 +145,10 @@ uint8_t AddTranspose(uint8_t *pIn, uint8_t *pOut, uint16_t inSize, uint16_t outS
         (127,127)(127,126)(127,125)(127,124)
      */
 
-    static uint16_t row = 0, col = 0, total = 0;
-    uint16_t  secondHalf = 0, wordRow = 0, byteInWord = 0, group = 0, index = 0;
-    for (int i = 0; i < inSize; i++) {
-        /* is it above 63? */
-        if (col >= (width >> 1)) {
-            secondHalf = 1; // odd word rows
-        } else {
-            secondHalf = 0; // even word rows
-        }
-
-        /* which group (0-15) it should be */
-        group = (col % (width >> 1)) / 4;
-
-        /* which word row (0-255) within the group */
-        wordRow = secondHalf + (row << 1);
-
-        /* which byte (0-3) in the word */
-        byteInWord = col % 4;
-
-        /* find output index */
-        index = 1024 * group + 4 * wordRow + byteInWord;
-
-        /* place sample in correct output location */
-        pOut[index] = pIn[i];
-
-        total++;
+    /* Samples arrive as whole rows, each row is copied as 4-byte words */
+    static uint16_t row = 0;
 
-        /* increment row and col index */
-        col++;
-        if (col >= width) {
-            col = 0;
-            row++;
-        }
-    }
-
-    if (total >= outSize) {
-        total = 0;
-        row = 0;
-        col = 0;
-        return 1;
-    } else {
-        return 0;
-    }
+    return (mic_transpose(&row, pIn, pOut, inSize, outSize, width) == MIC_TRANSPOSE_DONE);
 }
 
 uint8_t MicReadChunk(uint8_t *pBuff, uint16_t * avg)
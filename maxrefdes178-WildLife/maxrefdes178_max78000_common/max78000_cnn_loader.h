@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2023 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+#ifndef _MAX78000_CNN_LOADER_H_
+#define _MAX78000_CNN_LOADER_H_
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+// CNN input FIFO registers
+#define CNN_LOADER_FIFO_STAT_ADDR   0x50000004
+#define CNN_LOADER_FIFO_DATA_ADDR   0x50000008  // FIFO n is at +4*n
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+// One contiguous block copied into CNN data memory, size in bytes and multiple of 4
+typedef struct {
+    uint32_t dst;
+    const void *src;
+    uint32_t size;
+} cnn_loader_desc_t;
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+int cnn_loader_init(void);
+int cnn_loader_start(const cnn_loader_desc_t *desc, uint32_t desc_count);
+int cnn_loader_busy(void);
+int cnn_loader_wait(void);
+
+// Write one word into CNN input FIFO 0-3 when it is not full.
+// MAX78000 DMA has no CNN FIFO request line, so FIFO-fed models are paced by the CPU
+static inline void cnn_loader_fifo_write(uint8_t fifo, uint32_t data)
+{
+    while ((*((volatile uint32_t *) CNN_LOADER_FIFO_STAT_ADDR) & (1 << fifo)) != 0); // Wait for FIFO
+    *((volatile uint32_t *) (CNN_LOADER_FIFO_DATA_ADDR + 4 * fifo)) = data; // Write FIFO
+}
+
+
+#endif /* _MAX78000_CNN_LOADER_H_ */
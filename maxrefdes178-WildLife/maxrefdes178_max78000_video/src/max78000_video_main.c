@@ -47,11 +47,15 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "max78000_camera_stream.h"
+#include "max78000_cnn_loader.h"
 #include "max78000_debug.h"
 #include "max78000_qspi_slave.h"
 #include "max78000_video_cnn.h"
 #include "max78000_video_weights.h"
 #include "maxrefdes178_definitions.h"
+#include "maxrefdes178_rgb565.h"
+#include "maxrefdes178_timing.h"
 #include "maxrefdes178_utility.h"
 #include "maxrefdes178_version.h"
 
@@ -75,6 +79,8 @@
 //-----------------------------------------------------------------------------
 // Global variables
 //-----------------------------------------------------------------------------
+static uint32_t camera_image[LCD_DATA_SIZE / 4];  // QSPI frame buffer, camera streams rows into it
+static uint32_t cnn_start_us = 0;  // RTC us, DWT stops while the core sleeps waiting for the CNN
 
 static int32_t ml_data[CNN_NUM_OUTPUTS];
 static q15_t ml_softmax[CNN_NUM_OUTPUTS];
@@ -245,7 +251,9 @@ static uint32_t camera_clock = 15 * 1000 * 1000;
 
 static void fail(void);
 static void send_img(void);
-static void run_cnn(int x_offset, int y_offset);
+static void cnn_start_frame(void);
+static void cnn_load_row(const uint8_t *row);
+static void cnn_process_result(void);
 static void run_demo(void);
 
 
@@ -348,6 +356,8 @@ int main(void)
         fail();
     }
 
+    timing_init();
+
     ret = qspi_slave_init();
     if (ret != E_NO_ERROR) {
         PR_ERROR("qspi_dma_slave_init fail %d", ret);
@@ -388,7 +398,7 @@ int main(void)
 
     // Setup the camera image dimensions, pixel format and data acquiring details.
 
-    ret = camera_setup(CAMERA_WIDTH, CAMERA_HEIGHT, CAMERA_FORMAT, FIFO_FOUR_BYTE, USE_DMA, MAX78000_VIDEO_CAMERA_DMA_CHANNEL);
+    ret = camera_setup(CAMERA_WIDTH, CAMERA_HEIGHT, CAMERA_FORMAT, FIFO_FOUR_BYTE, STREAMING_DMA, MAX78000_VIDEO_CAMERA_DMA_CHANNEL);
 
     if (ret != STATUS_OK) {
         PR_ERROR("Error returned from setting up camera. Error : %d", ret);
@@ -413,12 +423,8 @@ int main(void)
     MXC_TMR_EnableInt(MAX78000_VIDEO_SLEEP_DEFER_TMR);
     MXC_TMR_Start(MAX78000_VIDEO_SLEEP_DEFER_TMR);
 
-    // Use camera interface buffer for QSPI payload buffer
-    {
-        uint32_t  imgLen;
-        uint32_t  w, h;
-        camera_get_image(&qspi_payload_buffer, &imgLen, &w, &h);
-    }
+    // Use camera frame buffer for QSPI payload buffer
+    qspi_payload_buffer = (uint8_t *) camera_image;
 
     // Successfully initialize the program
     PR_INFO("Initialization complete");
@@ -447,11 +453,21 @@ static void run_demo(void)
     uint32_t qspi_completed_time = 0;
     uint32_t capture_completed_time = 0;
     max78000_statistics_t max78000_statistics = {0};
+    stage_timing_t stage_timing[TIMING_STAGE_LAST];
     qspi_packet_header_t qspi_rx_header;
     qspi_state_e qspi_rx_state;
-
-
-    camera_start_capture_image();
+    camera_stream_config_t stream_config = {
+        .frame = (uint8_t *) camera_image,
+        .row_size = CAMERA_WIDTH * LCD_BYTE_PER_PIXEL,
+        .row_count = CAMERA_HEIGHT,
+        .cnn_x = (CAMERA_WIDTH - PIC_WIDTH) / 2,
+        .cnn_y = (CAMERA_HEIGHT - PIC_HEIGHT) / 2,
+        .cnn_height = PIC_HEIGHT,
+        .cnn_step = 3,
+        .cnn_row = NULL,
+    };
+    uint32_t cycles;
+    int ret;
 
     while (1) { //Capture image and run CNN
 
@@ -460,9 +476,9 @@ static void run_demo(void)
         if (qspi_rx_state == QSPI_STATE_CS_DEASSERTED_HEADER) {
             qspi_rx_header = qspi_slave_get_rx_header();
 
-            // Use camera interface buffer for QSPI payload
-            MXC_PCIF_Stop();
-
+            // Use camera frame buffer for QSPI payload. Rows are only copied into it by camera_stream_frame(),
+            // stop the early started capture as long payload handling, e.g. flash update, would overflow it
+            camera_stream_stop();
             qspi_slave_set_rx_data(qspi_payload_buffer, qspi_rx_header.info.packet_size);
             qspi_slave_trigger();
             qspi_slave_wait_rx();
@@ -471,7 +487,6 @@ static void run_demo(void)
             if (qspi_rx_header.payload_crc16 != crc16_sw(qspi_payload_buffer, qspi_rx_header.info.packet_size)) {
                 PR_ERROR("Invalid payload crc %x", qspi_rx_header.payload_crc16);
                 qspi_slave_set_rx_state(QSPI_STATE_IDLE);
-                camera_start_capture_image();
                 continue;
             }
 
@@ -493,7 +508,6 @@ static void run_demo(void)
             }
 
             qspi_slave_set_rx_state(QSPI_STATE_IDLE);
-            camera_start_capture_image();
 
         } else if (qspi_rx_state == QSPI_STATE_COMPLETED) {
             qspi_rx_header = qspi_slave_get_rx_header();
@@ -521,12 +535,11 @@ static void run_demo(void)
                 enable_cnn = 1;
                 // Enable camera
                 GPIO_CLR(gpio_camera);
-                camera_start_capture_image();
                 break;
             case QSPI_PACKET_TYPE_VIDEO_DISABLE_CMD:
                 PR_INFO("disable video");
                 enable_video = 0;
-                MXC_PCIF_Stop();
+                camera_stream_stop();
                 // Disable camera
                 GPIO_SET(gpio_camera);
                 GPIO_CLR(gpio_red);
@@ -625,73 +638,78 @@ static void run_demo(void)
             continue;
         }
 
-        if (camera_is_image_rcv()) { // Check whether image is ready
-            capture_completed_time = GET_RTC_MS();
-
-            send_img();
+        // Camera rows are copied into QSPI frame buffer and streamed into CNN FIFOs as they arrive
+        capture_started_time = GET_RTC_MS();
 
-            qspi_completed_time = GET_RTC_MS();
+        if (enable_cnn) {
+            cnn_start_frame();
+        }
 
-            if (enable_cnn) {
+        stream_config.cnn_row = enable_cnn ? cnn_load_row : NULL;
+        cycles = timing_cycles();
+        ret = camera_stream_frame(&stream_config);
+        cycles = timing_record(TIMING_STAGE_CAPTURE, cycles);
+        if (ret == E_TIME_OUT) {
+            PR_ERROR("incomplete camera frame");
+        }
 
+        capture_completed_time = GET_RTC_MS();
 
-            	PR_INFO("CNN_EN");
-                run_cnn(0, 0);
-            }
-            else
-            	PR_INFO("CNN_DIS");
+        send_img();
+        timing_record(TIMING_STAGE_COMMUNICATION, cycles);
 
-            cnn_completed_time = GET_RTC_MS();
+        // Frame buffer is free again, camera waits for the next frame start while the CNN result is processed
+        camera_stream_start();
 
-            if (time_counter % 10 == 0) {
-                max78000_statistics.capture_duration_us = (capture_completed_time - capture_started_time) * 1000;
-                max78000_statistics.communication_duration_us = (qspi_completed_time - capture_completed_time) * 1000;
-                max78000_statistics.cnn_duration_us = cnn_time; //(cnn_completed_time - qspi_completed_time) * 1000;
-                max78000_statistics.total_duration_us = (cnn_completed_time - capture_started_time) * 1000;
+        qspi_completed_time = GET_RTC_MS();
 
-                PR_DEBUG("Capture : %lu", max78000_statistics.capture_duration_us);
-                PR_DEBUG("CNN     : %lu", max78000_statistics.cnn_duration_us);
-                PR_DEBUG("QSPI    : %lu", max78000_statistics.communication_duration_us);
-                PR_DEBUG("Total   : %lu\n\n", max78000_statistics.total_duration_us);
-
-                qspi_slave_send_packet((uint8_t *) &max78000_statistics, sizeof(max78000_statistics),
-                        QSPI_PACKET_TYPE_VIDEO_STATISTICS_RES);
+        if (enable_cnn) {
+            if (ret == E_TIME_OUT) {
+                // CNN did not receive all rows, it would never finish
+                cnn_stop();
+                MXC_SYS_ClockDisable(MXC_SYS_PERIPH_CLOCK_CNN);
+            } else {
+                PR_INFO("CNN_EN");
+                cnn_process_result();
             }
-
-            time_counter++;
-
-            camera_start_capture_image();
-            capture_started_time = GET_RTC_MS();
-
         }
+        else
+            PR_INFO("CNN_DIS");
+
+        cnn_completed_time = GET_RTC_MS();
+
+        if (time_counter % 10 == 0) {
+            max78000_statistics.capture_duration_us = (capture_completed_time - capture_started_time) * 1000;
+            max78000_statistics.communication_duration_us = (qspi_completed_time - capture_completed_time) * 1000;
+            max78000_statistics.cnn_duration_us = cnn_time; //(cnn_completed_time - qspi_completed_time) * 1000;
+            max78000_statistics.total_duration_us = (cnn_completed_time - capture_started_time) * 1000;
+            max78000_statistics.stream_overflow_count = camera_stream_get_overflow_count();
+            timing_get(stage_timing);
+
+            PR_DEBUG("Capture : %lu", max78000_statistics.capture_duration_us);
+            PR_DEBUG("CNN     : %lu", max78000_statistics.cnn_duration_us);
+            PR_DEBUG("QSPI    : %lu", max78000_statistics.communication_duration_us);
+            PR_DEBUG("Total   : %lu", max78000_statistics.total_duration_us);
+            PR_DEBUG("Overflow: %lu", max78000_statistics.stream_overflow_count);
+            PR_DEBUG("CNN p50/p99/max: %lu/%lu/%lu\n\n", stage_timing[TIMING_STAGE_CNN].p50_us,
+                    stage_timing[TIMING_STAGE_CNN].p99_us, stage_timing[TIMING_STAGE_CNN].max_us);
+
+            qspi_slave_send_packet((uint8_t *) &max78000_statistics, sizeof(max78000_statistics),
+                    QSPI_PACKET_TYPE_VIDEO_STATISTICS_RES);
+        }
+
+        time_counter++;
     }
 }
 
 static void send_img(void)
 {
-    uint8_t   *raw;
-    uint32_t  imgLen;
-    uint32_t  w, h;
-
-    // Get the details of the image from the camera driver.
-    camera_get_image(&raw, &imgLen, &w, &h);
-
-    qspi_slave_send_packet(raw, imgLen, QSPI_PACKET_TYPE_VIDEO_DATA_RES);
+    qspi_slave_send_packet((uint8_t *) camera_image, LCD_DATA_SIZE, QSPI_PACKET_TYPE_VIDEO_DATA_RES);
 //    MXC_Delay(MXC_DELAY_MSEC(3)); // Yield SPI DMA RAM read
 }
 
-static void run_cnn(int x_offset, int y_offset)
+static void cnn_start_frame(void)
 {
-    uint8_t *data;
-    uint8_t *raw;
-    uint8_t ur, ug, ub;
-    int8_t r, g, b;
-    uint32_t number;
-    uint32_t w, h;
-
-    // Get the details of the image from the camera driver.
-    camera_get_image(&raw, &number, &w, &h);
-
 #ifdef PRINT_TIME_CNN
     uint32_t pass_time = GET_RTC_MS();
 #endif
@@ -705,73 +723,41 @@ static void run_cnn(int x_offset, int y_offset)
     cnn_configure(); // Configure state machine
 
     cnn_start();
+    cnn_start_us = GET_RTC_US();
 
 #ifdef PRINT_TIME_CNN
     PR_TIMER("CNN init : %d", GET_RTC_MS() - pass_time);
-    pass_time = GET_RTC_MS();
 #endif
+}
 
-    uint32_t r32=0, g32=0, b32=0;
-    int cnt = 3;
-
-    r32 = 0;
-	g32 = 0;
-	b32 = 0;
-	cnt = 3;
-
-	// Read 192x192, pick one out of 3 pixels to make it 64x64
-	// CNN needs RGB888, pack for bytes into 1 int for each color
-    for (int i = y_offset; i < PIC_HEIGHT + y_offset; i+=3) {
-        data = raw + (((LCD_HEIGHT - PIC_HEIGHT) / 2) + i) * LCD_WIDTH * LCD_BYTE_PER_PIXEL;  // down
-        data += ((LCD_WIDTH - PIC_WIDTH) / 2) * LCD_BYTE_PER_PIXEL;  // right
-
-        for(int j = x_offset; j < PIC_WIDTH + x_offset; j+=3) {
-
-        	// RGB565, |RRRRRGGG|GGGBBBBB|
-            ub = (data[j * LCD_BYTE_PER_PIXEL + 1] << 3);
-            ug = ((data[j * LCD_BYTE_PER_PIXEL] << 5) | ((data[j * LCD_BYTE_PER_PIXEL + 1] & 0xE0) >> 3));
-            ur = (data[j * LCD_BYTE_PER_PIXEL] & 0xF8);
-
-            b = ub - 128;
-            g = ug - 128;
-            r = ur - 128;
-
-            r32 = r32 | ((uint8_t)r << ((cnt)*8));
-            g32 = g32 | ((uint8_t)g << ((cnt)*8));
-            b32 = b32 | ((uint8_t)b << ((cnt)*8));
-
-            // when 4 bytes are packed, write to FIFOs
-            if (cnt == 0)
-			{
-			   while (((*((volatile uint32_t *) 0x50000004) & 1)) != 0); // Wait for FIFO 0
-			   *((volatile uint32_t *) 0x50000008) = r32; // Write FIFO 0
-
-			   while (((*((volatile uint32_t *) 0x50000004) & 2)) != 0); // Wait for FIFO 1
-			   *((volatile uint32_t *) 0x5000000c) = g32; // Write FIFO 1
-
-			   while (((*((volatile uint32_t *) 0x50000004) & 4)) != 0); // Wait for FIFO 2
-			   *((volatile uint32_t *) 0x50000010) = b32; // Write FIFO 2
-
-			   r32 = 0;
-			   g32 = 0;
-			   b32 = 0;
-			   cnt = 3;
-            }
-            else
-            {
-            	cnt--;
-            }
-        }
+static void cnn_load_row(const uint8_t *row)
+{
+    static uint32_t r32[PIC_WIDTH / 3 / 4];
+    static uint32_t g32[PIC_WIDTH / 3 / 4];
+    static uint32_t b32[PIC_WIDTH / 3 / 4];
+
+    // Pick one out of 3 pixels, 192 to 64
+    // CNN needs RGB888, pack four bytes into 1 int for each color
+    rgb565_to_cnn_chw(row, r32, g32, b32, PIC_WIDTH / 3, 3);
+
+    // Write packed words to FIFOs
+    for (int j = 0; j < PIC_WIDTH / 3 / 4; j++) {
+        cnn_loader_fifo_write(0, r32[j]); // Write FIFO 0
+        cnn_loader_fifo_write(1, g32[j]); // Write FIFO 1
+        cnn_loader_fifo_write(2, b32[j]); // Write FIFO 2
     }
+}
 
-
+static void cnn_process_result(void)
+{
+    uint32_t cycles;
 #ifdef PRINT_TIME_CNN
-    PR_TIMER("CNN load : %d", GET_RTC_MS() - pass_time);
-    pass_time = GET_RTC_MS();
+    uint32_t pass_time = GET_RTC_MS();
 #endif
 
     while (cnn_time == 0)
         __WFI(); // Wait for CNN done
+    timing_record_us(TIMING_STAGE_CNN, GET_RTC_US() - cnn_start_us);
 
 #ifdef PRINT_TIME_CNN
     PR_TIMER("CNN wait : %d", GET_RTC_MS() - pass_time);
@@ -795,11 +781,13 @@ static void run_cnn(int x_offset, int y_offset)
 	
 	PR_INFO("load_inference_time: %d us", cnn_time);
 	
+    cycles = timing_cycles();
     cnn_unload((uint32_t*) ml_data);
 
     cnn_stop();
     // Disable CNN clock to save power
     MXC_SYS_ClockDisable(MXC_SYS_PERIPH_CLOCK_CNN);
+    cycles = timing_record(TIMING_STAGE_UNLOAD, cycles);
 
 #ifdef PRINT_TIME_CNN
     PR_TIMER("CNN unload : %d", GET_RTC_MS() - pass_time);
@@ -843,6 +831,8 @@ static void run_cnn(int x_offset, int y_offset)
 	qspi_slave_send_packet((uint8_t *) &classification_result, sizeof(classification_result),
             QSPI_PACKET_TYPE_VIDEO_CLASSIFICATION_RES);
 
+    timing_record(TIMING_STAGE_POSTPROCESS, cycles);
+
     MXC_Delay(MXC_DELAY_MSEC(250));
 
 
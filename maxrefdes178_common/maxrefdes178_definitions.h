@@ -112,13 +112,17 @@
 #define FACEID_RECTANGLE_X2                (FACEID_RECTANGLE_X1 + FACEID_WIDTH)
 #define FACEID_RECTANGLE_Y2                (FACEID_RECTANGLE_Y1 + FACEID_HEIGHT)
 
+// FaceId sets it in its Makefiles, every demo sizes its MAX32666 BLE/QSPI payload buffers from the db size
+#ifndef FACEID_MAX_SUBJECT
 #define FACEID_MAX_SUBJECT                 6
+#endif
 #define FACEID_MAX_PHOTO_PER_SUBJECT       8
 #define FACEID_MAX_SUBJECT_NAME_SIZE       CLASSIFICATION_STRING_SIZE
 #define FACEID_EMBEDDING_SIZE              512
 #define FACEID_MAX_EMBEDDINGS_HEADER_SIZE  (((FACEID_MAX_SUBJECT_NAME_SIZE + 1) * FACEID_MAX_SUBJECT) + 9)
 #define FACEID_MAX_EMBEDDINGS_DATA_SIZE    ((FACEID_EMBEDDING_SIZE + 1) * FACEID_MAX_SUBJECT * FACEID_MAX_PHOTO_PER_SUBJECT)
 #define FACEID_MAX_EMBEDDINGS_SIZE         (FACEID_MAX_EMBEDDINGS_HEADER_SIZE + FACEID_MAX_EMBEDDINGS_DATA_SIZE)
+#define FACEID_EMBEDDINGS_FLASH_SIZE       0x14000  // .embeddings_storage in the video linker script, db and centroid index
 
 // Common CatsDogs
 #define CATSDOGS_WIDTH                     192
@@ -193,6 +197,10 @@
 
 // Common MAX78000s
 #define MAX78000_SLEEP_DEFER_DURATION      30  // s
+#define MAX78000_VIDEO_ML_CREDIT_TIMEOUT   UINT32_C(1000)  // ms
+// OV7692 runs 30 fps at 24 MHz clock, so a frame period is 160 ms at the slowest 5 MHz clock. Waiting for
+// the next frame start and capturing it takes at most 320 ms, this only trips on a stalled camera
+#define MAX78000_VIDEO_CAMERA_FRAME_TIMEOUT UINT32_C(1000)  // ms
 
 /*** MAX32666 ***/
 // MAX32666 PINS
@@ -271,6 +279,8 @@
 // MAX32666 Hardware semaphores
 #define MAX32666_SEMAPHORE_PRINT           1
 #define MAX32666_SEMAPHORE_BLE_QUEUE       2
+#define MAX32666_SEMAPHORE_FRAMEBUFFER     3
+#define MAX32666_SEMAPHORE_LCD_QSPI        4  // LCD DMA on core1 and QSPI TX on core0
 
 // MAX32666 Timers
 #define MAX32666_TIMER_BLE                 MXC_TMR0  // TODO remove
@@ -280,6 +290,9 @@
 
 // MAX32666 BLE Communication buffer
 #define MAX32666_BLE_QUEUE_SIZE            10
+#define MAX32666_BLE_TX_WINDOW             4  // packets in flight, must be smaller than MAX32666_BLE_QUEUE_SIZE
+#define MAX32666_BLE_RESPONSE_QUEUE_SIZE   4  // single packet responses waiting for the tx window
+#define MAX32666_BLE_TX_TRIES              3
 #define MAX32666_BLE_COMMAND_BUFFER_SIZE   FACEID_MAX_EMBEDDINGS_SIZE
 
 // MAX32666 PMIC and Fuel Gauge
@@ -290,9 +303,22 @@
 // MAX32666 Power Accumulator
 #define MAX32666_POWMON_INTERVAL           UINT32_C(5000)  // ms
 
+// MAX32666 QSPI link statistics
+#define MAX32666_QSPI_LINK_STATISTICS_INTERVAL  UINT32_C(5000)  // ms
+#define MAX32666_QSPI_RX_TIMEOUT           UINT32_C(100)  // ms, slave payload ready wait
+
 // MAX32666 LED
 #define MAX32666_LED_INTERVAL              UINT32_C(1000)  // ms
 
+// MAX32666 ML result credit is taken as lost when no mask arrived for this long,
+// longer than a capture and CNN pass plus MAX78000_VIDEO_ML_CREDIT_TIMEOUT
+#define MAX32666_ML_CREDIT_LOSS_TIMEOUT    UINT32_C(3000)  // ms
+
+// MAX32666 MAX78000 clock synchronization
+#define MAX32666_TIME_SYNC_INTERVAL        UINT32_C(500)  // ms
+#define MAX32666_TIME_SYNC_WINDOW          8  // exchanges, the one with the shortest round trip is used
+#define MAX32666_TIME_SYNC_MAX_RTT         UINT32_C(5000)  // us, slower exchanges are dropped
+
 /*** MAX78000 AUDIO ***/
 // MAX78000 AUDIO PINS
 #define MAX78000_AUDIO_HOST_CS_PIN         {MXC_GPIO0, MXC_GPIO_PIN_4, MXC_GPIO_FUNC_IN, MXC_GPIO_PAD_NONE, MXC_GPIO_VSSEL_VDDIO}
@@ -333,6 +359,16 @@
 #define MAX78000_AUDIO_QSPI_DMA_IRQ        DMA1_IRQn
 #define MAX78000_AUDIO_QSPI_DMA_IRQ_HAND   DMA1_IRQHandler
 
+// MAX78000 AUDIO I2S microphone
+#define MAX78000_AUDIO_I2S_DMA_CHANNEL     0
+#define MAX78000_AUDIO_I2S_DMA_IRQ         DMA0_IRQn
+#define MAX78000_AUDIO_I2S_DMA_IRQ_HAND    DMA0_IRQHandler
+
+// MAX78000 AUDIO CNN input loader
+#define MAX78000_AUDIO_CNN_DMA_CHANNEL     2
+#define MAX78000_AUDIO_CNN_DMA_IRQ         DMA2_IRQn
+#define MAX78000_AUDIO_CNN_DMA_IRQ_HAND    DMA2_IRQHandler
+
 // MAX78000 AUDIO I2C SLAVE
 #define MAX78000_AUDIO_I2C                 MXC_I2C0  // TODO
 
@@ -383,6 +419,11 @@
 #define MAX78000_VIDEO_CAMERA_DMA_IRQ      DMA0_IRQn
 #define MAX78000_VIDEO_CAMERA_DMA_IRQ_HAND DMA0_IRQHandler
 
+// MAX78000 VIDEO CNN input loader
+#define MAX78000_VIDEO_CNN_DMA_CHANNEL     2
+#define MAX78000_VIDEO_CNN_DMA_IRQ         DMA2_IRQn
+#define MAX78000_VIDEO_CNN_DMA_IRQ_HAND    DMA2_IRQHandler
+
 // MAX78000 VIDEO I2C SLAVE
 #define MAX78000_VIDEO_I2C                 MXC_I2C0  // TODO
 
@@ -477,6 +518,16 @@ typedef enum {
 	QSPI_PACKET_TYPE_AUDIO_LED_ON_CMD,   // None
 	QSPI_PACKET_TYPE_AUDIO_LED_OFF_CMD,   // None
 
+    QSPI_PACKET_TYPE_VIDEO_ML_CREDIT_CMD,      // None, host can accept one ML result
+
+    QSPI_PACKET_TYPE_VIDEO_TIME_SYNC_CMD,      // None, host keeps its send time
+    QSPI_PACKET_TYPE_VIDEO_TIME_SYNC_RES,      // time_sync_t
+    QSPI_PACKET_TYPE_AUDIO_TIME_SYNC_CMD,      // None, host keeps its send time
+    QSPI_PACKET_TYPE_AUDIO_TIME_SYNC_RES,      // time_sync_t
+    QSPI_PACKET_TYPE_VIDEO_FRAME_TIMESTAMP_RES, // uint32_t capture time of the next frame, MAX78000 clock
+    QSPI_PACKET_TYPE_VIDEO_TIMING_RES,         // stage_timing_t[TIMING_STAGE_LAST]
+    QSPI_PACKET_TYPE_AUDIO_TIMING_RES,         // stage_timing_t[TIMING_STAGE_LAST]
+
     QSPI_PACKET_TYPE_LAST
 } qspi_packet_type_e;
 
@@ -506,7 +557,7 @@ typedef enum {
 
     // Communication
     BLE_COMMAND_ABORT_CMD = 0,           // None
-    BLE_COMMAND_INVALID_RES,             // None
+    BLE_COMMAND_INVALID_RES,             // uint8_t rejected command
     BLE_COMMAND_NOP_CMD,                 // None
     BLE_COMMAND_MTU_CHANGE_RES,          // uint16_t MTU
 
@@ -626,6 +677,9 @@ typedef enum {
     BLE_COMMAND_GET_DEMO_NAME_CMD,         // None
     BLE_COMMAND_GET_DEMO_NAME_RES,         // Demo string
 
+    BLE_COMMAND_GET_TIMING_CMD,            // None
+    BLE_COMMAND_GET_TIMING_RES,            // device_timing_t, multi packet
+
     BLE_COMMAND_LAST
 } ble_command_e;
 
@@ -802,15 +856,59 @@ typedef struct __attribute__((packed)) {
     serial_num_t max78000_audio;
 } device_serial_num_t;
 
+// Pipeline stages with timing histograms, each core records the stages it has
+typedef enum {
+    TIMING_STAGE_CAPTURE = 0,
+    TIMING_STAGE_PREPROCESS,
+    TIMING_STAGE_CNN,
+    TIMING_STAGE_UNLOAD,
+    TIMING_STAGE_POSTPROCESS,
+    TIMING_STAGE_COMMUNICATION,
+    TIMING_STAGE_LAST
+} timing_stage_e;
+
+// Stage duration percentiles
+typedef struct __attribute__((packed)) {
+    uint32_t p50_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} stage_timing_t;
+
+// End-to-end latencies measured on MAX32666 with synchronized MAX78000 timestamps
+typedef enum {
+    LATENCY_VIDEO_FRAME = 0,        // camera capture to frame on LCD
+    LATENCY_VIDEO_CLASSIFICATION,   // camera capture to classification received
+    LATENCY_AUDIO_CLASSIFICATION,   // end of keyword to UI action
+    LATENCY_LAST
+} latency_e;
+
+// Time sync response
+typedef struct __attribute__((packed)) {
+    uint32_t device_rx_us;   // MAX78000 clock when command header was received
+    uint32_t device_tx_us;   // MAX78000 clock when response was sent
+} time_sync_t;
+
+// MAX78000 clock estimate, host time = device time + offset + drift
+typedef struct __attribute__((packed)) {
+    int32_t offset_us;
+    int32_t drift_ppb;
+    uint32_t rtt_us;         // round trip of the exchange the offset is taken from, 0 if not synced
+} time_sync_status_t;
+
 // MAX78000 statistics field
 typedef struct __attribute__((packed)) {
     uint32_t cnn_duration_us;
     uint32_t capture_duration_us;
     uint32_t communication_duration_us;
     uint32_t total_duration_us;
+    uint32_t latency_us;           // audio: end of keyword to classification result
+    uint32_t cpu_duty_permille;    // audio: busy time since last statistics
+    uint32_t cnn_duty_permille;    // audio: CNN time since last statistics
+    uint32_t stream_overflow_count; // video: camera rows dropped since last statistics
 } max78000_statistics_t;
 
-// Statistics command response
+// Statistics command response, sent periodically and kept within one command packet
 typedef struct __attribute__((packed)) {
     max78000_statistics_t max78000_video;
     max78000_statistics_t max78000_audio;
@@ -820,11 +918,22 @@ typedef struct __attribute__((packed)) {
     uint32_t max78000_audio_power_mw;
 } device_statistics_t;
 
+// Timing command response, sent on request only
+typedef struct __attribute__((packed)) {
+    stage_timing_t max78000_video[TIMING_STAGE_LAST];
+    stage_timing_t max78000_audio[TIMING_STAGE_LAST];
+    stage_timing_t max32666[TIMING_STAGE_LAST];
+    time_sync_status_t max78000_video_time_sync;
+    time_sync_status_t max78000_audio_time_sync;
+    stage_timing_t latency[LATENCY_LAST];
+} device_timing_t;
+
 // Classification command response
 typedef struct __attribute__((packed)) {
     float probability;
     classification_e classification;
     char result[CLASSIFICATION_STRING_SIZE];
+    uint32_t capture_timestamp_us;  // MAX78000 clock, frame capture or end of keyword
 } classification_result_t;
 
 // File operation commands file info field
@@ -0,0 +1,199 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <string.h>
+
+#include "maxrefdes178_mic.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+void mic_hpf_init(mic_hpf_t *hpf)
+{
+    hpf->coeff = MIC_HPF_COEFF;
+    hpf->x1 = 0;
+    hpf->y1 = 0;
+}
+
+void mic_hpf(mic_hpf_t *hpf, const int32_t *in, int16_t *out, uint16_t size)
+{
+    int16_t Acc, x0;
+    int32_t tmp, y0;
+
+    /* keep filter state in registers for the whole block */
+    int16_t xPrev = hpf->x1;
+    int32_t yPrev = hpf->y1;
+
+    for (int i = 0; i < size; i++) {
+        /* The actual value is 18 MSB of 32-bit word */
+        x0 = in[i] >> 14;
+
+        tmp = (hpf->coeff * yPrev);
+        Acc = (int16_t)((tmp + (1 << 14)) >> 15);
+        y0 = x0 - xPrev + Acc;
+
+        /* Clipping */
+        if (y0 > 32767) {
+            y0 = 32767;
+        }
+
+        if (y0 < -32768) {
+            y0 = -32768;
+        }
+
+        out[i] = (int16_t)y0;
+
+        yPrev = y0;
+        xPrev = x0;
+    }
+
+    /* Update filter state */
+    hpf->y1 = yPrev;
+    hpf->x1 = xPrev;
+}
+
+uint16_t mic_chunk(const int16_t *in, uint8_t *out, uint16_t size, int32_t scale, int16_t *max, int16_t *min)
+{
+    uint32_t sum = 0;
+    int32_t sample;
+    int16_t temp;
+
+    for (int i = 0; i < size; i++) {
+        sample = in[i];
+
+        /* absolute for averaging */
+        if (sample >= 0)
+            sum += sample;
+        else
+            sum -= sample;
+
+        /* Convert to 8 bit unsigned */
+        out[i] = (uint8_t)((sample)*scale/256);
+
+        temp=(int8_t)out[i];
+
+        /* record max and min */
+        if (temp > *max) {
+            *max = temp;
+        }
+
+        if (temp < *min) {
+            *min = temp;
+        }
+    }
+
+    return (uint16_t)(sum / size);
+}
+
+int mic_transpose(uint16_t *row, const uint8_t *in, uint8_t *out, uint16_t in_size,
+        uint16_t out_size, uint16_t width)
+{
+    /* Data order in Ai85 memory (transpose is included):
+	input(series of 8 bit samples): (0,0) ...  (0,127)  (1,0) ... (1,127) ...... (127,0)...(127,127)    16384 samples
+	output (32bit word): 16K samples in a buffer. Later, each 1K goes to a separate CNN memory group
+	0x0000:
+		(0,3)(0,2)(0,1)(0,0)
+		(0,67)(0,66)(0,65)(0,64)
+		(1,3)(1,2)(1,1)(1,0)
+		(1,67)(1,66)(1,65)(1,64)
+		....
+		(127,67)(127,66)(127,65)(127,64)
+	0x0400:
+		(0,7)(0,6)(0,5)(0,4)
+		(0,71)(0,70)(0,69)(0,68)
+		....
+		(127,71)(127,70)(127,69)(127,68)
+	...
+	0x3C00:
+		(0,63)(0,62)(0,61)(0,60)
+		(0,127)(0,126)(0,125)(0,124)
+		....
+		(127,127)(127,126)(127,125)(127,124)
+     */
+
+    /* Samples arrive as whole rows, so each row is copied as 4-byte words.
+     * First half of a row goes to even word rows, second half to odd word rows */
+    uint16_t half = width >> 1;
+    uint16_t group;
+
+    if (in_size % width) {
+        return MIC_TRANSPOSE_ERROR;
+    }
+
+    for (int i = 0; i < in_size; i += width) {
+        /* do not write beyond output buffer, rows left over are dropped */
+        if (*row >= (out_size / width)) {
+            break;
+        }
+
+        for (group = 0; group < (half / 4); group++) {
+            memcpy(&out[1024 * group + 8 * *row], &in[i + 4 * group], 4);
+            memcpy(&out[1024 * group + 8 * *row + 4], &in[i + half + 4 * group], 4);
+        }
+
+        (*row)++;
+    }
+
+    if ((*row * width) >= out_size) {
+        *row = 0;
+        return MIC_TRANSPOSE_DONE;
+    }
+
+    return MIC_TRANSPOSE_PARTIAL;
+}
@@ -0,0 +1,83 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _MAXREFDES178_MIC_H_
+#define _MAXREFDES178_MIC_H_
+
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define MIC_HPF_COEFF           32604   // 0.995 in Q15, 100 Hz cutoff at 16 kHz
+
+// mic_transpose return values
+#define MIC_TRANSPOSE_ERROR     (-1)
+#define MIC_TRANSPOSE_PARTIAL   0
+#define MIC_TRANSPOSE_DONE      1
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+// 1st order IIR high pass filter state, y(n) = x(n) - x(n-1) + A*y(n-1)
+typedef struct {
+    int16_t coeff;
+    int16_t x1;
+    int32_t y1;
+} mic_hpf_t;
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+void mic_hpf_init(mic_hpf_t *hpf);
+// Filters a block of I2S words, the microphone sample is in the 18 MSBs of each word. Output is clipped to 16 bits
+void mic_hpf(mic_hpf_t *hpf, const int32_t *in, int16_t *out, uint16_t size);
+// Converts filtered samples to 8 bits as sample * scale / 256, updates max and min of the 8-bit samples.
+// Returns the mean absolute value of the 16-bit samples
+uint16_t mic_chunk(const int16_t *in, uint8_t *out, uint16_t size, int32_t scale, int16_t *max, int16_t *min);
+// Appends in_size samples, a multiple of width, to the transposed CNN input at *row.
+// Returns MIC_TRANSPOSE_DONE and rewinds *row once out_size samples are collected, samples past out_size are dropped
+int mic_transpose(uint16_t *row, const uint8_t *in, uint8_t *out, uint16_t in_size,
+        uint16_t out_size, uint16_t width);
+
+
+#endif /* _MAXREFDES178_MIC_H_ */
@@ -0,0 +1,159 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <string.h>
+
+#include "maxrefdes178_rgb565.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include <mxc_device.h>
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+// Two pixels in one word, low halfword is the first pixel. Each component ends up
+// in the low byte of its halfword lane, already scaled to 8 bits
+#define RGB565_R(w)     ((w) & 0x00F800F8)
+#define RGB565_G(w)     ((((w) & 0x00070007) << 5) | (((w) & 0xE000E000) >> 11))
+#define RGB565_B(w)     (((w) & 0x1F001F00) >> 5)
+
+// x - 128 of an unsigned byte is x ^ 0x80
+#define RGB565_SIGNED4  0x80808080
+#define RGB565_SIGNED2  0x00800080
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define RGB565_PKHBT(a, b)  __PKHBT((a), (b), 16)
+#define RGB565_PKHTB(a, b)  __PKHTB((a), (b), 16)
+#define RGB565_REV(a)       __REV(a)
+#else
+#define RGB565_PKHBT(a, b)  (((a) & 0x0000FFFF) | ((b) << 16))
+#define RGB565_PKHTB(a, b)  (((a) & 0xFFFF0000) | ((b) >> 16))
+#define RGB565_REV(a)       __builtin_bswap32(a)
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+static inline uint32_t load16(const uint8_t *src)
+{
+    uint16_t val;
+
+    memcpy(&val, src, sizeof(val));
+    return val;
+}
+
+static inline uint32_t load32(const uint8_t *src)
+{
+    uint32_t val;
+
+    memcpy(&val, src, sizeof(val));
+    return val;
+}
+
+// Load two pixels, src and src + step
+static inline uint32_t load_pair(const uint8_t *src, uint32_t step)
+{
+    if (step == 1) {
+        return load32(src);
+    }
+
+    return RGB565_PKHBT(load16(src), load16(src + 2 * step));
+}
+
+void rgb565_to_cnn_hwc(const uint8_t *src, uint32_t *dst, uint32_t count, uint32_t step)
+{
+    uint32_t w, rg, b;
+
+    for (; count >= 2; count -= 2) {
+        w = load_pair(src, step);
+        src += 4 * step;
+
+        rg = (RGB565_R(w) | (RGB565_G(w) << 8)) ^ RGB565_SIGNED4;
+        b = RGB565_B(w) ^ RGB565_SIGNED2;
+
+        *dst++ = RGB565_PKHBT(rg, b);
+        *dst++ = RGB565_PKHTB(b, rg);
+    }
+
+    if (count) {
+        w = load16(src);
+
+        rg = (RGB565_R(w) | (RGB565_G(w) << 8)) ^ RGB565_SIGNED4;
+        b = RGB565_B(w) ^ RGB565_SIGNED2;
+
+        *dst = (rg & 0x0000FFFF) | (b << 16);
+    }
+}
+
+void rgb565_to_cnn_chw(const uint8_t *src, uint32_t *dst_r, uint32_t *dst_g, uint32_t *dst_b,
+        uint32_t count, uint32_t step)
+{
+    uint32_t w01, w23, w02, w13;
+
+    for (; count >= 4; count -= 4) {
+        w01 = load_pair(src, step);
+        w23 = load_pair(src + 4 * step, step);
+        src += 8 * step;
+
+        // p0 and p2 in one word, p1 and p3 in the other, so one OR puts p0..p3 into bytes 0..3
+        w02 = RGB565_PKHBT(w01, w23);
+        w13 = RGB565_PKHTB(w23, w01);
+
+        *dst_r++ = RGB565_REV(RGB565_R(w02) | (RGB565_R(w13) << 8)) ^ RGB565_SIGNED4;
+        *dst_g++ = RGB565_REV(RGB565_G(w02) | (RGB565_G(w13) << 8)) ^ RGB565_SIGNED4;
+        *dst_b++ = RGB565_REV(RGB565_B(w02) | (RGB565_B(w13) << 8)) ^ RGB565_SIGNED4;
+    }
+}
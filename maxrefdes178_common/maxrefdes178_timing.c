@@ -0,0 +1,203 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <string.h>
+
+#include "maxrefdes178_timing.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+// Histogram counts are halved when a stage reaches this many samples,
+// percentiles follow the last few hundred samples instead of the whole uptime
+#define TIMING_WINDOW           1024
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static timing_histogram_t histogram[TIMING_STAGE_LAST];
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+static uint32_t timing_bucket(uint32_t duration_us);
+static uint32_t timing_bucket_limit(uint32_t bucket);
+static uint32_t timing_percentile(timing_histogram_t *hist, uint32_t permille);
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+void timing_init(void)
+{
+    timing_cycles_init();
+
+    memset(histogram, 0, sizeof(histogram));
+}
+
+void timing_cycles_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void timing_record_us(timing_stage_e stage, uint32_t duration_us)
+{
+    if (stage >= TIMING_STAGE_LAST) {
+        return;
+    }
+
+    timing_histogram_record(&histogram[stage], duration_us);
+}
+
+uint32_t timing_record(timing_stage_e stage, uint32_t start_cycles)
+{
+    uint32_t now = timing_cycles();
+
+    timing_record_us(stage, timing_cycles_to_us(now - start_cycles));
+
+    return now;
+}
+
+void timing_get(stage_timing_t *stage_timing)
+{
+    for (uint32_t stage = 0; stage < TIMING_STAGE_LAST; stage++) {
+        timing_histogram_get(&histogram[stage], &stage_timing[stage]);
+    }
+}
+
+void timing_histogram_record(timing_histogram_t *hist, uint32_t duration_us)
+{
+    if (hist->count >= TIMING_WINDOW) {
+        hist->count = 0;
+        for (uint32_t i = 0; i < TIMING_BUCKET_COUNT; i++) {
+            hist->bucket[i] >>= 1;
+            hist->count += hist->bucket[i];
+        }
+    }
+
+    hist->bucket[timing_bucket(duration_us)]++;
+    hist->count++;
+
+    if (duration_us > hist->max_us) {
+        hist->max_us = duration_us;
+    }
+}
+
+void timing_histogram_get(timing_histogram_t *hist, stage_timing_t *stage_timing)
+{
+    stage_timing->p50_us = timing_percentile(hist, 500);
+    stage_timing->p90_us = timing_percentile(hist, 900);
+    stage_timing->p99_us = timing_percentile(hist, 990);
+    stage_timing->max_us = hist->max_us;
+
+    hist->max_us = 0;
+}
+
+static uint32_t timing_bucket(uint32_t duration_us)
+{
+    uint32_t shift;
+
+    if (duration_us < (1 << TIMING_SUB_BITS)) {
+        return duration_us;
+    }
+
+    if (duration_us >= (1 << TIMING_MAX_BITS)) {
+        return TIMING_BUCKET_COUNT - 1;
+    }
+
+    // Position of the leading one above the sub-bucket bits
+    shift = (31 - __builtin_clz(duration_us)) - TIMING_SUB_BITS;
+
+    return ((shift + 1) << TIMING_SUB_BITS) + ((duration_us >> shift) & ((1 << TIMING_SUB_BITS) - 1));
+}
+
+// Largest duration that falls into the bucket
+static uint32_t timing_bucket_limit(uint32_t bucket)
+{
+    uint32_t shift;
+    uint32_t mantissa;
+
+    if (bucket < (1 << TIMING_SUB_BITS)) {
+        return bucket;
+    }
+
+    shift = (bucket >> TIMING_SUB_BITS) - 1;
+    mantissa = (bucket & ((1 << TIMING_SUB_BITS) - 1)) | (1 << TIMING_SUB_BITS);
+
+    return ((mantissa + 1) << shift) - 1;
+}
+
+static uint32_t timing_percentile(timing_histogram_t *hist, uint32_t permille)
+{
+    uint32_t target;
+    uint32_t sum = 0;
+    uint32_t limit;
+    uint32_t i;
+
+    if (hist->count == 0) {
+        return 0;
+    }
+
+    // Smallest bucket that covers permille of the samples
+    target = (hist->count * permille + 999) / 1000;
+
+    for (i = 0; i < TIMING_BUCKET_COUNT - 1; i++) {
+        sum += hist->bucket[i];
+        if (sum >= target) {
+            break;
+        }
+    }
+
+    // Bucket limit overestimates, never report above the exact maximum
+    limit = timing_bucket_limit(i);
+    if (hist->max_us && (limit > hist->max_us)) {
+        limit = hist->max_us;
+    }
+
+    return limit;
+}
@@ -0,0 +1,100 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _MAXREFDES178_TIMING_H_
+#define _MAXREFDES178_TIMING_H_
+
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <mxc_device.h>
+#include <stdint.h>
+
+#include "maxrefdes178_definitions.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+// Log-linear buckets, each power of two is split into 2^TIMING_SUB_BITS buckets (max 25% error).
+// Durations up to 2^TIMING_MAX_BITS us (16.7 s) are kept, longer ones land in the last bucket
+#define TIMING_SUB_BITS         2
+#define TIMING_MAX_BITS         24
+#define TIMING_BUCKET_COUNT     ((TIMING_MAX_BITS - TIMING_SUB_BITS + 1) << TIMING_SUB_BITS)
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+typedef struct {
+    uint16_t bucket[TIMING_BUCKET_COUNT];
+    uint16_t count;
+    uint32_t max_us;
+} timing_histogram_t;
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+// Enable DWT cycle counter and clear histograms
+void timing_init(void);
+// Enable DWT cycle counter of the calling core only, e.g. MAX32666 core1
+void timing_cycles_init(void);
+
+// Add one stage duration to the stage histogram
+void timing_record_us(timing_stage_e stage, uint32_t duration_us);
+// Add cycles elapsed since start_cycles, returns current cycle count to chain stages
+uint32_t timing_record(timing_stage_e stage, uint32_t start_cycles);
+
+// Percentiles of all stages, max is reset after read. Stages without samples read as 0
+void timing_get(stage_timing_t *stage_timing);
+
+// Same as above for histograms owned by the caller, e.g. end-to-end latencies
+void timing_histogram_record(timing_histogram_t *hist, uint32_t duration_us);
+void timing_histogram_get(timing_histogram_t *hist, stage_timing_t *stage_timing);
+
+static inline uint32_t timing_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+static inline uint32_t timing_cycles_to_us(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000);
+}
+
+
+#endif /* _MAXREFDES178_TIMING_H_ */
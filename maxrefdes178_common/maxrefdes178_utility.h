@@ -50,9 +50,20 @@
 #define GPIO_CLR(x)         MXC_GPIO_OutClr(x.port, x.mask)
 
 #define GET_RTC_MS()        ((MXC_RTC_GetSecond() * 1000) + (( MXC_RTC_GetSubSecond() / 4096.0)*1000))
+// 244 us resolution, wraps every 71 minutes, use only for differences and time sync.
+// Read again if the seconds rolled over while the sub-seconds were read
+#define GET_RTC_US()        ({                                              \
+        uint32_t rtc_sec_, rtc_ssec_;                                       \
+        do {                                                                \
+            rtc_sec_ = MXC_RTC_GetSecond();                                 \
+            rtc_ssec_ = MXC_RTC_GetSubSecond();                             \
+        } while (rtc_sec_ != (uint32_t) MXC_RTC_GetSecond());               \
+        (rtc_sec_ * 1000000) + ((rtc_ssec_ * 1000000) >> 12); })
 
 #define MIN(x, y) (((x) < (y)) ? (x) : (y))
 
+#define CRC16_INIT_VALUE    0x0000
+
 
 //-----------------------------------------------------------------------------
 // Typedefs
@@ -62,7 +73,11 @@
 //-----------------------------------------------------------------------------
 // Function declarations
 //-----------------------------------------------------------------------------
-uint16_t crc16_sw(uint8_t *data, uint8_t len);
+// CRC-16 0xA001, can be fed chunk by chunk: crc16_final(crc16_update(crc16_update(crc16_init(), a, n), b, m))
+uint16_t crc16_init(void);
+uint16_t crc16_update(uint16_t crc, const uint8_t *data, uint32_t len);
+uint16_t crc16_final(uint16_t crc);
+uint16_t crc16_sw(const uint8_t *data, uint32_t len);
 
 
 #endif /* _MAXREFDES178_UTILITY_H_ */
@@ -0,0 +1,382 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+
+// QSPI link between the MAX32666 and both MAX78000s, running the real master and slave drivers
+// against emulated CS, R/W and INT lines and DMA. Without arguments a clean and a faulty link are
+// checked, "bench" sweeps the QSPI clock and faults, options run and report a single configuration.
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <getopt.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "test_common.h"
+#include "sim.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define PACKET_NAME(type)   [QSPI_PACKET_TYPE_##type] = #type
+
+// A lost CS edge stalls the video slave until its wait loop times out, a few hundred ms
+#define SIM_RECOVERY_NS     UINT64_C(1500000000)
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+typedef struct {
+    const char *name;
+    uint32_t qspi_hz;
+    double cs_drop;
+    double corrupt;
+} bench_run_t;
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static const char *packet_names[QSPI_PACKET_TYPE_LAST] = {
+    PACKET_NAME(VIDEO_VERSION_CMD),
+    PACKET_NAME(VIDEO_VERSION_RES),
+    PACKET_NAME(AUDIO_VERSION_CMD),
+    PACKET_NAME(AUDIO_VERSION_RES),
+    PACKET_NAME(VIDEO_DATA_RES),
+    PACKET_NAME(VIDEO_CLASSIFICATION_RES),
+    PACKET_NAME(VIDEO_STATISTICS_RES),
+    PACKET_NAME(AUDIO_CLASSIFICATION_RES),
+    PACKET_NAME(AUDIO_STATISTICS_RES),
+    PACKET_NAME(TEST),
+    PACKET_NAME(VIDEO_TIME_SYNC_CMD),
+    PACKET_NAME(VIDEO_TIME_SYNC_RES),
+    PACKET_NAME(AUDIO_TIME_SYNC_CMD),
+    PACKET_NAME(AUDIO_TIME_SYNC_RES),
+    PACKET_NAME(VIDEO_FRAME_TIMESTAMP_RES),
+};
+
+static const char *chip_names[SIM_CHIPS] = {"host", "video", "audio"};
+
+static const bench_run_t bench_runs[] = {
+    {"clean",   7500000,  0,     0},
+    {"clean",   10000000, 0,     0},
+    {"clean",   12000000, 0,     0},
+    {"cs-drop", 10000000, 0.005, 0},
+    {"corrupt", 10000000, 0,     0.01},
+    {"both",    10000000, 0.005, 0.01},
+};
+
+static const struct option options[] = {
+    {"duration",        required_argument, NULL, 'd'},
+    {"rate",            required_argument, NULL, 'r'},
+    {"latency-ns",      required_argument, NULL, 'l'},
+    {"cs-drop",         required_argument, NULL, 'c'},
+    {"corrupt",         required_argument, NULL, 'x'},
+    {"frame-period-us", required_argument, NULL, 'f'},
+    {"tx-interval-ms",  required_argument, NULL, 't'},
+    {"tx-size",         required_argument, NULL, 's'},
+    {"no-audio",        no_argument,       NULL, 'n'},
+    {"seed",            required_argument, NULL, 'S'},
+    {"quantum-us",      required_argument, NULL, 'q'},
+    {"loop-ns",         required_argument, NULL, 'L'},
+    {"verbose",         no_argument,       NULL, 'v'},
+    {"help",            no_argument,       NULL, 'h'},
+    {NULL, 0, NULL, 0},
+};
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+static void usage(const char *prog)
+{
+    printf("usage: %s [bench] [options]\n"
+           "  -d, --duration S          virtual seconds to simulate (%.1f)\n"
+           "  -r, --rate HZ             QSPI clock (%u)\n"
+           "  -l, --latency-ns NS       CS, R/W and INT edge latency (%u)\n"
+           "  -c, --cs-drop P           probability a CS edge interrupt is lost\n"
+           "  -x, --corrupt P           probability a transfer has a bit flipped\n"
+           "  -f, --frame-period-us US  video frame interval, 0 back to back\n"
+           "  -t, --tx-interval-ms MS   host test packet interval, 0 disables (%u)\n"
+           "  -s, --tx-size BYTES       host test packet size (%u)\n"
+           "  -n, --no-audio            leave the audio MAX78000 out\n"
+           "  -S, --seed N              fault injection seed\n"
+           "  -q, --quantum-us US       host time a busy loop runs before it is preempted (%u)\n"
+           "  -L, --loop-ns NS          target time of one busy wait iteration (%u)\n"
+           "  -v, --verbose             print firmware logs\n",
+           prog, sim_config.duration_s, sim_config.qspi_hz, sim_config.gpio_latency_ns,
+           sim_config.tx_interval_ms, sim_config.tx_size, sim_config.quantum_us, sim_config.target_loop_ns);
+}
+
+static uint32_t packets_received(int sender, int type)
+{
+    if (sender == SIM_CHIP_MASTER) {
+        return sim_received[SIM_CHIP_VIDEO][type].packets + sim_received[SIM_CHIP_AUDIO][type].packets;
+    }
+
+    return sim_received[SIM_CHIP_MASTER][type].packets;
+}
+
+static double payload_bytes_per_s(void)
+{
+    double bytes = 0;
+
+    for (int chip = 0; chip < SIM_CHIPS; chip++) {
+        for (int type = 0; type < QSPI_PACKET_TYPE_LAST; type++) {
+            if (sim_sent[chip][type].packets) {
+                bytes += (double) packets_received(chip, type) * sim_sent[chip][type].bytes / sim_sent[chip][type].packets;
+            }
+        }
+    }
+
+    return bytes / sim_config.duration_s;
+}
+
+// Received packets of each type, bytes are payload bytes and use the average sent size
+static void report(void)
+{
+    char name[16];
+
+    printf("qspi %.1f MHz, %.1f s, gpio latency %u ns, cs drop %g, corrupt %g\n",
+           sim_config.qspi_hz / 1e6, sim_config.duration_s, sim_config.gpio_latency_ns,
+           sim_config.cs_drop, sim_config.corrupt);
+    printf("  %-26s %-6s %9s %9s %10s %12s\n", "packet", "from", "sent", "received", "packets/s", "bytes/s");
+
+    for (int chip = 0; chip < SIM_CHIPS; chip++) {
+        for (int type = 0; type < QSPI_PACKET_TYPE_LAST; type++) {
+            sim_counter_t *sent = &sim_sent[chip][type];
+            uint32_t received = packets_received(chip, type);
+
+            if (!sent->packets) {
+                continue;
+            }
+            if (!packet_names[type]) {
+                snprintf(name, sizeof(name), "%d", type);
+            }
+
+            printf("  %-26s %-6s %9u %9u %10.1f %12.0f\n", packet_names[type] ? packet_names[type] : name,
+                   chip_names[chip], sent->packets, received, received / sim_config.duration_s,
+                   (double) received * sent->bytes / sent->packets / sim_config.duration_s);
+        }
+    }
+
+    printf("  payload %.0f bytes/s, bus %.0f bytes/s (%.1f%% of %.0f), idle %llu bytes\n",
+           payload_bytes_per_s(), sim_stats.bytes / sim_config.duration_s,
+           100.0 * sim_stats.bytes / sim_config.duration_s / (sim_config.qspi_hz / 2.0), sim_config.qspi_hz / 2.0,
+           (unsigned long long) sim_stats.idle_bytes);
+    printf("  frames corrupted %u dropped %u, cs edges %u dropped %u, transfers corrupted %u, conflicts %u\n",
+           sim_frames_corrupted, sim_frames_dropped, sim_stats.cs_edges, sim_stats.cs_dropped,
+           sim_stats.corrupted, sim_stats.conflicts);
+    for (int chip = 0; chip < SIM_CHIPS; chip++) {
+        printf("  %-6s rx errors %u, tx errors %u, log warnings %u errors %u\n", chip_names[chip],
+               sim_rx_errors[chip], sim_tx_errors[chip], sim_stats.warnings[chip], sim_stats.errors[chip]);
+    }
+    printf("  %u preemptions\n", sim_stats.preemptions);
+}
+
+static int simulate(void)
+{
+    sim_master_setup();
+    sim_video_setup();
+    if (sim_config.audio) {
+        sim_audio_setup();
+    }
+
+    return sim_run();
+}
+
+// Driver state is static, every run gets a fresh process
+static int run_forked(int (*fn)(void))
+{
+    int status;
+    pid_t pid;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return 1;
+    }
+    if (pid == 0) {
+        test_fail_count = 0;
+        exit(fn());
+    }
+
+    if ((waitpid(pid, &status, 0) < 0) || !WIFEXITED(status)) {
+        printf("simulation crashed\n");
+        return 1;
+    }
+
+    return WEXITSTATUS(status);
+}
+
+static int run_single(void)
+{
+    if (simulate()) {
+        return 1;
+    }
+    report();
+
+    return 0;
+}
+
+static int run_clean(void)
+{
+    if (simulate()) {
+        return 1;
+    }
+
+    CHECK(sim_received[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_VIDEO_VERSION_RES].packets == 1, "video version");
+    CHECK(sim_received[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_AUDIO_VERSION_RES].packets == 1, "audio version");
+    CHECK(sim_received[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_VIDEO_DATA_RES].packets >= 20, "%u frames",
+          sim_received[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_VIDEO_DATA_RES].packets);
+    CHECK(sim_received[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_AUDIO_CLASSIFICATION_RES].packets >= 10, "%u audio results",
+          sim_received[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_AUDIO_CLASSIFICATION_RES].packets);
+    CHECK(sim_received[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_VIDEO_TIME_SYNC_RES].packets >= 1, "video time sync");
+    CHECK(sim_received[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_AUDIO_TIME_SYNC_RES].packets >= 1, "audio time sync");
+    CHECK(sim_sent[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_TEST].packets >= 10, "%u test packets sent",
+          sim_sent[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_TEST].packets);
+    CHECK(sim_received[SIM_CHIP_VIDEO][QSPI_PACKET_TYPE_TEST].packets + 1 >= sim_sent[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_TEST].packets,
+          "%u of %u test packets received", sim_received[SIM_CHIP_VIDEO][QSPI_PACKET_TYPE_TEST].packets,
+          sim_sent[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_TEST].packets);
+    CHECK(sim_frames_corrupted == 0, "%u frames corrupted", sim_frames_corrupted);
+    CHECK(sim_stats.conflicts == 0, "%u bus conflicts", sim_stats.conflicts);
+    // Error logs are not counted, the host logs its deferred command retries as errors
+    for (int chip = 0; chip < SIM_CHIPS; chip++) {
+        CHECK(!sim_rx_errors[chip] && !sim_tx_errors[chip], "%s rx %u tx %u errors", chip_names[chip],
+              sim_rx_errors[chip], sim_tx_errors[chip]);
+    }
+
+    if (test_fail_count) {
+        report();
+    }
+
+    return test_fail_count;
+}
+
+// Lost CS edges and corrupted transfers cost packets, the link has to keep recovering.
+static int run_faults(void)
+{
+    uint64_t end_ns = (uint64_t) (sim_config.duration_s * 1e9);
+
+    if (simulate()) {
+        return 1;
+    }
+
+    CHECK(sim_stats.cs_dropped && sim_stats.corrupted, "faults injected %u %u", sim_stats.cs_dropped, sim_stats.corrupted);
+    CHECK(sim_received[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_VIDEO_DATA_RES].packets >= 20, "%u frames",
+          sim_received[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_VIDEO_DATA_RES].packets);
+    CHECK(sim_last_frame_ns + SIM_RECOVERY_NS >= end_ns, "last frame at %.3f s", sim_last_frame_ns / 1e9);
+    CHECK(sim_received[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_AUDIO_CLASSIFICATION_RES].packets >= 10, "%u audio results",
+          sim_received[SIM_CHIP_MASTER][QSPI_PACKET_TYPE_AUDIO_CLASSIFICATION_RES].packets);
+    // Payload crc rejects the frames hit by a bit flip
+    CHECK(sim_frames_corrupted == 0, "%u frames corrupted", sim_frames_corrupted);
+    CHECK(sim_stats.conflicts == 0, "%u bus conflicts", sim_stats.conflicts);
+
+    if (test_fail_count) {
+        report();
+    }
+
+    return test_fail_count;
+}
+
+static int run_bench(void)
+{
+    int failed = 0;
+
+    for (int i = 0; i < sizeof(bench_runs) / sizeof(bench_runs[0]); i++) {
+        sim_config.qspi_hz = bench_runs[i].qspi_hz;
+        sim_config.cs_drop = bench_runs[i].cs_drop;
+        sim_config.corrupt = bench_runs[i].corrupt;
+        printf("\n%s\n", bench_runs[i].name);
+        failed |= run_forked(run_single);
+    }
+
+    return failed;
+}
+
+int main(int argc, char **argv)
+{
+    int bench = test_bench_mode(argc, argv);
+    int single = 0;
+    int opt;
+
+    if (bench) {
+        argc--;
+        argv++;
+    }
+
+    while ((opt = getopt_long(argc, argv, "d:r:l:c:x:f:t:s:nS:q:L:vh", options, NULL)) != -1) {
+        single = 1;
+        switch (opt) {
+        case 'd': sim_config.duration_s = atof(optarg); break;
+        case 'r': sim_config.qspi_hz = strtoul(optarg, NULL, 0); break;
+        case 'l': sim_config.gpio_latency_ns = strtoul(optarg, NULL, 0); break;
+        case 'c': sim_config.cs_drop = atof(optarg); break;
+        case 'x': sim_config.corrupt = atof(optarg); break;
+        case 'f': sim_config.frame_period_us = strtoul(optarg, NULL, 0); break;
+        case 't': sim_config.tx_interval_ms = strtoul(optarg, NULL, 0); break;
+        case 's': sim_config.tx_size = strtoul(optarg, NULL, 0); break;
+        case 'n': sim_config.audio = 0; break;
+        case 'S': sim_config.seed = strtoul(optarg, NULL, 0); break;
+        case 'q': sim_config.quantum_us = strtoul(optarg, NULL, 0); break;
+        case 'L': sim_config.target_loop_ns = strtoul(optarg, NULL, 0); break;
+        case 'v': sim_config.verbose = 1; break;
+        default:
+            usage(argv[0]);
+            return (opt == 'h') ? 0 : 2;
+        }
+    }
+
+    if (bench) {
+        return run_bench();
+    }
+
+    if (single) {
+        return run_forked(run_single);
+    }
+
+    CHECK(run_forked(run_clean) == 0, "clean link");
+
+    sim_config.duration_s = 3.0;
+    sim_config.cs_drop = 0.005;
+    sim_config.corrupt = 0.01;
+    CHECK(run_forked(run_faults) == 0, "faulty link");
+
+    return test_result("qspi_sim");
+}
@@ -0,0 +1,1119 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#define _GNU_SOURCE     // gettid, SIGEV_THREAD_ID
+
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <dma.h>
+#include <gpio.h>
+#include <mxc_device.h>
+#include <spi.h>
+
+#include "sim.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define SIM_EVENTS_MAX          256
+#define SIM_WIRES_MAX           16
+#define SIM_SLAVES_MAX          2
+#define SIM_GPIO_SLOTS          16
+#define SIM_STACK_SIZE          (512 * 1024)
+
+// Interrupt sources of a chip, lower ones are served first
+#define SIM_IRQ_DMA(ch)         (ch)
+#define SIM_IRQ_GPIO(slot)      (SIM_DMA_CHANNELS + (slot))
+#define SIM_IRQ_TIMER           (SIM_DMA_CHANNELS + SIM_GPIO_SLOTS)
+#define SIM_IRQ_SOURCES         (SIM_IRQ_TIMER + 1)
+
+#define SIM_POLL_NS             500     // virtual time of one DWT read, e.g. in a cycle counter wait
+#define SIM_BUS_IDLE            0xff    // quad lines are pulled up while no slave drives them
+
+#define SIM_REQUEST(cfg)        (((cfg) & MXC_F_DMA_CFG_REQSEL) >> MXC_F_DMA_CFG_REQSEL_POS)
+#define SIM_REQUEST_TX          0x20
+
+#define SIM_PTR(addr)           ((uint8_t *) (uintptr_t) (addr))
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+typedef enum {
+    SIM_CHIP_STOPPED = 0,
+    SIM_CHIP_READY,
+    SIM_CHIP_RUNNING,
+    SIM_CHIP_WFI,       // until an interrupt
+    SIM_CHIP_TIMED,     // until wake_ns, or an interrupt if isr_wake
+} sim_chip_state_e;
+
+typedef struct {
+    void (*fn)(void *);
+    void *arg;
+    int spin_wake;      // wakes a preempted busy loop, the timer tick does not
+} sim_irq_t;
+
+typedef struct {
+    mxc_gpio_regs_t *port;
+    uint32_t mask;
+    mxc_gpio_int_pol_t pol;
+    int enabled;
+} sim_gpio_slot_t;
+
+typedef struct {
+    const char *name;
+    void (*entry)(void);
+    pthread_t thread;
+    sem_t run;
+    sem_t *resumer;             // semaphore of the context that resumed the chip
+    timer_t quantum_timer;
+
+    volatile sim_chip_state_e state;
+    uint64_t wake_ns;
+    int isr_wake;
+
+    volatile int primask;
+    volatile int in_isr;
+    uint64_t pending;
+    sim_irq_t irq[SIM_IRQ_SOURCES];
+    sim_gpio_slot_t gpio[SIM_GPIO_SLOTS];
+
+    volatile sig_atomic_t preempt_pending;
+    sim_dwt_t dwt;
+    uint64_t rtc_offset_ns;
+} sim_chip_t;
+
+typedef struct {
+    uint64_t t;
+    uint64_t seq;
+    void (*fn)(void *arg, uint32_t value);
+    void *arg;
+    uint32_t value;
+} sim_event_t;
+
+typedef struct {
+    mxc_gpio_regs_t *out;
+    uint32_t out_mask;
+    mxc_gpio_regs_t *in;
+    uint32_t in_mask;
+    int cs;
+} sim_wire_t;
+
+typedef struct {
+    int chip;
+    const mxc_gpio_cfg_t *cs;
+    mxc_spi_regs_t *spi;
+    uint8_t ch;
+} sim_slave_t;
+
+typedef struct {
+    int chip;
+    uint64_t period_ns;
+} sim_timer_t;
+
+typedef struct {
+    sim_chip_t chips[SIM_CHIPS];
+    int rr;
+    uint64_t now;
+    uint64_t end;
+    uint64_t spin_ns;
+    sem_t sched;
+
+    sim_event_t events[SIM_EVENTS_MAX];
+    int event_count;
+    uint64_t event_seq;
+
+    sim_wire_t wires[SIM_WIRES_MAX];
+    int wire_count;
+
+    mxc_spi_regs_t *master_spi;
+    uint8_t master_ch;
+    sim_slave_t slaves[SIM_SLAVES_MAX];
+    int slave_count;
+    int bus_active;
+    uint32_t bus_len;
+
+    sim_timer_t timers[SIM_CHIPS];
+    uint32_t rand_state;
+} sim_t;
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+mxc_gpio_regs_t sim_gpio[SIM_CHIPS][SIM_GPIO_PORTS];
+mxc_spi_regs_t sim_spi[SIM_CHIPS][SIM_SPI_INSTANCES];
+sim_dma_max32665_regs_t sim_dma_max32665;
+sim_dma_max78000_regs_t sim_dma_max78000[SIM_CHIPS];
+sim_scb_t sim_scb[SIM_CHIPS];
+sim_core_debug_t sim_core_debug;
+uint32_t sim_core_clock[SIM_CHIPS] = {96000000, 100000000, 100000000};
+
+sim_config_t sim_config = {
+    .duration_s = 2.0,
+    .qspi_hz = QSPI_SPEED,
+    .gpio_latency_ns = 200,
+    .frame_period_us = 0,
+    .tx_interval_ms = 100,
+    .tx_size = 1024,
+    .audio = 1,
+    .seed = 1,
+    .quantum_us = 50,
+    .target_loop_ns = 60,
+};
+sim_stats_t sim_stats;
+sim_qspi_pins_t sim_host_pins[SIM_CHIPS];
+sim_counter_t sim_sent[SIM_CHIPS][QSPI_PACKET_TYPE_LAST];
+sim_counter_t sim_received[SIM_CHIPS][QSPI_PACKET_TYPE_LAST];
+uint32_t sim_rx_errors[SIM_CHIPS];
+uint32_t sim_tx_errors[SIM_CHIPS];
+uint32_t sim_frames_corrupted;
+uint32_t sim_frames_dropped;
+uint64_t sim_last_frame_ns;
+
+static sim_t sim;
+
+// DMA addresses are 32 bit, chips run on stacks in .bss of a non PIE binary
+static uint8_t sim_stacks[SIM_CHIPS + 1][SIM_STACK_SIZE] __attribute__((aligned(64)));
+static uint8_t sim_bus_buffer[0x10000];
+
+static __thread sim_chip_t *sim_self;      // chip whose main runs on this thread, NULL for the scheduler
+static __thread volatile int sim_preempt_depth;
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+static void sim_step(uint64_t limit);
+static void sim_bus_poll(void);
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+uint64_t sim_now_ns(void)
+{
+    return sim.now;
+}
+
+uint32_t sim_rand(void)
+{
+    sim.rand_state ^= sim.rand_state << 13;
+    sim.rand_state ^= sim.rand_state >> 17;
+    sim.rand_state ^= sim.rand_state << 5;
+
+    return sim.rand_state;
+}
+
+static int sim_chance(double probability)
+{
+    return (probability > 0) && ((sim_rand() / 4294967296.0) < probability);
+}
+
+//-----------------------------------------------------------------------------
+// Event queue, binary heap ordered by time then insertion
+//-----------------------------------------------------------------------------
+static int sim_event_before(const sim_event_t *a, const sim_event_t *b)
+{
+    return (a->t < b->t) || ((a->t == b->t) && (a->seq < b->seq));
+}
+
+static void sim_event_add(uint64_t t, void (*fn)(void *, uint32_t), void *arg, uint32_t value)
+{
+    int i = sim.event_count++;
+
+    if (sim.event_count > SIM_EVENTS_MAX) {
+        fprintf(stderr, "sim: event queue overflow\n");
+        abort();
+    }
+
+    sim.events[i] = (sim_event_t) {.t = t, .seq = sim.event_seq++, .fn = fn, .arg = arg, .value = value};
+    while (i && sim_event_before(&sim.events[i], &sim.events[(i - 1) / 2])) {
+        sim_event_t tmp = sim.events[i];
+        sim.events[i] = sim.events[(i - 1) / 2];
+        sim.events[(i - 1) / 2] = tmp;
+        i = (i - 1) / 2;
+    }
+}
+
+static sim_event_t sim_event_pop(void)
+{
+    sim_event_t top = sim.events[0];
+    int i = 0;
+
+    sim.events[0] = sim.events[--sim.event_count];
+    for (;;) {
+        int min = i;
+        int l = (2 * i) + 1;
+        int r = l + 1;
+
+        if ((l < sim.event_count) && sim_event_before(&sim.events[l], &sim.events[min])) {
+            min = l;
+        }
+        if ((r < sim.event_count) && sim_event_before(&sim.events[r], &sim.events[min])) {
+            min = r;
+        }
+        if (min == i) {
+            break;
+        }
+        sim_event_t tmp = sim.events[i];
+        sim.events[i] = sim.events[min];
+        sim.events[min] = tmp;
+        i = min;
+    }
+
+    return top;
+}
+
+static void sim_events_fire(void)
+{
+    while (sim.event_count && (sim.events[0].t <= sim.now)) {
+        sim_event_t event = sim_event_pop();
+        event.fn(event.arg, event.value);
+        sim_bus_poll();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Chip threads. One chip runs at a time, the others are parked on their semaphore.
+// Busy loops are preempted by a timer signal and resumed once virtual time advanced.
+//-----------------------------------------------------------------------------
+static void sim_quantum_set(sim_chip_t *chip, uint32_t us)
+{
+    struct itimerspec its = {0};
+
+    its.it_value.tv_nsec = (long) us * 1000;
+    timer_settime(chip->quantum_timer, 0, &its, NULL);
+}
+
+// Called on the chip thread with its state set, returns when the chip is resumed
+static void sim_switch_out(sim_chip_t *chip)
+{
+    sim_quantum_set(chip, 0);
+    sem_post(chip->resumer);
+    while (sem_wait(&chip->run) != 0) {}
+    chip->preempt_pending = 0;
+    sim_quantum_set(chip, sim_config.quantum_us);
+}
+
+static void sim_resume(sim_chip_t *chip)
+{
+    sem_t *self = sim_self ? &sim_self->run : &sim.sched;
+
+    chip->state = SIM_CHIP_RUNNING;
+    chip->resumer = self;
+    sem_post(&chip->run);
+    while (sem_wait(self) != 0) {}
+}
+
+static void sim_spin_yield(sim_chip_t *chip)
+{
+    sim_stats.preemptions++;
+    chip->wake_ns = sim.now + sim.spin_ns;
+    chip->isr_wake = 1;
+    chip->state = SIM_CHIP_TIMED;
+    sim_switch_out(chip);
+}
+
+static void sim_preempt_signal(int sig)
+{
+    sim_chip_t *chip = sim_self;
+    int saved_errno = errno;
+
+    if (!chip || (chip->state != SIM_CHIP_RUNNING)) {
+        return;
+    }
+
+    if (sim_preempt_depth || chip->in_isr) {
+        chip->preempt_pending = 1;
+    } else {
+        sim_spin_yield(chip);
+    }
+
+    errno = saved_errno;
+}
+
+void sim_preempt_disable(void)
+{
+    sim_preempt_depth++;
+}
+
+void sim_preempt_enable(void)
+{
+    sim_chip_t *chip = sim_self;
+
+    if ((--sim_preempt_depth == 0) && chip && chip->preempt_pending && !chip->in_isr) {
+        chip->preempt_pending = 0;
+        sim_preempt_depth++;
+        sim_spin_yield(chip);
+        sim_preempt_depth--;
+    }
+}
+
+static void *sim_chip_thread(void *arg)
+{
+    sim_chip_t *chip = arg;
+    struct sigevent sev = {0};
+
+    sim_self = chip;
+
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = SIGRTMIN;
+    sev._sigev_un._tid = gettid();
+    if (timer_create(CLOCK_MONOTONIC, &sev, &chip->quantum_timer) != 0) {
+        perror("sim: timer_create");
+        abort();
+    }
+
+    while (sem_wait(&chip->run) != 0) {}
+    sim_quantum_set(chip, sim_config.quantum_us);
+
+    chip->entry();
+
+    sim_preempt_depth++;
+    chip->state = SIM_CHIP_STOPPED;
+    for (;;) {
+        sim_switch_out(chip);
+    }
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Interrupts
+//-----------------------------------------------------------------------------
+static void sim_irq_acknowledge(int id, int source)
+{
+    // Handlers write the status back to clear it, the write-1-to-clear is done here
+    if (source < SIM_DMA_CHANNELS) {
+        if (id == SIM_CHIP_MASTER) {
+            sim_dma_max32665.ch[source].st = 0;
+            sim_dma_max32665.intr &= ~(1u << source);
+        } else {
+            sim_dma_max78000[id].ch[source].status = 0;
+            sim_dma_max78000[id].intfl &= ~(1u << source);
+        }
+    }
+}
+
+static void sim_irq_dispatch(int id)
+{
+    sim_chip_t *chip = &sim.chips[id];
+
+    if (chip->in_isr) {
+        return;
+    }
+
+    sim_preempt_depth++;
+    while (chip->pending && !chip->primask) {
+        int source = __builtin_ctzll(chip->pending);
+
+        chip->pending &= ~(1ull << source);
+        if (!chip->irq[source].fn) {
+            continue;
+        }
+
+        chip->in_isr = 1;
+        chip->irq[source].fn(chip->irq[source].arg);
+        sim_irq_acknowledge(id, source);
+        chip->in_isr = 0;
+    }
+    sim_preempt_depth--;
+}
+
+// A pending interrupt ends WFI even when masked, busy loops only resume for interrupts that feed them
+static void sim_irq_raise(int id, int source)
+{
+    sim_chip_t *chip = &sim.chips[id];
+
+    chip->pending |= 1ull << source;
+    if ((chip->state == SIM_CHIP_WFI) ||
+        ((chip->state == SIM_CHIP_TIMED) && chip->isr_wake && chip->irq[source].spin_wake)) {
+        chip->state = SIM_CHIP_READY;
+    }
+    sim_irq_dispatch(id);
+}
+
+static void sim_irq_call(void *arg)
+{
+    ((void (*)(void)) arg)();
+}
+
+void sim_irq_disable(int id)
+{
+    sim.chips[id].primask = 1;
+}
+
+void sim_irq_enable(int id)
+{
+    sim_chip_t *chip = &sim.chips[id];
+
+    sim_preempt_disable();
+    chip->primask = 0;
+    if (chip->pending) {
+        sim_irq_dispatch(id);
+    }
+    sim_preempt_enable();
+}
+
+void sim_wfi(int id)
+{
+    sim_chip_t *chip = &sim.chips[id];
+
+    sim_preempt_disable();
+    if (!chip->in_isr && (sim_self == chip) && !chip->pending) {
+        chip->state = SIM_CHIP_WFI;
+        sim_switch_out(chip);
+    }
+    if (!chip->primask) {
+        sim_irq_dispatch(id);
+    }
+    sim_preempt_enable();
+}
+
+//-----------------------------------------------------------------------------
+// Time
+//-----------------------------------------------------------------------------
+// Wait on virtual time from a chip, interrupt handlers can not yield and step the others instead
+static void sim_wait_until(sim_chip_t *chip, uint64_t t, int isr_wake)
+{
+    if (!chip->in_isr && (sim_self == chip)) {
+        chip->wake_ns = t;
+        chip->isr_wake = isr_wake;
+        chip->state = SIM_CHIP_TIMED;
+        sim_switch_out(chip);
+    } else {
+        while (sim.now < t) {
+            sim_step(t);
+        }
+    }
+}
+
+sim_dwt_t *sim_dwt(int id)
+{
+    sim_chip_t *chip = &sim.chips[id];
+
+    sim_preempt_disable();
+    // Cycle counter reads are how firmware polls time
+    sim_wait_until(chip, sim.now + SIM_POLL_NS, 1);
+    chip->dwt.CYCCNT = (uint32_t) ((sim.now * sim_core_clock[id]) / 1000000000u);
+    sim_preempt_enable();
+
+    return &chip->dwt;
+}
+
+int sim_delay_us(int id, uint32_t us)
+{
+    sim_preempt_disable();
+    sim_wait_until(&sim.chips[id], sim.now + ((uint64_t) us * 1000), 0);
+    sim_preempt_enable();
+
+    return E_NO_ERROR;
+}
+
+uint32_t sim_rtc_second(int id)
+{
+    return (uint32_t) ((sim.now + sim.chips[id].rtc_offset_ns) / 1000000000u);
+}
+
+uint32_t sim_rtc_subsecond(int id)
+{
+    return (uint32_t) ((((sim.now + sim.chips[id].rtc_offset_ns) % 1000000000u) * 4096) / 1000000000u);
+}
+
+static void sim_timer_tick(void *arg, uint32_t value)
+{
+    sim_timer_t *timer = arg;
+
+    sim_event_add(sim.now + timer->period_ns, sim_timer_tick, timer, 0);
+    sim_irq_raise(timer->chip, SIM_IRQ_TIMER);
+}
+
+void sim_timer_attach(int id, uint32_t period_us, void (*irq)(void))
+{
+    sim.timers[id].chip = id;
+    sim.timers[id].period_ns = (uint64_t) period_us * 1000;
+    sim.chips[id].irq[SIM_IRQ_TIMER] = (sim_irq_t) {.fn = sim_irq_call, .arg = irq, .spin_wake = 0};
+}
+
+int sim_printf(int id, const char *fmt, ...)
+{
+    va_list args;
+    int len;
+
+    sim_preempt_disable();
+
+    // Debug macros start with their level
+    if (fmt[0] == 'E') {
+        sim_stats.errors[id]++;
+    } else if (fmt[0] == 'W') {
+        sim_stats.warnings[id]++;
+    }
+
+    va_start(args, fmt);
+    len = vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+
+    if (sim_config.verbose) {
+        printf("%10.6f %-6s ", sim.now / 1e9, sim.chips[id].name);
+        va_start(args, fmt);
+        vprintf(fmt, args);
+        va_end(args);
+    }
+
+    sim_preempt_enable();
+
+    return len;
+}
+
+//-----------------------------------------------------------------------------
+// GPIO
+//-----------------------------------------------------------------------------
+static int sim_gpio_chip(mxc_gpio_regs_t *port)
+{
+    return (port - &sim_gpio[0][0]) / SIM_GPIO_PORTS;
+}
+
+static sim_gpio_slot_t *sim_gpio_slot(mxc_gpio_regs_t *port, uint32_t mask, int create)
+{
+    sim_chip_t *chip = &sim.chips[sim_gpio_chip(port)];
+
+    for (int i = 0; i < SIM_GPIO_SLOTS; i++) {
+        if ((chip->gpio[i].port == port) && (chip->gpio[i].mask == mask)) {
+            return &chip->gpio[i];
+        }
+    }
+
+    if (create) {
+        for (int i = 0; i < SIM_GPIO_SLOTS; i++) {
+            if (!chip->gpio[i].port) {
+                chip->gpio[i].port = port;
+                chip->gpio[i].mask = mask;
+                return &chip->gpio[i];
+            }
+        }
+        fprintf(stderr, "sim: out of gpio interrupt slots\n");
+        abort();
+    }
+
+    return NULL;
+}
+
+static void sim_gpio_edge(void *arg, uint32_t level)
+{
+    sim_wire_t *wire = arg;
+    int id = sim_gpio_chip(wire->in);
+    sim_gpio_slot_t *slot;
+    int rising;
+
+    if (!!(wire->in->in & wire->in_mask) == !!level) {
+        return;
+    }
+
+    if (level) {
+        wire->in->in |= wire->in_mask;
+    } else {
+        wire->in->in &= ~wire->in_mask;
+    }
+    rising = !!level;
+
+    slot = sim_gpio_slot(wire->in, wire->in_mask, 0);
+    if (!slot || !slot->enabled) {
+        return;
+    }
+
+    if ((slot->pol == MXC_GPIO_INT_BOTH) ||
+        ((slot->pol == MXC_GPIO_INT_RISING) && rising) ||
+        ((slot->pol == MXC_GPIO_INT_FALLING) && !rising)) {
+        if (wire->cs) {
+            sim_stats.cs_edges++;
+            if (sim_chance(sim_config.cs_drop)) {
+                sim_stats.cs_dropped++;
+                return;
+            }
+        }
+        sim_irq_raise(id, SIM_IRQ_GPIO(slot - sim.chips[id].gpio));
+    }
+}
+
+static void sim_gpio_drive(mxc_gpio_regs_t *port, uint32_t out)
+{
+    uint32_t changed = port->out ^ out;
+
+    port->out = out;
+
+    for (int i = 0; i < sim.wire_count; i++) {
+        sim_wire_t *wire = &sim.wires[i];
+        if ((wire->out == port) && (changed & wire->out_mask)) {
+            sim_event_add(sim.now + sim_config.gpio_latency_ns, sim_gpio_edge, wire, !!(out & wire->out_mask));
+        }
+    }
+}
+
+void sim_gpio_connect(const mxc_gpio_cfg_t *out, const mxc_gpio_cfg_t *in, int cs)
+{
+    sim.wires[sim.wire_count++] = (sim_wire_t) {
+        .out = out->port, .out_mask = out->mask, .in = in->port, .in_mask = in->mask, .cs = cs};
+}
+
+int MXC_GPIO_Config(const mxc_gpio_cfg_t *cfg)
+{
+    return E_NO_ERROR;
+}
+
+uint32_t MXC_GPIO_InGet(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    return port->in & mask;
+}
+
+uint32_t MXC_GPIO_OutGet(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    return port->out & mask;
+}
+
+void MXC_GPIO_OutSet(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    sim_preempt_disable();
+    sim_gpio_drive(port, port->out | mask);
+    sim_preempt_enable();
+}
+
+void MXC_GPIO_OutClr(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    sim_preempt_disable();
+    sim_gpio_drive(port, port->out & ~mask);
+    sim_preempt_enable();
+}
+
+void MXC_GPIO_OutToggle(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    sim_preempt_disable();
+    sim_gpio_drive(port, port->out ^ mask);
+    sim_preempt_enable();
+}
+
+void MXC_GPIO_RegisterCallback(const mxc_gpio_cfg_t *cfg, mxc_gpio_callback_fn func, void *cbdata)
+{
+    int id = sim_gpio_chip(cfg->port);
+    sim_gpio_slot_t *slot = sim_gpio_slot(cfg->port, cfg->mask, 1);
+
+    sim.chips[id].irq[SIM_IRQ_GPIO(slot - sim.chips[id].gpio)] = (sim_irq_t) {.fn = func, .arg = cbdata, .spin_wake = 1};
+}
+
+int MXC_GPIO_IntConfig(const mxc_gpio_cfg_t *cfg, mxc_gpio_int_pol_t pol)
+{
+    sim_gpio_slot(cfg->port, cfg->mask, 1)->pol = pol;
+
+    return E_NO_ERROR;
+}
+
+void MXC_GPIO_EnableInt(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    sim_gpio_slot(port, mask, 1)->enabled = 1;
+}
+
+void MXC_GPIO_DisableInt(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    sim_gpio_slot(port, mask, 1)->enabled = 0;
+}
+
+//-----------------------------------------------------------------------------
+// SPI
+//-----------------------------------------------------------------------------
+int sim_spi_init_max32665(mxc_spi_regs_t *spi, int masterMode, int quadModeUsed, int numSlaves,
+                          unsigned ssPolarity, unsigned int hz, sys_map_t map)
+{
+    memset((void *) spi, 0, sizeof(*spi));
+
+    return E_NO_ERROR;
+}
+
+int sim_spi_init_max78000(mxc_spi_regs_t *spi, int masterMode, int quadModeUsed, int numSlaves,
+                          unsigned ssPolarity, unsigned int hz, mxc_spi_pins_t pins)
+{
+    memset((void *) spi, 0, sizeof(*spi));
+
+    return E_NO_ERROR;
+}
+
+int MXC_SPI_Shutdown(mxc_spi_regs_t *spi)
+{
+    spi->ctrl0 = 0;
+
+    return E_NO_ERROR;
+}
+
+int MXC_SPI_SetWidth(mxc_spi_regs_t *spi, mxc_spi_width_t width)
+{
+    return E_NO_ERROR;
+}
+
+//-----------------------------------------------------------------------------
+// QSPI bus. A transfer starts when the master sets START with its DMA channel enabled and
+// takes two clocks per byte. Data moves when it completes, through the DMA of the selected slave.
+//-----------------------------------------------------------------------------
+void sim_qspi_master_attach(mxc_spi_regs_t *spi, uint8_t ch, void (*irq)(void))
+{
+    sim.master_spi = spi;
+    sim.master_ch = ch;
+    sim.chips[SIM_CHIP_MASTER].irq[SIM_IRQ_DMA(ch)] = (sim_irq_t) {.fn = sim_irq_call, .arg = irq, .spin_wake = 1};
+}
+
+void sim_qspi_slave_attach(const mxc_gpio_cfg_t *cs, mxc_spi_regs_t *spi, uint8_t ch, void (*irq)(void))
+{
+    int id = sim_gpio_chip(cs->port);
+
+    sim.slaves[sim.slave_count++] = (sim_slave_t) {.chip = id, .cs = cs, .spi = spi, .ch = ch};
+    sim.chips[id].irq[SIM_IRQ_DMA(ch)] = (sim_irq_t) {.fn = sim_irq_call, .arg = irq, .spin_wake = 1};
+}
+
+static void sim_slave_dma_end(sim_slave_t *slave)
+{
+    sim_dma_max78000_regs_t *dma = &sim_dma_max78000[slave->chip];
+    sim_dma_max78000_ch_t *ch = &dma->ch[slave->ch];
+
+    if (ch->ctrl & MXC_F_DMA_CTRL_RLDEN) {
+        ch->cnt = ch->cntrld;
+        ch->src = ch->srcrld;
+        ch->dst = ch->dstrld;
+        ch->ctrl &= ~MXC_F_DMA_CTRL_RLDEN;
+        ch->status |= MXC_F_DMA_STATUS_RLD_IF;
+    } else {
+        ch->ctrl &= ~MXC_F_DMA_CTRL_EN;
+        ch->status |= MXC_F_DMA_STATUS_CTZ_IF;
+    }
+
+    dma->intfl |= 1u << slave->ch;
+    if (dma->inten & (1u << slave->ch)) {
+        sim_irq_raise(slave->chip, SIM_IRQ_DMA(slave->ch));
+    }
+}
+
+// Move len bytes between the bus buffer and the slave DMA, master_tx is the bus direction
+static void sim_slave_transfer(sim_slave_t *slave, uint8_t *data, uint32_t len, int master_tx)
+{
+    sim_dma_max78000_ch_t *ch = slave ? &sim_dma_max78000[slave->chip].ch[slave->ch] : NULL;
+    uint32_t done = 0;
+
+    while (done < len) {
+        uint32_t request = ch ? SIM_REQUEST(ch->ctrl) : 0;
+        uint32_t n;
+
+        if (!ch || !(ch->ctrl & MXC_F_DMA_CTRL_EN) || !ch->cnt || !(slave->spi->ctrl0 & MXC_F_SPI_CTRL0_EN) ||
+            (master_tx == ((request & SIM_REQUEST_TX) != 0))) {
+            if (!master_tx) {
+                memset(data + done, SIM_BUS_IDLE, len - done);
+            }
+            sim_stats.idle_bytes += len - done;
+            return;
+        }
+
+        n = len - done;
+        if (n > ch->cnt) {
+            n = ch->cnt;
+        }
+
+        if (master_tx) {
+            memcpy(SIM_PTR(ch->dst), data + done, n);
+            if (ch->ctrl & MXC_F_DMA_CTRL_DSTINC) {
+                ch->dst += n;
+            }
+        } else {
+            memcpy(data + done, SIM_PTR(ch->src), n);
+            if (ch->ctrl & MXC_F_DMA_CTRL_SRCINC) {
+                ch->src += n;
+            }
+        }
+
+        ch->cnt -= n;
+        done += n;
+        if (!ch->cnt) {
+            sim_slave_dma_end(slave);
+        }
+    }
+}
+
+static sim_slave_t *sim_slave_selected(void)
+{
+    sim_slave_t *selected = NULL;
+
+    for (int i = 0; i < sim.slave_count; i++) {
+        if (!(sim.slaves[i].cs->port->in & sim.slaves[i].cs->mask)) {
+            if (selected) {
+                sim_stats.conflicts++;
+            }
+            selected = &sim.slaves[i];
+        }
+    }
+
+    return selected;
+}
+
+static void sim_bus_done(void *arg, uint32_t value)
+{
+    sim_dma_max32665_ch_t *ch = &sim_dma_max32665.ch[sim.master_ch];
+    sim_slave_t *slave = sim_slave_selected();
+    uint32_t len = sim.bus_len;
+    int tx = (SIM_REQUEST(ch->cfg) & SIM_REQUEST_TX) != 0;
+
+    if (tx) {
+        if (ch->cfg & MXC_F_DMA_CFG_SRINC) {
+            memcpy(sim_bus_buffer, SIM_PTR(ch->src), len);
+            ch->src += len;
+        } else {
+            memset(sim_bus_buffer, *SIM_PTR(ch->src), len);
+        }
+    }
+
+    if (!tx) {
+        sim_slave_transfer(slave, sim_bus_buffer, len, 0);
+    }
+
+    if (sim_chance(sim_config.corrupt)) {
+        uint32_t bit = sim_rand() % (len * 8);
+        sim_bus_buffer[bit / 8] ^= 1u << (bit % 8);
+        sim_stats.corrupted++;
+    }
+
+    if (tx) {
+        sim_slave_transfer(slave, sim_bus_buffer, len, 1);
+    } else if (ch->cfg & MXC_F_DMA_CFG_DISTINC) {
+        memcpy(SIM_PTR(ch->dst), sim_bus_buffer, len);
+        ch->dst += len;
+    } else {
+        *SIM_PTR(ch->dst) = sim_bus_buffer[len - 1];
+    }
+
+    sim_stats.transfers++;
+    sim_stats.bytes += len;
+
+    ch->cnt = 0;
+    sim.master_spi->stat &= ~MXC_F_SPI_STAT_BUSY;
+    sim.bus_active = 0;
+
+    // Reload only loads the DMA, the handler restarts the SPI
+    if (ch->cfg & MXC_F_DMA_CFG_RLDEN) {
+        ch->cnt = ch->cnt_rld;
+        ch->src = ch->src_rld;
+        ch->dst = ch->dst_rld;
+        ch->cfg &= ~MXC_F_DMA_CFG_RLDEN;
+        ch->st |= MXC_F_DMA_ST_RLD_ST | MXC_F_DMA_ST_IPEND;
+    } else {
+        ch->cfg &= ~MXC_F_DMA_CFG_CHEN;
+        ch->st |= MXC_F_DMA_ST_CTZ_ST | MXC_F_DMA_ST_IPEND;
+    }
+
+    if (sim_dma_max32665.cn & (1u << sim.master_ch)) {
+        sim_dma_max32665.intr |= 1u << sim.master_ch;
+        sim_irq_raise(SIM_CHIP_MASTER, SIM_IRQ_DMA(sim.master_ch));
+    }
+}
+
+static void sim_bus_poll(void)
+{
+    sim_dma_max32665_ch_t *ch;
+    uint64_t duration;
+
+    if (!sim.master_spi || sim.bus_active || !(sim.master_spi->ctrl0 & MXC_F_SPI_CTRL0_START)) {
+        return;
+    }
+
+    ch = &sim_dma_max32665.ch[sim.master_ch];
+    if (!(ch->cfg & MXC_F_DMA_CFG_CHEN) || !ch->cnt) {
+        return;
+    }
+
+    sim.master_spi->ctrl0 &= ~MXC_F_SPI_CTRL0_START;
+    sim.master_spi->stat |= MXC_F_SPI_STAT_BUSY;
+    sim.bus_active = 1;
+    sim.bus_len = ch->cnt;
+
+    // Quad lines, two clocks per byte
+    duration = ((uint64_t) ch->cnt * 2 * 1000000000u) / sim_config.qspi_hz;
+    sim_event_add(sim.now + duration, sim_bus_done, NULL, 0);
+}
+
+//-----------------------------------------------------------------------------
+// Scheduler
+//-----------------------------------------------------------------------------
+// Run one ready chip, or advance virtual time to the next event or wake up, at most to limit.
+// Chips in an interrupt handler stay frozen, a handler waiting on time steps the others.
+static void sim_step(uint64_t limit)
+{
+    uint64_t next = limit;
+
+    sim_events_fire();
+    sim_bus_poll();
+
+    for (int n = 0; n < SIM_CHIPS; n++) {
+        int id = (sim.rr + n) % SIM_CHIPS;
+        sim_chip_t *chip = &sim.chips[id];
+
+        if ((chip->state == SIM_CHIP_READY) && !chip->in_isr) {
+            sim.rr = (id + 1) % SIM_CHIPS;
+            sim_resume(chip);
+            sim_bus_poll();
+            return;
+        }
+    }
+
+    if (sim.event_count && (sim.events[0].t < next)) {
+        next = sim.events[0].t;
+    }
+    for (int id = 0; id < SIM_CHIPS; id++) {
+        if ((sim.chips[id].state == SIM_CHIP_TIMED) && (sim.chips[id].wake_ns < next)) {
+            next = sim.chips[id].wake_ns;
+        }
+    }
+
+    if (next > sim.now) {
+        sim.now = next;
+    }
+
+    for (int id = 0; id < SIM_CHIPS; id++) {
+        if ((sim.chips[id].state == SIM_CHIP_TIMED) && (sim.chips[id].wake_ns <= sim.now)) {
+            sim.chips[id].state = SIM_CHIP_READY;
+        }
+    }
+
+    sim_events_fire();
+}
+
+static void *sim_scheduler_thread(void *arg)
+{
+    while (sim.now < sim.end) {
+        sim_step(sim.end);
+    }
+
+    return NULL;
+}
+
+void sim_chip_add(int id, const char *name, void (*entry)(void))
+{
+    sim.chips[id].name = name;
+    sim.chips[id].entry = entry;
+}
+
+// Busy loop iterations per host microsecond, maps a preempted busy wait to target time
+static double sim_loop_rate(void)
+{
+    volatile uint32_t cnt = 20000000;
+    volatile int flag = 0;
+    uint64_t start;
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    start = ((uint64_t) ts.tv_sec * 1000000000u) + ts.tv_nsec;
+    while (!flag && cnt) {
+        cnt--;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return 20000000.0 * 1000 / ((((uint64_t) ts.tv_sec * 1000000000u) + ts.tv_nsec) - start);
+}
+
+int sim_run(void)
+{
+    struct sigaction sa = {0};
+    pthread_attr_t attr;
+    pthread_t scheduler;
+    sigset_t mask;
+
+    if ((uintptr_t) &sim_stacks[SIM_CHIPS][SIM_STACK_SIZE] > UINT32_MAX) {
+        fprintf(stderr, "sim: memory above 4 GB, build with -no-pie\n");
+        return -1;
+    }
+
+    sim.rand_state = sim_config.seed ? sim_config.seed : 1;
+    sim.end = (uint64_t) (sim_config.duration_s * 1e9);
+    sim.spin_ns = (uint64_t) (sim_loop_rate() * sim_config.quantum_us * sim_config.target_loop_ns);
+    sem_init(&sim.sched, 0, 0);
+
+    // Idle lines are pulled up
+    memset(sim_gpio, 0xff, sizeof(sim_gpio));
+
+    // Clocks of the MAX78000s are not aligned with the host
+    sim.chips[SIM_CHIP_VIDEO].rtc_offset_ns = 1234567000;
+    sim.chips[SIM_CHIP_AUDIO].rtc_offset_ns = 7654321000;
+
+    sa.sa_handler = sim_preempt_signal;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGRTMIN, &sa, NULL);
+
+    for (int id = 0; id < SIM_CHIPS; id++) {
+        if (sim.timers[id].period_ns) {
+            sim_event_add(sim.timers[id].period_ns, sim_timer_tick, &sim.timers[id], 0);
+        }
+    }
+
+    pthread_attr_init(&attr);
+    for (int id = 0; id < SIM_CHIPS; id++) {
+        sim_chip_t *chip = &sim.chips[id];
+        if (!chip->entry) {
+            continue;
+        }
+        sem_init(&chip->run, 0, 0);
+        chip->state = SIM_CHIP_READY;
+        pthread_attr_setstack(&attr, sim_stacks[id], SIM_STACK_SIZE);
+        pthread_create(&chip->thread, &attr, sim_chip_thread, chip);
+    }
+
+    // Only chip threads are preempted
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGRTMIN);
+    pthread_sigmask(SIG_BLOCK, &mask, NULL);
+    pthread_attr_setstack(&attr, sim_stacks[SIM_CHIPS], SIM_STACK_SIZE);
+    pthread_create(&scheduler, &attr, sim_scheduler_thread, NULL);
+    pthread_join(scheduler, NULL);
+    pthread_attr_destroy(&attr);
+
+    return 0;
+}
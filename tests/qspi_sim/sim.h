@@ -0,0 +1,143 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _SIM_H_
+#define _SIM_H_
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <gpio.h>
+#include <spi.h>
+#include <stdint.h>
+
+#include "maxrefdes178_definitions.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+typedef struct {
+    double duration_s;          // virtual time simulated
+    uint32_t qspi_hz;           // QSPI clock, quad lines
+    uint32_t gpio_latency_ns;   // CS, R/W and INT edge propagation and interrupt latency
+    double cs_drop;             // probability a CS edge interrupt is lost by the slave
+    double corrupt;             // probability a transfer has one bit flipped
+    uint32_t frame_period_us;   // video frame interval, 0 sends frames back to back
+    uint32_t tx_interval_ms;    // host command with payload to video, 0 disables
+    uint32_t tx_size;
+    int audio;                  // audio MAX78000 attached
+    int verbose;                // print firmware logs
+    uint32_t seed;
+    uint32_t quantum_us;        // host time a busy loop runs before it is preempted
+    uint32_t target_loop_ns;    // target time of one busy wait loop iteration
+} sim_config_t;
+
+// Host side pins of one slave link
+typedef struct {
+    mxc_gpio_cfg_t cs;
+    mxc_gpio_cfg_t io;
+    mxc_gpio_cfg_t int_pin;
+} sim_qspi_pins_t;
+
+typedef struct {
+    uint32_t packets;
+    uint64_t bytes;
+} sim_counter_t;
+
+typedef struct {
+    uint64_t transfers;
+    uint64_t bytes;
+    uint64_t idle_bytes;        // clocked while no slave DMA was armed
+    uint32_t conflicts;         // more than one slave selected
+    uint32_t cs_edges;
+    uint32_t cs_dropped;
+    uint32_t corrupted;
+    uint32_t preemptions;
+    uint32_t warnings[SIM_CHIPS];
+    uint32_t errors[SIM_CHIPS];
+} sim_stats_t;
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+extern sim_config_t sim_config;
+extern sim_stats_t sim_stats;
+// Filled by sim_master_setup, slaves connect their pins to them
+extern sim_qspi_pins_t sim_host_pins[SIM_CHIPS];
+
+// Packets by sending and by receiving chip, bytes are payload bytes
+extern sim_counter_t sim_sent[SIM_CHIPS][QSPI_PACKET_TYPE_LAST];
+extern sim_counter_t sim_received[SIM_CHIPS][QSPI_PACKET_TYPE_LAST];
+extern uint32_t sim_rx_errors[SIM_CHIPS];
+extern uint32_t sim_tx_errors[SIM_CHIPS];
+extern uint32_t sim_frames_corrupted;
+extern uint32_t sim_frames_dropped;
+extern uint64_t sim_last_frame_ns;
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+// Chip programs, each registers its pins and peripherals from its setup function
+void sim_master_setup(void);
+void sim_video_setup(void);
+void sim_audio_setup(void);
+
+void sim_chip_add(int chip, const char *name, void (*entry)(void));
+void sim_gpio_connect(const mxc_gpio_cfg_t *out, const mxc_gpio_cfg_t *in, int cs);
+void sim_qspi_master_attach(mxc_spi_regs_t *spi, uint8_t ch, void (*irq)(void));
+void sim_qspi_slave_attach(const mxc_gpio_cfg_t *cs, mxc_spi_regs_t *spi, uint8_t ch, void (*irq)(void));
+void sim_timer_attach(int chip, uint32_t period_us, void (*irq)(void));
+
+// Run sim_config.duration_s of virtual time, chips are left stopped
+int sim_run(void);
+
+uint64_t sim_now_ns(void);
+uint32_t sim_rand(void);
+
+// Payload content of frames and test packets, the first word carries the sequence number
+static inline uint8_t sim_pattern(uint32_t seq, uint32_t i)
+{
+    return (uint8_t) ((seq * 7) + (i * 13) + (i >> 8));
+}
+
+#endif /* _SIM_H_ */
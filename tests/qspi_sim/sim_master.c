@@ -0,0 +1,280 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <mxc_delay.h>
+#include <string.h>
+
+#include "max32666_debug.h"
+#include "max32666_data.h"
+#include "max32666_framebuffer.h"
+#include "max32666_lcd.h"
+#include "max32666_passthrough.h"
+#include "max32666_qspi_master.h"
+#include "max32666_time_sync.h"
+#include "max32666_timer_led_button.h"
+#include "maxrefdes178_definitions.h"
+#include "maxrefdes178_timing.h"
+#include "maxrefdes178_utility.h"
+#include "sim.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define S_MODULE_NAME   "sim"
+
+#define MASTER_SLAVE_BOOT_US    20000
+#define MASTER_SYNC_TIMEOUT_MS  100     // lost time sync response
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+volatile uint32_t timer_ms_tick;
+uint32_t __isr_vector_core1;
+
+// Host code the QSPI master links against, the LCD is not simulated
+static uint8_t master_frame[LCD_DATA_SIZE];
+static uint32_t master_frame_seq;
+static uint8_t master_test_payload[MAX32666_BLE_COMMAND_BUFFER_SIZE];
+static uint8_t master_sync_pending;
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+void MAX32666_QSPI_DMA_IRQ_HAND(void);
+void qspi_video_int(void *cbdata);
+void qspi_audio_int(void *cbdata);
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+uint32_t timer_get_us(void)
+{
+    return (uint32_t) (sim_now_ns() / 1000);
+}
+
+uint8_t *framebuffer_receive_acquire(void)
+{
+    return master_frame;
+}
+
+void framebuffer_receive_done(uint8_t *buffer, uint32_t capture_time)
+{
+    uint32_t seq;
+
+    memcpy(&seq, buffer, sizeof(seq));
+    for (uint32_t i = sizeof(seq); i < LCD_DATA_SIZE; i++) {
+        if (buffer[i] != sim_pattern(seq, i)) {
+            sim_frames_corrupted++;
+            break;
+        }
+    }
+
+    if (master_frame_seq && (seq > master_frame_seq + 1)) {
+        sim_frames_dropped += seq - master_frame_seq - 1;
+    }
+    master_frame_seq = seq;
+    sim_last_frame_ns = sim_now_ns();
+}
+
+uint32_t framebuffer_dropped_frames(void)
+{
+    return sim_frames_dropped;
+}
+
+int lcd_streamWait(void)
+{
+    return E_NO_ERROR;
+}
+
+void render_lcd_hold(void)
+{
+}
+
+void render_lcd_release(void)
+{
+}
+
+int lcd_notification(uint16_t color, const char *notification)
+{
+    return E_NO_ERROR;
+}
+
+int passthrough_stream_start(uint32_t packet_size)
+{
+    return E_NOT_SUPPORTED;
+}
+
+void passthrough_stream_chunk(uint8_t *chunk, uint32_t len)
+{
+}
+
+static void master_tick(void)
+{
+    timer_ms_tick++;
+}
+
+static void master_rx(int chip, int ret, qspi_packet_type_e type)
+{
+    if (ret == E_NONE_AVAIL) {
+        return;
+    }
+
+    if (ret == E_NO_ERROR) {
+        sim_received[SIM_CHIP_MASTER][type].packets++;
+        if (type == QSPI_PACKET_TYPE_VIDEO_TIME_SYNC_RES) {
+            master_sync_pending = 0;
+        }
+    } else {
+        sim_rx_errors[SIM_CHIP_MASTER]++;
+    }
+}
+
+static int master_send(int chip, uint8_t *data, uint32_t size, uint8_t type)
+{
+    int ret;
+
+    if (chip == SIM_CHIP_VIDEO) {
+        ret = qspi_master_send_video(data, size, type);
+    } else {
+        ret = qspi_master_send_audio(data, size, type);
+    }
+
+    if (ret == E_NO_ERROR) {
+        sim_sent[SIM_CHIP_MASTER][type].packets++;
+        sim_sent[SIM_CHIP_MASTER][type].bytes += size;
+    } else {
+        sim_tx_errors[SIM_CHIP_MASTER]++;
+    }
+
+    return ret;
+}
+
+static void master_main(void)
+{
+    qspi_packet_type_e type;
+    uint32_t sync_tick = 0;
+    uint32_t test_tick = 0;
+    uint32_t test_seq = 0;
+    int ret;
+
+    timing_cycles_init();
+
+    if ((ret = qspi_master_init()) != E_NO_ERROR) {
+        PR_ERROR("qspi_master_init fail %d", ret);
+        return;
+    }
+    time_sync_init();
+
+    // MAX78000s are brought up after the host
+    MXC_Delay(MASTER_SLAVE_BOOT_US);
+
+    master_send(SIM_CHIP_VIDEO, NULL, 0, QSPI_PACKET_TYPE_VIDEO_VERSION_CMD);
+    master_rx(SIM_CHIP_VIDEO, qspi_master_video_rx_wait(&type), type);
+    if (sim_config.audio) {
+        master_send(SIM_CHIP_AUDIO, NULL, 0, QSPI_PACKET_TYPE_AUDIO_VERSION_CMD);
+        master_rx(SIM_CHIP_AUDIO, qspi_master_audio_rx_wait(&type), type);
+    }
+
+    while (1) {
+        master_rx(SIM_CHIP_VIDEO, qspi_master_video_rx_worker(&type), type);
+        if (sim_config.audio) {
+            master_rx(SIM_CHIP_AUDIO, qspi_master_audio_rx_worker(&type), type);
+        }
+
+        qspi_master_video_tx_worker();
+        if (sim_config.audio) {
+            qspi_master_audio_tx_worker();
+        }
+
+        // Back to back frames keep the link busy, a round is only started between packets
+        if (((timer_ms_tick - sync_tick) >= MAX32666_TIME_SYNC_INTERVAL) && (time_sync_worker() == E_NO_ERROR)) {
+            sync_tick = timer_ms_tick;
+            master_sync_pending = 1;
+        }
+
+        // The slave driver holds one received command until its main loop serves it, a header sent
+        // before then is dropped. The test packet waits for the time sync response
+        if (master_sync_pending && ((timer_ms_tick - sync_tick) >= MASTER_SYNC_TIMEOUT_MS)) {
+            master_sync_pending = 0;
+        }
+
+        if (sim_config.tx_interval_ms && ((timer_ms_tick - test_tick) >= sim_config.tx_interval_ms) &&
+            !qspi_master_busy() && !master_sync_pending) {
+            test_tick = timer_ms_tick;
+            test_seq++;
+            memcpy(master_test_payload, &test_seq, sizeof(test_seq));
+            for (uint32_t i = sizeof(test_seq); i < sim_config.tx_size; i++) {
+                master_test_payload[i] = sim_pattern(test_seq, i);
+            }
+            master_send(SIM_CHIP_VIDEO, master_test_payload, sim_config.tx_size, QSPI_PACKET_TYPE_TEST);
+        }
+
+        __WFI();
+    }
+}
+
+void sim_master_setup(void)
+{
+    static const mxc_gpio_cfg_t video_cs_pin  = MAX32666_VIDEO_CS_PIN;
+    static const mxc_gpio_cfg_t video_io_pin  = MAX32666_VIDEO_IO_PIN;
+    static const mxc_gpio_cfg_t video_int_pin = MAX32666_VIDEO_INT_PIN;
+    static const mxc_gpio_cfg_t audio_cs_pin  = MAX32666_AUDIO_CS_PIN;
+    static const mxc_gpio_cfg_t audio_io_pin  = MAX32666_AUDIO_IO_PIN;
+    static const mxc_gpio_cfg_t audio_int_pin = MAX32666_AUDIO_INT_PIN;
+
+    if (sim_config.tx_size > sizeof(master_test_payload)) {
+        sim_config.tx_size = sizeof(master_test_payload);
+    }
+
+    sim_host_pins[SIM_CHIP_VIDEO] = (sim_qspi_pins_t) {video_cs_pin, video_io_pin, video_int_pin};
+    sim_host_pins[SIM_CHIP_AUDIO] = (sim_qspi_pins_t) {audio_cs_pin, audio_io_pin, audio_int_pin};
+
+    sim_chip_add(SIM_CHIP_MASTER, "max32666", master_main);
+    sim_qspi_master_attach(MAX32666_QSPI, MAX32666_QSPI_DMA_CHANNEL, MAX32666_QSPI_DMA_IRQ_HAND);
+    sim_timer_attach(SIM_CHIP_MASTER, 1000, master_tick);
+}
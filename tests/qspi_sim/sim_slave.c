@@ -0,0 +1,288 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <mxc.h>
+#include <string.h>
+
+#include "max78000_debug.h"
+#include "max78000_qspi_slave.h"
+#include "maxrefdes178_definitions.h"
+#include "maxrefdes178_utility.h"
+#include "sim.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define S_MODULE_NAME   "sim"
+
+// Built once per MAX78000, the receive loop follows the video and audio mains
+#if defined(MAXREFDES178_MAX78000_VIDEO)
+#define SLAVE_NAME              "video"
+#define SLAVE_SETUP             sim_video_setup
+#define SLAVE_HOST_CS_PIN       MAX78000_VIDEO_HOST_CS_PIN
+#define SLAVE_HOST_INT_PIN      MAX78000_VIDEO_HOST_INT_PIN
+#define SLAVE_HOST_IO_PIN       MAX78000_VIDEO_HOST_IO_PIN
+#define SLAVE_QSPI              MAX78000_VIDEO_QSPI
+#define SLAVE_QSPI_DMA_CHANNEL  MAX78000_VIDEO_QSPI_DMA_CHANNEL
+#define SLAVE_QSPI_DMA_IRQ_HAND MAX78000_VIDEO_QSPI_DMA_IRQ_HAND
+#define SLAVE_VERSION_CMD       QSPI_PACKET_TYPE_VIDEO_VERSION_CMD
+#define SLAVE_VERSION_RES       QSPI_PACKET_TYPE_VIDEO_VERSION_RES
+#define SLAVE_TIME_SYNC_CMD     QSPI_PACKET_TYPE_VIDEO_TIME_SYNC_CMD
+#define SLAVE_TIME_SYNC_RES     QSPI_PACKET_TYPE_VIDEO_TIME_SYNC_RES
+#define SLAVE_CLASSIFICATION    QSPI_PACKET_TYPE_VIDEO_CLASSIFICATION_RES
+#define SLAVE_STATISTICS        QSPI_PACKET_TYPE_VIDEO_STATISTICS_RES
+#elif defined(MAXREFDES178_MAX78000_AUDIO)
+#define SLAVE_NAME              "audio"
+#define SLAVE_SETUP             sim_audio_setup
+#define SLAVE_HOST_CS_PIN       MAX78000_AUDIO_HOST_CS_PIN
+#define SLAVE_HOST_INT_PIN      MAX78000_AUDIO_HOST_INT_PIN
+#define SLAVE_HOST_IO_PIN       MAX78000_AUDIO_HOST_IO_PIN
+#define SLAVE_QSPI              MAX78000_AUDIO_QSPI
+#define SLAVE_QSPI_DMA_CHANNEL  MAX78000_AUDIO_QSPI_DMA_CHANNEL
+#define SLAVE_QSPI_DMA_IRQ_HAND MAX78000_AUDIO_QSPI_DMA_IRQ_HAND
+#define SLAVE_VERSION_CMD       QSPI_PACKET_TYPE_AUDIO_VERSION_CMD
+#define SLAVE_VERSION_RES       QSPI_PACKET_TYPE_AUDIO_VERSION_RES
+#define SLAVE_TIME_SYNC_CMD     QSPI_PACKET_TYPE_AUDIO_TIME_SYNC_CMD
+#define SLAVE_TIME_SYNC_RES     QSPI_PACKET_TYPE_AUDIO_TIME_SYNC_RES
+#define SLAVE_CLASSIFICATION    QSPI_PACKET_TYPE_AUDIO_CLASSIFICATION_RES
+#define SLAVE_STATISTICS        QSPI_PACKET_TYPE_AUDIO_STATISTICS_RES
+#else
+#error MAX78000 AUDIO or MAX78000 VIDEO flag should be set
+#endif
+
+#define SLAVE_BOOT_US           10000   // host brings the MAX78000s up after its own init
+#define SLAVE_IDLE_POLL_US      100
+#define SLAVE_SEND_RETRY_US     10
+#define SLAVE_SEND_RETRIES      1000
+#define SLAVE_AUDIO_RESULT_US   100000
+#define SLAVE_STATISTICS_FRAMES 10
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static uint8_t qspi_payload_buffer[MAX32666_BLE_COMMAND_BUFFER_SIZE];
+static const version_t version = {.major = 1, .minor = 2, .build = 3};
+static time_sync_t time_sync;
+static classification_result_t classification_result = {.probability = 99.0f, .result = "sim"};
+static max78000_statistics_t max78000_statistics;
+#if defined(MAXREFDES178_MAX78000_VIDEO)
+static uint8_t camera_image[LCD_DATA_SIZE];
+static uint32_t frame_capture_time;
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Local function declarations
+//-----------------------------------------------------------------------------
+void SLAVE_QSPI_DMA_IRQ_HAND(void);
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+static void slave_rx(void);
+
+// The driver refuses to send while a host command is pending, serve it and try again
+static int slave_send(uint8_t *data, uint32_t size, uint8_t type)
+{
+    uint32_t retries = SLAVE_SEND_RETRIES;
+    int ret;
+
+    while (((ret = qspi_slave_send_packet(data, size, type)) == E_BUSY) && retries--) {
+        slave_rx();
+        MXC_Delay(SLAVE_SEND_RETRY_US);
+    }
+
+    if (ret == E_NO_ERROR) {
+        sim_sent[SIM_CHIP][type].packets++;
+        sim_sent[SIM_CHIP][type].bytes += size;
+    } else {
+        sim_tx_errors[SIM_CHIP]++;
+    }
+
+    return ret;
+}
+
+static void slave_rx_test(qspi_packet_header_t *header)
+{
+    uint32_t seq;
+
+    memcpy(&seq, qspi_payload_buffer, sizeof(seq));
+    for (uint32_t i = sizeof(seq); i < header->info.packet_size; i++) {
+        if (qspi_payload_buffer[i] != sim_pattern(seq, i)) {
+            PR_ERROR("test data mismatch at %u", i);
+            sim_rx_errors[SIM_CHIP]++;
+            return;
+        }
+    }
+
+    sim_received[SIM_CHIP][QSPI_PACKET_TYPE_TEST].packets++;
+}
+
+static void slave_rx(void)
+{
+    qspi_state_e qspi_rx_state = qspi_slave_get_rx_state();
+    qspi_packet_header_t qspi_rx_header;
+
+    if (qspi_rx_state == QSPI_STATE_CS_DEASSERTED_HEADER) {
+        qspi_rx_header = qspi_slave_get_rx_header();
+
+        if (qspi_rx_header.info.packet_size > sizeof(qspi_payload_buffer)) {
+            PR_ERROR("Invalid packet size %u", qspi_rx_header.info.packet_size);
+            sim_rx_errors[SIM_CHIP]++;
+            qspi_slave_set_rx_state(QSPI_STATE_IDLE);
+            return;
+        }
+
+        qspi_slave_set_rx_data(qspi_payload_buffer, qspi_rx_header.info.packet_size);
+        qspi_slave_trigger();
+        if (qspi_slave_wait_rx() != E_NO_ERROR) {
+            sim_rx_errors[SIM_CHIP]++;
+            qspi_slave_set_rx_state(QSPI_STATE_IDLE);
+            return;
+        }
+
+        // Check payload crc again
+        if (qspi_rx_header.payload_crc16 != crc16_sw(qspi_payload_buffer, qspi_rx_header.info.packet_size)) {
+            PR_ERROR("Invalid payload crc %x", qspi_rx_header.payload_crc16);
+            sim_rx_errors[SIM_CHIP]++;
+            qspi_slave_set_rx_state(QSPI_STATE_IDLE);
+            return;
+        }
+
+        switch(qspi_rx_header.info.packet_type) {
+        case QSPI_PACKET_TYPE_TEST:
+            slave_rx_test(&qspi_rx_header);
+            break;
+        default:
+            PR_ERROR("Invalid packet %d", qspi_rx_header.info.packet_type);
+            break;
+        }
+
+        qspi_slave_set_rx_state(QSPI_STATE_IDLE);
+    } else if (qspi_rx_state == QSPI_STATE_COMPLETED) {
+        qspi_rx_header = qspi_slave_get_rx_header();
+        if (qspi_rx_header.info.packet_type < QSPI_PACKET_TYPE_LAST) {
+            sim_received[SIM_CHIP][qspi_rx_header.info.packet_type].packets++;
+        }
+
+        switch(qspi_rx_header.info.packet_type) {
+        case SLAVE_VERSION_CMD:
+            qspi_slave_set_rx_state(QSPI_STATE_IDLE);
+            slave_send((uint8_t *) &version, sizeof(version), SLAVE_VERSION_RES);
+            break;
+        case SLAVE_TIME_SYNC_CMD:
+            time_sync.device_rx_us = qspi_slave_get_rx_header_time();
+            qspi_slave_set_rx_state(QSPI_STATE_IDLE);
+            time_sync.device_tx_us = GET_RTC_US();
+            slave_send((uint8_t *) &time_sync, sizeof(time_sync), SLAVE_TIME_SYNC_RES);
+            break;
+        default:
+            PR_ERROR("Invalid packet %d", qspi_rx_header.info.packet_type);
+            break;
+        }
+
+        qspi_slave_set_rx_state(QSPI_STATE_IDLE);
+    }
+}
+
+static void slave_main(void)
+{
+    uint64_t next_result_us = 0;
+    uint32_t results = 0;
+    int ret;
+
+    MXC_Delay(SLAVE_BOOT_US);
+
+    if ((ret = qspi_slave_init()) != E_NO_ERROR) {
+        PR_ERROR("qspi_slave_init fail %d", ret);
+        return;
+    }
+
+    while (1) {
+        slave_rx();
+
+        if ((sim_now_ns() / 1000) < next_result_us) {
+            MXC_Delay(SLAVE_IDLE_POLL_US);
+            continue;
+        }
+
+#if defined(MAXREFDES178_MAX78000_VIDEO)
+        // Frames back to back unless paced, the camera is not simulated
+        next_result_us = (sim_now_ns() / 1000) + sim_config.frame_period_us;
+
+        memcpy(camera_image, &results, sizeof(results));
+        for (uint32_t i = sizeof(results); i < LCD_DATA_SIZE; i++) {
+            camera_image[i] = sim_pattern(results, i);
+        }
+        frame_capture_time = GET_RTC_US();
+
+        slave_send((uint8_t *) &frame_capture_time, sizeof(frame_capture_time), QSPI_PACKET_TYPE_VIDEO_FRAME_TIMESTAMP_RES);
+        slave_send(camera_image, LCD_DATA_SIZE, QSPI_PACKET_TYPE_VIDEO_DATA_RES);
+#else
+        next_result_us = (sim_now_ns() / 1000) + SLAVE_AUDIO_RESULT_US;
+#endif
+        classification_result.capture_timestamp_us = GET_RTC_US();
+        slave_send((uint8_t *) &classification_result, sizeof(classification_result), SLAVE_CLASSIFICATION);
+
+        if ((++results % SLAVE_STATISTICS_FRAMES) == 0) {
+            slave_send((uint8_t *) &max78000_statistics, sizeof(max78000_statistics), SLAVE_STATISTICS);
+        }
+    }
+}
+
+void SLAVE_SETUP(void)
+{
+    static const mxc_gpio_cfg_t cs_pin  = SLAVE_HOST_CS_PIN;
+    static const mxc_gpio_cfg_t int_pin = SLAVE_HOST_INT_PIN;
+    static const mxc_gpio_cfg_t io_pin  = SLAVE_HOST_IO_PIN;
+
+    sim_chip_add(SIM_CHIP, SLAVE_NAME, slave_main);
+    sim_gpio_connect(&sim_host_pins[SIM_CHIP].cs, &cs_pin, 1);
+    sim_gpio_connect(&sim_host_pins[SIM_CHIP].io, &io_pin, 0);
+    sim_gpio_connect(&int_pin, &sim_host_pins[SIM_CHIP].int_pin, 0);
+    sim_qspi_slave_attach(&cs_pin, SLAVE_QSPI, SLAVE_QSPI_DMA_CHANNEL, SLAVE_QSPI_DMA_IRQ_HAND);
+}
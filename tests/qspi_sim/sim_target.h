@@ -0,0 +1,71 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _SIM_TARGET_H_
+#define _SIM_TARGET_H_
+
+// Included first in every firmware translation unit of a simulated chip
+
+#include <stdio.h>
+
+#include "sim_soc.h"
+
+// Firmware logs go through the simulator, stdio is not preempted
+#define printf(...)     sim_printf(SIM_CHIP, __VA_ARGS__)
+
+// Interrupt handlers of different chips share names
+#if SIM_CHIP == SIM_CHIP_MASTER
+#define DMA0_IRQHandler master_DMA0_IRQHandler
+#define DMA1_IRQHandler master_DMA1_IRQHandler
+#elif SIM_CHIP == SIM_CHIP_VIDEO
+#define DMA1_IRQHandler video_DMA1_IRQHandler
+#elif SIM_CHIP == SIM_CHIP_AUDIO
+#define DMA1_IRQHandler audio_DMA1_IRQHandler
+// Second instance of the slave driver
+#define qspi_slave_cs_handler           audio_qspi_slave_cs_handler
+#define qspi_slave_init                 audio_qspi_slave_init
+#define qspi_slave_trigger              audio_qspi_slave_trigger
+#define qspi_slave_wait_rx              audio_qspi_slave_wait_rx
+#define qspi_slave_send_packet          audio_qspi_slave_send_packet
+#define qspi_slave_set_rx_state         audio_qspi_slave_set_rx_state
+#define qspi_slave_get_rx_state         audio_qspi_slave_get_rx_state
+#define qspi_slave_get_rx_header        audio_qspi_slave_get_rx_header
+#define qspi_slave_get_rx_header_time   audio_qspi_slave_get_rx_header_time
+#define qspi_slave_set_rx_data          audio_qspi_slave_set_rx_data
+#else
+#error unknown SIM_CHIP
+#endif
+
+#endif /* _SIM_TARGET_H_ */
@@ -0,0 +1,91 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _DMA_REGS_H_
+#define _DMA_REGS_H_
+
+#include "mxc_device.h"
+
+#define MXC_DMA_CHANNELS                8
+
+#define MXC_DMA0                        (&sim_dma_max32665)
+#define MXC_DMA                         (&sim_dma_max78000[SIM_CHIP])
+
+// Request select field, same encoding in MAX32665 cfg and MAX78000 ctrl
+#define MXC_F_DMA_CFG_REQSEL_POS        4
+#define MXC_F_DMA_CFG_REQSEL            (0x3FUL << MXC_F_DMA_CFG_REQSEL_POS)
+#define MXC_S_DMA_CFG_REQSEL_SPI0RX     (0x01UL << MXC_F_DMA_CFG_REQSEL_POS)
+#define MXC_S_DMA_CFG_REQSEL_SPI1RX     (0x02UL << MXC_F_DMA_CFG_REQSEL_POS)
+#define MXC_S_DMA_CFG_REQSEL_SPI2RX     (0x03UL << MXC_F_DMA_CFG_REQSEL_POS)
+#define MXC_S_DMA_CFG_REQSEL_SPI0TX     (0x21UL << MXC_F_DMA_CFG_REQSEL_POS)
+#define MXC_S_DMA_CFG_REQSEL_SPI1TX     (0x22UL << MXC_F_DMA_CFG_REQSEL_POS)
+#define MXC_S_DMA_CFG_REQSEL_SPI2TX     (0x23UL << MXC_F_DMA_CFG_REQSEL_POS)
+
+// MAX32665 channel configuration and status
+#define MXC_F_DMA_CFG_CHEN              (1UL << 0)
+#define MXC_F_DMA_CFG_RLDEN             (1UL << 1)
+#define MXC_S_DMA_CFG_SRCWD_BYTE        (0UL << 20)
+#define MXC_F_DMA_CFG_SRINC             (1UL << 22)
+#define MXC_S_DMA_CFG_DSTWD_BYTE        (0UL << 25)
+#define MXC_F_DMA_CFG_DISTINC           (1UL << 27)
+#define MXC_F_DMA_CFG_CHDIEN            (1UL << 30)
+#define MXC_F_DMA_CFG_CTZIEN            (1UL << 31)
+
+#define MXC_F_DMA_ST_CH_ST              (1UL << 0)
+#define MXC_F_DMA_ST_IPEND              (1UL << 1)
+#define MXC_F_DMA_ST_CTZ_ST             (1UL << 2)
+#define MXC_F_DMA_ST_RLD_ST             (1UL << 3)
+#define MXC_F_DMA_ST_BUS_ERR            (1UL << 4)
+#define MXC_F_DMA_ST_TO_ST              (1UL << 6)
+
+// MAX78000 channel control and status
+#define MXC_F_DMA_CTRL_EN               (1UL << 0)
+#define MXC_F_DMA_CTRL_RLDEN            (1UL << 1)
+#define MXC_F_DMA_CTRL_REQUEST          MXC_F_DMA_CFG_REQSEL
+#define MXC_S_DMA_CTRL_REQUEST_SPI0RX   MXC_S_DMA_CFG_REQSEL_SPI0RX
+#define MXC_S_DMA_CTRL_REQUEST_SPI0TX   MXC_S_DMA_CFG_REQSEL_SPI0TX
+#define MXC_S_DMA_CTRL_SRCWD_BYTE       (0UL << 20)
+#define MXC_S_DMA_CTRL_SRCWD_WORD       (2UL << 20)
+#define MXC_F_DMA_CTRL_SRCINC           (1UL << 22)
+#define MXC_S_DMA_CTRL_DSTWD_WORD       (2UL << 25)
+#define MXC_F_DMA_CTRL_DSTINC           (1UL << 27)
+#define MXC_F_DMA_CTRL_CTZ_IE           (1UL << 31)
+
+#define MXC_F_DMA_STATUS_CTZ_IF         (1UL << 2)
+#define MXC_F_DMA_STATUS_RLD_IF         (1UL << 3)
+#define MXC_F_DMA_STATUS_BUS_ERR        (1UL << 4)
+#define MXC_F_DMA_STATUS_TO_IF          (1UL << 6)
+
+#endif /* _DMA_REGS_H_ */
@@ -0,0 +1,61 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _FLC_H_
+#define _FLC_H_
+
+#include "mxc_device.h"
+
+// Flash controller, the test provides the flash array and the functions
+#define MXC_FLASH_PAGE_SIZE         0x2000
+
+#define MXC_F_FLC_INTR_DONE         (1u << 0)
+#define MXC_F_FLC_INTR_AF           (1u << 1)
+#define MXC_F_FLC_INTR_DONEIE       (1u << 8)
+#define MXC_F_FLC_INTR_AFIE         (1u << 9)
+
+typedef struct {
+    volatile uint32_t clkdiv;
+    volatile uint32_t intr;
+} mxc_flc_regs_t;
+
+extern mxc_flc_regs_t sim_flc0;
+#define MXC_FLC0                    (&sim_flc0)
+
+int MXC_FLC_PageErase(uint32_t address);
+int MXC_FLC_Write(uint32_t address, uint32_t length, uint32_t *buffer);
+int MXC_FLC_EnableInt(uint32_t flags);
+
+#endif /* _FLC_H_ */
@@ -0,0 +1,146 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _GPIO_H_
+#define _GPIO_H_
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "mxc_device.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define MXC_GPIO0               (&sim_gpio[SIM_CHIP][0])
+#define MXC_GPIO1               (&sim_gpio[SIM_CHIP][1])
+#define MXC_GPIO2               (&sim_gpio[SIM_CHIP][2])
+#define MXC_GPIO3               (&sim_gpio[SIM_CHIP][3])
+
+#define MXC_GPIO_GET_IDX(port)  ((int) (((port) - &sim_gpio[0][0]) % SIM_GPIO_PORTS))
+#define MXC_GPIO_GET_IRQ(idx)   ((IRQn_Type) (GPIO0_IRQn + (idx)))
+
+#define MXC_GPIO_PIN_0          ((uint32_t) (1UL << 0))
+#define MXC_GPIO_PIN_1          ((uint32_t) (1UL << 1))
+#define MXC_GPIO_PIN_2          ((uint32_t) (1UL << 2))
+#define MXC_GPIO_PIN_3          ((uint32_t) (1UL << 3))
+#define MXC_GPIO_PIN_4          ((uint32_t) (1UL << 4))
+#define MXC_GPIO_PIN_5          ((uint32_t) (1UL << 5))
+#define MXC_GPIO_PIN_6          ((uint32_t) (1UL << 6))
+#define MXC_GPIO_PIN_7          ((uint32_t) (1UL << 7))
+#define MXC_GPIO_PIN_8          ((uint32_t) (1UL << 8))
+#define MXC_GPIO_PIN_9          ((uint32_t) (1UL << 9))
+#define MXC_GPIO_PIN_10         ((uint32_t) (1UL << 10))
+#define MXC_GPIO_PIN_11         ((uint32_t) (1UL << 11))
+#define MXC_GPIO_PIN_12         ((uint32_t) (1UL << 12))
+#define MXC_GPIO_PIN_13         ((uint32_t) (1UL << 13))
+#define MXC_GPIO_PIN_14         ((uint32_t) (1UL << 14))
+#define MXC_GPIO_PIN_15         ((uint32_t) (1UL << 15))
+#define MXC_GPIO_PIN_16         ((uint32_t) (1UL << 16))
+#define MXC_GPIO_PIN_17         ((uint32_t) (1UL << 17))
+#define MXC_GPIO_PIN_18         ((uint32_t) (1UL << 18))
+#define MXC_GPIO_PIN_19         ((uint32_t) (1UL << 19))
+#define MXC_GPIO_PIN_20         ((uint32_t) (1UL << 20))
+#define MXC_GPIO_PIN_21         ((uint32_t) (1UL << 21))
+#define MXC_GPIO_PIN_22         ((uint32_t) (1UL << 22))
+#define MXC_GPIO_PIN_23         ((uint32_t) (1UL << 23))
+#define MXC_GPIO_PIN_24         ((uint32_t) (1UL << 24))
+#define MXC_GPIO_PIN_25         ((uint32_t) (1UL << 25))
+#define MXC_GPIO_PIN_26         ((uint32_t) (1UL << 26))
+#define MXC_GPIO_PIN_27         ((uint32_t) (1UL << 27))
+#define MXC_GPIO_PIN_28         ((uint32_t) (1UL << 28))
+#define MXC_GPIO_PIN_29         ((uint32_t) (1UL << 29))
+#define MXC_GPIO_PIN_30         ((uint32_t) (1UL << 30))
+#define MXC_GPIO_PIN_31         ((uint32_t) (1UL << 31))
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+typedef enum {
+    MXC_GPIO_FUNC_IN,
+    MXC_GPIO_FUNC_OUT,
+    MXC_GPIO_FUNC_ALT1,
+    MXC_GPIO_FUNC_ALT2,
+    MXC_GPIO_FUNC_ALT3,
+    MXC_GPIO_FUNC_ALT4,
+} mxc_gpio_func_t;
+
+typedef enum {
+    MXC_GPIO_PAD_NONE,
+    MXC_GPIO_PAD_PULL_UP,
+    MXC_GPIO_PAD_PULL_DOWN,
+} mxc_gpio_pad_t;
+
+typedef enum {
+    MXC_GPIO_VSSEL_VDDIO,
+    MXC_GPIO_VSSEL_VDDIOH,
+} mxc_gpio_vssel_t;
+
+typedef enum {
+    MXC_GPIO_INT_LOW,
+    MXC_GPIO_INT_HIGH,
+    MXC_GPIO_INT_RISING,
+    MXC_GPIO_INT_FALLING,
+    MXC_GPIO_INT_BOTH,
+} mxc_gpio_int_pol_t;
+
+typedef struct {
+    mxc_gpio_regs_t *port;
+    uint32_t mask;
+    mxc_gpio_func_t func;
+    mxc_gpio_pad_t pad;
+    mxc_gpio_vssel_t vssel;
+} mxc_gpio_cfg_t;
+
+typedef void (*mxc_gpio_callback_fn)(void *cbdata);
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+int MXC_GPIO_Config(const mxc_gpio_cfg_t *cfg);
+uint32_t MXC_GPIO_InGet(mxc_gpio_regs_t *port, uint32_t mask);
+uint32_t MXC_GPIO_OutGet(mxc_gpio_regs_t *port, uint32_t mask);
+void MXC_GPIO_OutSet(mxc_gpio_regs_t *port, uint32_t mask);
+void MXC_GPIO_OutClr(mxc_gpio_regs_t *port, uint32_t mask);
+void MXC_GPIO_OutToggle(mxc_gpio_regs_t *port, uint32_t mask);
+void MXC_GPIO_RegisterCallback(const mxc_gpio_cfg_t *cfg, mxc_gpio_callback_fn func, void *cbdata);
+int MXC_GPIO_IntConfig(const mxc_gpio_cfg_t *cfg, mxc_gpio_int_pol_t pol);
+void MXC_GPIO_EnableInt(mxc_gpio_regs_t *port, uint32_t mask);
+void MXC_GPIO_DisableInt(mxc_gpio_regs_t *port, uint32_t mask);
+
+#endif /* _GPIO_H_ */
@@ -0,0 +1,135 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _MXC_DEVICE_H_
+#define _MXC_DEVICE_H_
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mxc_errors.h"
+#include "sim_soc.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#ifndef TRUE
+#define TRUE    1
+#endif
+#ifndef FALSE
+#define FALSE   0
+#endif
+
+#define MXC_SETFIELD(reg, mask, setting)    ((reg) = ((reg) & ~(mask)) | ((setting) & (mask)))
+
+// Cortex-M core, interrupts are dispatched by the simulator
+#define __disable_irq()         sim_irq_disable(SIM_CHIP)
+#define __enable_irq()          sim_irq_enable(SIM_CHIP)
+#define __WFI()                 sim_wfi(SIM_CHIP)
+#define __DMB()                 __sync_synchronize()
+#define __DSB()                 __sync_synchronize()
+#define __ISB()                 __sync_synchronize()
+#define __NOP()                 do {} while (0)
+
+#define NVIC_EnableIRQ(irq)             ((void) (irq))
+#define NVIC_DisableIRQ(irq)            ((void) (irq))
+#define NVIC_ClearPendingIRQ(irq)       ((void) (irq))
+#define NVIC_SetPriority(irq, prio)     ((void) (irq), (void) (prio))
+
+#define DWT                     (sim_dwt(SIM_CHIP))
+#define DWT_CTRL_CYCCNTENA_Msk  1u
+#define CoreDebug               (&sim_core_debug)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1u << 24)
+#define SCB                     (&sim_scb[SIM_CHIP])
+#define SystemCoreClock         (sim_core_clock[SIM_CHIP])
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+typedef enum {
+    FLC0_IRQn = 23,
+    GPIO0_IRQn,
+    GPIO1_IRQn,
+    GPIO2_IRQn,
+    GPIO3_IRQn,
+    DMA0_IRQn = 28,
+    DMA1_IRQn,
+    DMA2_IRQn,
+    DMA3_IRQn,
+    SPI0_IRQn = 40,
+    SPI1_IRQn,
+    SPI2_IRQn,
+} IRQn_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} sim_core_debug_t;
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+extern sim_core_debug_t sim_core_debug;
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+#if defined(__ARM_FEATURE_DSP)
+// Cortex-M4 SIMD, sum of the absolute differences of the four unsigned bytes plus the accumulator
+static inline uint32_t __USADA8(uint32_t op1, uint32_t op2, uint32_t op3)
+{
+    for (int i = 0; i < 32; i += 8) {
+        int a = (op1 >> i) & 0xFF;
+        int b = (op2 >> i) & 0xFF;
+
+        op3 += (a > b) ? (a - b) : (b - a);
+    }
+
+    return op3;
+}
+
+// Cortex-M4 halfword packing and byte reversal
+#define __PKHBT(a, b, s)        ((((uint32_t)(a)) & 0x0000FFFF) | ((((uint32_t)(b)) << (s)) & 0xFFFF0000))
+#define __PKHTB(a, b, s)        ((((uint32_t)(a)) & 0xFFFF0000) | ((((uint32_t)(b)) >> (s)) & 0x0000FFFF))
+#define __REV(a)                __builtin_bswap32(a)
+#endif
+
+#endif /* _MXC_DEVICE_H_ */
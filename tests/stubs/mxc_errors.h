@@ -0,0 +1,61 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _MXC_ERRORS_H_
+#define _MXC_ERRORS_H_
+
+// Maxim SDK return codes
+#define E_NO_ERROR          0
+#define E_SUCCESS           0
+#define E_NULL_PTR          -1
+#define E_NO_DEVICE         -2
+#define E_BAD_PARAM         -3
+#define E_INVALID           -4
+#define E_UNINITIALIZED     -5
+#define E_BUSY              -6
+#define E_BAD_STATE         -7
+#define E_UNKNOWN           -8
+#define E_COMM_ERR          -9
+#define E_TIME_OUT          -10
+#define E_NO_RESPONSE       -11
+#define E_OVERFLOW          -12
+#define E_UNDERFLOW         -13
+#define E_NONE_AVAIL        -14
+#define E_SHUTDOWN          -15
+#define E_ABORT             -16
+#define E_NOT_SUPPORTED     -17
+#define E_FAIL              -255
+
+#endif /* _MXC_ERRORS_H_ */
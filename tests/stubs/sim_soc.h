@@ -0,0 +1,156 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _SIM_SOC_H_
+#define _SIM_SOC_H_
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+// Register files of the chips simulated by qspi_sim, each chip is a separate set of translation
+// units built with its own SIM_CHIP. Tests not linking the simulator only use the types
+#ifndef SIM_CHIP
+#define SIM_CHIP                0
+#endif
+
+#define SIM_CHIP_MASTER         0   // MAX32666
+#define SIM_CHIP_VIDEO          1   // MAX78000 video
+#define SIM_CHIP_AUDIO          2   // MAX78000 audio
+#define SIM_CHIPS               3
+
+#define SIM_GPIO_PORTS          4
+#define SIM_SPI_INSTANCES       3
+#define SIM_DMA_CHANNELS        16
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+typedef struct {
+    volatile uint32_t in;
+    volatile uint32_t out;
+} mxc_gpio_regs_t;
+
+typedef struct {
+    volatile uint32_t ctrl0;
+    volatile uint32_t ctrl1;
+    volatile uint32_t ctrl2;
+    volatile uint32_t ss_time;
+    volatile uint32_t dma;
+    volatile uint32_t stat;
+} mxc_spi_regs_t;
+
+// MAX32665 DMA, the MAX32666 master
+typedef struct {
+    volatile uint32_t cfg;
+    volatile uint32_t st;
+    volatile uint32_t src;
+    volatile uint32_t dst;
+    volatile uint32_t cnt;
+    volatile uint32_t src_rld;
+    volatile uint32_t dst_rld;
+    volatile uint32_t cnt_rld;
+} sim_dma_max32665_ch_t;
+
+typedef struct {
+    volatile uint32_t cn;
+    volatile uint32_t intr;
+    sim_dma_max32665_ch_t ch[SIM_DMA_CHANNELS];
+} sim_dma_max32665_regs_t;
+
+// MAX78000 DMA
+typedef struct {
+    volatile uint32_t ctrl;
+    volatile uint32_t status;
+    volatile uint32_t src;
+    volatile uint32_t dst;
+    volatile uint32_t cnt;
+    volatile uint32_t srcrld;
+    volatile uint32_t dstrld;
+    volatile uint32_t cntrld;
+} sim_dma_max78000_ch_t;
+
+typedef struct {
+    volatile uint32_t inten;
+    volatile uint32_t intfl;
+    sim_dma_max78000_ch_t ch[SIM_DMA_CHANNELS];
+} sim_dma_max78000_regs_t;
+
+typedef struct {
+    volatile uint32_t CYCCNT;
+    volatile uint32_t CTRL;
+} sim_dwt_t;
+
+typedef struct {
+    volatile uint32_t VTOR;
+    volatile uint32_t AIRCR;
+} sim_scb_t;
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+extern mxc_gpio_regs_t sim_gpio[SIM_CHIPS][SIM_GPIO_PORTS];
+extern mxc_spi_regs_t sim_spi[SIM_CHIPS][SIM_SPI_INSTANCES];
+extern sim_dma_max32665_regs_t sim_dma_max32665;
+extern sim_dma_max78000_regs_t sim_dma_max78000[SIM_CHIPS];
+extern sim_scb_t sim_scb[SIM_CHIPS];
+extern uint32_t sim_core_clock[SIM_CHIPS];
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+// Core hooks, PRIMASK and WFI of a chip, DWT reads and busy delays take virtual time
+void sim_irq_disable(int chip);
+void sim_irq_enable(int chip);
+void sim_wfi(int chip);
+sim_dwt_t *sim_dwt(int chip);
+int sim_delay_us(int chip, uint32_t us);
+uint32_t sim_rtc_second(int chip);
+uint32_t sim_rtc_subsecond(int chip);
+
+// Sections the simulator must not switch chips in, e.g. inside stdio
+void sim_preempt_disable(void);
+void sim_preempt_enable(void);
+int sim_printf(int chip, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+#endif /* _SIM_SOC_H_ */
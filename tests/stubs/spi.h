@@ -0,0 +1,136 @@
+/*******************************************************************************
+* Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+*
+* This software is protected by copyright laws of the United States and
+* of foreign countries. This material may also be protected by patent laws
+* and technology transfer regulations of the United States and of foreign
+* countries. This software is furnished under a license agreement and/or a
+* nondisclosure agreement and may only be used or reproduced in accordance
+* with the terms of those agreements. Dissemination of this information to
+* any party or parties not specified in the license agreement and/or
+* nondisclosure agreement is expressly prohibited.
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+*******************************************************************************
+*/
+
+#ifndef _SPI_H_
+#define _SPI_H_
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "mxc_device.h"
+#include "mxc_sys.h"
+#include "gpio.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define MXC_SPI0                            (&sim_spi[SIM_CHIP][0])
+#define MXC_SPI1                            (&sim_spi[SIM_CHIP][1])
+#define MXC_SPI2                            (&sim_spi[SIM_CHIP][2])
+
+// MAX32665 and MAX78000 register fields, both families share the layout the simulator decodes
+#define MXC_F_SPI_CTRL0_EN                  (1UL << 0)
+#define MXC_F_SPI_CTRL0_MASTER              (1UL << 1)
+#define MXC_F_SPI_CTRL0_START               (1UL << 5)
+
+#define MXC_F_SPI_CTRL1_TX_NUM_CHAR_POS     0
+#define MXC_F_SPI_CTRL1_TX_NUM_CHAR         (0xFFFFUL << MXC_F_SPI_CTRL1_TX_NUM_CHAR_POS)
+#define MXC_F_SPI_CTRL1_RX_NUM_CHAR_POS     16
+#define MXC_F_SPI_CTRL1_RX_NUM_CHAR         (0xFFFFUL << MXC_F_SPI_CTRL1_RX_NUM_CHAR_POS)
+
+#define MXC_F_SPI_CTRL2_NUMBITS_POS         8
+#define MXC_F_SPI_CTRL2_NUMBITS             (0xFUL << MXC_F_SPI_CTRL2_NUMBITS_POS)
+#define MXC_S_SPI_CTRL2_DATA_WIDTH_MONO     (0UL << 12)
+#define MXC_S_SPI_CTRL2_DATA_WIDTH_DUAL     (1UL << 12)
+#define MXC_S_SPI_CTRL2_DATA_WIDTH_QUAD     (2UL << 12)
+
+#define MXC_F_SPI_SS_TIME_PRE_POS           0
+#define MXC_F_SPI_SS_TIME_POST_POS          8
+#define MXC_F_SPI_SS_TIME_INACT_POS         16
+
+#define MXC_F_SPI_DMA_TX_FIFO_LEVEL_POS     0
+#define MXC_F_SPI_DMA_TX_THD_VAL_POS        0
+#define MXC_F_SPI_DMA_TX_THD_VAL            (0x1FUL << MXC_F_SPI_DMA_TX_THD_VAL_POS)
+#define MXC_F_SPI_DMA_TX_FIFO_EN            (1UL << 6)
+#define MXC_F_SPI_DMA_TX_FIFO_CLEAR         (1UL << 7)
+#define MXC_F_SPI_DMA_TX_FLUSH              MXC_F_SPI_DMA_TX_FIFO_CLEAR
+#define MXC_F_SPI_DMA_TX_DMA_EN             (1UL << 15)
+#define MXC_F_SPI_DMA_DMA_TX_EN             MXC_F_SPI_DMA_TX_DMA_EN
+#define MXC_F_SPI_DMA_RX_THD_VAL_POS        16
+#define MXC_F_SPI_DMA_RX_THD_VAL            (0x1FUL << MXC_F_SPI_DMA_RX_THD_VAL_POS)
+#define MXC_F_SPI_DMA_RX_FIFO_EN            (1UL << 22)
+#define MXC_F_SPI_DMA_RX_FIFO_CLEAR         (1UL << 23)
+#define MXC_F_SPI_DMA_RX_FLUSH              MXC_F_SPI_DMA_RX_FIFO_CLEAR
+#define MXC_F_SPI_DMA_RX_DMA_EN             (1UL << 31)
+#define MXC_F_SPI_DMA_DMA_RX_EN             MXC_F_SPI_DMA_RX_DMA_EN
+
+#define MXC_F_SPI_STAT_BUSY                 (1UL << 0)
+
+// The two families differ in the last parameter of MXC_SPI_Init
+#if SIM_CHIP == SIM_CHIP_MASTER
+#define MXC_SPI_Init                        sim_spi_init_max32665
+#else
+#define MXC_SPI_Init                        sim_spi_init_max78000
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+typedef enum {
+    SPI_WIDTH_3WIRE,
+    SPI_WIDTH_STANDARD,
+    SPI_WIDTH_DUAL,
+    SPI_WIDTH_QUAD,
+} mxc_spi_width_t;
+
+typedef struct {
+    bool clock;
+    bool ss0;
+    bool ss1;
+    bool ss2;
+    bool miso;
+    bool mosi;
+    bool sdio2;
+    bool sdio3;
+    bool vddioh;
+} mxc_spi_pins_t;
+
+
+//-----------------------------------------------------------------------------
+// Function declarations
+//-----------------------------------------------------------------------------
+#if SIM_CHIP == SIM_CHIP_MASTER
+int MXC_SPI_Init(mxc_spi_regs_t *spi, int masterMode, int quadModeUsed, int numSlaves,
+                 unsigned ssPolarity, unsigned int hz, sys_map_t map);
+#else
+int MXC_SPI_Init(mxc_spi_regs_t *spi, int masterMode, int quadModeUsed, int numSlaves,
+                 unsigned ssPolarity, unsigned int hz, mxc_spi_pins_t pins);
+#endif
+int MXC_SPI_Shutdown(mxc_spi_regs_t *spi);
+int MXC_SPI_SetWidth(mxc_spi_regs_t *spi, mxc_spi_width_t width);
+
+#endif /* _SPI_H_ */
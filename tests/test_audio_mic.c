@@ -0,0 +1,479 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+
+// Bit-exact replay of microphone words through the original per-sample FIFO path and the DMA block path:
+// high pass filter, 8-bit chunks, chunk averages, max/min and the transposed CNN input
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <math.h>
+
+#include "test_common.h"
+#include "maxrefdes178_mic.h"
+#include "maxrefdes178_utility.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+// Same as max78000_audio_main.c
+#define CHUNK                   128
+#define TRANSPOSE_WIDTH         128
+#define SAMPLE_SIZE             16384
+#define PREAMBLE_SIZE           (30 * CHUNK)
+#define SAMPLE_SCALE_FACTOR     5
+#define MIC_DISCARD_SAMPLES     10000
+#define MIC_DISCARD_FIRST_BLOCK ((MIC_DISCARD_SAMPLES % CHUNK) ? (MIC_DISCARD_SAMPLES % CHUNK) : CHUNK)
+
+#define SAMPLE_RATE             16000
+#define REPLAY_SECONDS          20
+#define MAX_WORDS               (SAMPLE_RATE * 120)
+#define BENCH_ROUNDS            20
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+typedef struct {
+    uint8_t data[CHUNK];
+    uint16_t avg;
+    int16_t max;
+    int16_t min;
+} chunk_t;
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static int32_t words[MAX_WORDS];
+static uint32_t word_count;
+static chunk_t ref_chunks[MAX_WORDS / CHUNK];
+static chunk_t new_chunks[MAX_WORDS / CHUNK];
+
+// Original per-sample state
+static int16_t ref_x0, ref_x1, ref_coeff;
+static int32_t ref_y0, ref_y1;
+static int16_t ref_max, ref_min;
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+// Original HPF_init() and HPF(), one sample per call
+static void ref_hpf_init(void)
+{
+    ref_coeff = 32604; //0.995
+    ref_x0 = 0;
+    ref_y0 = 0;
+    ref_y1 = ref_y0;
+    ref_x1 = ref_x0;
+}
+
+static int16_t ref_hpf(int16_t input)
+{
+    int16_t Acc, output;
+    int32_t tmp;
+
+    ref_x0 = input;
+
+    tmp = (ref_coeff * ref_y1);
+    Acc = (int16_t)((tmp + (1 << 14)) >> 15);
+    ref_y0 = ref_x0 - ref_x1 + Acc;
+
+    if (ref_y0 > 32767) {
+        ref_y0 = 32767;
+    }
+
+    if (ref_y0 < -32768) {
+        ref_y0 = -32768;
+    }
+
+    ref_y1 = ref_y0;
+    ref_x1 = ref_x0;
+
+    output = (int16_t)ref_y0;
+
+    return (output);
+}
+
+// Original MicReadChunk(), rx_size words are read from the I2S FIFO per interrupt.
+// The sum is 32 bits as in the block path, the original 16-bit sum wrapped on loud chunks
+static int ref_read_chunk(const int32_t *fifo, uint32_t *pos, uint32_t rx_size, uint8_t *pBuff, uint16_t *avg)
+{
+    static uint16_t chunkCount = 0;
+    static uint32_t sum = 0;
+    static uint32_t index = 0;
+
+    int32_t sample = 0;
+    int16_t temp = 0;
+
+    while ((rx_size--) && (chunkCount < CHUNK)) {
+        sample = fifo[(*pos)++];
+        temp = sample >> 14;
+
+        sample = ref_hpf((int16_t)temp);
+
+        if (index++ < MIC_DISCARD_SAMPLES)
+            continue;
+
+        if (sample >= 0)
+            sum += sample;
+        else
+            sum -= sample;
+
+        pBuff[chunkCount] = (uint8_t)((sample)*SAMPLE_SCALE_FACTOR/256);
+
+        temp=(int8_t)pBuff[chunkCount];
+
+        chunkCount++;
+
+        if (temp > ref_max) {
+            ref_max = temp;
+        }
+
+        if (temp < ref_min) {
+            ref_min = temp;
+        }
+    }
+
+    if (chunkCount < CHUNK) {
+        *avg = 0;
+        return 0;
+    }
+
+    *avg = ((uint16_t)(sum / CHUNK));
+
+    chunkCount = 0;
+    sum = 0;
+    return 1;
+}
+
+// Original AddTranspose(), one byte at a time
+static uint8_t ref_transpose(const uint8_t *pIn, uint8_t *pOut, uint16_t inSize, uint16_t outSize, uint16_t width)
+{
+    static uint16_t row = 0, col = 0, total = 0;
+    uint16_t secondHalf = 0, wordRow = 0, byteInWord = 0, group = 0, index = 0;
+
+    for (int i = 0; i < inSize; i++) {
+        secondHalf = (col >= (width >> 1));
+        group = (col % (width >> 1)) / 4;
+        wordRow = secondHalf + (row << 1);
+        byteInWord = col % 4;
+        index = 1024 * group + 4 * wordRow + byteInWord;
+
+        pOut[index] = pIn[i];
+
+        total++;
+
+        col++;
+        if (col >= width) {
+            col = 0;
+            row++;
+        }
+    }
+
+    if (total >= outSize) {
+        total = 0;
+        row = 0;
+        col = 0;
+        return 1;
+    }
+
+    return 0;
+}
+
+// Replays words through the original path, the FIFO threshold interrupt finds 1 to 8 words
+static uint32_t ref_replay(const int32_t *in, uint32_t count, chunk_t *chunks)
+{
+    uint32_t pos = 0, n = 0, rx_size;
+
+    ref_hpf_init();
+    ref_max = 0;
+    ref_min = 0;
+
+    while (pos < count) {
+        rx_size = 1 + test_rand() % 8;
+        if (rx_size > count - pos) {
+            rx_size = count - pos;
+        }
+        if (ref_read_chunk(in, &pos, rx_size, chunks[n].data, &chunks[n].avg)) {
+            chunks[n].max = ref_max;
+            chunks[n].min = ref_min;
+            n++;
+        }
+    }
+
+    return n;
+}
+
+// Replays words through the DMA block path as MicReadChunk() does: the first block finishes the
+// discarded samples, then every block is one CHUNK
+static uint32_t block_replay(const int32_t *in, uint32_t count, chunk_t *chunks)
+{
+    mic_hpf_t hpf;
+    int16_t hpf_block[CHUNK];
+    int16_t max = 0, min = 0;
+    uint32_t pos = 0, n = 0, index = 0;
+    uint16_t size = MIC_DISCARD_FIRST_BLOCK;
+
+    mic_hpf_init(&hpf);
+
+    while ((count - pos) >= size) {
+        mic_hpf(&hpf, &in[pos], hpf_block, size);
+        pos += size;
+
+        if (index < MIC_DISCARD_SAMPLES) {
+            index += size;
+        } else {
+            chunks[n].avg = mic_chunk(hpf_block, chunks[n].data, CHUNK, SAMPLE_SCALE_FACTOR, &max, &min);
+            chunks[n].max = max;
+            chunks[n].min = min;
+            n++;
+        }
+
+        size = CHUNK;
+    }
+
+    return n;
+}
+
+// 18-bit microphone sample in the MSBs of the I2S word, low bits are noise
+static int32_t mic_word(int32_t sample)
+{
+    if (sample > 131071) {
+        sample = 131071;
+    }
+    if (sample < -131072) {
+        sample = -131072;
+    }
+
+    return (int32_t)((uint32_t) sample << 14) | (test_rand() & 0x3FFF);
+}
+
+// DC offset and noise with tone bursts, loud enough to clip the filter, and full scale random words
+static void make_words(uint32_t seconds)
+{
+    double phase = 0;
+
+    word_count = seconds * SAMPLE_RATE;
+    for (uint32_t i = 0; i < word_count; i++) {
+        uint32_t t = i % SAMPLE_RATE;
+        double level = 0;
+
+        if (t < 4000) {
+            level = 0;
+        } else if (t < 8000) {
+            level = 3000;
+        } else if (t < 12000) {
+            level = 60000 + 70000 * ((i / SAMPLE_RATE) % 2);
+        } else if (t < 13000) {
+            words[i] = (int32_t) test_rand();
+            continue;
+        }
+
+        phase += 2 * M_PI * (300 + 50 * (i / SAMPLE_RATE)) / SAMPLE_RATE;
+        words[i] = mic_word(-20000 + (int32_t)(level * sin(phase)) + (int32_t)(test_rand() % 401) - 200);
+    }
+}
+
+static int load_words(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+
+    if (!f) {
+        printf("cannot open %s\n", path);
+        return -1;
+    }
+
+    word_count = fread(words, sizeof(words[0]), MAX_WORDS, f);
+    fclose(f);
+
+    if (word_count < (MIC_DISCARD_SAMPLES + CHUNK)) {
+        printf("%s: %u words, at least %u needed\n", path, word_count, MIC_DISCARD_SAMPLES + CHUNK);
+        return -1;
+    }
+    printf("replaying %u words from %s\n", word_count, path);
+
+    return 0;
+}
+
+static void test_chunks(void)
+{
+    uint32_t ref_count = ref_replay(words, word_count, ref_chunks);
+    uint32_t new_count = block_replay(words, word_count, new_chunks);
+
+    CHECK(ref_count == new_count, "chunks %u expected %u", new_count, ref_count);
+    CHECK(ref_count == (word_count - MIC_DISCARD_SAMPLES) / CHUNK, "chunks %u", ref_count);
+
+    for (uint32_t n = 0; n < MIN(ref_count, new_count); n++) {
+        CHECK(!memcmp(ref_chunks[n].data, new_chunks[n].data, CHUNK), "chunk %u data", n);
+        CHECK(ref_chunks[n].avg == new_chunks[n].avg, "chunk %u avg %u expected %u", n, new_chunks[n].avg, ref_chunks[n].avg);
+        CHECK((ref_chunks[n].max == new_chunks[n].max) && (ref_chunks[n].min == new_chunks[n].min),
+              "chunk %u max/min %d/%d expected %d/%d", n, new_chunks[n].max, new_chunks[n].min,
+              ref_chunks[n].max, ref_chunks[n].min);
+    }
+}
+
+// Builds CNN inputs from the replayed chunks the way the main loop does: a preamble circular buffer
+// split at a random chunk followed by keyword chunks, and a sliding window split at a random chunk
+static void test_transpose(void)
+{
+    static uint8_t ref_out[SAMPLE_SIZE], new_out[SAMPLE_SIZE];
+    static uint8_t flat[SAMPLE_SIZE * 2];
+    uint32_t chunk_count = (word_count - MIC_DISCARD_SAMPLES) / CHUNK;
+    const uint8_t *samples = flat;
+    uint16_t row = 0;
+    int ref_ret, new_ret;
+
+    // Replayed chunks back to back, as in the circular buffers
+    for (uint32_t n = 0; n < (sizeof(flat) / CHUNK); n++) {
+        memcpy(&flat[n * CHUNK], ref_chunks[n % chunk_count].data, CHUNK);
+    }
+
+    for (int word = 0; word < 64; word++) {
+        uint32_t split = (test_rand() % (PREAMBLE_SIZE / CHUNK)) * CHUNK;
+        uint32_t pos = PREAMBLE_SIZE;
+
+        memset(ref_out, 0x55, sizeof(ref_out));
+        memset(new_out, 0x55, sizeof(new_out));
+
+        ref_ret = ref_transpose(&samples[split], ref_out, PREAMBLE_SIZE - split, SAMPLE_SIZE, TRANSPOSE_WIDTH);
+        new_ret = mic_transpose(&row, &samples[split], new_out, PREAMBLE_SIZE - split, SAMPLE_SIZE, TRANSPOSE_WIDTH);
+        if (split) {
+            ref_ret = ref_transpose(samples, ref_out, split, SAMPLE_SIZE, TRANSPOSE_WIDTH);
+            new_ret = mic_transpose(&row, samples, new_out, split, SAMPLE_SIZE, TRANSPOSE_WIDTH);
+        }
+        CHECK(!ref_ret && (new_ret == MIC_TRANSPOSE_PARTIAL), "word %d preamble", word);
+
+        while (pos < SAMPLE_SIZE) {
+            ref_ret = ref_transpose(&samples[pos], ref_out, CHUNK, SAMPLE_SIZE, TRANSPOSE_WIDTH);
+            new_ret = mic_transpose(&row, &samples[pos], new_out, CHUNK, SAMPLE_SIZE, TRANSPOSE_WIDTH);
+            pos += CHUNK;
+            CHECK(ref_ret == new_ret, "word %d pos %u ret %d expected %d", word, pos, new_ret, ref_ret);
+        }
+        CHECK((ref_ret == 1) && (row == 0), "word %d not completed", word);
+        CHECK(!memcmp(ref_out, new_out, SAMPLE_SIZE), "word %d keyword buffer", word);
+
+        samples = &flat[(test_rand() % (SAMPLE_SIZE / CHUNK)) * CHUNK];
+    }
+
+    for (int window = 0; window < 64; window++) {
+        uint32_t split = (test_rand() % (SAMPLE_SIZE / CHUNK)) * CHUNK;
+
+        ref_ret = ref_transpose(&samples[split], ref_out, SAMPLE_SIZE - split, SAMPLE_SIZE, TRANSPOSE_WIDTH);
+        new_ret = mic_transpose(&row, &samples[split], new_out, SAMPLE_SIZE - split, SAMPLE_SIZE, TRANSPOSE_WIDTH);
+        if (split) {
+            ref_ret = ref_transpose(samples, ref_out, split, SAMPLE_SIZE, TRANSPOSE_WIDTH);
+            new_ret = mic_transpose(&row, samples, new_out, split, SAMPLE_SIZE, TRANSPOSE_WIDTH);
+        }
+        CHECK((ref_ret == 1) && (new_ret == MIC_TRANSPOSE_DONE), "window %d split %u", window, split);
+        CHECK(!memcmp(ref_out, new_out, SAMPLE_SIZE), "window %d split %u", window, split);
+    }
+
+    // Partial rows are rejected without moving the row, rows past the buffer are dropped
+    CHECK(mic_transpose(&row, samples, new_out, CHUNK + 1, SAMPLE_SIZE, TRANSPOSE_WIDTH) == MIC_TRANSPOSE_ERROR, "partial row");
+    CHECK(row == 0, "row %u after partial row", row);
+    memcpy(ref_out, new_out, SAMPLE_SIZE);
+    CHECK(mic_transpose(&row, samples, new_out, SAMPLE_SIZE, SAMPLE_SIZE / 2, TRANSPOSE_WIDTH) == MIC_TRANSPOSE_DONE, "overflow");
+    CHECK(row == 0, "row %u after overflow", row);
+    for (uint32_t group = 0; group < (SAMPLE_SIZE / 1024); group++) {
+        // Word rows of the second half of the rows are untouched
+        CHECK(!memcmp(&ref_out[1024 * group + 512], &new_out[1024 * group + 512], 512), "overflow group %u", group);
+    }
+}
+
+static void bench(void)
+{
+    static uint8_t out[SAMPLE_SIZE];
+    uint64_t start, ref_ns, new_ns;
+    uint16_t row = 0;
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        ref_replay(words, word_count, ref_chunks);
+    }
+    ref_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        block_replay(words, word_count, new_chunks);
+    }
+    new_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    printf("mic chunks  per second of audio: per sample %7.1f us, block %7.1f us, %.1fx\n",
+           ref_ns / 1000.0 / (word_count / SAMPLE_RATE), new_ns / 1000.0 / (word_count / SAMPLE_RATE),
+           (double) ref_ns / new_ns);
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS * 10; i++) {
+        ref_transpose((const uint8_t *) words, out, SAMPLE_SIZE, SAMPLE_SIZE, TRANSPOSE_WIDTH);
+    }
+    ref_ns = (test_time_ns() - start) / (BENCH_ROUNDS * 10);
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS * 10; i++) {
+        mic_transpose(&row, (const uint8_t *) words, out, SAMPLE_SIZE, SAMPLE_SIZE, TRANSPOSE_WIDTH);
+    }
+    new_ns = (test_time_ns() - start) / (BENCH_ROUNDS * 10);
+
+    printf("mic transpose 16 KB CNN input:   per byte   %7.1f us, rows  %7.1f us, %.1fx\n",
+           ref_ns / 1000.0, new_ns / 1000.0, (double) ref_ns / new_ns);
+}
+
+int main(int argc, char **argv)
+{
+    int bench_mode = test_bench_mode(argc, argv);
+    const char *replay = (argc > (1 + bench_mode)) ? argv[1 + bench_mode] : NULL;
+
+    if (replay) {
+        if (load_words(replay)) {
+            return 1;
+        }
+    } else {
+        make_words(REPLAY_SECONDS);
+    }
+
+    if (bench_mode) {
+        bench();
+        return 0;
+    }
+
+    test_chunks();
+    test_transpose();
+
+    return test_result("audio_mic");
+}
@@ -0,0 +1,448 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+
+// Lock-free BLE queues between core0 and core1 under two host threads, and their cost against
+// the hardware semaphore protected queue they replaced. Threads yield on a full or empty queue
+// so the test also runs on a single host CPU
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#include "test_common.h"
+#include "max32666_ble_queue.h"
+#include "mxc_errors.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define STRESS_PACKETS      1000000
+#define FLUSH_PACKETS       300000
+#define FLUSH_INTERVAL      1000  // packets between tx flushes, randomized
+#define BENCH_PACKETS       1000000
+
+// Smallest packet holds the command header and the sequence number
+#define PACKET_MIN_SIZE     (sizeof(ble_command_packet_header_t) + sizeof(uint32_t))
+#define PACKET_SIZE(seq)    (PACKET_MIN_SIZE + ((seq) % (BLE_MAX_PACKET_SIZE - PACKET_MIN_SIZE + 1)))
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+// Original queue, every access takes MAX32666_SEMAPHORE_BLE_QUEUE
+typedef struct {
+    ble_packet_container_t container_array[MAX32666_BLE_QUEUE_SIZE];
+    uint32_t head;
+    uint32_t tail;
+} sema_queue_t;
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static uint8_t flush_boundary[FLUSH_PACKETS];  // first packet enqueued after a flush
+static atomic_flag sema = ATOMIC_FLAG_INIT;
+static volatile sema_queue_t sema_queue;
+static volatile int producer_done;
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+// Packet content is derived from its sequence number so torn copies are detected
+static void fill_packet(ble_packet_container_t *container, uint32_t seq)
+{
+    container->size = PACKET_SIZE(seq);
+    memcpy(container->packet.command_packet.payload, &seq, sizeof(seq));
+    memset(&container->packet.command_packet.payload[sizeof(seq)], seq & 0xFF,
+           container->size - sizeof(ble_command_packet_header_t) - sizeof(seq));
+}
+
+static int check_packet(const ble_packet_container_t *container, uint32_t *seq)
+{
+    const uint8_t *payload = container->packet.command_packet.payload;
+
+    memcpy(seq, payload, sizeof(*seq));
+
+    if (container->size != PACKET_SIZE(*seq)) {
+        return 0;
+    }
+
+    for (uint32_t i = sizeof(*seq); i < container->size - sizeof(ble_command_packet_header_t); i++) {
+        if (payload[i] != (*seq & 0xFF)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Periodic responses are sent every interval and must not need the multi packet path
+static void test_response_sizes(void)
+{
+    CHECK(sizeof(device_statistics_t) <= BLE_COMMAND_PACKET_MAX_PAYLOAD_SIZE,
+          "statistics %zu bytes\n", sizeof(device_statistics_t));
+    CHECK(sizeof(classification_result_t) <= BLE_COMMAND_PACKET_MAX_PAYLOAD_SIZE,
+          "classification %zu bytes\n", sizeof(classification_result_t));
+    CHECK(sizeof(device_timing_t) <= MAX32666_BLE_COMMAND_BUFFER_SIZE,
+          "timing %zu bytes\n", sizeof(device_timing_t));
+}
+
+static void test_single_thread(void)
+{
+    ble_packet_container_t container;
+    uint32_t seq;
+    int ret;
+
+    ble_queue_init();
+
+    // One slot stays empty to tell full from empty
+    for (uint32_t i = 0; i < MAX32666_BLE_QUEUE_SIZE - 1; i++) {
+        fill_packet(&container, i);
+        CHECK(ble_queue_enq_rx(&container) == E_SUCCESS, "enq %u", i);
+    }
+    CHECK(ble_queue_enq_rx(&container) == E_OVERFLOW, "enq on a full queue");
+    CHECK(ble_queue_reserve_rx() == NULL, "reserve on a full queue");
+
+    for (uint32_t i = 0; i < MAX32666_BLE_QUEUE_SIZE - 1; i++) {
+        ret = ble_queue_deq_rx(&container);
+        CHECK((ret == E_SUCCESS) && check_packet(&container, &seq) && (seq == i), "deq %u", i);
+    }
+    CHECK(ble_queue_deq_rx(&container) == E_UNDERFLOW, "deq on an empty queue");
+    CHECK(ble_queue_peek_rx() == NULL, "peek on an empty queue");
+
+    // Flush drops tx packets committed before it, the consumer applies it on its next peek
+    for (uint32_t i = 0; i < 3; i++) {
+        fill_packet(&container, i);
+        ble_queue_enq_tx(&container);
+    }
+    ble_queue_flush();
+    fill_packet(&container, 3);
+    ble_queue_enq_tx(&container);
+    CHECK(ble_queue_peek_tx() == NULL, "flush is applied by a peek");
+    ret = ble_queue_deq_tx(&container);
+    CHECK((ret == E_SUCCESS) && check_packet(&container, &seq) && (seq == 3), "packet after flush");
+    CHECK(ble_queue_deq_tx(&container) == E_UNDERFLOW, "tx empty after flush");
+
+    // Core1 sends packets after the oldest before releasing it, a flush drops them all
+    for (uint32_t i = 0; i < MAX32666_BLE_QUEUE_SIZE - 1; i++) {
+        fill_packet(&container, i);
+        ble_queue_enq_tx(&container);
+    }
+    for (uint32_t i = 0; i < MAX32666_BLE_QUEUE_SIZE - 1; i++) {
+        ble_packet_container_t *slot = ble_queue_peek_tx_at(i);
+        CHECK((slot != NULL) && check_packet(slot, &seq) && (seq == i), "peek at %u", i);
+    }
+    CHECK(ble_queue_peek_tx_at(MAX32666_BLE_QUEUE_SIZE - 1) == NULL, "peek past the newest");
+    ble_queue_release_tx();
+    CHECK((ble_queue_peek_tx_at(0) != NULL) && check_packet(ble_queue_peek_tx_at(0), &seq) && (seq == 1),
+          "peek at 0 after a release");
+    CHECK(ble_queue_peek_tx_at(MAX32666_BLE_QUEUE_SIZE - 2) == NULL, "peek past the newest after a release");
+    ble_queue_flush();
+    CHECK(ble_queue_peek_tx_at(1) == NULL, "flush is applied by a peek at an index");
+    CHECK(ble_queue_peek_tx() == NULL, "tx empty after flush");
+}
+
+// core1, BLE stack receiving packets
+static void *rx_producer(void *arg)
+{
+    ble_packet_container_t container;
+    ble_packet_container_t *slot;
+
+    (void) arg;
+
+    for (uint32_t seq = 0; seq < STRESS_PACKETS; ) {
+        // Both producer interfaces, in place and by copy
+        if (seq & 1) {
+            slot = ble_queue_reserve_rx();
+            if (slot != NULL) {
+                fill_packet(slot, seq++);
+                ble_queue_commit_rx();
+            } else {
+                sched_yield();
+            }
+        } else {
+            fill_packet(&container, seq);
+            if (ble_queue_enq_rx(&container) == E_SUCCESS) {
+                seq++;
+            } else {
+                sched_yield();
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void test_stress_rx(void)
+{
+    pthread_t producer;
+    ble_packet_container_t container;
+    ble_packet_container_t *slot;
+    uint32_t expected = 0;
+    uint32_t seq;
+    int bad = 0;
+
+    ble_queue_init();
+    pthread_create(&producer, NULL, rx_producer, NULL);
+
+    // core0, ble_command_worker
+    while (expected < STRESS_PACKETS) {
+        if (expected & 2) {
+            slot = ble_queue_peek_rx();
+            if (slot == NULL) {
+                sched_yield();
+                continue;
+            }
+            memcpy(&container, slot, sizeof(container));
+            ble_queue_release_rx();
+        } else if (ble_queue_deq_rx(&container) != E_SUCCESS) {
+            sched_yield();
+            continue;
+        }
+
+        if (!check_packet(&container, &seq) || (seq != expected)) {
+            if (bad++ < 5) {
+                CHECK(0, "rx packet %u received as %u", expected, seq);
+            }
+        }
+        expected++;
+    }
+
+    pthread_join(producer, NULL);
+    CHECK(bad == 0, "%d of %d rx packets lost, reordered or torn", bad, STRESS_PACKETS);
+}
+
+// core0, responses with an abort now and then
+static void *tx_producer(void *arg)
+{
+    ble_packet_container_t container;
+    uint32_t next_flush = FLUSH_INTERVAL;
+
+    (void) arg;
+
+    for (uint32_t seq = 0; seq < FLUSH_PACKETS; ) {
+        if (seq == next_flush) {
+            flush_boundary[seq] = 1;
+            ble_queue_flush();
+            next_flush += 1 + (test_rand() % (2 * FLUSH_INTERVAL));
+        }
+
+        fill_packet(&container, seq);
+        if (ble_queue_enq_tx(&container) == E_SUCCESS) {
+            seq++;
+        } else {
+            sched_yield();
+        }
+    }
+
+    producer_done = 1;
+
+    return NULL;
+}
+
+static void test_stress_flush(void)
+{
+    pthread_t producer;
+    ble_packet_container_t container;
+    uint32_t last = UINT32_MAX;
+    uint32_t seq;
+    int received = 0;
+    int bad = 0;
+
+    ble_queue_init();
+    producer_done = 0;
+    memset(flush_boundary, 0, sizeof(flush_boundary));
+    pthread_create(&producer, NULL, tx_producer, NULL);
+
+    // core1, ble_worker. Stops once the producer is done and the queue is drained
+    while (1) {
+        int done = producer_done;
+
+        if (ble_queue_deq_tx(&container) != E_SUCCESS) {
+            if (done && (ble_queue_peek_tx() == NULL)) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        received++;
+
+        // In order, and packets are skipped only up to a flush boundary
+        if (!check_packet(&container, &seq) || ((last != UINT32_MAX) && (seq <= last)) ||
+            ((seq != last + 1) && !flush_boundary[seq])) {
+            if (bad++ < 5) {
+                CHECK(0, "tx packet %u after %u", seq, last);
+            }
+        }
+        last = seq;
+    }
+
+    pthread_join(producer, NULL);
+    CHECK(bad == 0, "%d tx packets out of order or dropped without a flush", bad);
+    CHECK(last == FLUSH_PACKETS - 1, "last tx packet %u", last);
+    printf("flush stress: %d of %d tx packets delivered\n", received, FLUSH_PACKETS);
+}
+
+static int sema_enq(volatile sema_queue_t *queue, ble_packet_container_t *container)
+{
+    uint32_t next;
+
+    while (atomic_flag_test_and_set_explicit(&sema, memory_order_acquire)) {}
+
+    next = (queue->head + 1) % MAX32666_BLE_QUEUE_SIZE;
+    if (next == queue->tail) {
+        atomic_flag_clear_explicit(&sema, memory_order_release);
+        return E_OVERFLOW;
+    }
+
+    memcpy((uint8_t *) &queue->container_array[queue->head], container, sizeof(ble_packet_container_t));
+    queue->head = next;
+
+    atomic_flag_clear_explicit(&sema, memory_order_release);
+
+    return E_SUCCESS;
+}
+
+static int sema_deq(volatile sema_queue_t *queue, ble_packet_container_t *container)
+{
+    while (atomic_flag_test_and_set_explicit(&sema, memory_order_acquire)) {}
+
+    if (queue->head == queue->tail) {
+        atomic_flag_clear_explicit(&sema, memory_order_release);
+        return E_UNDERFLOW;
+    }
+
+    memcpy(container, (uint8_t *) &queue->container_array[queue->tail], sizeof(ble_packet_container_t));
+    queue->tail = (queue->tail + 1) % MAX32666_BLE_QUEUE_SIZE;
+
+    atomic_flag_clear_explicit(&sema, memory_order_release);
+
+    return E_SUCCESS;
+}
+
+static void *bench_producer(void *arg)
+{
+    ble_packet_container_t container;
+    ble_packet_container_t *slot;
+    int sema_mode = *(int *) arg;
+
+    fill_packet(&container, BLE_MAX_PACKET_SIZE);
+
+    for (uint32_t i = 0; i < BENCH_PACKETS; ) {
+        if (sema_mode) {
+            if (sema_enq(&sema_queue, &container) == E_SUCCESS) {
+                i++;
+                continue;
+            }
+        } else if ((slot = ble_queue_reserve_rx()) != NULL) {
+            memcpy(slot, &container, sizeof(container));
+            ble_queue_commit_rx();
+            i++;
+            continue;
+        }
+        sched_yield();
+    }
+
+    return NULL;
+}
+
+static double bench_two_threads(int sema_mode)
+{
+    pthread_t producer;
+    ble_packet_container_t container;
+    uint64_t start;
+
+    ble_queue_init();
+    memset((void *) &sema_queue, 0, sizeof(sema_queue));
+
+    start = test_time_ns();
+    pthread_create(&producer, NULL, bench_producer, &sema_mode);
+    for (uint32_t i = 0; i < BENCH_PACKETS; ) {
+        if ((sema_mode ? sema_deq(&sema_queue, &container) : ble_queue_deq_rx(&container)) == E_SUCCESS) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+    pthread_join(producer, NULL);
+
+    return (double) (test_time_ns() - start) / BENCH_PACKETS;
+}
+
+static double bench_one_thread(int sema_mode)
+{
+    ble_packet_container_t container;
+    uint64_t start;
+
+    ble_queue_init();
+    memset((void *) &sema_queue, 0, sizeof(sema_queue));
+    fill_packet(&container, BLE_MAX_PACKET_SIZE);
+
+    start = test_time_ns();
+    for (uint32_t i = 0; i < BENCH_PACKETS; i++) {
+        if (sema_mode) {
+            sema_enq(&sema_queue, &container);
+            sema_deq(&sema_queue, &container);
+        } else {
+            ble_queue_enq_rx(&container);
+            ble_queue_deq_rx(&container);
+        }
+    }
+
+    return (double) (test_time_ns() - start) / BENCH_PACKETS;
+}
+
+int main(int argc, char **argv)
+{
+    if (test_bench_mode(argc, argv)) {
+        printf("ble queue ns/packet       semaphore  lock-free\n");
+        printf("  enq+deq, one thread     %9.1f  %9.1f\n", bench_one_thread(1), bench_one_thread(0));
+        printf("  two threads             %9.1f  %9.1f\n", bench_two_threads(1), bench_two_threads(0));
+        return 0;
+    }
+
+    test_response_sizes();
+    test_single_thread();
+    test_stress_rx();
+    test_stress_flush();
+
+    return test_result("ble_queue");
+}
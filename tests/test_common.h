@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+
+#ifndef _TEST_COMMON_H_
+#define _TEST_COMMON_H_
+
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+// Count a failed check and keep going, main returns test_failed()
+#define CHECK(cond, ...)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            if (test_fail_count++ < 10) {                                   \
+                printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond); \
+                printf(__VA_ARGS__);                                        \
+                printf("\n");                                               \
+            }                                                               \
+        }                                                                   \
+    } while (0)
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static int test_fail_count = 0;
+static uint32_t test_rand_state = 0x12345678;
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+static inline uint64_t test_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t) ts.tv_sec * 1000000000u) + ts.tv_nsec;
+}
+
+// Deterministic xorshift, runs are reproducible across hosts
+static inline uint32_t test_rand(void)
+{
+    test_rand_state ^= test_rand_state << 13;
+    test_rand_state ^= test_rand_state >> 17;
+    test_rand_state ^= test_rand_state << 5;
+
+    return test_rand_state;
+}
+
+static inline void test_rand_fill(uint8_t *buff, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        buff[i] = test_rand();
+    }
+}
+
+// Benchmarks run with "bench" as the first argument
+static inline int test_bench_mode(int argc, char **argv)
+{
+    return (argc > 1) && !strcmp(argv[1], "bench");
+}
+
+static inline int test_result(const char *name)
+{
+    if (test_fail_count) {
+        printf("%s: FAILED, %d checks\n", name, test_fail_count);
+        return 1;
+    }
+
+    printf("%s: passed\n", name);
+    return 0;
+}
+
+#endif /* _TEST_COMMON_H_ */
@@ -0,0 +1,158 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+
+// Bit-exactness of the table driven CRC-16 against the original bitwise routine, and its speed
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "test_common.h"
+#include "maxrefdes178_utility.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define FRAME_SIZE      (240 * 240 * 2)
+#define BENCH_ROUNDS    50
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static uint8_t frame[FRAME_SIZE + 8];
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+// Original crc16_sw, one bit at a time. Length widened from uint8_t so whole frames can be compared
+static uint16_t crc16_bitwise(const uint8_t *data, uint32_t len)
+{
+    uint16_t temp;
+    uint16_t crcval = 0;
+
+    for (uint32_t i = 0; i < len; ++i) {
+        temp = (data[i] & 0xFF);
+        for (int j = 0; j < 8; ++j) {
+            if ((temp ^ crcval) & 1) {
+                crcval >>= 1;
+                crcval ^= 0xA001;
+            } else {
+                crcval >>= 1;
+            }
+            temp >>= 1;
+        }
+    }
+
+    return crcval;
+}
+
+static void test_lengths(void)
+{
+    // All short lengths at every alignment
+    for (uint32_t offset = 0; offset < 4; offset++) {
+        for (uint32_t len = 0; len <= 600; len++) {
+            uint16_t expected = crc16_bitwise(&frame[offset], len);
+            uint16_t crc = crc16_sw(&frame[offset], len);
+            CHECK(crc == expected, "offset %u len %u crc 0x%04x expected 0x%04x", offset, len, crc, expected);
+        }
+    }
+
+    // Known answer, CRC-16/ARC of "123456789"
+    CHECK(crc16_sw((const uint8_t *) "123456789", 9) == 0xBB3D, "check value 0x%04x", crc16_sw((const uint8_t *) "123456789", 9));
+}
+
+static void test_frame(void)
+{
+    uint16_t expected = crc16_bitwise(frame, FRAME_SIZE);
+    uint16_t crc;
+
+    CHECK(crc16_sw(frame, FRAME_SIZE) == expected, "full frame");
+
+    // Split in random chunks, e.g. per DMA block
+    for (int round = 0; round < 200; round++) {
+        uint32_t pos = 0;
+
+        crc = crc16_init();
+        while (pos < FRAME_SIZE) {
+            uint32_t len = test_rand() % 5000;
+
+            len = MIN(len, FRAME_SIZE - pos);
+            crc = crc16_update(crc, &frame[pos], len);
+            pos += len;
+        }
+        CHECK(crc16_final(crc) == expected, "round %d", round);
+    }
+}
+
+static void bench(void)
+{
+    volatile uint16_t sink = 0;
+    uint64_t start, bitwise_ns, table_ns;
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        sink ^= crc16_bitwise(frame, FRAME_SIZE);
+    }
+    bitwise_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        sink ^= crc16_sw(frame, FRAME_SIZE);
+    }
+    table_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    printf("crc16 %u bytes: bitwise %.1f us (%.1f MB/s), slicing-by-4 %.1f us (%.1f MB/s), %.1fx\n",
+           FRAME_SIZE, bitwise_ns / 1000.0, FRAME_SIZE * 1000.0 / bitwise_ns,
+           table_ns / 1000.0, FRAME_SIZE * 1000.0 / table_ns, (double) bitwise_ns / table_ns);
+    (void) sink;
+}
+
+int main(int argc, char **argv)
+{
+    test_rand_fill(frame, sizeof(frame));
+
+    if (test_bench_mode(argc, argv)) {
+        bench();
+        return 0;
+    }
+
+    test_lengths();
+    test_frame();
+
+    return test_result("crc16");
+}
@@ -0,0 +1,494 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+// DigitDetection post-processing against the original floating point implementation, and its speed.
+// Scenes are synthetic CNN outputs, or a DUMP_CNN_OUTPUT log given as "bench <file>"
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <math.h>
+
+#include "test_common.h"
+#include "max78000_video_postproc.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define SQUARE(x)       ((x) * (x))
+#define MIN(x, y)       (((x) < (y)) ? (x) : (y))
+#define MAX(x, y)       (((x) > (y)) ? (x) : (y))
+#define NMS_CLASSES     (NUM_CLASSES - 2)
+#define TEST_SCENES     1000
+#define WORST_SCENES    10
+#define BENCH_ROUNDS    20
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static const int dims[NUM_SCALES] = {18, 9, 4, 2};
+static const float scales[NUM_SCALES] = {0.15f, 0.35f, 0.55f, 0.725f};
+static const float ars[NUM_ARS]       = {0.85f, 0.60f, 0.40f, 0.25f};
+
+static uint8_t scratch[POSTPROC_SCRATCH_SIZE];
+static int8_t scene_locs[NUM_PRIORS * LOC_DIM];
+static int8_t scene_cls[NUM_PRIORS * NUM_CLASSES];
+
+// Original implementation state
+static uint16_t ref_softmax_out[NUM_CLASSES * NUM_PRIORS];
+static uint8_t ref_removed[NMS_CLASSES * MAX_PRIORS];
+static int ref_num_priors[NMS_CLASSES];
+static uint16_t ref_scores[NMS_CLASSES][MAX_PRIORS];
+static uint16_t ref_indices[NMS_CLASSES][MAX_PRIORS];
+static uint8_t ref_objects[1 + ML_DATA_SIZE * NMS_CLASSES * MAX_PRIORS];
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+// Original post-processing: double exp() softmax, and every NMS pair decoded from scratch with sqrt() and exp().
+// nms_removed is indexed by MAX_PRIORS as in the fixed version, the original per-class count indexing mixed classes
+static void ref_softmax(void)
+{
+    int i, ch, calc_softmax;
+    float sum;
+
+    memset(ref_softmax_out, 0, sizeof(ref_softmax_out));
+
+    for (i = 0; i < NUM_PRIORS; ++i) {
+        sum          = 0.;
+        calc_softmax = 0;
+
+        for (ch = 1; ch < (NUM_CLASSES - 1); ++ch) {
+            if (scene_cls[i * NUM_CLASSES + ch] >= scene_cls[i * NUM_CLASSES]) {
+                calc_softmax = 1;
+                break;
+            }
+        }
+
+        if (calc_softmax == 0) {
+            continue;
+        }
+
+        for (ch = 0; ch < (NUM_CLASSES); ++ch) {
+            sum += exp(scene_cls[i * NUM_CLASSES + ch] / 128.);
+        }
+
+        for (ch = 0; ch < (NUM_CLASSES); ++ch) {
+            ref_softmax_out[i * NUM_CLASSES + ch] =
+                (uint16_t)(65536. * exp(scene_cls[i * NUM_CLASSES + ch] / 128.) / sum);
+        }
+    }
+}
+
+static void ref_get_indices(int* ar_idx, int* scale_idx, int* rel_idx, int prior_idx)
+{
+    int s;
+
+    int prior_count = 0;
+
+    for (s = 0; s < NUM_SCALES; ++s) {
+        prior_count += (NUM_ARS * SQUARE(dims[s]));
+
+        if (prior_idx < prior_count) {
+            *scale_idx = s;
+            break;
+        }
+    }
+
+    int in_scale_idx = prior_idx;
+
+    for (s = 0; s < *scale_idx; ++s) {
+        in_scale_idx -= (NUM_ARS * SQUARE(dims[s]));
+    }
+
+    *ar_idx  = in_scale_idx % NUM_ARS;
+    *rel_idx = in_scale_idx / NUM_ARS;
+}
+
+static float ref_calculate_IOU(float* box1, float* box2)
+{
+    float x_left   = MAX(box1[0], box2[0]);
+    float y_top    = MAX(box1[1], box2[1]);
+    float x_right  = MIN(box1[2], box2[2]);
+    float y_bottom = MIN(box1[3], box2[3]);
+    float intersection_area;
+
+    if (x_right < x_left || y_bottom < y_top) {
+        return 0.0;
+    }
+
+    intersection_area = (x_right - x_left) * (y_bottom - y_top);
+
+    float box1_area = (box1[2] - box1[0]) * (box1[3] - box1[1]);
+    float box2_area = (box2[2] - box2[0]) * (box2[3] - box2[1]);
+
+    float iou = (float)(intersection_area) / (float)(box1_area + box2_area - intersection_area);
+
+    return iou;
+}
+
+static void ref_get_cxcy(float* cxcy, int prior_idx)
+{
+    int i, scale_idx = 0, ar_idx, rel_idx, cx, cy;
+
+    ref_get_indices(&ar_idx, &scale_idx, &rel_idx, prior_idx);
+
+    cy      = rel_idx / dims[scale_idx];
+    cx      = rel_idx % dims[scale_idx];
+    cxcy[0] = (float)((float)(cx + 0.5) / dims[scale_idx]);
+    cxcy[1] = (float)((float)(cy + 0.5) / dims[scale_idx]);
+    cxcy[2] = scales[scale_idx] * sqrt(ars[ar_idx]);
+    cxcy[3] = scales[scale_idx] / sqrt(ars[ar_idx]);
+
+    for (i = 0; i < 4; ++i) {
+        cxcy[i] = MAX(0.0, cxcy[i]);
+        cxcy[i] = MIN(cxcy[i], 1.0);
+    }
+}
+
+static void ref_decode(float* xy, int prior_idx)
+{
+    float prior_cxcy[4];
+    float gcxgcy[4];
+    float cxcy[4];
+
+    ref_get_cxcy(prior_cxcy, prior_idx);
+
+    for (int i = 0; i < 4; i++) {
+        gcxgcy[i] = (float)scene_locs[4 * prior_idx + i] / 128.0;
+    }
+
+    cxcy[0] = prior_cxcy[0] + gcxgcy[0] * prior_cxcy[2] / 10;
+    cxcy[1] = prior_cxcy[1] + gcxgcy[1] * prior_cxcy[3] / 10;
+    cxcy[2] = exp(gcxgcy[2] / 5) * prior_cxcy[2];
+    cxcy[3] = exp(gcxgcy[3] / 5) * prior_cxcy[3];
+
+    xy[0] = cxcy[0] - cxcy[2] / 2;
+    xy[1] = cxcy[1] - cxcy[3] / 2;
+    xy[2] = cxcy[0] + cxcy[2] / 2;
+    xy[3] = cxcy[1] + cxcy[3] / 2;
+}
+
+static void ref_insert(uint16_t val, int idx, uint16_t* val_arr, uint16_t* idx_arr, int* arr_len)
+{
+    if ((*arr_len == 0) || ((val <= val_arr[*arr_len - 1]) && (*arr_len != MAX_PRIORS))) {
+        val_arr[*arr_len] = val;
+        idx_arr[*arr_len] = idx;
+    } else {
+        for (int i = 0; i < *arr_len; ++i) {
+            if (val > val_arr[i]) {
+                if (*arr_len < MAX_PRIORS) {
+                    val_arr[*arr_len] = val_arr[*arr_len - 1];
+                    idx_arr[*arr_len] = idx_arr[*arr_len - 1];
+                }
+                for (int j = (*arr_len - 1); j > i; --j) {
+                    val_arr[j] = val_arr[j - 1];
+                    idx_arr[j] = idx_arr[j - 1];
+                }
+                val_arr[i] = val;
+                idx_arr[i] = idx;
+                break;
+            }
+        }
+    }
+
+    *arr_len = MIN((*arr_len + 1), MAX_PRIORS);
+}
+
+static uint8_t *ref_localize_objects(void)
+{
+    int prior_idx, class_idx, nms_idx1, nms_idx2;
+    uint16_t cls_prob;
+    float xy1[4];
+    float xy2[4];
+    uint8_t obj_number = 0;
+
+    ref_softmax();
+
+    memset(ref_num_priors, 0, sizeof(ref_num_priors));
+    memset(ref_removed, 0, sizeof(ref_removed));
+
+    for (prior_idx = 0; prior_idx < NUM_PRIORS; ++prior_idx) {
+        for (class_idx = 0; class_idx < NMS_CLASSES; ++class_idx) {
+            cls_prob = ref_softmax_out[prior_idx * NUM_CLASSES + class_idx + 1];
+
+            if (cls_prob < MIN_CLASS_SCORE) {
+                continue;
+            }
+
+            ref_insert(cls_prob, prior_idx, ref_scores[class_idx], ref_indices[class_idx], &ref_num_priors[class_idx]);
+        }
+    }
+
+    for (class_idx = 0; class_idx < NMS_CLASSES; ++class_idx) {
+        for (nms_idx1 = 0; nms_idx1 < ref_num_priors[class_idx]; ++nms_idx1) {
+            if (ref_removed[class_idx * MAX_PRIORS + nms_idx1] != 1 && nms_idx1 != ref_num_priors[class_idx] - 1) {
+                for (nms_idx2 = nms_idx1 + 1; nms_idx2 < ref_num_priors[class_idx]; ++nms_idx2) {
+                    ref_decode(xy1, ref_indices[class_idx][nms_idx1]);
+                    ref_decode(xy2, ref_indices[class_idx][nms_idx2]);
+
+                    if (ref_calculate_IOU(xy1, xy2) > MAX_ALLOWED_OVERLAP) {
+                        ref_removed[class_idx * MAX_PRIORS + nms_idx2] = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    for (class_idx = 0; class_idx < NMS_CLASSES; ++class_idx) {
+        for (prior_idx = 0; prior_idx < ref_num_priors[class_idx]; ++prior_idx) {
+            if (ref_removed[class_idx * MAX_PRIORS + prior_idx] != 1) {
+                ref_decode(xy1, ref_indices[class_idx][prior_idx]);
+                ref_objects[obj_number*ML_DATA_SIZE + 1] = class_idx;
+                ref_objects[obj_number*ML_DATA_SIZE + 2] = (uint8_t)IMG_SCALE*X_SIZE*xy1[0];
+                ref_objects[obj_number*ML_DATA_SIZE + 3] = (uint8_t)IMG_SCALE*Y_SIZE*xy1[1];
+                ref_objects[obj_number*ML_DATA_SIZE + 4] = (uint8_t)IMG_SCALE*X_SIZE*xy1[2];
+                ref_objects[obj_number*ML_DATA_SIZE + 5] = (uint8_t)IMG_SCALE*Y_SIZE*xy1[3];
+                obj_number++;
+            }
+        }
+    }
+
+    ref_objects[0] = obj_number;
+
+    return ref_objects;
+}
+
+static int8_t rand_range(int lo, int hi)
+{
+    return lo + (int) (test_rand() % (uint32_t) (hi - lo + 1));
+}
+
+static int prior_index(int scale_idx, int x, int y, int ar_idx)
+{
+    int prior_idx = 0;
+
+    for (int s = 0; s < scale_idx; ++s) {
+        prior_idx += NUM_ARS * SQUARE(dims[s]);
+    }
+
+    return prior_idx + NUM_ARS * (y * dims[scale_idx] + x) + ar_idx;
+}
+
+// Background everywhere, and each object seen by the neighbouring priors of one scale, like a real detection
+static void make_scene(int num_objects)
+{
+    for (int i = 0; i < NUM_PRIORS; i++) {
+        int8_t *cls = &scene_cls[i * NUM_CLASSES];
+
+        cls[0] = rand_range(40, 120);
+        for (int ch = 1; ch < NUM_CLASSES; ch++) {
+            cls[ch] = rand_range(-128, cls[0] - 1);
+        }
+        for (int j = 0; j < LOC_DIM; j++) {
+            scene_locs[i * LOC_DIM + j] = rand_range(-40, 40);
+        }
+    }
+
+    for (int obj = 0; obj < num_objects; obj++) {
+        int class_idx = rand_range(1, NMS_CLASSES);
+        int scale_idx = rand_range(0, NUM_SCALES - 1);
+        int cx = rand_range(0, dims[scale_idx] - 1);
+        int cy = rand_range(0, dims[scale_idx] - 1);
+
+        for (int y = MAX(cy - 1, 0); y <= MIN(cy + 1, dims[scale_idx] - 1); y++) {
+            for (int x = MAX(cx - 1, 0); x <= MIN(cx + 1, dims[scale_idx] - 1); x++) {
+                for (int ar_idx = 0; ar_idx < NUM_ARS; ar_idx++) {
+                    int8_t *cls = &scene_cls[prior_index(scale_idx, x, y, ar_idx) * NUM_CLASSES];
+
+                    cls[class_idx] = rand_range(60, 127);
+                    for (int ch = 0; ch < NUM_CLASSES; ch++) {
+                        if (ch != class_idx) {
+                            cls[ch] = rand_range(-128, cls[class_idx] - 100);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Every prior a confident candidate of one class, all NMS lists are full
+static void make_worst_scene(void)
+{
+    for (int i = 0; i < NUM_PRIORS; i++) {
+        int8_t *cls = &scene_cls[i * NUM_CLASSES];
+
+        for (int ch = 0; ch < NUM_CLASSES; ch++) {
+            cls[ch] = rand_range(-128, -64);
+        }
+        cls[1 + (i % NMS_CLASSES)] = rand_range(64, 127);
+        for (int j = 0; j < LOC_DIM; j++) {
+            scene_locs[i * LOC_DIM + j] = rand_range(-128, 127);
+        }
+    }
+}
+
+// DUMP_CNN_OUTPUT log: hex bytes of prior_locs then prior_cls after a "cnn_output" line
+static int load_dump(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char line[256];
+    uint32_t pos = 0;
+    unsigned int val;
+
+    if (!f) {
+        printf("cannot open %s\n", path);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), f) && !strstr(line, "cnn_output")) {
+    }
+
+    while ((pos < sizeof(scene_locs) + sizeof(scene_cls)) && (fscanf(f, "%2x", &val) == 1)) {
+        if (pos < sizeof(scene_locs)) {
+            scene_locs[pos] = val;
+        } else {
+            scene_cls[pos - sizeof(scene_locs)] = val;
+        }
+        pos++;
+    }
+    fclose(f);
+
+    if (pos != sizeof(scene_locs) + sizeof(scene_cls)) {
+        printf("%s: %u of %zu bytes\n", path, pos, sizeof(scene_locs) + sizeof(scene_cls));
+        return -1;
+    }
+
+    return 0;
+}
+
+// CNN outputs as get_priors() leaves them, post-processing does not modify them
+static void load_scene(void)
+{
+    memcpy(postproc_get_prior_locs(), scene_locs, sizeof(scene_locs));
+    memcpy(postproc_get_prior_cls(), scene_cls, sizeof(scene_cls));
+}
+
+// Detections of the same class within a pixel are the same object, order within a class can differ on equal scores.
+// Returns the objects only one implementation found
+static int compare_scene(void)
+{
+    uint8_t *ref = ref_localize_objects();
+    uint8_t *objects;
+    uint8_t matched[1 + NMS_CLASSES * MAX_PRIORS] = {0};
+    int missing = 0;
+
+    load_scene();
+    objects = postproc_localize_objects();
+
+    for (int i = 0; i < objects[0]; i++) {
+        uint8_t *obj = &objects[i * ML_DATA_SIZE + 1];
+        int found = 0;
+
+        for (int k = 0; (k < ref[0]) && !found; k++) {
+            uint8_t *exp = &ref[k * ML_DATA_SIZE + 1];
+
+            found = !matched[k] && (obj[0] == exp[0]);
+            for (int j = 1; (j < ML_DATA_SIZE) && found; j++) {
+                found = abs(obj[j] - exp[j]) <= 1;
+            }
+            matched[k] |= found;
+        }
+        missing += !found;
+    }
+
+    return missing + ref[0] - (objects[0] - missing);
+}
+
+static void bench_scene(const char *name)
+{
+    uint64_t start, ref_ns, new_ns;
+    uint8_t count = 0;
+
+    load_scene();
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        count = ref_localize_objects()[0];
+    }
+    ref_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        postproc_localize_objects();
+    }
+    new_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    printf("digit postproc %-10s %3u objects: float %8.1f us, table driven %6.1f us, %.1fx\n",
+           name, count, ref_ns / 1000.0, new_ns / 1000.0, (double) ref_ns / new_ns);
+}
+
+int main(int argc, char **argv)
+{
+    int differing = 0;
+
+    postproc_init(scratch);
+
+    if (test_bench_mode(argc, argv)) {
+        make_scene(0);
+        bench_scene("empty");
+        make_scene(5);
+        bench_scene("5 digits");
+        make_worst_scene();
+        bench_scene("worst");
+        if ((argc > 2) && !load_dump(argv[2])) {
+            bench_scene("dump");
+        }
+        return 0;
+    }
+
+    // Q15 priors and exp tables move boxes by a fraction of a pixel, which flips NMS decisions whose IoU is within
+    // about 1e-4 of MAX_ALLOWED_OVERLAP, or scores at MIN_CLASS_SCORE. Such a flip adds or drops one or two boxes
+    for (int scene = 0; scene < TEST_SCENES + WORST_SCENES; scene++) {
+        int diff;
+
+        if (scene < TEST_SCENES) {
+            make_scene(scene % 8);
+        } else {
+            make_worst_scene();
+        }
+
+        diff = compare_scene();
+        CHECK(diff <= 2, "scene %d: %d objects differ", scene, diff);
+        differing += (diff != 0);
+    }
+    CHECK(differing * 100 <= TEST_SCENES + WORST_SCENES, "%d of %d scenes differ", differing, TEST_SCENES + WORST_SCENES);
+
+    return test_result("digit_postproc");
+}
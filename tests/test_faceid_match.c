@@ -0,0 +1,369 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+
+// FaceID two-stage matching and its L1 distance against the original brute force mean distance,
+// database capacity and a match time sweep over the database size
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "test_common.h"
+#include "flc.h"
+#include "max78000_video_embedding_process.h"
+#include "maxrefdes178_definitions.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+// Emulated flash is larger than the embeddings region so the sweep can go past FACEID_MAX_SUBJECT
+#define SIM_FLASH_SIZE      0x200000
+#define DB_HEADER_SIZE      11  // tsFaceIDFile
+#define INDEX_HEADER_SIZE   16  // tsFaceIDIndex
+#define ALIGN16(x)          (((x) + 15) & ~15)
+
+#define QUERY_COUNT         200
+#define BENCH_QUERY_COUNT   2000
+
+// Built once with the scalar L1 distance and once with the Cortex-M4 SIMD one emulated
+#if defined(__ARM_FEATURE_DSP)
+#define TEST_NAME           "faceid_match_dsp"
+#else
+#define TEST_NAME           "faceid_match"
+#endif
+
+#define STR_(x)             #x
+#define STR(x)              STR_(x)
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+uint32_t sim_flash[SIM_FLASH_SIZE / 4] __attribute__((aligned(MXC_FLASH_PAGE_SIZE)));
+mxc_flc_regs_t sim_flc0;
+
+__asm__(".globl _embeddings_start_\n"
+        ".set _embeddings_start_, sim_flash\n"
+        ".globl _embeddings_end_\n"
+        ".set _embeddings_end_, sim_flash + " STR(SIM_FLASH_SIZE) "\n");
+
+static uint8_t db[SIM_FLASH_SIZE];
+static int8_t centers[UINT8_MAX + 1][FACEID_EMBEDDING_SIZE];
+static int8_t queries[BENCH_QUERY_COUNT][FACEID_EMBEDDING_SIZE];
+static int flash_write_count;
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+void sim_irq_enable(int chip)
+{
+    (void) chip;
+}
+
+int MXC_FLC_PageErase(uint32_t address)
+{
+    uint8_t *page = (uint8_t *)(uintptr_t) address;
+
+    if ((address % MXC_FLASH_PAGE_SIZE) || (page < (uint8_t *) sim_flash) ||
+            (page + MXC_FLASH_PAGE_SIZE > (uint8_t *) sim_flash + SIM_FLASH_SIZE)) {
+        return E_BAD_PARAM;
+    }
+
+    memset(page, 0xFF, MXC_FLASH_PAGE_SIZE);
+
+    return E_NO_ERROR;
+}
+
+// Programming can only clear bits
+int MXC_FLC_Write(uint32_t address, uint32_t length, uint32_t *buffer)
+{
+    uint8_t *dst = (uint8_t *)(uintptr_t) address;
+    uint8_t *src = (uint8_t *) buffer;
+
+    if ((dst < (uint8_t *) sim_flash) || (dst + length > (uint8_t *) sim_flash + SIM_FLASH_SIZE)) {
+        return E_BAD_PARAM;
+    }
+
+    for (uint32_t i = 0; i < length; i++) {
+        dst[i] &= src[i];
+    }
+    flash_write_count++;
+
+    return E_NO_ERROR;
+}
+
+int MXC_FLC_EnableInt(uint32_t flags)
+{
+    (void) flags;
+
+    return E_NO_ERROR;
+}
+
+static int8_t clamp_s8(int value)
+{
+    return (value > 127) ? 127 : ((value < -128) ? -128 : value);
+}
+
+static void make_embedding(int8_t *embedding, const int8_t *center, int noise)
+{
+    for (int j = 0; j < FACEID_EMBEDDING_SIZE; j++) {
+        embedding[j] = clamp_s8(center[j] + (int) (test_rand() % (2 * noise + 1)) - noise);
+    }
+}
+
+// Subjects are clusters of photos around random centers within +-spread, returns the db size
+static uint32_t make_db(int subjects, int photos, int spread)
+{
+    uint8_t *p = db + DB_HEADER_SIZE;
+    uint16_t names_len;
+    uint16_t embeddings = subjects * photos;
+
+    for (int s = 0; s < subjects; s++) {
+        p += sprintf((char *) p, "subject_%d", s) + 1;
+    }
+    names_len = p - (db + DB_HEADER_SIZE);
+
+    for (int s = 0; s < subjects; s++) {
+        for (int j = 0; j < FACEID_EMBEDDING_SIZE; j++) {
+            centers[s][j] = clamp_s8((int) (test_rand() % (2 * spread + 1)) - spread);
+        }
+    }
+
+    // Photos of a subject are interleaved with the others, like the host sends them
+    for (int i = 0; i < embeddings; i++) {
+        int s = i % subjects;
+
+        *p++ = s;
+        make_embedding((int8_t *) p, centers[s], 20);
+        p += FACEID_EMBEDDING_SIZE;
+    }
+
+    db[0] = subjects;
+    db[1] = FACEID_EMBEDDING_SIZE & 0xFF;
+    db[2] = FACEID_EMBEDDING_SIZE >> 8;
+    db[3] = embeddings & 0xFF;
+    db[4] = embeddings >> 8;
+    db[5] = FACEID_WIDTH;
+    db[6] = 0;
+    db[7] = FACEID_HEIGHT;
+    db[8] = 0;
+    db[9] = names_len & 0xFF;
+    db[10] = names_len >> 8;
+
+    return p - db;
+}
+
+static void make_queries(int subjects, int count)
+{
+    for (int q = 0; q < count; q++) {
+        // Every tenth face is not in the db
+        if ((q % 10) == 9) {
+            make_embedding(queries[q], centers[UINT8_MAX], 60);
+        } else {
+            make_embedding(queries[q], centers[test_rand() % subjects], 25);
+        }
+    }
+}
+
+// Original calculate_minDistance, mean L1 distance of every subject, top 3 by ascending mean
+static void brute_force(const int8_t *embedding, tsMinDistance *min)
+{
+    static int32_t sum[UINT8_MAX + 1];
+    static int number[UINT8_MAX + 1];
+    const int8_t *pData = (const int8_t *)(db + DB_HEADER_SIZE + (db[9] | (db[10] << 8)));
+    int subjects = db[0];
+    int embeddings = db[3] | (db[4] << 8);
+
+    memset(sum, 0, sizeof(sum));
+    memset(number, 0, sizeof(number));
+
+    for (int i = 0; i < embeddings; i++) {
+        int total = 0;
+
+        for (int j = 0; j < FACEID_EMBEDDING_SIZE; j++) {
+            total += abs(embedding[j] - pData[1 + j]);
+        }
+        sum[(uint8_t) pData[0]] += total;
+        number[(uint8_t) pData[0]]++;
+        pData += FACEID_EMBEDDING_SIZE + 1;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        min[i].subID = 0xFF;
+        min[i].distance = 1000000;
+    }
+
+    for (int s = 0; s < subjects; s++) {
+        int32_t mean = sum[s] / number[s];
+
+        if (mean < min[0].distance) {
+            min[2] = min[1];
+            min[1] = min[0];
+            min[0].subID = s;
+            min[0].distance = mean;
+        } else if (mean < min[1].distance) {
+            min[2] = min[1];
+            min[1].subID = s;
+            min[1].distance = mean;
+        } else if (mean < min[2].distance) {
+            min[2].subID = s;
+            min[2].distance = mean;
+        }
+    }
+}
+
+// Writes the db like QSPI_PACKET_TYPE_VIDEO_FACEID_EMBED_UPDATE_CMD and builds the index
+static int load_db(uint32_t db_size)
+{
+    int ret;
+
+    uninit_database();
+    ret = update_database(db, db_size);
+    if (ret == E_NO_ERROR) {
+        ret = init_database();
+    }
+
+    return ret;
+}
+
+static void test_match(int subjects, int spread)
+{
+    tsMinDistance ref[3];
+    tsMinDistance *min;
+    uint32_t db_size = make_db(subjects, FACEID_MAX_PHOTO_PER_SUBJECT, spread);
+    int top1_mismatch = 0;
+    int writes;
+
+    CHECK(load_db(db_size) == E_NO_ERROR, "%d subjects", subjects);
+    CHECK(get_subject_count() == subjects, "%d subjects", subjects);
+
+    // The index is kept across resets, a second init must not write flash
+    writes = flash_write_count;
+    CHECK(init_database() == E_NO_ERROR, "%d subjects", subjects);
+    CHECK(flash_write_count == writes, "%d subjects, index rebuilt", subjects);
+
+    make_queries(subjects, QUERY_COUNT);
+
+    for (int q = 0; q < QUERY_COUNT; q++) {
+        calculate_minDistance((const uint8_t *) queries[q]);
+        min = get_min_distance();
+        brute_force(queries[q], ref);
+
+        if (subjects <= FACEID_PREFILTER_CANDIDATES) {
+            // Every subject is rescored, the top 3 must be identical
+            for (int i = 0; i < 3; i++) {
+                CHECK((min[i].subID == ref[i].subID) && (min[i].distance == ref[i].distance),
+                      "%d subjects, query %d, rank %d: %d/%d != %d/%d", subjects, q, i,
+                      min[i].subID, min[i].distance, ref[i].subID, ref[i].distance);
+            }
+        } else if ((min[0].subID != ref[0].subID) || (min[0].distance != ref[0].distance)) {
+            top1_mismatch++;
+        }
+    }
+
+    // Centroid prefilter may only miss a closest subject that is not really close
+    CHECK(top1_mismatch == 0, "%d subjects, %d of %d top 1 mismatches", subjects, top1_mismatch, QUERY_COUNT);
+}
+
+static void test_capacity(void)
+{
+    uint32_t db_size = make_db(FACEID_MAX_SUBJECT, FACEID_MAX_PHOTO_PER_SUBJECT, 60);
+    uint32_t index_end = ALIGN16(FACEID_MAX_EMBEDDINGS_SIZE) + INDEX_HEADER_SIZE +
+                         (FACEID_MAX_SUBJECT * FACEID_EMBEDDING_SIZE);
+
+    CHECK(db_size <= FACEID_MAX_EMBEDDINGS_SIZE, "db %u > %u", db_size, FACEID_MAX_EMBEDDINGS_SIZE);
+    CHECK(index_end <= FACEID_EMBEDDINGS_FLASH_SIZE, "db and index %u > %u", index_end, FACEID_EMBEDDINGS_FLASH_SIZE);
+    CHECK(FACEID_MAX_EMBEDDINGS_SIZE <= LCD_DATA_SIZE, "db %u > QSPI payload buffer", FACEID_MAX_EMBEDDINGS_SIZE);
+    CHECK(FACEID_MAX_EMBEDDINGS_SIZE <= MAX32666_BLE_COMMAND_BUFFER_SIZE, "db %u > BLE buffer", FACEID_MAX_EMBEDDINGS_SIZE);
+    CHECK(FACEID_MAX_SUBJECT <= UINT8_MAX, "subject id is 8 bit");
+
+    printf("FACEID_MAX_SUBJECT %d: db %u B, db and index %u B of %u B\n",
+           FACEID_MAX_SUBJECT, FACEID_MAX_EMBEDDINGS_SIZE, index_end, FACEID_EMBEDDINGS_FLASH_SIZE);
+}
+
+static void bench(void)
+{
+    static const int subjects[] = {6, 16, 32, 64, 128, 255};
+    tsMinDistance ref[3];
+    uint64_t start, brute_ns, match_ns;
+    uint32_t db_size;
+
+    printf("%8s %10s %14s %14s\n", "subjects", "db bytes", "brute us/frm", "2-stage us/frm");
+
+    for (int i = 0; i < (int) (sizeof(subjects) / sizeof(subjects[0])); i++) {
+        db_size = make_db(subjects[i], FACEID_MAX_PHOTO_PER_SUBJECT, 60);
+        load_db(db_size);
+        make_queries(subjects[i], BENCH_QUERY_COUNT);
+
+        start = test_time_ns();
+        for (int q = 0; q < BENCH_QUERY_COUNT; q++) {
+            brute_force(queries[q], ref);
+        }
+        brute_ns = test_time_ns() - start;
+
+        start = test_time_ns();
+        for (int q = 0; q < BENCH_QUERY_COUNT; q++) {
+            calculate_minDistance((const uint8_t *) queries[q]);
+        }
+        match_ns = test_time_ns() - start;
+
+        printf("%8d %10u %14.1f %14.1f\n", subjects[i], db_size,
+               brute_ns / 1000.0 / BENCH_QUERY_COUNT, match_ns / 1000.0 / BENCH_QUERY_COUNT);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (test_bench_mode(argc, argv)) {
+        bench();
+        return 0;
+    }
+
+    test_capacity();
+
+    test_match(6, 60);
+    test_match(FACEID_PREFILTER_CANDIDATES, 60);
+    test_match(FACEID_MAX_SUBJECT, 60);
+    test_match(40, 60);
+    test_match(UINT8_MAX, 60);
+
+    // Saturated embeddings, -128 and 127 are the edge cases of the SIMD sign flip
+    test_match(6, 128);
+    test_match(FACEID_MAX_SUBJECT, 128);
+
+    return test_result(TEST_NAME);
+}
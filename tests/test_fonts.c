@@ -0,0 +1,520 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+// Pixel equivalence of the cached glyph span text path and the span overlay primitives against the per-pixel
+// code they replaced, and their speed
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "test_common.h"
+#include "max32666_fonts.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define TEST_NAME           "fonts"
+
+#define FRAME_PIXELS        (LCD_WIDTH * LCD_HEIGHT)
+#define BENCH_ROUNDS        2000
+
+// Coordinates of the random primitives reach past the LCD to exercise the clipping
+#define COORD_RANGE         (LCD_WIDTH + 64)
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static const FontDef *fonts[] = {&Font_7x10, &Font_11x18, &Font_16x26};
+
+// Strings refresh_screen draws every frame
+static const char *screen_strings[] = {"FPS:29.97", "CNN:  74ms", "Capture:  33ms", "Comm:  12ms", "Unknown"};
+
+static uint16_t ref_frame[FRAME_PIXELS];
+static uint16_t new_frame[FRAME_PIXELS];
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+// Original fonts_putChar, one glyph bit and one pixel at a time
+static void ref_putChar(uint16_t x, uint16_t y, char ch, const FontDef *font, uint16_t color, uint8_t bg, uint16_t bgcolor, uint8_t *buff)
+{
+    uint32_t i, b, j, pos;
+
+    uint16_t *p = (uint16_t *) buff;
+
+    for (i = 0; i < font->height; i++) {
+        b = font->data[(ch - 32) * font->height + i];
+        for (j = 0; j < font->width; j++) {
+            pos = (((i + y) * LCD_WIDTH) + (j + x));
+            if ((b << j) & 0x8000) {
+                p[pos] = __builtin_bswap16 (color);
+            } else if (bg) {
+                p[pos] = __builtin_bswap16 (bgcolor);
+            }
+        }
+    }
+}
+
+// Original fonts_putString, same line wrapping as the library
+static void ref_putString(uint16_t x, uint16_t y, const char *str, const FontDef *font, uint16_t color, uint8_t bg, uint16_t bgcolor, uint8_t *buff)
+{
+    while (*str) {
+        if (x + font->width >= LCD_WIDTH) {
+            x = 0;
+            y += font->height;
+            if (y + font->height >= LCD_HEIGHT) {
+                break;
+            }
+
+            if (*str == ' ') {
+                str++;
+                continue;
+            }
+        }
+        ref_putChar(x, y, *str, font, color, bg, bgcolor, buff);
+        x += font->width;
+        str++;
+    }
+}
+
+// Original fonts_drawLine with the pixels outside the frame dropped, the original wrote past the framebuffer
+static void ref_drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color, uint8_t *buff)
+{
+    uint16_t swap;
+    uint16_t steep = abs(y1 - y0) > abs(x1 - x0);
+    uint16_t *p = (uint16_t *) buff;
+
+    if (steep) {
+        swap = x0;
+        x0 = y0;
+        y0 = swap;
+
+        swap = x1;
+        x1 = y1;
+        y1 = swap;
+    }
+
+    if (x0 > x1) {
+        swap = x0;
+        x0 = x1;
+        x1 = swap;
+
+        swap = y0;
+        y0 = y1;
+        y1 = swap;
+    }
+
+    int16_t dx, dy;
+    dx = x1 - x0;
+    dy = abs(y1 - y0);
+
+    int16_t err = dx / 2;
+    int16_t ystep;
+
+    if (y0 < y1) {
+        ystep = 1;
+    } else {
+        ystep = -1;
+    }
+
+    for (; x0<=x1; x0++) {
+        uint16_t x = steep ? y0 : x0;
+        uint16_t y = steep ? x0 : y0;
+
+        if ((x < LCD_WIDTH) && (y < LCD_HEIGHT)) {
+            p[(y * LCD_WIDTH) + x] = __builtin_bswap16 (color);
+        }
+        err -= dy;
+        if (err < 0) {
+            y0 += ystep;
+            err += dx;
+        }
+    }
+}
+
+// Original fonts_drawRectangle, four lines
+static void ref_drawRectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color, uint8_t *buff)
+{
+    ref_drawLine(x1, y1, x2, y1, color, buff);
+    ref_drawLine(x1, y1, x1, y2, color, buff);
+    ref_drawLine(x1, y2, x2, y2, color, buff);
+    ref_drawLine(x2, y1, x2, y2, color, buff);
+}
+
+// Original fonts_drawThickRectangle, one nested rectangle per pixel of thickness
+static void ref_drawThickRectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color, uint8_t thickness, uint8_t *buff)
+{
+    for (uint8_t i = 0; i < thickness; i++) {
+        ref_drawRectangle(x1 + i, y1 + i, x2 - i, y2 - i, color, buff);
+    }
+}
+
+// Original fonts_drawFilledRectangle, one line per row
+static void ref_drawFilledRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color, uint8_t *buff)
+{
+    for (uint32_t i = 0; i <= h; i++) {
+        ref_drawLine(x, y + i, x + w, y + i, color, buff);
+    }
+}
+
+static void reset_frames(void)
+{
+    test_rand_fill((uint8_t *) ref_frame, sizeof(ref_frame));
+    memcpy(new_frame, ref_frame, sizeof(new_frame));
+}
+
+// Every printable glyph of every font, transparent and opaque, at both pixel alignments
+static void test_all_glyphs(void)
+{
+    char str[2] = {0, 0};
+
+    for (uint32_t f = 0; f < 3; f++) {
+        for (char ch = ' '; ch <= '~'; ch++) {
+            for (uint32_t i = 0; i < 4; i++) {
+                uint16_t x = 20 + (i & 1);
+                uint16_t color = test_rand();
+                uint16_t bgcolor = test_rand();
+
+                str[0] = ch;
+                reset_frames();
+                ref_putString(x, 20, str, fonts[f], color, i >> 1, bgcolor, (uint8_t *) ref_frame);
+                fonts_putString(x, 20, str, fonts[f], color, i >> 1, bgcolor, (uint8_t *) new_frame);
+                CHECK(!memcmp(ref_frame, new_frame, sizeof(ref_frame)), "font %u char '%c' x %u bg %u", f, ch, x, i >> 1);
+            }
+        }
+    }
+}
+
+// Random strings at random positions, including line wrapping. Mixing the fonts thrashes the 32 glyph
+// cache, so hits, empty ways and LRU evictions all take part
+static void test_strings(void)
+{
+    char str[64];
+
+    for (uint32_t round = 0; round < 5000; round++) {
+        const FontDef *font = fonts[test_rand() % 3];
+        uint32_t len = 1 + test_rand() % (sizeof(str) - 1);
+        uint16_t x = test_rand() % LCD_WIDTH;
+        uint16_t y = test_rand() % (LCD_HEIGHT - font->height);
+        uint16_t color = test_rand();
+        uint16_t bgcolor = test_rand();
+        uint8_t bg = test_rand() & 1;
+
+        for (uint32_t i = 0; i < len; i++) {
+            str[i] = ' ' + test_rand() % ('~' - ' ' + 1);
+        }
+        str[len] = 0;
+
+        reset_frames();
+        ref_putString(x, y, str, font, color, bg, bgcolor, (uint8_t *) ref_frame);
+        fonts_putString(x, y, str, font, color, bg, bgcolor, (uint8_t *) new_frame);
+        CHECK(!memcmp(ref_frame, new_frame, sizeof(ref_frame)), "round %u font %ux%u at %u,%u bg %u \"%s\"",
+              round, font->width, font->height, x, y, bg, str);
+    }
+
+    fonts_getDamage();
+}
+
+// Damage covers the rows of every line the string wrapped to
+static void test_damage(void)
+{
+    uint32_t damage;
+
+    fonts_getDamage();
+    fonts_putString(0, 4, "A", &Font_7x10, WHITE, 0, 0, (uint8_t *) new_frame);
+    damage = fonts_getDamage();
+    CHECK(damage == 0x3, "one line damage 0x%08x", damage);
+
+    fonts_putString(LCD_WIDTH - Font_7x10.width - 1, 4, "AB", &Font_7x10, WHITE, 0, 0, (uint8_t *) new_frame);
+    damage = fonts_getDamage();
+    CHECK(damage == 0x7, "wrapped damage 0x%08x", damage);
+}
+
+static uint32_t damage_bands(uint16_t y1, uint16_t y2)
+{
+    uint32_t damage = 0;
+
+    if (y1 > y2) {
+        uint16_t swap = y1;
+        y1 = y2;
+        y2 = swap;
+    }
+
+    for (uint32_t y = y1; (y <= y2) && (y < LCD_HEIGHT); y++) {
+        damage |= UINT32_C(1) << (y / FONTS_DAMAGE_BAND_HEIGHT);
+    }
+
+    return damage;
+}
+
+// Lines of every slope, on screen through the address stepping path and partly off screen through the
+// clipped run path
+static void test_lines(void)
+{
+    for (uint32_t round = 0; round < 20000; round++) {
+        uint16_t range = (round & 1) ? COORD_RANGE : LCD_WIDTH;
+        uint16_t x0 = test_rand() % range;
+        uint16_t y0 = test_rand() % range;
+        uint16_t x1 = test_rand() % range;
+        uint16_t y1 = test_rand() % range;
+        uint16_t color = test_rand();
+        uint32_t damage;
+
+        // Axis aligned spans
+        if ((round % 8) == 2) {
+            y1 = y0;
+        } else if ((round % 8) == 4) {
+            x1 = x0;
+        }
+
+        reset_frames();
+        fonts_getDamage();
+        ref_drawLine(x0, y0, x1, y1, color, (uint8_t *) ref_frame);
+        fonts_drawLine(x0, y0, x1, y1, color, (uint8_t *) new_frame);
+        CHECK(!memcmp(ref_frame, new_frame, sizeof(ref_frame)), "line %u,%u %u,%u", x0, y0, x1, y1);
+        damage = fonts_getDamage();
+        CHECK(damage == damage_bands(y0, y1), "line %u,%u %u,%u damage 0x%08x", x0, y0, x1, y1, damage);
+    }
+}
+
+// Random boxes with the edges inside them, in any corner order for single pixel outlines
+static void test_rectangles(void)
+{
+    for (uint32_t round = 0; round < 20000; round++) {
+        uint8_t thickness = 1 + test_rand() % 4;
+        uint16_t x1 = test_rand() % (COORD_RANGE - 2 * thickness);
+        uint16_t y1 = test_rand() % (COORD_RANGE - 2 * thickness);
+        uint16_t x2 = x1 + 2 * thickness + test_rand() % (COORD_RANGE - 2 * thickness - x1);
+        uint16_t y2 = y1 + 2 * thickness + test_rand() % (COORD_RANGE - 2 * thickness - y1);
+        uint16_t color = test_rand();
+        uint32_t damage;
+
+        reset_frames();
+        fonts_getDamage();
+        ref_drawThickRectangle(x1, y1, x2, y2, color, thickness, (uint8_t *) ref_frame);
+        fonts_drawThickRectangle(x1, y1, x2, y2, color, thickness, (uint8_t *) new_frame);
+        CHECK(!memcmp(ref_frame, new_frame, sizeof(ref_frame)), "box %u,%u %u,%u thickness %u", x1, y1, x2, y2, thickness);
+        damage = fonts_getDamage();
+        CHECK(damage == damage_bands(y1, y2), "box %u,%u %u,%u damage 0x%08x", x1, y1, x2, y2, damage);
+
+        x1 = test_rand() % COORD_RANGE;
+        y1 = test_rand() % COORD_RANGE;
+        x2 = (round & 1) ? (test_rand() % COORD_RANGE) : x1 + test_rand() % 2;
+        y2 = (round & 2) ? (test_rand() % COORD_RANGE) : y1 + test_rand() % 2;
+
+        reset_frames();
+        ref_drawRectangle(x1, y1, x2, y2, color, (uint8_t *) ref_frame);
+        fonts_drawRectangle(x1, y1, x2, y2, color, (uint8_t *) new_frame);
+        CHECK(!memcmp(ref_frame, new_frame, sizeof(ref_frame)), "rectangle %u,%u %u,%u", x1, y1, x2, y2);
+    }
+}
+
+// Inverted corners draw the ordered box and boxes without an inside are solid, where the original drew
+// nested rectangles growing outwards
+static void test_degenerate_rectangles(void)
+{
+    for (uint32_t round = 0; round < 5000; round++) {
+        uint8_t thickness = 2 + test_rand() % 3;
+        uint16_t x1 = test_rand() % (LCD_WIDTH - 16);
+        uint16_t y1 = test_rand() % (LCD_HEIGHT - 16);
+        uint16_t x2 = x1 + test_rand() % 16;
+        uint16_t y2 = y1 + test_rand() % 16;
+        uint16_t color = test_rand();
+
+        reset_frames();
+        fonts_drawThickRectangle(x1, y1, x2, y2, color, thickness, (uint8_t *) ref_frame);
+        fonts_drawThickRectangle(x2, y2, x1, y1, color, thickness, (uint8_t *) new_frame);
+        CHECK(!memcmp(ref_frame, new_frame, sizeof(ref_frame)), "inverted box %u,%u %u,%u thickness %u", x2, y2, x1, y1, thickness);
+
+        if (((x2 - x1) < (2 * thickness)) || ((y2 - y1) < (2 * thickness))) {
+            reset_frames();
+            ref_drawFilledRectangle(x1, y1, x2 - x1, y2 - y1, color, (uint8_t *) ref_frame);
+            fonts_drawThickRectangle(x1, y1, x2, y2, color, thickness, (uint8_t *) new_frame);
+            CHECK(!memcmp(ref_frame, new_frame, sizeof(ref_frame)), "thin box %u,%u %u,%u thickness %u", x1, y1, x2, y2, thickness);
+        }
+    }
+
+    reset_frames();
+    fonts_drawThickRectangle(10, 10, 20, 20, WHITE, 0, (uint8_t *) new_frame);
+    CHECK(!memcmp(ref_frame, new_frame, sizeof(ref_frame)), "zero thickness");
+}
+
+static void test_filled_rectangles(void)
+{
+    for (uint32_t round = 0; round < 5000; round++) {
+        uint16_t x = test_rand() % COORD_RANGE;
+        uint16_t y = test_rand() % COORD_RANGE;
+        uint16_t w = test_rand() % (COORD_RANGE - x);
+        uint16_t h = test_rand() % (COORD_RANGE - y);
+        uint16_t color = test_rand();
+
+        reset_frames();
+        ref_drawFilledRectangle(x, y, w, h, color, (uint8_t *) ref_frame);
+        fonts_drawFilledRectangle(x, y, w, h, color, (uint8_t *) new_frame);
+        CHECK(!memcmp(ref_frame, new_frame, sizeof(ref_frame)), "filled %u,%u %ux%u", x, y, w, h);
+    }
+}
+
+// A box list draws like the boxes one by one, later boxes on top
+static void test_boxes(void)
+{
+    fonts_box_t boxes[8];
+
+    for (uint32_t round = 0; round < 1000; round++) {
+        uint16_t count = test_rand() % 8;
+        uint8_t thickness = 1 + test_rand() % 4;
+
+        for (uint16_t i = 0; i < count; i++) {
+            boxes[i].x1 = test_rand() % LCD_WIDTH;
+            boxes[i].y1 = test_rand() % LCD_HEIGHT;
+            boxes[i].x2 = test_rand() % LCD_WIDTH;
+            boxes[i].y2 = test_rand() % LCD_HEIGHT;
+            boxes[i].color = test_rand();
+        }
+
+        reset_frames();
+        for (uint16_t i = 0; i < count; i++) {
+            fonts_drawThickRectangle(boxes[i].x1, boxes[i].y1, boxes[i].x2, boxes[i].y2, boxes[i].color, thickness, (uint8_t *) ref_frame);
+        }
+        fonts_drawBoxes(boxes, count, thickness, (uint8_t *) new_frame);
+        CHECK(!memcmp(ref_frame, new_frame, sizeof(ref_frame)), "round %u %u boxes", round, count);
+    }
+}
+
+static void bench_strings(const FontDef *font, uint8_t bg)
+{
+    uint64_t start, ref_ns, new_ns;
+    uint32_t count = sizeof(screen_strings) / sizeof(screen_strings[0]);
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        for (uint32_t s = 0; s < count; s++) {
+            ref_putString(4, 4 + s * font->height, screen_strings[s], font, WHITE, bg, BLACK, (uint8_t *) ref_frame);
+        }
+    }
+    ref_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        for (uint32_t s = 0; s < count; s++) {
+            fonts_putString(4, 4 + s * font->height, screen_strings[s], font, WHITE, bg, BLACK, (uint8_t *) new_frame);
+        }
+    }
+    new_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    printf("%-11s text %2ux%-2u %-12s per bit %6.2f us, glyph cache %6.2f us, %.1fx\n", TEST_NAME,
+           font->width, font->height, bg ? "opaque" : "transparent", ref_ns / 1000.0, new_ns / 1000.0, (double) ref_ns / new_ns);
+}
+
+// Overlays the demos draw, a FaceID frame and a result bar
+static void bench_primitives(void)
+{
+    uint64_t start, ref_ns, new_ns;
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        ref_drawThickRectangle(40, 40, 199, 199, GREEN, 2, (uint8_t *) ref_frame);
+        ref_drawThickRectangle(38, 38, 201, 201, BLACK, 2, (uint8_t *) ref_frame);
+    }
+    ref_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        fonts_drawThickRectangle(40, 40, 199, 199, GREEN, 2, (uint8_t *) new_frame);
+        fonts_drawThickRectangle(38, 38, 201, 201, BLACK, 2, (uint8_t *) new_frame);
+    }
+    new_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    printf("%-11s %-24s per pixel %6.2f us, spans %6.2f us, %.1fx\n", TEST_NAME, "2x 160x160 boxes",
+           ref_ns / 1000.0, new_ns / 1000.0, (double) ref_ns / new_ns);
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        ref_drawFilledRectangle(0, LCD_HEIGHT - 24, LCD_WIDTH - 1, 23, BLACK, (uint8_t *) ref_frame);
+    }
+    ref_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        fonts_drawFilledRectangle(0, LCD_HEIGHT - 24, LCD_WIDTH - 1, 23, BLACK, (uint8_t *) new_frame);
+    }
+    new_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    printf("%-11s %-24s per pixel %6.2f us, spans %6.2f us, %.1fx\n", TEST_NAME, "240x24 filled",
+           ref_ns / 1000.0, new_ns / 1000.0, (double) ref_ns / new_ns);
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        ref_drawLine(0, 0, LCD_WIDTH - 1, LCD_HEIGHT / 2, WHITE, (uint8_t *) ref_frame);
+        ref_drawLine(0, LCD_HEIGHT - 1, LCD_WIDTH / 2, 0, WHITE, (uint8_t *) ref_frame);
+    }
+    ref_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        fonts_drawLine(0, 0, LCD_WIDTH - 1, LCD_HEIGHT / 2, WHITE, (uint8_t *) new_frame);
+        fonts_drawLine(0, LCD_HEIGHT - 1, LCD_WIDTH / 2, 0, WHITE, (uint8_t *) new_frame);
+    }
+    new_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    printf("%-11s %-24s per pixel %6.2f us, spans %6.2f us, %.1fx\n", TEST_NAME, "2 diagonal lines",
+           ref_ns / 1000.0, new_ns / 1000.0, (double) ref_ns / new_ns);
+}
+
+int main(int argc, char **argv)
+{
+    if (test_bench_mode(argc, argv)) {
+        for (uint32_t f = 0; f < 3; f++) {
+            bench_strings(fonts[f], 0);
+            bench_strings(fonts[f], 1);
+        }
+        bench_primitives();
+        return 0;
+    }
+
+    test_all_glyphs();
+    test_strings();
+    test_damage();
+    test_lines();
+    test_rectangles();
+    test_degenerate_rectangles();
+    test_filled_rectangles();
+    test_boxes();
+
+    return test_result(TEST_NAME);
+}
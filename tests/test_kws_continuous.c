@@ -0,0 +1,289 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+// Continuous keyword spotting decision against the original inline smoothing and suppression in
+// kws_continuous(), and the utterance cases it has to get right: one report per held keyword,
+// no report on a single confident inference or on "Unknown", a repeat only after the suppression
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "test_common.h"
+#include "max78000_audio_kws.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define MIN(x, y)               (((x) < (y)) ? (x) : (y))
+
+// Same as max78000_audio_main.c
+#define INFERENCE_THRESHOLD     75
+#define UNKNOWN_CLASS           (KWS_NUM_OUTPUTS - 1)
+
+#define TEST_STREAMS            200
+#define TEST_STREAM_HOPS        500
+#define BENCH_HOPS              1000000
+#define Q15_ONE                 32767
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+// Original state, static locals of kws_continuous()
+typedef struct {
+    int16_t posteriors[KWS_SMOOTHING_HOPS][KWS_NUM_OUTPUTS];
+    uint16_t inferenceCounter;
+    uint16_t posteriorCounter;
+    uint16_t suppressCounter;
+    int16_t lastClass;
+} ref_state_t;
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+static void ref_init(ref_state_t *ref)
+{
+    memset(ref, 0, sizeof(ref_state_t));
+    ref->lastClass = -1;
+}
+
+// Original decision of kws_continuous(), returns the reported class or -1
+static int ref_update(ref_state_t *ref, const int16_t *softmax, int16_t *out, double *prob)
+{
+    int32_t sum, max_sum = -1;
+    int16_t out_class = -1;
+    uint16_t hops;
+    double probability;
+    int report = -1;
+
+    memcpy(ref->posteriors[ref->posteriorCounter], softmax, sizeof(ref->posteriors[0]));
+    ref->posteriorCounter = (ref->posteriorCounter + 1) % KWS_SMOOTHING_HOPS;
+    if (ref->inferenceCounter < KWS_SMOOTHING_HOPS) {
+        ref->inferenceCounter++;
+    }
+
+    for (int i = 0; i < KWS_NUM_OUTPUTS; i++) {
+        sum = 0;
+        for (hops = 0; hops < ref->inferenceCounter; hops++) {
+            sum += ref->posteriors[hops][i];
+        }
+        if (sum > max_sum) {
+            max_sum = sum;
+            out_class = i;
+        }
+    }
+    probability = 100.0 * max_sum / ref->inferenceCounter / 32768.0;
+
+    if (ref->suppressCounter) {
+        ref->suppressCounter--;
+    }
+
+    if ((probability > INFERENCE_THRESHOLD) && (out_class != UNKNOWN_CLASS)) {
+        if ((out_class != ref->lastClass) || (ref->suppressCounter == 0)) {
+            report = out_class;
+            ref->lastClass = out_class;
+        }
+        ref->suppressCounter = KWS_SUPPRESS_HOPS;
+    }
+
+    *out = out_class;
+    *prob = probability;
+
+    return report;
+}
+
+// Softmax with most of the probability on one class, the rest spread over the others
+static void make_softmax(int16_t *softmax, int cls, int32_t weight)
+{
+    int32_t rest = Q15_ONE - weight;
+
+    for (int i = 0; i < KWS_NUM_OUTPUTS; i++) {
+        softmax[i] = rest / (KWS_NUM_OUTPUTS - 1);
+    }
+    softmax[cls] = weight;
+}
+
+// Feed hops of one class, returns the number of reports and checks that only cls is reported
+static int feed(kws_decision_t *kws, int cls, int32_t weight, int hops)
+{
+    int16_t softmax[KWS_NUM_OUTPUTS];
+    int16_t out_class;
+    double probability;
+    int reports = 0;
+    int report;
+
+    make_softmax(softmax, cls, weight);
+    for (int i = 0; i < hops; i++) {
+        report = kws_decision_update(kws, softmax, &out_class, &probability);
+        if (report >= 0) {
+            CHECK(report == cls, "reported %d while feeding %d", report, cls);
+            reports++;
+        }
+    }
+
+    return reports;
+}
+
+// Random utterances over a noisy background, decisions have to match the original ones exactly
+static void test_reference(void)
+{
+    kws_decision_t kws;
+    ref_state_t ref;
+    int16_t softmax[KWS_NUM_OUTPUTS];
+    int16_t out_class, ref_class;
+    double probability, ref_probability;
+    int report, ref_report;
+    int cls = UNKNOWN_CLASS;
+    int remaining = 0;
+    int32_t weight = 0;
+    int reports = 0;
+
+    for (int stream = 0; stream < TEST_STREAMS; stream++) {
+        kws_decision_init(&kws, INFERENCE_THRESHOLD, UNKNOWN_CLASS);
+        ref_init(&ref);
+
+        for (int hop = 0; hop < TEST_STREAM_HOPS; hop++) {
+            // Next utterance, a keyword or background, held for a few hops
+            if (remaining == 0) {
+                cls = test_rand() % KWS_NUM_OUTPUTS;
+                remaining = 1 + test_rand() % (2 * KWS_SUPPRESS_HOPS);
+                weight = Q15_ONE / 2 + test_rand() % (Q15_ONE / 2);
+            }
+            remaining--;
+
+            // Per class jitter, each inference differs
+            make_softmax(softmax, cls, weight);
+            for (int i = 0; i < KWS_NUM_OUTPUTS; i++) {
+                softmax[i] = MIN(Q15_ONE, softmax[i] + (int16_t)(test_rand() % 2048));
+            }
+
+            report = kws_decision_update(&kws, softmax, &out_class, &probability);
+            ref_report = ref_update(&ref, softmax, &ref_class, &ref_probability);
+
+            CHECK(report == ref_report, "stream %d hop %d: report %d, original %d", stream, hop, report, ref_report);
+            CHECK(out_class == ref_class, "stream %d hop %d: class %d, original %d", stream, hop, out_class, ref_class);
+            CHECK(probability == ref_probability, "stream %d hop %d: probability %f, original %f",
+                  stream, hop, probability, ref_probability);
+            reports += (report >= 0);
+        }
+    }
+
+    // Streams have to exercise the reports, not only the background
+    CHECK(reports > TEST_STREAMS, "only %d reports", reports);
+}
+
+static void test_utterances(void)
+{
+    kws_decision_t kws;
+    int reports;
+    int gap;
+
+    // A held keyword is reported once
+    kws_decision_init(&kws, INFERENCE_THRESHOLD, UNKNOWN_CLASS);
+    reports = feed(&kws, 3, Q15_ONE, 4 * KWS_SUPPRESS_HOPS);
+    CHECK(reports == 1, "held keyword reported %d times", reports);
+
+    // "Unknown" is never reported
+    kws_decision_init(&kws, INFERENCE_THRESHOLD, UNKNOWN_CLASS);
+    reports = feed(&kws, UNKNOWN_CLASS, Q15_ONE, 4 * KWS_SUPPRESS_HOPS);
+    CHECK(reports == 0, "unknown reported %d times", reports);
+
+    // A single confident inference is averaged away once the window is full
+    reports = feed(&kws, 5, Q15_ONE, 1);
+    CHECK(reports == 0, "single inference reported %d times", reports);
+    reports = feed(&kws, UNKNOWN_CLASS, Q15_ONE, KWS_SMOOTHING_HOPS);
+    CHECK(reports == 0, "unknown reported %d times", reports);
+
+    // Below the threshold nothing is reported
+    reports = feed(&kws, 5, Q15_ONE * (INFERENCE_THRESHOLD - 5) / 100, 4 * KWS_SUPPRESS_HOPS);
+    CHECK(reports == 0, "low confidence reported %d times", reports);
+
+    // Another keyword is reported right away, even while the previous one is suppressed
+    kws_decision_init(&kws, INFERENCE_THRESHOLD, UNKNOWN_CLASS);
+    reports = feed(&kws, 3, Q15_ONE, KWS_SMOOTHING_HOPS);
+    reports += feed(&kws, 4, Q15_ONE, KWS_SMOOTHING_HOPS);
+    CHECK(reports == 2, "two keywords reported %d times", reports);
+
+    // Same keyword again: the return gets confident once the smoothing window is full of it, it is
+    // reported if the suppression ran out by then. Leaving it is not confident from the first hop
+    for (gap = 1; gap < 2 * KWS_SUPPRESS_HOPS; gap++) {
+        kws_decision_init(&kws, INFERENCE_THRESHOLD, UNKNOWN_CLASS);
+        reports = feed(&kws, 3, Q15_ONE, KWS_SMOOTHING_HOPS);
+        reports += feed(&kws, UNKNOWN_CLASS, Q15_ONE, gap);
+        reports += feed(&kws, 3, Q15_ONE, KWS_SMOOTHING_HOPS);
+        CHECK(reports == (((gap + KWS_SMOOTHING_HOPS) >= KWS_SUPPRESS_HOPS) ? 2 : 1),
+              "gap %d: reported %d times", gap, reports);
+    }
+}
+
+static void bench(void)
+{
+    static int16_t softmax[64][KWS_NUM_OUTPUTS];
+    volatile int sink = 0;
+    kws_decision_t kws;
+    int16_t out_class;
+    double probability;
+    uint64_t start, ns;
+
+    for (int i = 0; i < 64; i++) {
+        make_softmax(softmax[i], test_rand() % KWS_NUM_OUTPUTS, test_rand() % Q15_ONE);
+    }
+    kws_decision_init(&kws, INFERENCE_THRESHOLD, UNKNOWN_CLASS);
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_HOPS; i++) {
+        sink += kws_decision_update(&kws, softmax[i % 64], &out_class, &probability);
+    }
+    ns = test_time_ns() - start;
+
+    printf("kws decision %d classes, %d hops smoothing: %.1f ns per inference\n",
+           KWS_NUM_OUTPUTS, KWS_SMOOTHING_HOPS, (double) ns / BENCH_HOPS);
+    (void) sink;
+}
+
+int main(int argc, char **argv)
+{
+    if (test_bench_mode(argc, argv)) {
+        bench();
+        return 0;
+    }
+
+    test_reference();
+    test_utterances();
+
+    return test_result("kws_continuous");
+}
@@ -0,0 +1,227 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+
+// Bit-exactness of the RGB565 to CNN input conversion against the per-pixel loops it replaced, and its speed
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "test_common.h"
+#include "maxrefdes178_rgb565.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#if defined(__ARM_FEATURE_DSP)
+#define TEST_NAME           "rgb565_dsp"
+#else
+#define TEST_NAME           "rgb565"
+#endif
+
+#define LCD_WIDTH           240
+#define LCD_HEIGHT          240
+#define ROW_SIZE            (LCD_WIDTH * 2)
+#define BENCH_ROUNDS        200
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static uint8_t frame[LCD_WIDTH * LCD_HEIGHT * 2 + 8];
+static uint32_t ref_out[3][LCD_WIDTH];
+static uint32_t new_out[3][LCD_WIDTH];
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+// Original FaceId row loop, one 0x00bbggrr word per pixel. UNet had the same loop but built the word from
+// sign extended int8_t components, the library output is the masked FaceId one for both
+static void ref_hwc(const uint8_t *data, uint32_t *dst, uint32_t count, uint32_t step)
+{
+    uint8_t ur, ug, ub;
+    int8_t r, g, b;
+    uint32_t number;
+
+    for (uint32_t j = 0; j < count * step; j += step) {
+        // RGB565, |RRRRRGGG|GGGBBBBB|
+        ub = (data[j * 2 + 1] << 3);
+        ug = ((data[j * 2] << 5) | ((data[j * 2 + 1] & 0xE0) >> 3));
+        ur = (data[j * 2] & 0xF8);
+        b = ub - 128;
+        g = ug - 128;
+        r = ur - 128;
+
+        number = 0x00FFFFFF & ((((uint8_t)b) << 16) | (((uint8_t)g) << 8) | ((uint8_t) r));
+        *dst++ = number;
+    }
+}
+
+// Original CatsDogs and WildLife row loop, four pixels per word in each channel, first pixel in the MSB
+static void ref_chw(const uint8_t *data, uint32_t *dst_r, uint32_t *dst_g, uint32_t *dst_b,
+        uint32_t count, uint32_t step)
+{
+    uint8_t ur, ug, ub;
+    int8_t r, g, b;
+    uint32_t r32 = 0, g32 = 0, b32 = 0;
+    int cnt = 3;
+
+    for (uint32_t j = 0; j < count * step; j += step) {
+        ub = (data[j * 2 + 1] << 3);
+        ug = ((data[j * 2] << 5) | ((data[j * 2 + 1] & 0xE0) >> 3));
+        ur = (data[j * 2] & 0xF8);
+
+        b = ub - 128;
+        g = ug - 128;
+        r = ur - 128;
+
+        r32 = r32 | ((uint8_t)r << ((cnt)*8));
+        g32 = g32 | ((uint8_t)g << ((cnt)*8));
+        b32 = b32 | ((uint8_t)b << ((cnt)*8));
+        if (cnt == 0) {
+            *dst_r++ = r32;
+            *dst_g++ = g32;
+            *dst_b++ = b32;
+
+            r32 = 0;
+            g32 = 0;
+            b32 = 0;
+            cnt = 3;
+        } else {
+            cnt--;
+        }
+    }
+}
+
+// Every RGB565 value once
+static void test_all_pixels(void)
+{
+    static uint8_t all[65536 * 2];
+    static uint32_t ref[65536], out[65536], r[3][16384], n[3][16384];
+
+    for (uint32_t i = 0; i < 65536; i++) {
+        all[2 * i] = i >> 8;
+        all[2 * i + 1] = i;
+    }
+
+    ref_hwc(all, ref, 65536, 1);
+    rgb565_to_cnn_hwc(all, out, 65536, 1);
+    for (uint32_t i = 0; i < 65536; i++) {
+        CHECK(out[i] == ref[i], "hwc pixel 0x%04x: 0x%08x expected 0x%08x", i, out[i], ref[i]);
+    }
+
+    ref_chw(all, r[0], r[1], r[2], 65536, 1);
+    rgb565_to_cnn_chw(all, n[0], n[1], n[2], 65536, 1);
+    CHECK(!memcmp(r, n, sizeof(r)), "chw all pixels");
+}
+
+// Random rows at every source alignment, the steps and counts the demos use and odd counts
+static void test_rows(void)
+{
+    static const uint32_t steps[] = {1, 2, 3};
+
+    for (uint32_t round = 0; round < 2000; round++) {
+        uint32_t offset = round % 4;
+        uint32_t step = steps[round % 3];
+        uint32_t count = 1 + test_rand() % (LCD_WIDTH / step);
+        const uint8_t *src = &frame[offset + 2 * (test_rand() % LCD_HEIGHT) * LCD_WIDTH];
+
+        memset(ref_out, 0xA5, sizeof(ref_out));
+        memset(new_out, 0xA5, sizeof(new_out));
+        ref_hwc(src, ref_out[0], count, step);
+        rgb565_to_cnn_hwc(src, new_out[0], count, step);
+        CHECK(!memcmp(ref_out, new_out, sizeof(ref_out)), "hwc offset %u step %u count %u", offset, step, count);
+
+        // Partial words are not written
+        count &= ~3;
+        memset(ref_out, 0xA5, sizeof(ref_out));
+        memset(new_out, 0xA5, sizeof(new_out));
+        ref_chw(src, ref_out[0], ref_out[1], ref_out[2], count, step);
+        rgb565_to_cnn_chw(src, new_out[0], new_out[1], new_out[2], count, step);
+        CHECK(!memcmp(ref_out, new_out, sizeof(ref_out)), "chw offset %u step %u count %u", offset, step, count);
+    }
+}
+
+// rows rows of count pixels, every step-th pixel of every step-th line as the demos downscale
+static void bench_rows(const char *name, uint32_t count, uint32_t rows, uint32_t step, int chw)
+{
+    uint64_t start, ref_ns, new_ns;
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        for (uint32_t y = 0; y < rows * step; y += step) {
+            if (chw) {
+                ref_chw(&frame[y * ROW_SIZE], ref_out[0], ref_out[1], ref_out[2], count, step);
+            } else {
+                ref_hwc(&frame[y * ROW_SIZE], ref_out[0], count, step);
+            }
+        }
+    }
+    ref_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        for (uint32_t y = 0; y < rows * step; y += step) {
+            if (chw) {
+                rgb565_to_cnn_chw(&frame[y * ROW_SIZE], new_out[0], new_out[1], new_out[2], count, step);
+            } else {
+                rgb565_to_cnn_hwc(&frame[y * ROW_SIZE], new_out[0], count, step);
+            }
+        }
+    }
+    new_ns = (test_time_ns() - start) / BENCH_ROUNDS;
+
+    printf("%-11s %-22s per pixel %6.1f us, library %6.1f us, %.1fx\n",
+           TEST_NAME, name, ref_ns / 1000.0, new_ns / 1000.0, (double) ref_ns / new_ns);
+}
+
+int main(int argc, char **argv)
+{
+    test_rand_fill(frame, sizeof(frame));
+
+    if (test_bench_mode(argc, argv)) {
+        bench_rows("hwc 160x160 (FaceId)", 160, 160, 1, 0);
+        bench_rows("hwc 80x80 (UNet)", 80, 80, 3, 0);
+        bench_rows("chw 64x64 (CatsDogs)", 64, 64, 3, 1);
+        return 0;
+    }
+
+    test_all_pixels();
+    test_rows();
+
+    return test_result(TEST_NAME);
+}
@@ -0,0 +1,516 @@
+/*******************************************************************************
+ * Copyright (C) 2020-2021 Maxim Integrated Products, Inc., All rights Reserved.
+ *
+ * This software is protected by copyright laws of the United States and
+ * of foreign countries. This material may also be protected by patent laws
+ * and technology transfer regulations of the United States and of foreign
+ * countries. This software is furnished under a license agreement and/or a
+ * nondisclosure agreement and may only be used or reproduced in accordance
+ * with the terms of those agreements. Dissemination of this information to
+ * any party or parties not specified in the license agreement and/or
+ * nondisclosure agreement is expressly prohibited.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *******************************************************************************
+ */
+
+// Timeline model of the FaceID video frame loop in run_demo(): camera rows, QSPI transfers and CNN
+// inference in the order the firmware runs them. Checks that no buffer is used by two stages at once,
+// that the early restarted capture loses no rows, and the frame period against the sensor frame
+// period and the original capture, send, CNN order
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "test_common.h"
+#include "mxc_errors.h"
+#include "maxrefdes178_definitions.h"
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+#define NS_PER_S                1000000000ULL
+#define MAX(x, y)               (((x) > (y)) ? (x) : (y))
+#define DIV_ROUND_UP(x, y)      (((x) + (y) - 1) / (y))
+
+// Assumed OVM7692 timing, VGA sensor lines scaled down to CAMERA_HEIGHT rows, one clock per sensor pixel
+#define SENSOR_LINE_CLOCKS      780
+#define SENSOR_FRAME_LINES      510
+#define SENSOR_LINES_PER_ROW    (480 / CAMERA_HEIGHT)
+#define CAMERA_STREAM_ROWS      2           // camera stream buffer, rows that wait for camera_stream_frame()
+
+// Assumed MAX78000 stage costs
+#define ROW_COPY_NS             3000        // memcpy of one camera row into camera_image
+#define CNN_ROW_NS              12000       // rgb565_to_cnn_hwc() and FIFO writes of one CNN row
+#define CNN_COMPUTE_NS          12000000    // inference with the input loaded at full speed
+#define CNN_TAIL_NS             3000000     // inference left after the last streamed row
+#define CNN_UNLOAD_NS           50000
+#define MATCH_NS                2000000     // calculate_minDistance() and the decision
+#define QSPI_LATENCY_NS         30000       // INT to master, CS and DMA setup of one transfer
+#define PAYLOAD_PROCESS_NS      300000000   // update_database() and init_database() flash writes
+
+#define CNN_FIRST_ROW           ((CAMERA_HEIGHT - FACEID_HEIGHT) / 2)
+#define STATISTICS_INTERVAL     10          // time_counter % 10 in run_demo()
+#define MODEL_FRAMES            100
+#define MAX_USES                (MODEL_FRAMES * CAMERA_HEIGHT)
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+typedef enum {
+    BUFFER_FRAME = 0,                               // camera_image, QSPI frame and payload buffer
+    BUFFER_STREAM,                                  // camera stream buffer, one per row slot
+    BUFFER_CNN = BUFFER_STREAM + CAMERA_STREAM_ROWS, // accelerator from cnn_start_frame() to unload
+    BUFFER_EMBEDDING,                               // CNN output
+
+    BUFFER_LAST
+} buffer_e;
+
+typedef enum {
+    OWNER_CAMERA = 0,   // camera DMA fills a stream slot, held until the row is copied
+    OWNER_CAPTURE,      // camera_stream_frame() copies rows into camera_image
+    OWNER_QSPI_TX,
+    OWNER_QSPI_RX,      // payload received and processed in place
+    OWNER_CNN,
+    OWNER_UNLOAD,
+    OWNER_MATCH,
+
+    OWNER_LAST
+} owner_e;
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    owner_e owner;
+    uint32_t item;      // frame, or camera row for the stream slots
+} use_t;
+
+typedef struct {
+    uint32_t camera_hz;
+    uint32_t qspi_hz;
+    uint64_t match_ns;
+    uint32_t payload_interval;  // frames between QSPI payload commands, 0 for none
+} model_config_t;
+
+typedef struct {
+    uint32_t lost_rows;
+    uint32_t incomplete;        // frames with lost rows, CNN stopped
+    uint64_t vsync[MODEL_FRAMES];
+} model_result_t;
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+static use_t uses[BUFFER_LAST][MAX_USES];
+static uint32_t use_count[BUFFER_LAST];
+static model_config_t config;
+static uint64_t now;            // MAX78000 video core, run_demo() is single threaded
+
+// Camera, PCIF captures from the next VSYNC of the free running sensor
+static uint64_t frame_ns;
+static uint64_t row_ns;
+static uint64_t capture_vsync;
+static int capture_started;
+static uint32_t camera_row;
+
+static uint64_t cnn_start_ns;
+static uint64_t cnn_loaded_ns;  // last input row in the CNN FIFO
+
+
+//-----------------------------------------------------------------------------
+// Function definitions
+//-----------------------------------------------------------------------------
+static void use(buffer_e buffer, owner_e owner, uint32_t item, uint64_t start, uint64_t end)
+{
+    if (use_count[buffer] < MAX_USES) {
+        uses[buffer][use_count[buffer]++] = (use_t) {start, end, owner, item};
+    }
+}
+
+static int use_compare(const void *a, const void *b)
+{
+    const use_t *x = a;
+    const use_t *y = b;
+
+    return (x->start > y->start) - (x->start < y->start);
+}
+
+// Uses by different owners, or by one owner for different items, must not overlap
+static uint32_t check_ownership(void)
+{
+    uint32_t conflicts = 0;
+
+    for (int b = 0; b < BUFFER_LAST; b++) {
+        use_t *last;
+
+        if (use_count[b] == 0) {
+            continue;
+        }
+
+        qsort(uses[b], use_count[b], sizeof(use_t), use_compare);
+
+        // A use that overlaps any earlier one overlaps the one that ends last
+        last = &uses[b][0];
+        for (uint32_t i = 1; i < use_count[b]; i++) {
+            use_t *u = &uses[b][i];
+
+            if ((u->start < last->end) && ((u->owner != last->owner) || (u->item != last->item))) {
+                if (conflicts++ == 0) {
+                    printf("buffer %d: owner %d item %u at %llu ns, owner %d item %u until %llu ns\n",
+                           b, u->owner, u->item, (unsigned long long) u->start,
+                           last->owner, last->item, (unsigned long long) last->end);
+                }
+            }
+            if (u->end > last->end) {
+                last = u;
+            }
+        }
+    }
+
+    return conflicts;
+}
+
+static void model_reset(const model_config_t *model_config)
+{
+    config = *model_config;
+    memset(use_count, 0, sizeof(use_count));
+    now = 0;
+
+    row_ns = ((uint64_t) SENSOR_LINE_CLOCKS * SENSOR_LINES_PER_ROW * NS_PER_S) / config.camera_hz;
+    frame_ns = ((uint64_t) SENSOR_LINE_CLOCKS * SENSOR_FRAME_LINES * NS_PER_S) / config.camera_hz;
+    capture_started = 0;
+    camera_row = 0;
+}
+
+// Header and payload are separate transfers, quad lines move a byte in two clocks
+static uint64_t qspi_ns(uint32_t size)
+{
+    uint64_t ns = QSPI_LATENCY_NS + ((sizeof(qspi_packet_header_t) * 2 * NS_PER_S) / config.qspi_hz);
+
+    if (size) {
+        ns += QSPI_LATENCY_NS + (((uint64_t) size * 2 * NS_PER_S) / config.qspi_hz);
+    }
+
+    return ns;
+}
+
+static void model_send_packet(uint32_t size)
+{
+    now += qspi_ns(size);
+}
+
+static void model_camera_stream_start(void)
+{
+    if (capture_started) {
+        return;
+    }
+
+    capture_vsync = DIV_ROUND_UP(now, frame_ns) * frame_ns;
+    capture_started = 1;
+}
+
+static void model_camera_stream_stop(void)
+{
+    capture_started = 0;
+}
+
+// camera_stream_frame(), a row waits in a stream slot until it is copied, with no free slot it is lost
+static int model_camera_stream_frame(uint32_t frame, int enable_cnn, model_result_t *result)
+{
+    uint64_t slot_free[CAMERA_STREAM_ROWS] = {0};
+    uint64_t row_start;
+    uint64_t copy_start;
+    uint64_t first_copy = 0;
+    uint32_t received = 0;
+    uint32_t lost = 0;
+    uint32_t slot;
+
+    model_camera_stream_start();
+    result->vsync[frame] = capture_vsync;
+
+    for (uint32_t hw_row = 0; hw_row < CAMERA_HEIGHT; hw_row++) {
+        row_start = capture_vsync + (hw_row * row_ns);
+        slot = received % CAMERA_STREAM_ROWS;
+
+        if (slot_free[slot] > row_start) {
+            lost++;
+            continue;
+        }
+
+        copy_start = MAX(now, row_start + row_ns);
+        if (received == 0) {
+            first_copy = copy_start;
+        }
+        now = copy_start + ROW_COPY_NS;
+        use(BUFFER_STREAM + slot, OWNER_CAMERA, camera_row++, row_start, now);
+        slot_free[slot] = now;
+
+        // Firmware counts received rows, a lost row shifts the CNN window
+        if (enable_cnn && (received >= CNN_FIRST_ROW) && (received < (CNN_FIRST_ROW + FACEID_HEIGHT))) {
+            now += CNN_ROW_NS;
+            cnn_loaded_ns = now;
+        }
+        received++;
+    }
+
+    capture_started = 0;
+    use(BUFFER_FRAME, OWNER_CAPTURE, frame, first_copy, now);
+
+    if (lost) {
+        // Waits for the frame end with rows missing
+        now = MAX(now, capture_vsync + (CAMERA_HEIGHT * row_ns));
+        result->lost_rows += lost;
+        return E_TIME_OUT;
+    }
+
+    return E_NO_ERROR;
+}
+
+static void model_send_img(uint32_t frame)
+{
+    uint64_t start;
+
+    model_send_packet(sizeof(uint32_t));
+    start = now;
+    model_send_packet(LCD_DATA_SIZE);
+    use(BUFFER_FRAME, OWNER_QSPI_TX, frame, start, now);
+}
+
+// cnn_process_result(), classification is sent on every frame as the worst case
+static void model_cnn_process_result(uint32_t frame)
+{
+    now = MAX(now, MAX(cnn_loaded_ns + CNN_TAIL_NS, cnn_start_ns + CNN_COMPUTE_NS));
+
+    use(BUFFER_EMBEDDING, OWNER_UNLOAD, frame, now, now + CNN_UNLOAD_NS);
+    now += CNN_UNLOAD_NS;
+    use(BUFFER_CNN, OWNER_CNN, frame, cnn_start_ns, now);
+
+    use(BUFFER_EMBEDDING, OWNER_MATCH, frame, now, now + config.match_ns);
+    now += config.match_ns;
+
+    model_send_packet(sizeof(classification_result_t));
+}
+
+static void model_send_statistics(uint32_t frame)
+{
+    if (frame % STATISTICS_INTERVAL == 0) {
+        model_send_packet(sizeof(max78000_statistics_t));
+        model_send_packet(sizeof(stage_timing_t) * TIMING_STAGE_LAST);
+    }
+}
+
+// Same order as run_demo()
+static void model_run_demo(const model_config_t *model_config, model_result_t *result)
+{
+    uint64_t start;
+    int ret;
+
+    model_reset(model_config);
+    memset(result, 0, sizeof(model_result_t));
+
+    for (uint32_t frame = 0; frame < MODEL_FRAMES; frame++) {
+        // Payload is received into the frame buffer with the early started capture stopped
+        if (config.payload_interval && frame && ((frame % config.payload_interval) == 0)) {
+            model_camera_stream_stop();
+            start = now;
+            now += qspi_ns(FACEID_MAX_EMBEDDINGS_SIZE) + PAYLOAD_PROCESS_NS;
+            use(BUFFER_FRAME, OWNER_QSPI_RX, frame, start, now);
+            model_send_packet(sizeof(uint8_t));
+        }
+
+        cnn_start_ns = now;
+        ret = model_camera_stream_frame(frame, 1, result);
+
+        model_send_img(frame);
+
+        // Frame buffer is free again, camera waits for the next frame start while the CNN result is processed
+        model_camera_stream_start();
+
+        if (ret == E_TIME_OUT) {
+            use(BUFFER_CNN, OWNER_CNN, frame, cnn_start_ns, now);
+            result->incomplete++;
+        } else {
+            model_cnn_process_result(frame);
+        }
+
+        model_send_statistics(frame);
+    }
+}
+
+// Original order: capture the whole frame, send it, then load it into the CNN and wait for the result
+static void model_run_sequential(const model_config_t *model_config, model_result_t *result)
+{
+    uint64_t start;
+
+    model_reset(model_config);
+    memset(result, 0, sizeof(model_result_t));
+
+    for (uint32_t frame = 0; frame < MODEL_FRAMES; frame++) {
+        model_camera_stream_start();
+        result->vsync[frame] = capture_vsync;
+        now = capture_vsync + (CAMERA_HEIGHT * row_ns);
+        capture_started = 0;
+        use(BUFFER_FRAME, OWNER_CAPTURE, frame, capture_vsync, now);
+
+        start = now;
+        model_send_packet(LCD_DATA_SIZE);
+        use(BUFFER_FRAME, OWNER_QSPI_TX, frame, start, now);
+
+        cnn_start_ns = now;
+        now += FACEID_HEIGHT * CNN_ROW_NS;
+        cnn_loaded_ns = now;
+        use(BUFFER_FRAME, OWNER_CNN, frame, cnn_start_ns, now);
+        model_cnn_process_result(frame);
+
+        model_send_statistics(frame);
+    }
+}
+
+// Frame period in ns if every frame after the first has the same one, 0 otherwise
+static uint64_t model_period(const model_result_t *result)
+{
+    uint64_t period = result->vsync[1] - result->vsync[0];
+
+    for (uint32_t frame = 2; frame < MODEL_FRAMES; frame++) {
+        if ((result->vsync[frame] - result->vsync[frame - 1]) != period) {
+            return 0;
+        }
+    }
+
+    return period;
+}
+
+// Capture is restarted after the frame is sent, at the first VSYNC after readout and QSPI transfer
+static uint64_t expected_period(void)
+{
+    uint64_t busy = (CAMERA_HEIGHT * row_ns) + ROW_COPY_NS + qspi_ns(sizeof(uint32_t)) + qspi_ns(LCD_DATA_SIZE);
+
+    return DIV_ROUND_UP(busy, frame_ns) * frame_ns;
+}
+
+static void test_pipeline(void)
+{
+    static const uint32_t camera_clocks[] = {5000000, 10000000, 15000000};
+    model_result_t result;
+    uint64_t period;
+    uint64_t sequential_period;
+    uint32_t conflicts;
+
+    for (uint32_t i = 0; i < sizeof(camera_clocks) / sizeof(camera_clocks[0]); i++) {
+        model_config_t model_config = {camera_clocks[i], QSPI_SPEED, MATCH_NS, 0};
+
+        model_run_demo(&model_config, &result);
+        conflicts = check_ownership();
+        period = model_period(&result);
+        CHECK(conflicts == 0, "camera %u Hz: %u buffer conflicts", camera_clocks[i], conflicts);
+        CHECK((result.lost_rows == 0) && (result.incomplete == 0), "camera %u Hz: %u rows lost, %u frames incomplete",
+              camera_clocks[i], result.lost_rows, result.incomplete);
+        CHECK(period == expected_period(), "camera %u Hz: period %llu ns, expected %llu ns",
+              camera_clocks[i], (unsigned long long) period, (unsigned long long) expected_period());
+
+        model_run_sequential(&model_config, &result);
+        conflicts = check_ownership();
+        sequential_period = model_period(&result);
+        CHECK(conflicts == 0, "camera %u Hz: %u buffer conflicts in the original order", camera_clocks[i], conflicts);
+        CHECK(period <= sequential_period, "camera %u Hz: period %llu ns, original order %llu ns", camera_clocks[i],
+              (unsigned long long) period, (unsigned long long) sequential_period);
+
+        // Default camera clock, the original order needs one more sensor frame
+        if (camera_clocks[i] == 15000000) {
+            CHECK(period < sequential_period, "camera %u Hz: period %llu ns, original order %llu ns", camera_clocks[i],
+                  (unsigned long long) period, (unsigned long long) sequential_period);
+        }
+    }
+}
+
+// Post-processing that runs past the restarted capture has to show up as lost rows
+static void test_late_restart(void)
+{
+    model_config_t model_config = {15000000, QSPI_SPEED, 4 * MATCH_NS, 0};
+    model_result_t result;
+    uint32_t conflicts;
+
+    model_run_demo(&model_config, &result);
+    conflicts = check_ownership();
+    CHECK(conflicts == 0, "%u buffer conflicts", conflicts);
+    CHECK((result.lost_rows > 0) && (result.incomplete > 0), "no rows lost with %llu ns post-processing",
+          (unsigned long long) model_config.match_ns);
+}
+
+// Payload commands take the frame buffer between frames, capture starts again on the next VSYNC
+static void test_payload(void)
+{
+    model_config_t model_config = {15000000, QSPI_SPEED, MATCH_NS, 7};
+    model_result_t result;
+    uint32_t conflicts;
+
+    model_run_demo(&model_config, &result);
+    conflicts = check_ownership();
+    CHECK(conflicts == 0, "%u buffer conflicts", conflicts);
+    // Capture armed before the command would lose the rows that arrive while the payload is processed
+    CHECK((result.lost_rows == 0) && (result.incomplete == 0), "%u rows lost, %u frames incomplete",
+          result.lost_rows, result.incomplete);
+}
+
+static void bench(void)
+{
+    static const uint32_t camera_clocks[] = {5000000, 10000000, 15000000};
+    static const uint32_t qspi_clocks[] = {7500000, 10000000, 12000000};
+    model_result_t result;
+    uint64_t period;
+    uint64_t sequential_period;
+
+    printf("assumed sensor timing and stage costs, see the defines\n");
+    printf("camera   QSPI      sensor       run_demo          original order\n");
+    for (uint32_t i = 0; i < sizeof(camera_clocks) / sizeof(camera_clocks[0]); i++) {
+        for (uint32_t j = 0; j < sizeof(qspi_clocks) / sizeof(qspi_clocks[0]); j++) {
+            model_config_t model_config = {camera_clocks[i], qspi_clocks[j], MATCH_NS, 0};
+
+            model_run_demo(&model_config, &result);
+            period = model_period(&result);
+            model_run_sequential(&model_config, &result);
+            sequential_period = model_period(&result);
+
+            printf("%2u MHz %5.1f MHz %5.1f fps  %5.1f fps %u frames  %5.1f fps %u frames\n",
+                   camera_clocks[i] / 1000000, qspi_clocks[j] / 1e6, (double) NS_PER_S / frame_ns,
+                   (double) NS_PER_S / period, (uint32_t) (period / frame_ns),
+                   (double) NS_PER_S / sequential_period, (uint32_t) (sequential_period / frame_ns));
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (test_bench_mode(argc, argv)) {
+        bench();
+        return 0;
+    }
+
+    test_pipeline();
+    test_late_restart();
+    test_payload();
+
+    return test_result("video_pipeline");
+}